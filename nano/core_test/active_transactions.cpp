@@ -66,6 +66,55 @@ TEST (active_transactions, confirm_active)
 	// Blocks were cleared (except for not_an_account)
 	ASSERT_EQ (1, election->blocks ().size ());
 }
+
+// Elections are only visited by the request loop when their scheduled transition is due
+TEST (active_transactions, schedule_transitions)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.disable_request_loop = true;
+	auto & node = *system.add_node (node_flags);
+	nano::genesis genesis;
+	auto send = nano::send_block_builder ()
+				.previous (genesis.hash ())
+				.destination (nano::public_key ())
+				.balance (nano::dev::genesis_amount - 100)
+				.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				.work (*system.work.generate (genesis.hash ()))
+				.build_shared ();
+	ASSERT_EQ (nano::process_result::progress, node.process (*send).code);
+	node.block_confirm (send);
+	node.scheduler.flush ();
+	auto election (node.active.election (send->qualified_root ()));
+	ASSERT_NE (nullptr, election);
+	{
+		nano::lock_guard<nano::mutex> guard (node.active.transitions_mutex);
+		ASSERT_EQ (1, node.active.transitions.size ());
+		ASSERT_EQ (election->next_transition (), node.active.transitions.begin ()->first);
+		ASSERT_GT (node.active.transitions.begin ()->first, std::chrono::steady_clock::now ());
+	}
+	// The passive election is not visited before its passive period ends
+	{
+		nano::unique_lock<nano::mutex> lock (node.active.mutex);
+		node.active.request_confirm (lock);
+	}
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::election, nano::stat::detail::election_transitions, nano::stat::dir::in));
+	// Activating it makes it due immediately, superseding the passive deadline
+	election->transition_active ();
+	{
+		nano::unique_lock<nano::mutex> lock (node.active.mutex);
+		node.active.request_confirm (lock);
+	}
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::election, nano::stat::detail::election_transitions, nano::stat::dir::in));
+	// Erased elections are skipped
+	node.active.erase (*send);
+	std::this_thread::sleep_for (election->confirm_req_interval ());
+	{
+		nano::unique_lock<nano::mutex> lock (node.active.mutex);
+		node.active.request_confirm (lock);
+	}
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::election, nano::stat::detail::election_transitions, nano::stat::dir::in));
+}
 }
 
 namespace nano
@@ -381,6 +430,111 @@ TEST (active_transactions, inactive_votes_cache_multiple_votes)
 	ASSERT_EQ (2, node.stats.count (nano::stat::type::election, nano::stat::detail::vote_cached));
 }
 
+TEST (inactive_votes_cache, tally)
+{
+	nano::stat stats;
+	nano::inactive_votes_cache cache (4, stats);
+	nano::block_hash hash (1);
+	nano::inactive_cache_status status;
+	size_t voters (0);
+	ASSERT_FALSE (cache.vote (hash, nano::account (1), 1, 10, status, voters));
+	ASSERT_EQ (10, status.tally);
+	ASSERT_EQ (1, voters);
+	// Repeated voters are not counted twice
+	ASSERT_TRUE (cache.vote (hash, nano::account (1), 2, 10, status, voters));
+	for (size_t i (2); i <= nano::inactive_votes_cache::max_voters; ++i)
+	{
+		ASSERT_FALSE (cache.vote (hash, nano::account (i), 1, 10 * i, status, voters));
+	}
+	auto const max_voters (nano::inactive_votes_cache::max_voters);
+	nano::uint128_t tally (10 * max_voters * (max_voters + 1) / 2);
+	ASSERT_EQ (tally, status.tally);
+	ASSERT_EQ (max_voters, voters);
+	// Once full, a voter only makes it in by replacing a lighter one
+	ASSERT_TRUE (cache.vote (hash, nano::account (max_voters + 1), 1, 5, status, voters));
+	ASSERT_EQ (1, stats.count (nano::stat::type::inactive_votes_cache, nano::stat::detail::voter_dropped));
+	ASSERT_FALSE (cache.vote (hash, nano::account (max_voters + 2), 1, 100, status, voters));
+	ASSERT_EQ (tally - 10 + 100, status.tally);
+	ASSERT_EQ (max_voters, voters);
+	auto info (cache.find (hash));
+	ASSERT_EQ (hash, info.hash);
+	ASSERT_EQ (max_voters, info.voters.size ());
+	ASSERT_EQ (info.voters.end (), std::find_if (info.voters.begin (), info.voters.end (), [] (auto const & voter_a) { return voter_a.first == nano::account (1); }));
+	// Flags are kept once set, the tally is kept by the cache
+	nano::inactive_cache_status update;
+	update.election_started = true;
+	cache.update (hash, update);
+	info = cache.find (hash);
+	ASSERT_TRUE (info.status.election_started);
+	ASSERT_FALSE (info.status.confirmed);
+	ASSERT_EQ (tally - 10 + 100, info.status.tally);
+	// Entries which need no further evaluation take no more votes
+	update.bootstrap_started = true;
+	update.confirmed = true;
+	cache.update (hash, update);
+	ASSERT_TRUE (cache.vote (hash, nano::account (max_voters + 3), 1, 1000, status, voters));
+	ASSERT_TRUE (cache.find (nano::block_hash (2)).voters.empty ());
+}
+
+TEST (inactive_votes_cache, eviction)
+{
+	nano::stat stats;
+	nano::inactive_votes_cache cache (2, stats);
+	ASSERT_EQ (2, cache.capacity ());
+	nano::inactive_cache_status status;
+	size_t voters (0);
+	ASSERT_FALSE (cache.vote (nano::block_hash (1), nano::account (1), 1, 1, status, voters));
+	ASSERT_FALSE (cache.vote (nano::block_hash (2), nano::account (1), 1, 1, status, voters));
+	ASSERT_EQ (2, cache.size ());
+	// Both entries were voted for, the hand clears their marks and evicts the first one on its second pass
+	ASSERT_FALSE (cache.vote (nano::block_hash (3), nano::account (1), 1, 1, status, voters));
+	ASSERT_EQ (2, cache.size ());
+	ASSERT_EQ (1, stats.count (nano::stat::type::inactive_votes_cache, nano::stat::detail::evict));
+	ASSERT_TRUE (cache.find (nano::block_hash (1)).voters.empty ());
+	ASSERT_EQ (1, cache.find (nano::block_hash (2)).voters.size ());
+	ASSERT_EQ (1, cache.find (nano::block_hash (3)).voters.size ());
+	// The second entry was not voted for since the hand passed it
+	ASSERT_FALSE (cache.vote (nano::block_hash (3), nano::account (2), 1, 1, status, voters));
+	ASSERT_FALSE (cache.vote (nano::block_hash (4), nano::account (1), 1, 1, status, voters));
+	ASSERT_EQ (2, stats.count (nano::stat::type::inactive_votes_cache, nano::stat::detail::evict));
+	ASSERT_TRUE (cache.find (nano::block_hash (2)).voters.empty ());
+	ASSERT_EQ (2, cache.find (nano::block_hash (3)).voters.size ());
+	cache.erase (nano::block_hash (3));
+	ASSERT_EQ (1, cache.size ());
+	ASSERT_FALSE (cache.vote (nano::block_hash (5), nano::account (1), 1, 1, status, voters));
+	ASSERT_EQ (2, stats.count (nano::stat::type::inactive_votes_cache, nano::stat::detail::evict));
+}
+
+TEST (inactive_votes_cache, erase)
+{
+	nano::stat stats;
+	size_t const count (256);
+	nano::inactive_votes_cache cache (count, stats);
+	nano::inactive_cache_status status;
+	size_t voters (0);
+	for (size_t i (1); i <= count; ++i)
+	{
+		ASSERT_FALSE (cache.vote (nano::block_hash (i), nano::account (1), 1, 1, status, voters));
+	}
+	ASSERT_EQ (count, cache.size ());
+	// Erasing shifts back entries probed past the erased ones, which must still be found
+	for (size_t i (1); i <= count; i += 2)
+	{
+		cache.erase (nano::block_hash (i));
+	}
+	ASSERT_EQ (count / 2, cache.size ());
+	for (size_t i (1); i <= count; ++i)
+	{
+		ASSERT_EQ (i % 2 == 0, cache.find (nano::block_hash (i)).hash == nano::block_hash (i));
+	}
+	for (auto i (count + 1); i <= count + count / 2; ++i)
+	{
+		ASSERT_FALSE (cache.vote (nano::block_hash (i), nano::account (1), 1, 1, status, voters));
+	}
+	ASSERT_EQ (count, cache.size ());
+	ASSERT_EQ (0, stats.count (nano::stat::type::inactive_votes_cache, nano::stat::detail::evict));
+}
+
 TEST (active_transactions, inactive_votes_cache_election_start)
 {
 	nano::system system;
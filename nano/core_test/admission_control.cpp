@@ -0,0 +1,95 @@
+#include <nano/lib/stats.hpp>
+#include <nano/node/admission_control.hpp>
+
+#include <gtest/gtest.h>
+
+TEST (admission_control, levels)
+{
+	nano::stat stats;
+	nano::admission_control admission (stats);
+	auto now (std::chrono::steady_clock::now ());
+	std::size_t size (0);
+	uint64_t processed (0);
+	admission.add ([&size] () { return size; }, 100, [&processed] () { return processed; });
+	admission.add ([] () { return std::size_t{ 0 }; }, 100, [] () { return uint64_t{ 0 }; });
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::normal, admission.level ());
+	ASSERT_FALSE (admission.throttle_bootstrap ());
+	ASSERT_FALSE (admission.pause_read ([] () { return false; }));
+
+	// Half full, bootstrap waits but live reads continue
+	size = 50;
+	// Producers only see the new level once it was sampled
+	ASSERT_EQ (nano::admission_control::pressure::normal, admission.level ());
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::elevated, admission.level ());
+	ASSERT_TRUE (admission.throttle_bootstrap ());
+	ASSERT_FALSE (admission.pause_read ([] () { return false; }));
+
+	// Nearly full, reads from principal representatives are still admitted
+	size = 80;
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::critical, admission.level ());
+	ASSERT_TRUE (admission.pause_read ([] () { return false; }));
+	ASSERT_FALSE (admission.pause_read ([] () { return true; }));
+
+	size = 0;
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::normal, admission.level ());
+
+	ASSERT_EQ (1, stats.count (nano::stat::type::admission, nano::stat::detail::pressure_elevated));
+	ASSERT_EQ (1, stats.count (nano::stat::type::admission, nano::stat::detail::pressure_critical));
+	ASSERT_EQ (1, stats.count (nano::stat::type::admission, nano::stat::detail::pressure_normal));
+	ASSERT_EQ (1, stats.count (nano::stat::type::admission, nano::stat::detail::bootstrap_throttled));
+	ASSERT_EQ (1, stats.count (nano::stat::type::admission, nano::stat::detail::read_paused));
+}
+
+// A queue which is far from full but drains too slowly throttles bootstrap
+TEST (admission_control, slow_drain)
+{
+	nano::stat stats;
+	nano::admission_control admission (stats, std::chrono::seconds (1));
+	auto now (std::chrono::steady_clock::now ());
+	std::size_t size (100);
+	uint64_t processed (0);
+	admission.add ([&size] () { return size; }, 1000, [&processed] () { return processed; });
+	// Not being drained at all is only judged by the fill level
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::normal, admission.level ());
+	// About ten items per second, the backlog takes seconds to drain
+	++processed;
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::elevated, admission.level ());
+	ASSERT_TRUE (admission.throttle_bootstrap ());
+	// Fast enough to drain the backlog well within a second
+	processed += 10000;
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::normal, admission.level ());
+}
+
+// The smoothed rate of an idle queue decays, a handful of new items must not make it look slow
+TEST (admission_control, idle_queue)
+{
+	nano::stat stats;
+	nano::admission_control admission (stats, std::chrono::seconds (1));
+	auto now (std::chrono::steady_clock::now ());
+	std::size_t size (0);
+	uint64_t processed (0);
+	admission.add ([&size] () { return size; }, 1000, [&processed] () { return processed; });
+	processed += 10000;
+	admission.sample (now += nano::admission_control::sample_interval);
+	// Idle for a minute
+	for (auto i (0); i < 600; ++i)
+	{
+		admission.sample (now += nano::admission_control::sample_interval);
+	}
+	// A small backlog is only judged by the fill level
+	size = 1;
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::normal, admission.level ());
+	// So is a larger one, as the queue is no longer considered drained at all
+	size = 200;
+	admission.sample (now += nano::admission_control::sample_interval);
+	ASSERT_EQ (nano::admission_control::pressure::normal, admission.level ());
+	ASSERT_EQ (0, stats.count (nano::stat::type::admission, nano::stat::detail::pressure_elevated));
+}
@@ -0,0 +1,148 @@
+#include <nano/node/block_prefetcher.hpp>
+#include <nano/test_common/system.hpp>
+#include <nano/test_common/testutil.hpp>
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+/** Processes a chain of sends from the genesis account and returns the hashes of the account chain, genesis first */
+std::vector<nano::block_hash> genesis_chain (nano::system & system_a, nano::node & node_a, unsigned count_a)
+{
+	std::vector<nano::block_hash> result{ nano::dev::genesis->hash () };
+	auto transaction (node_a.store.tx_begin_write ());
+	for (auto i (0u); i < count_a; ++i)
+	{
+		auto send = nano::send_block_builder ()
+					.previous (result.back ())
+					.destination (nano::keypair ().pub)
+					.balance (nano::dev::genesis_amount - i - 1)
+					.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+					.work (*system_a.work.generate (result.back ()))
+					.build_shared ();
+		EXPECT_EQ (nano::process_result::progress, node_a.ledger.process (transaction, *send).code);
+		result.push_back (send->hash ());
+	}
+	return result;
+}
+}
+
+TEST (block_prefetcher, chain)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto chain (genesis_chain (system, node, 5));
+	nano::block_prefetcher prefetcher (node.ledger, 1);
+	nano::mutex mutex;
+	std::vector<nano::block_hash> visited;
+	auto visitor = [&mutex, &visited] (std::shared_ptr<nano::block> const & block_a) {
+		nano::lock_guard<nano::mutex> guard (mutex);
+		visited.push_back (block_a->hash ());
+		return true;
+	};
+	auto visited_count = [&mutex, &visited] () {
+		nano::lock_guard<nano::mutex> guard (mutex);
+		return visited.size ();
+	};
+	// Reading backwards stops at the open block even if more blocks were asked for
+	prefetcher.chain (chain.back (), chain.size () + 10, nano::block_prefetcher::direction::previous, false, visitor);
+	ASSERT_TIMELY (5s, visited_count () == chain.size ());
+	ASSERT_TRUE (std::equal (chain.rbegin (), chain.rend (), visited.begin ()));
+
+	// Reading forwards stops after the requested number of blocks
+	{
+		nano::lock_guard<nano::mutex> guard (mutex);
+		visited.clear ();
+	}
+	prefetcher.chain (chain.front (), 3, nano::block_prefetcher::direction::successor, true, visitor);
+	ASSERT_TIMELY (5s, visited_count () == 3);
+	ASSERT_TRUE (std::equal (visited.begin (), visited.end (), chain.begin ()));
+}
+
+TEST (block_prefetcher, cancel)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto chain (genesis_chain (system, node, 5));
+	nano::block_prefetcher prefetcher (node.ledger, 1);
+	std::promise<void> release;
+	auto released (release.get_future ().share ());
+	std::atomic<unsigned> visited{ 0 };
+	prefetcher.chain (chain.back (), chain.size (), nano::block_prefetcher::direction::previous, false, [&visited, released] (std::shared_ptr<nano::block> const &) {
+		if (++visited == 1)
+		{
+			released.wait ();
+		}
+		return true;
+	});
+	// Queued behind the blocked prefetch on the single thread
+	std::atomic<unsigned> queued_visited{ 0 };
+	prefetcher.chain (chain.back (), chain.size (), nano::block_prefetcher::direction::previous, false, [&queued_visited] (std::shared_ptr<nano::block> const &) {
+		++queued_visited;
+		return true;
+	});
+	ASSERT_TIMELY (5s, visited == 1);
+	prefetcher.cancel ();
+	release.set_value ();
+	// Prefetches made after cancelling still run, once this one is done the earlier ones are as well
+	std::atomic<bool> later{ false };
+	prefetcher.chain (chain.back (), 1, nano::block_prefetcher::direction::previous, false, [&later] (std::shared_ptr<nano::block> const &) {
+		later = true;
+		return true;
+	});
+	ASSERT_TIMELY (5s, later);
+	ASSERT_EQ (1, visited);
+	ASSERT_EQ (0, queued_visited);
+}
+
+TEST (block_prefetcher, stop)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto chain (genesis_chain (system, node, 1));
+	nano::block_prefetcher prefetcher (node.ledger, 1);
+	prefetcher.stop ();
+	std::atomic<unsigned> visited{ 0 };
+	prefetcher.chain (chain.back (), chain.size (), nano::block_prefetcher::direction::previous, true, [&visited] (std::shared_ptr<nano::block> const &) {
+		++visited;
+		return true;
+	});
+	std::this_thread::sleep_for (100ms);
+	ASSERT_EQ (0, visited);
+
+	// Without threads nothing is read either
+	nano::block_prefetcher disabled (node.ledger, 0);
+	disabled.chain (chain.back (), chain.size (), nano::block_prefetcher::direction::previous, true, [&visited] (std::shared_ptr<nano::block> const &) {
+		++visited;
+		return true;
+	});
+	std::this_thread::sleep_for (100ms);
+	ASSERT_EQ (0, visited);
+}
+
+// Stopping joins the threads without holding the lock a running prefetch needs to queue source reads
+TEST (block_prefetcher, stop_while_reading_sources)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto chain (genesis_chain (system, node, 20));
+	nano::block_prefetcher prefetcher (node.ledger, 2, 1024);
+	std::atomic<unsigned> visited{ 0 };
+	for (auto i (0); i < 100; ++i)
+	{
+		// Reading back to the genesis open block queues a read of its source
+		prefetcher.chain (chain.back (), chain.size (), nano::block_prefetcher::direction::previous, true, [&visited] (std::shared_ptr<nano::block> const &) {
+			++visited;
+			return true;
+		});
+	}
+	ASSERT_TIMELY (5s, visited > 0);
+	auto stopped (std::async (std::launch::async, [&prefetcher] () {
+		prefetcher.stop ();
+	}));
+	ASSERT_EQ (std::future_status::ready, stopped.wait_for (5s));
+}
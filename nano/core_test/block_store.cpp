@@ -29,6 +29,8 @@ void modify_confirmation_height_to_v15 (nano::mdb_store & store, nano::transacti
 void write_sideband_v14 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a, MDB_dbi db_a);
 void write_sideband_v15 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a);
 void write_block_w_sideband_v18 (nano::mdb_store & store_a, MDB_dbi database, nano::write_transaction & transaction_a, nano::block const & block_a);
+void fill_compactor_source (nano::mdb_store & store_a);
+std::vector<std::pair<std::string, std::string>> mdb_table_contents (MDB_env * env_a, std::string const & table_a);
 }
 
 TEST (block_store, construction)
@@ -2056,6 +2058,127 @@ TEST (rocksdb_block_store, tombstone_count)
 }
 }
 
+// Untracked writes are visible inside their transaction and applied on commit
+TEST (rocksdb_block_store, untracked_writes)
+{
+	if (nano::rocksdb_config::using_rocksdb_in_tests ())
+	{
+		nano::logger_mt logger;
+		auto store = std::make_unique<nano::rocksdb_store> (logger, nano::unique_path ());
+		ASSERT_TRUE (!store->init_error ());
+		store->set_untracked_writes (true);
+		nano::account account1 (1);
+		nano::account account2 (2);
+		{
+			auto transaction (store->tx_begin_write ());
+			store->account.put (transaction, account1, nano::account_info{});
+			store->account.put (transaction, account2, nano::account_info{});
+			ASSERT_TRUE (store->account.exists (transaction, account1));
+			store->account.del (transaction, account2);
+			ASSERT_FALSE (store->account.exists (transaction, account2));
+		}
+		auto transaction (store->tx_begin_read ());
+		ASSERT_TRUE (store->account.exists (transaction, account1));
+		ASSERT_FALSE (store->account.exists (transaction, account2));
+	}
+}
+
+TEST (mdb_compactor, copy)
+{
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, nano::unique_path ());
+	ASSERT_FALSE (store.init_error ());
+	fill_compactor_source (store);
+	auto destination (nano::unique_path ());
+	nano::mdb_compactor compactor (store.env, destination, 4, 4 * 1024);
+	std::vector<std::string> completed;
+	ASSERT_FALSE (compactor.run ([&completed] (nano::mdb_compactor::table_progress const & progress_a) {
+		if (progress_a.done)
+		{
+			completed.push_back (progress_a.name);
+		}
+	}));
+	ASSERT_EQ (compactor.tables ().size (), completed.size ());
+	auto error (false);
+	nano::mdb_env copy (error, destination);
+	ASSERT_FALSE (error);
+	for (auto const & table : compactor.tables ())
+	{
+		ASSERT_TRUE (table.done);
+		ASSERT_EQ (table.total, table.entries);
+		ASSERT_EQ (0, table.resumed);
+		ASSERT_EQ (mdb_table_contents (store.env, table.name), mdb_table_contents (copy, table.name));
+	}
+	ASSERT_TRUE (mdb_table_contents (copy, nano::mdb_compactor::progress_table).empty ());
+}
+
+// An interrupted copy continues from its last checkpoint, including in the middle of the duplicates of a key
+TEST (mdb_compactor, resume)
+{
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, nano::unique_path ());
+	ASSERT_FALSE (store.init_error ());
+	fill_compactor_source (store);
+	auto destination (nano::unique_path ());
+	{
+		nano::mdb_compactor compactor (store.env, destination, 2, 4 * 1024);
+		ASSERT_TRUE (compactor.run ([&compactor] (nano::mdb_compactor::table_progress const & progress_a) {
+			if (progress_a.name == "compactor_dup" && !progress_a.done)
+			{
+				compactor.stop ();
+			}
+		}));
+	}
+	nano::mdb_compactor compactor (store.env, destination, 2, 4 * 1024);
+	ASSERT_FALSE (compactor.run ());
+	auto error (false);
+	nano::mdb_env copy (error, destination);
+	ASSERT_FALSE (error);
+	for (auto const & table : compactor.tables ())
+	{
+		ASSERT_EQ (table.total, table.entries);
+		ASSERT_EQ (mdb_table_contents (store.env, table.name), mdb_table_contents (copy, table.name));
+		if (table.name == "compactor_dup")
+		{
+			ASSERT_GT (table.resumed, 0);
+			ASSERT_LT (table.resumed, table.total);
+		}
+	}
+}
+
+// Checkpoints made before the source was written to are discarded
+TEST (mdb_compactor, resume_modified_source)
+{
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, nano::unique_path ());
+	ASSERT_FALSE (store.init_error ());
+	fill_compactor_source (store);
+	auto destination (nano::unique_path ());
+	{
+		nano::mdb_compactor compactor (store.env, destination, 2, 4 * 1024);
+		ASSERT_TRUE (compactor.run ([&compactor] (nano::mdb_compactor::table_progress const & progress_a) {
+			if (progress_a.entries > 0)
+			{
+				compactor.stop ();
+			}
+		}));
+	}
+	{
+		auto transaction (store.tx_begin_write ());
+		ASSERT_EQ (0, mdb_put (store.env.tx (transaction), store.confirmation_height_handle, nano::mdb_val (nano::account (0)), nano::mdb_val (nano::uint256_union (0)), 0));
+	}
+	nano::mdb_compactor compactor (store.env, destination, 2, 4 * 1024);
+	ASSERT_FALSE (compactor.run ());
+	auto error (false);
+	nano::mdb_env copy (error, destination);
+	ASSERT_FALSE (error);
+	for (auto const & table : compactor.tables ())
+	{
+		ASSERT_EQ (0, table.resumed);
+		ASSERT_EQ (mdb_table_contents (store.env, table.name), mdb_table_contents (copy, table.name));
+	}
+}
+
 namespace
 {
 void write_sideband_v14 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a, MDB_dbi db_a)
@@ -2127,4 +2250,46 @@ void modify_confirmation_height_to_v15 (nano::mdb_store & store, nano::transacti
 	auto status (mdb_put (store.env.tx (transaction), store.confirmation_height_handle, nano::mdb_val (account), nano::mdb_val (confirmation_height), 0));
 	ASSERT_EQ (status, 0);
 }
+
+void fill_compactor_source (nano::mdb_store & store_a)
+{
+	auto transaction (store_a.tx_begin_write ());
+	for (auto i (0); i < 1000; ++i)
+	{
+		nano::account account;
+		nano::random_pool::generate_block (account.bytes.data (), account.bytes.size ());
+		ASSERT_EQ (0, mdb_put (store_a.env.tx (transaction), store_a.confirmation_height_handle, nano::mdb_val (account), nano::mdb_val (nano::uint256_union (i)), 0));
+	}
+	MDB_dbi dup_handle;
+	ASSERT_EQ (0, mdb_dbi_open (store_a.env.tx (transaction), "compactor_dup", MDB_CREATE | MDB_DUPSORT, &dup_handle));
+	for (auto i (0); i < 100; ++i)
+	{
+		for (auto j (0); j < 20; ++j)
+		{
+			ASSERT_EQ (0, mdb_put (store_a.env.tx (transaction), dup_handle, nano::mdb_val (nano::uint256_union (i)), nano::mdb_val (nano::uint256_union (j * 7 % 20)), 0));
+		}
+	}
+}
+
+std::vector<std::pair<std::string, std::string>> mdb_table_contents (MDB_env * env_a, std::string const & table_a)
+{
+	std::vector<std::pair<std::string, std::string>> result;
+	MDB_txn * transaction;
+	release_assert (mdb_txn_begin (env_a, nullptr, MDB_RDONLY, &transaction) == 0);
+	MDB_dbi handle;
+	if (mdb_dbi_open (transaction, table_a.c_str (), 0, &handle) == 0)
+	{
+		MDB_cursor * cursor;
+		release_assert (mdb_cursor_open (transaction, handle, &cursor) == 0);
+		MDB_val key;
+		MDB_val value;
+		for (auto status (mdb_cursor_get (cursor, &key, &value, MDB_FIRST)); status == 0; status = mdb_cursor_get (cursor, &key, &value, MDB_NEXT))
+		{
+			result.emplace_back (std::string (static_cast<char const *> (key.mv_data), key.mv_size), std::string (static_cast<char const *> (value.mv_data), value.mv_size));
+		}
+		mdb_cursor_close (cursor);
+	}
+	mdb_txn_abort (transaction);
+	return result;
+}
 }
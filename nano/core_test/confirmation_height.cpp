@@ -1451,3 +1451,44 @@ TEST (confirmation_height, pruned_source)
 	[] (auto const &) {}, [] () { return 0; });
 	bounded_processor.process (open2);
 }
+
+// Cementing time is recorded for each cemented block, including blocks below the one added to the processor
+TEST (confirmation_height, cement_latency_per_block)
+{
+	auto test_mode = [] (nano::confirmation_height_mode mode_a) {
+		nano::system system;
+		nano::node_flags node_flags;
+		node_flags.confirmation_height_processor_mode = mode_a;
+		nano::node_config node_config (nano::get_available_port (), system.logging);
+		node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+		auto node = system.add_node (node_config, node_flags);
+		nano::keypair key1;
+		auto latest (nano::dev::genesis->hash ());
+		std::shared_ptr<nano::block> send;
+		{
+			auto transaction = node->store.tx_begin_write ();
+			for (auto i (1); i <= 3; ++i)
+			{
+				send = std::make_shared<nano::send_block> (latest, key1.pub, nano::dev::genesis_amount - i * nano::Gxrb_ratio, nano::dev::genesis_key.prv, nano::dev::genesis_key.pub, *system.work.generate (latest));
+				ASSERT_EQ (nano::process_result::progress, node->ledger.process (transaction, *send).code);
+				latest = send->hash ();
+			}
+		}
+		node->confirmation_height_processor.add (send);
+		auto histogram (node->stats.get_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in));
+		ASSERT_NE (nullptr, histogram);
+		auto count = [histogram] () {
+			uint64_t result (0);
+			for (auto const & bin : histogram->get_bins ())
+			{
+				result += bin.value;
+			}
+			return result;
+		};
+		ASSERT_TIMELY (10s, count () == 3);
+		ASSERT_EQ (4, node->ledger.cache.cemented_count);
+	};
+
+	test_mode (nano::confirmation_height_mode::bounded);
+	test_mode (nano::confirmation_height_mode::unbounded);
+}
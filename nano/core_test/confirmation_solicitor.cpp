@@ -1,5 +1,6 @@
 #include <nano/lib/jsonconfig.hpp>
 #include <nano/node/confirmation_solicitor.hpp>
+#include <nano/node/rep_tracker.hpp>
 #include <nano/test_common/system.hpp>
 #include <nano/test_common/testutil.hpp>
 
@@ -134,3 +135,92 @@ TEST (confirmation_solicitor, bypass_max_requests_cap)
 	ASSERT_EQ (2 * max_representatives + 1, node2.stats.count (nano::stat::type::message, nano::stat::detail::confirm_req, nano::stat::dir::out));
 }
 }
+
+TEST (rep_tracker, round_trip)
+{
+	nano::rep_tracker tracker;
+	nano::keypair key;
+	ASSERT_EQ (nano::rep_tracker::default_rtt, tracker.stats (key.pub).rtt);
+	tracker.requested (key.pub, 1);
+	std::this_thread::sleep_for (50ms);
+	tracker.vote (nano::vote (key.pub, key.prv, 0, std::vector<nano::block_hash>{ 1 }));
+	auto stats (tracker.stats (key.pub));
+	ASSERT_EQ (1, stats.samples);
+	ASSERT_LT (stats.rtt, nano::rep_tracker::default_rtt);
+	ASSERT_EQ (1.0, stats.reply_ratio);
+	ASSERT_EQ (0.0, stats.unsolicited_ratio);
+	ASSERT_FALSE (stats.votes_unsolicited ());
+	// The request was answered, another vote for the same hash was not requested
+	tracker.vote (nano::vote (key.pub, key.prv, 0, std::vector<nano::block_hash>{ 1 }));
+	ASSERT_GT (tracker.stats (key.pub).unsolicited_ratio, 0.0);
+}
+
+TEST (rep_tracker, unsolicited)
+{
+	nano::rep_tracker tracker;
+	nano::keypair key;
+	tracker.requested (key.pub, 1000);
+	for (auto i (0); i < 64; ++i)
+	{
+		tracker.vote (nano::vote (key.pub, key.prv, 0, std::vector<nano::block_hash>{ nano::block_hash (i) }));
+	}
+	auto stats (tracker.stats (key.pub));
+	ASSERT_EQ (64, stats.samples);
+	ASSERT_TRUE (stats.votes_unsolicited ());
+	ASSERT_EQ (1, tracker.size ());
+}
+
+// Only requested representatives are tracked, the one requested least recently makes room for a new one
+TEST (rep_tracker, bounded)
+{
+	nano::rep_tracker tracker;
+	nano::keypair key;
+	tracker.vote (nano::vote (key.pub, key.prv, 0, std::vector<nano::block_hash>{ 1 }));
+	ASSERT_EQ (0, tracker.size ());
+	ASSERT_EQ (0, tracker.stats (key.pub).samples);
+
+	tracker.requested (0, 1);
+	std::this_thread::sleep_for (10ms);
+	for (std::size_t i (1); i < nano::rep_tracker::max_reps; ++i)
+	{
+		tracker.requested (i, 1);
+	}
+	ASSERT_EQ (nano::rep_tracker::max_reps, tracker.size ());
+	tracker.requested (key.pub, 1);
+	ASSERT_EQ (nano::rep_tracker::max_reps, tracker.size ());
+	auto stats (tracker.stats (std::vector<nano::account>{ 0, 1, key.pub }));
+	ASSERT_EQ (0, stats.count (0));
+	ASSERT_EQ (1, stats.count (1));
+	ASSERT_EQ (1, stats.count (key.pub));
+}
+
+// Representatives which reliably vote unprompted are not asked while their vote is expected
+TEST (confirmation_solicitor, skip_unsolicited)
+{
+	nano::system system;
+	nano::node_flags node_flags;
+	node_flags.disable_request_loop = true;
+	node_flags.disable_rep_crawler = true;
+	node_flags.disable_udp = false;
+	auto & node1 = *system.add_node (node_flags);
+	auto & node2 = *system.add_node (node_flags);
+	auto channel1 (node2.network.udp_channels.create (node1.network.endpoint ()));
+	nano::representative representative (nano::dev::genesis_key.pub, nano::dev::genesis_amount, channel1);
+	std::vector<nano::representative> representatives{ representative };
+	node2.rep_crawler.tracker.requested (nano::dev::genesis_key.pub, 1000);
+	for (auto i (0); i < 64; ++i)
+	{
+		node2.rep_crawler.tracker.vote (nano::vote (nano::dev::genesis_key.pub, nano::dev::genesis_key.prv, 0, std::vector<nano::block_hash>{ nano::block_hash (i) }));
+	}
+	ASSERT_TRUE (node2.rep_crawler.tracker.stats (nano::dev::genesis_key.pub).votes_unsolicited ());
+	nano::confirmation_solicitor solicitor (node2.network, node2.config);
+	solicitor.prepare (representatives);
+	ASSERT_TIMELY (3s, node2.network.size () == 1);
+	auto send (std::make_shared<nano::send_block> (nano::dev::genesis->hash (), nano::keypair ().pub, nano::dev::genesis_amount - 100, nano::dev::genesis_key.prv, nano::dev::genesis_key.pub, *system.work.generate (nano::dev::genesis->hash ())));
+	send->sideband_set ({});
+	auto election (std::make_shared<nano::election> (node2, send, nullptr, nullptr, nano::election_behavior::normal));
+	ASSERT_TRUE (solicitor.add (*election));
+	solicitor.flush ();
+	ASSERT_EQ (1, node2.stats.count (nano::stat::type::requests, nano::stat::detail::requests_skipped_unsolicited, nano::stat::dir::out));
+	ASSERT_EQ (0, node2.stats.count (nano::stat::type::message, nano::stat::detail::confirm_req, nano::stat::dir::out));
+}
@@ -50,6 +50,54 @@ TEST (election_scheduler, activate_one_flush)
 	ASSERT_NE (nullptr, system.nodes[0]->active.election (send1->qualified_root ()));
 }
 
+// Accounts are activated together, duplicates and accounts with nothing to activate are skipped
+TEST (election_scheduler, activate_batch)
+{
+	nano::system system{ 1 };
+	auto & node = *system.nodes[0];
+	nano::keypair key1;
+	nano::state_block_builder builder;
+	auto send1 = builder.make_block ()
+				 .account (nano::dev::genesis_key.pub)
+				 .previous (nano::dev::genesis->hash ())
+				 .representative (nano::dev::genesis_key.pub)
+				 .balance (nano::dev::genesis_amount - nano::Gxrb_ratio)
+				 .link (key1.pub)
+				 .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				 .work (*system.work.generate (nano::dev::genesis->hash ()))
+				 .build_shared ();
+	auto send2 = builder.make_block ()
+				 .account (nano::dev::genesis_key.pub)
+				 .previous (send1->hash ())
+				 .representative (nano::dev::genesis_key.pub)
+				 .balance (nano::dev::genesis_amount - 2 * nano::Gxrb_ratio)
+				 .link (nano::dev::genesis_key.pub)
+				 .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				 .work (*system.work.generate (send1->hash ()))
+				 .build_shared ();
+	auto open1 = builder.make_block ()
+				 .account (key1.pub)
+				 .previous (0)
+				 .representative (key1.pub)
+				 .balance (nano::Gxrb_ratio)
+				 .link (send1->hash ())
+				 .sign (key1.prv, key1.pub)
+				 .work (*system.work.generate (key1.pub))
+				 .build_shared ();
+	{
+		auto transaction = node.store.tx_begin_write ();
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *send1).code);
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *send2).code);
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *open1).code);
+		node.store.confirmation_height.put (transaction, nano::dev::genesis_key.pub, nano::confirmation_height_info{ 2, send1->hash () });
+	}
+	node.scheduler.activate (std::vector<nano::account>{ key1.pub, nano::dev::genesis_key.pub, key1.pub, nano::keypair ().pub }, node.store.tx_begin_read ());
+	node.scheduler.flush ();
+	ASSERT_NE (nullptr, node.active.election (send2->qualified_root ()));
+	ASSERT_NE (nullptr, node.active.election (open1->qualified_root ()));
+	ASSERT_EQ (2, node.active.size ());
+}
+
 TEST (election_scheduler, no_vacancy)
 {
 	nano::system system;
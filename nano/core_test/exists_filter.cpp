@@ -0,0 +1,60 @@
+#include <nano/lib/stats.hpp>
+#include <nano/secure/exists_filter.hpp>
+#include <nano/secure/ledger.hpp>
+#include <nano/secure/store.hpp>
+#include <nano/secure/utility.hpp>
+#include <nano/test_common/testutil.hpp>
+
+#include <gtest/gtest.h>
+
+TEST (exists_filter, insert_absent)
+{
+	nano::stat stats;
+	nano::exists_filter filter;
+	nano::block_hash hash1 (1);
+	nano::block_hash hash2 (2);
+	// Never absent while disabled or not ready
+	ASSERT_FALSE (filter.absent (nano::exists_filter::table::blocks, hash1));
+	filter.enable (64 * 1024, stats);
+	ASSERT_EQ (64 * 1024, filter.size_bytes ());
+	filter.insert (nano::exists_filter::table::blocks, hash1);
+	ASSERT_FALSE (filter.absent (nano::exists_filter::table::blocks, hash2));
+	filter.set_ready ();
+	ASSERT_FALSE (filter.absent (nano::exists_filter::table::blocks, hash1));
+	ASSERT_TRUE (filter.absent (nano::exists_filter::table::blocks, hash2));
+	// Tables are independent
+	ASSERT_TRUE (filter.absent (nano::exists_filter::table::accounts, hash1));
+	filter.insert (nano::exists_filter::table::pending, hash1, hash2);
+	ASSERT_FALSE (filter.absent (nano::exists_filter::table::pending, hash1, hash2));
+	ASSERT_TRUE (filter.absent (nano::exists_filter::table::pending, hash2, hash1));
+	ASSERT_EQ (3, stats.count (nano::stat::type::filter, nano::stat::detail::exists_filter_negative));
+}
+
+// Keys already in the store and keys written afterwards are found, missing keys skip the store
+TEST (exists_filter, ledger)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_FALSE (store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	store->initialize (store->tx_begin_write (), ledger.cache);
+	ledger.enable_exists_filter (1024 * 1024);
+	ASSERT_TRUE (store->exists_filter.ready ());
+	ASSERT_TRUE (store->block.exists (store->tx_begin_read (), nano::dev::genesis->hash ()));
+	ASSERT_TRUE (store->account.exists (store->tx_begin_read (), nano::dev::genesis->account ()));
+
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	nano::state_block send1 (nano::dev::genesis->account (), nano::dev::genesis->hash (), nano::dev::genesis->account (), nano::dev::genesis_amount - nano::Gxrb_ratio, key1.pub, nano::dev::genesis_key.prv, nano::dev::genesis_key.pub, *pool.generate (nano::dev::genesis->hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (store->tx_begin_write (), send1).code);
+	auto transaction (store->tx_begin_read ());
+	ASSERT_TRUE (store->block.exists (transaction, send1.hash ()));
+	ASSERT_TRUE (store->pending.exists (transaction, nano::pending_key (key1.pub, send1.hash ())));
+
+	auto negative (stats.count (nano::stat::type::filter, nano::stat::detail::exists_filter_negative));
+	ASSERT_FALSE (store->block.exists (transaction, nano::block_hash (1)));
+	ASSERT_FALSE (store->account.exists (transaction, key1.pub));
+	ASSERT_FALSE (store->pending.exists (transaction, nano::pending_key (key1.pub, nano::block_hash (1))));
+	ASSERT_EQ (negative + 3, stats.count (nano::stat::type::filter, nano::stat::detail::exists_filter_negative));
+}
@@ -1,4 +1,5 @@
 #include <nano/lib/ipc_client.hpp>
+#include <nano/lib/ipc_shm.hpp>
 #include <nano/lib/tomlconfig.hpp>
 #include <nano/node/ipc/ipc_access_config.hpp>
 #include <nano/node/ipc/ipc_server.hpp>
@@ -8,13 +9,21 @@
 
 #include <gtest/gtest.h>
 
+#include <boost/filesystem/operations.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <vector>
 
+#if defined(NANO_IPC_SHM)
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 using namespace std::chrono_literals;
 
 TEST (ipc, asynchronous)
@@ -189,3 +198,290 @@ TEST (ipc, permissions_default_user_order)
 	nano::ipc::access access;
 	ASSERT_TRUE (access.deserialize_toml (toml));
 }
+
+namespace
+{
+/** Records the confirmations sent to it, optionally holding their completion */
+class confirmation_recorder final : public nano::ipc::subscriber
+{
+public:
+	void async_send_message (uint8_t const * data_a, size_t length_a, std::function<void (nano::error const &)> broadcast_completion_handler_a) override
+	{
+		auto event (nanoapi::GetEnvelope (data_a)->message_as_EventConfirmation ());
+		ASSERT_NE (nullptr, event);
+		events.emplace_back ();
+		event->UnPackTo (&events.back ());
+		if (hold)
+		{
+			held.push_back (broadcast_completion_handler_a);
+		}
+		else
+		{
+			broadcast_completion_handler_a (nano::error{});
+		}
+	}
+	uint64_t get_id () const override
+	{
+		return 1;
+	}
+	std::string get_service_name () const override
+	{
+		return {};
+	}
+	void set_service_name (std::string const & service_name_a) override
+	{
+	}
+	nano::ipc::payload_encoding get_active_encoding () const override
+	{
+		return nano::ipc::payload_encoding::flatbuffers;
+	}
+
+	std::vector<nanoapi::EventConfirmationT> events;
+	bool hold{ false };
+	std::vector<std::function<void (nano::error const &)>> held;
+};
+}
+
+TEST (ipc, broker_confirmation)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto broker (std::make_shared<nano::ipc::broker> (node));
+	broker->start ();
+	nano::keypair key;
+	nano::state_block_builder builder;
+	std::shared_ptr<nano::block> send = builder.make_block ()
+										.account (nano::dev::genesis_key.pub)
+										.previous (nano::dev::genesis->hash ())
+										.representative (nano::dev::genesis_key.pub)
+										.balance (nano::dev::genesis_amount - 1)
+										.link (key.pub)
+										.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+										.work (0)
+										.build_shared ();
+	nano::election_status status{ send, 1, 0, std::chrono::milliseconds (100), std::chrono::milliseconds (10), 2, 1, 1, nano::election_status_type::active_confirmed_quorum };
+	auto confirm = [&node, &status] (nano::election_status_type type_a) {
+		status.type = type_a;
+		node.observers.blocks.notify (status, {}, nano::dev::genesis_key.pub, 1, true);
+	};
+
+	// Everything, including the block and election info
+	auto all (std::make_shared<confirmation_recorder> ());
+	broker->subscribe (all, std::make_shared<nanoapi::TopicConfirmationT> ());
+
+	// Only the destination account, without the block
+	auto destination (std::make_shared<confirmation_recorder> ());
+	auto destination_topic (std::make_shared<nanoapi::TopicConfirmationT> ());
+	destination_topic->options = std::make_unique<nanoapi::TopicConfirmationOptionsT> ();
+	destination_topic->options->accounts.push_back (key.pub.to_account ());
+	destination_topic->options->include_block = false;
+	broker->subscribe (destination, destination_topic);
+
+	// Only an invalid account, which never matches
+	auto invalid (std::make_shared<confirmation_recorder> ());
+	auto invalid_topic (std::make_shared<nanoapi::TopicConfirmationT> ());
+	invalid_topic->options = std::make_unique<nanoapi::TopicConfirmationOptionsT> ();
+	invalid_topic->options->accounts.push_back ("invalid");
+	broker->subscribe (invalid, invalid_topic);
+
+	// Only inactive confirmations
+	auto inactive (std::make_shared<confirmation_recorder> ());
+	auto inactive_topic (std::make_shared<nanoapi::TopicConfirmationT> ());
+	inactive_topic->options = std::make_unique<nanoapi::TopicConfirmationOptionsT> ();
+	inactive_topic->options->confirmation_type_filter = nanoapi::TopicConfirmationTypeFilter::TopicConfirmationTypeFilter_inactive;
+	broker->subscribe (inactive, inactive_topic);
+	ASSERT_EQ (4, broker->confirmation_subscriber_count ());
+
+	confirm (nano::election_status_type::active_confirmed_quorum);
+	ASSERT_EQ (1, all->events.size ());
+	auto const & event (all->events.front ());
+	ASSERT_EQ (nanoapi::TopicConfirmationType::TopicConfirmationType_active_quorum, event.confirmation_type);
+	ASSERT_EQ (nano::dev::genesis_key.pub.to_account (), event.account);
+	ASSERT_EQ (send->hash ().to_string (), event.hash);
+	ASSERT_EQ ("1", event.amount);
+	auto state (event.block.AsBlockState ());
+	ASSERT_NE (nullptr, state);
+	ASSERT_EQ (send->hash ().to_string (), state->hash);
+	ASSERT_EQ (key.pub.to_account (), state->link_as_account);
+	ASSERT_EQ (nanoapi::BlockSubType::BlockSubType_send, state->subtype);
+	ASSERT_NE (nullptr, event.election_info);
+	ASSERT_EQ (10, event.election_info->duration);
+	ASSERT_EQ ("1", event.election_info->tally);
+	ASSERT_EQ (1, destination->events.size ());
+	ASSERT_EQ (nanoapi::Block::Block_NONE, destination->events.front ().block.type);
+	ASSERT_NE (nullptr, destination->events.front ().election_info);
+	ASSERT_TRUE (invalid->events.empty ());
+	ASSERT_TRUE (inactive->events.empty ());
+
+	confirm (nano::election_status_type::inactive_confirmation_height);
+	ASSERT_EQ (2, all->events.size ());
+	ASSERT_EQ (nanoapi::TopicConfirmationType::TopicConfirmationType_inactive, all->events.back ().confirmation_type);
+	ASSERT_EQ (1, inactive->events.size ());
+
+	// Confirmations are dropped while too many are outstanding, the session has to complete some first
+	all->hold = true;
+	for (size_t i (0); i < nano::ipc::broker::max_outstanding_confirmations + 1; ++i)
+	{
+		confirm (nano::election_status_type::active_confirmed_quorum);
+	}
+	ASSERT_EQ (2 + nano::ipc::broker::max_outstanding_confirmations, all->events.size ());
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::ipc, nano::stat::detail::confirmation_drop));
+	all->held.front () (nano::error{});
+	confirm (nano::election_status_type::active_confirmed_quorum);
+	ASSERT_EQ (3 + nano::ipc::broker::max_outstanding_confirmations, all->events.size ());
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::ipc, nano::stat::detail::confirmation_drop));
+
+	// Closed sessions are evicted on the next broadcast
+	destination.reset ();
+	confirm (nano::election_status_type::active_confirmed_quorum);
+	ASSERT_EQ (3, broker->confirmation_subscriber_count ());
+}
+
+#if defined(NANO_IPC_SHM)
+TEST (ipc, shm_ring)
+{
+	nano::ipc::shm_channel channel;
+	ASSERT_FALSE (channel.create (1));
+	ASSERT_EQ (nano::ipc::shm_channel::min_capacity, channel.capacity ());
+	auto & ring (channel.requests ());
+	ASSERT_TRUE (ring.empty ());
+	uint8_t const * data;
+	size_t size;
+	ASSERT_TRUE (ring.peek (data, size));
+
+	// Oversized messages are refused
+	std::vector<uint8_t> message (ring.max_message_size () + 1);
+	ASSERT_TRUE (ring.write (message.data (), message.size ()));
+
+	// Message sizes not dividing the capacity make records wrap at varying offsets
+	for (uint8_t i (0); i < 50; ++i)
+	{
+		message.resize (1001 + i);
+		std::fill (message.begin (), message.end (), i);
+		ASSERT_FALSE (ring.write (message.data (), message.size ()));
+		ASSERT_FALSE (ring.peek (data, size));
+		ASSERT_EQ (message.size (), size);
+		ASSERT_TRUE (std::equal (message.begin (), message.end (), data));
+		ring.consume ();
+		ASSERT_TRUE (ring.empty ());
+	}
+
+	// Fill up, then read everything back
+	size_t written (0);
+	while (!ring.write (message.data (), message.size ()))
+	{
+		++written;
+	}
+	ASSERT_GE (written, 2);
+	ASSERT_LE (written * message.size (), channel.capacity ());
+	while (!ring.peek (data, size))
+	{
+		ASSERT_EQ (message.size (), size);
+		ring.consume ();
+		--written;
+	}
+	ASSERT_EQ (0, written);
+
+	// The eventfd is only signalled if the reader armed the notification
+	pollfd event{ channel.request_event (), POLLIN, 0 };
+	ASSERT_FALSE (ring.write (message.data (), message.size ()));
+	ASSERT_EQ (0, ::poll (&event, 1, 0));
+	ASSERT_FALSE (ring.arm_notification ());
+	ASSERT_FALSE (ring.peek (data, size));
+	ring.consume ();
+	ASSERT_TRUE (ring.arm_notification ());
+	ASSERT_FALSE (ring.write (message.data (), message.size ()));
+	ASSERT_EQ (1, ::poll (&event, 1, 0));
+	uint64_t counter;
+	ASSERT_EQ (static_cast<ssize_t> (sizeof (counter)), ::read (channel.request_event (), &counter, sizeof (counter)));
+	ASSERT_EQ (1, counter);
+}
+
+// The node reads requests written by the client, headers which do not describe a record inside the ring must be refused
+TEST (ipc, shm_ring_corrupt)
+{
+	auto capacity (nano::ipc::shm_channel::min_capacity);
+	auto region_size (nano::ipc::shm_ring::region_size (capacity));
+	std::unique_ptr<void, decltype (&std::free)> region (std::aligned_alloc (64, region_size), &std::free);
+	auto & control (*static_cast<nano::ipc::shm_ring::header *> (region.get ()));
+	auto data (static_cast<uint8_t *> (region.get ()) + sizeof (nano::ipc::shm_ring::header));
+	auto corrupt = [&] (uint64_t tail_a, uint32_t length_a, size_t offset_a) {
+		std::memset (region.get (), 0, region_size);
+		std::memcpy (data + offset_a, &length_a, sizeof (length_a));
+		control.tail = tail_a;
+		// The reader starts at the current head, as the node does for a new channel
+		control.head = offset_a;
+		nano::ipc::shm_ring ring (region.get (), capacity, -1);
+		uint8_t const * message;
+		size_t size;
+		return ring.peek (message, size) && ring.corrupt ();
+	};
+	// Bogus length running past the end of the mapping
+	ASSERT_TRUE (corrupt (capacity, 0xfffffff0, 0));
+	// Length running past the end of the ring
+	ASSERT_TRUE (corrupt (capacity + 8, 16, capacity - 8));
+	// Record ending past the published tail
+	ASSERT_TRUE (corrupt (16, 64, 0));
+	// Tail more than one ring ahead of the head
+	ASSERT_TRUE (corrupt (capacity + 16, 8, 0));
+	// Wrap marker at the start of the ring
+	ASSERT_TRUE (corrupt (16, 0xffffffff, 0));
+	// Wrap marker skipping past the tail
+	ASSERT_TRUE (corrupt (64 + 8, 0xffffffff, 64));
+
+	// A valid record is still accepted
+	std::memset (region.get (), 0, region_size);
+	nano::ipc::shm_ring ring (region.get (), capacity, -1);
+	uint32_t length (5);
+	std::memcpy (data, &length, sizeof (length));
+	control.tail = nano::ipc::shm_ring::record_header_size + 8;
+	uint8_t const * message;
+	size_t size;
+	ASSERT_FALSE (ring.peek (message, size));
+	ASSERT_FALSE (ring.corrupt ());
+	ASSERT_EQ (5, size);
+}
+
+TEST (ipc, flatbuffers_shm)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto path ((boost::filesystem::temp_directory_path () / "nano_test_ipc_shm").string ());
+	node.config.ipc_config.transport_domain.enabled = true;
+	node.config.ipc_config.transport_domain.path = path;
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc (node, node_rpc_config);
+
+	nano::ipc::shm_client client;
+	ASSERT_FALSE (client.connect (path, 64 * 1024));
+	auto write = [&client] (auto & message_a) {
+		auto fbb (nano::ipc::flatbuffer_producer::make_buffer (message_a));
+		return client.write (fbb->GetBufferPointer (), fbb->GetSize (), std::chrono::seconds (5));
+	};
+	nanoapi::Message type{ nanoapi::Message::Message_NONE };
+	auto read = [&client, &type] () {
+		return client.read ([&type] (uint8_t const * data_a, size_t size_a) {
+			type = nanoapi::GetEnvelope (data_a)->message_type ();
+		},
+		std::chrono::seconds (5));
+	};
+
+	// Request and response
+	nanoapi::IsAliveT alive;
+	ASSERT_FALSE (write (alive));
+	ASSERT_FALSE (read ());
+	ASSERT_EQ (nanoapi::Message::Message_IsAlive, type);
+
+	// Confirmations are broadcast through the response ring
+	nanoapi::TopicConfirmationT topic;
+	ASSERT_FALSE (write (topic));
+	ASSERT_FALSE (read ());
+	ASSERT_EQ (nanoapi::Message::Message_EventAck, type);
+	system.wallet (0)->insert_adhoc (nano::dev::genesis_key.prv);
+	nano::keypair key;
+	ASSERT_NE (nullptr, system.wallet (0)->send_action (nano::dev::genesis_key.pub, key.pub, node.config.receive_minimum.number ()));
+	ASSERT_FALSE (read ());
+	ASSERT_EQ (nanoapi::Message::Message_EventConfirmation, type);
+	ipc.stop ();
+}
+#endif
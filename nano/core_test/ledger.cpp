@@ -3841,3 +3841,151 @@ TEST (ledger, unconfirmed_frontiers)
 	ASSERT_EQ (uncemented_info1.cemented_frontier, uncemented_info2.cemented_frontier);
 	ASSERT_EQ (uncemented_info1.frontier, uncemented_info2.frontier);
 }
+
+// The uncemented index follows processing, rollback and cementing, and is rebuilt identically from the store
+TEST (ledger, uncemented_index)
+{
+	nano::system system;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	auto & node = *system.add_node (node_config);
+	ASSERT_EQ (0, node.ledger.uncemented.size ());
+	nano::keypair key;
+	nano::state_block_builder builder;
+	auto send = builder.make_block ()
+				.account (nano::dev::genesis->account ())
+				.previous (nano::dev::genesis->hash ())
+				.representative (nano::dev::genesis->account ())
+				.balance (nano::dev::genesis_amount - 100)
+				.link (key.pub)
+				.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				.work (*system.work.generate (nano::dev::genesis->hash ()))
+				.build_shared ();
+	auto open = builder.make_block ()
+				.account (key.pub)
+				.previous (0)
+				.representative (key.pub)
+				.balance (100)
+				.link (send->hash ())
+				.sign (key.prv, key.pub)
+				.work (*system.work.generate (key.pub))
+				.build_shared ();
+	{
+		auto transaction (node.store.tx_begin_write ());
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *send).code);
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *open).code);
+	}
+	auto entries (node.ledger.uncemented.next (0, 10));
+	ASSERT_EQ (2, entries.size ());
+	nano::confirmation_height_info confirmation_height_info;
+	ASSERT_FALSE (node.ledger.uncemented.confirmation_height (nano::dev::genesis->account (), confirmation_height_info));
+	ASSERT_EQ (1, confirmation_height_info.height);
+	ASSERT_EQ (nano::dev::genesis->hash (), confirmation_height_info.frontier);
+	ASSERT_FALSE (node.ledger.uncemented.confirmation_height (key.pub, confirmation_height_info));
+	ASSERT_EQ (0, confirmation_height_info.height);
+	{
+		nano::stat stats;
+		nano::ledger ledger (node.store, stats);
+		auto rebuilt (ledger.uncemented.next (0, 10));
+		ASSERT_EQ (entries.size (), rebuilt.size ());
+		for (std::size_t i (0); i < entries.size (); ++i)
+		{
+			ASSERT_EQ (entries[i].first, rebuilt[i].first);
+			ASSERT_EQ (entries[i].second.head, rebuilt[i].second.head);
+			ASSERT_EQ (entries[i].second.block_count, rebuilt[i].second.block_count);
+			ASSERT_EQ (entries[i].second.cemented_height, rebuilt[i].second.cemented_height);
+		}
+	}
+
+	// Rolling back the open removes the account
+	ASSERT_FALSE (node.ledger.rollback (node.store.tx_begin_write (), open->hash ()));
+	ASSERT_TRUE (node.ledger.uncemented.confirmation_height (key.pub, confirmation_height_info));
+	ASSERT_EQ (1, node.ledger.unconfirmed_frontiers ().size ());
+	ASSERT_EQ (nano::process_result::progress, node.ledger.process (node.store.tx_begin_write (), *open).code);
+	ASSERT_EQ (2, node.ledger.unconfirmed_frontiers ().size ());
+
+	// Cementing the open also cements the send it receives
+	node.confirmation_height_processor.add (open);
+	ASSERT_TIMELY (5s, node.ledger.uncemented.size () == 0);
+	ASSERT_TRUE (node.ledger.unconfirmed_frontiers ().empty ());
+}
+
+// Accounts which do not fit into the uncemented index are left out, which makes it incomplete until nothing is uncemented any more
+TEST (ledger, uncemented_index_bounded)
+{
+	nano::uncemented_index index (2);
+	nano::confirmation_height_info cemented (1, 1);
+	ASSERT_FALSE (index.update (1, 2, 2, cemented));
+	ASSERT_FALSE (index.update (2, 3, 3, cemented));
+	ASSERT_FALSE (index.complete ());
+	index.built ();
+	ASSERT_TRUE (index.complete ());
+	ASSERT_TRUE (index.update (3, 4, 2, cemented));
+	ASSERT_EQ (2, index.size ());
+	ASSERT_FALSE (index.complete ());
+	nano::confirmation_height_info confirmation_height_info;
+	ASSERT_TRUE (index.confirmation_height (3, confirmation_height_info));
+
+	// Accounts which are already tracked are still updated
+	ASSERT_FALSE (index.update (1, 5, 3, cemented));
+	auto entries (index.next (0, 10));
+	ASSERT_EQ (2, entries.size ());
+	ASSERT_EQ (nano::block_hash (5), entries[0].second.head);
+	ASSERT_EQ (3, entries[0].second.block_count);
+
+	// Only an empty index can be complete again
+	index.all_cemented ();
+	ASSERT_FALSE (index.complete ());
+	index.cemented (1, nano::confirmation_height_info (3, 5));
+	index.cemented (2, nano::confirmation_height_info (3, 3));
+	ASSERT_EQ (0, index.size ());
+	index.all_cemented ();
+	ASSERT_TRUE (index.complete ());
+
+	ASSERT_FALSE (index.update (1, 6, 4, cemented));
+	ASSERT_FALSE (index.update (2, 7, 4, cemented));
+	ASSERT_TRUE (index.update (3, 8, 4, cemented));
+	index.built ();
+	ASSERT_FALSE (index.complete ());
+	index.clear ();
+	ASSERT_FALSE (index.complete ());
+	index.built ();
+	ASSERT_TRUE (index.complete ());
+
+	// Confirmation heights written to the store directly are not seen by the index
+	index.invalidate ();
+	ASSERT_FALSE (index.complete ());
+}
+
+// An index which has not been built is incomplete, the tables are read instead
+TEST (ledger, uncemented_index_not_built)
+{
+	nano::system system;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	auto & node = *system.add_node (node_config);
+	ASSERT_TRUE (node.ledger.uncemented.complete ());
+	nano::keypair key;
+	auto send = nano::state_block_builder ()
+				.account (nano::dev::genesis->account ())
+				.previous (nano::dev::genesis->hash ())
+				.representative (nano::dev::genesis->account ())
+				.balance (nano::dev::genesis_amount - 100)
+				.link (key.pub)
+				.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				.work (*system.work.generate (nano::dev::genesis->hash ()))
+				.build_shared ();
+	ASSERT_EQ (nano::process_result::progress, node.ledger.process (node.store.tx_begin_write (), *send).code);
+	nano::stat stats;
+	nano::generate_cache generate_cache;
+	generate_cache.uncemented = false;
+	nano::ledger ledger (node.store, stats, generate_cache);
+	ASSERT_FALSE (ledger.uncemented.complete ());
+	ASSERT_EQ (0, ledger.uncemented.size ());
+	auto unconfirmed_frontiers (ledger.unconfirmed_frontiers ());
+	ASSERT_EQ (1, unconfirmed_frontiers.size ());
+	ASSERT_EQ (send->hash (), unconfirmed_frontiers.begin ()->second.frontier);
+	ledger.rebuild_uncemented ();
+	ASSERT_TRUE (ledger.uncemented.complete ());
+	ASSERT_EQ (1, ledger.uncemented.size ());
+}
@@ -0,0 +1,129 @@
+#include <nano/lib/stats.hpp>
+#include <nano/node/ledger_snapshot.hpp>
+#include <nano/secure/ledger.hpp>
+#include <nano/secure/store.hpp>
+#include <nano/secure/utility.hpp>
+#include <nano/test_common/testutil.hpp>
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem/fstream.hpp>
+
+namespace
+{
+class snapshot_ledger_context
+{
+public:
+	snapshot_ledger_context () :
+		store (nano::make_store (logger, nano::unique_path ())),
+		ledger (*store, stats)
+	{
+		store->initialize (store->tx_begin_write (), ledger.cache);
+	}
+	nano::logger_mt logger;
+	std::unique_ptr<nano::store> store;
+	nano::stat stats;
+	nano::ledger ledger;
+};
+}
+
+// Only cemented blocks are exported, receivables consumed by uncemented receives are restored
+TEST (ledger_snapshot, export_import_cemented)
+{
+	snapshot_ledger_context source;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	nano::state_block send1 (nano::dev::genesis->account (), nano::dev::genesis->hash (), nano::dev::genesis->account (), nano::dev::genesis_amount - nano::Gxrb_ratio, key1.pub, nano::dev::genesis_key.prv, nano::dev::genesis_key.pub, *pool.generate (nano::dev::genesis->hash ()));
+	nano::state_block send2 (nano::dev::genesis->account (), send1.hash (), nano::dev::genesis->account (), nano::dev::genesis_amount - 2 * nano::Gxrb_ratio, key1.pub, nano::dev::genesis_key.prv, nano::dev::genesis_key.pub, *pool.generate (send1.hash ()));
+	nano::state_block open1 (key1.pub, 0, key1.pub, nano::Gxrb_ratio, send1.hash (), key1.prv, key1.pub, *pool.generate (key1.pub));
+	{
+		auto transaction (source.store->tx_begin_write ());
+		ASSERT_EQ (nano::process_result::progress, source.ledger.process (transaction, send1).code);
+		ASSERT_EQ (nano::process_result::progress, source.ledger.process (transaction, send2).code);
+		ASSERT_EQ (nano::process_result::progress, source.ledger.process (transaction, open1).code);
+		source.store->confirmation_height.put (transaction, nano::dev::genesis->account (), { 2, send1.hash () });
+	}
+
+	auto path (nano::unique_path ());
+	nano::ledger_snapshot snapshot (path, 1);
+	ASSERT_FALSE (snapshot.export_ledger (source.ledger));
+	ASSERT_FALSE (snapshot.chunks ().empty ());
+
+	nano::logger_mt logger;
+	auto store (nano::make_store (logger, nano::unique_path ()));
+	ASSERT_FALSE (store->init_error ());
+	nano::ledger_snapshot imported (path);
+	ASSERT_FALSE (imported.import_ledger (*store));
+	auto transaction (store->tx_begin_read ());
+	ASSERT_EQ (2, store->block.count (transaction));
+	auto block (store->block.get (transaction, send1.hash ()));
+	ASSERT_NE (nullptr, block);
+	ASSERT_TRUE (block->sideband ().successor.is_zero ());
+	ASSERT_FALSE (store->block.exists (transaction, send2.hash ()));
+	ASSERT_FALSE (store->block.exists (transaction, open1.hash ()));
+	nano::account_info info;
+	ASSERT_FALSE (store->account.get (transaction, nano::dev::genesis->account (), info));
+	ASSERT_EQ (send1.hash (), info.head);
+	ASSERT_EQ (2, info.block_count);
+	ASSERT_EQ (nano::dev::genesis_amount - nano::Gxrb_ratio, info.balance.number ());
+	ASSERT_FALSE (store->account.exists (transaction, key1.pub));
+	nano::pending_info pending;
+	ASSERT_FALSE (store->pending.get (transaction, nano::pending_key (key1.pub, send1.hash ()), pending));
+	ASSERT_EQ (nano::Gxrb_ratio, pending.amount.number ());
+	ASSERT_EQ (nano::dev::genesis->account (), pending.source);
+	ASSERT_FALSE (store->pending.exists (transaction, nano::pending_key (key1.pub, send2.hash ())));
+}
+
+// A store holding only genesis is replaced by the snapshot, a store with more of a ledger is refused
+TEST (ledger_snapshot, import_initialized)
+{
+	snapshot_ledger_context source;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	nano::send_block send1 (nano::dev::genesis->hash (), key1.pub, nano::dev::genesis_amount - nano::Gxrb_ratio, nano::dev::genesis_key.prv, nano::dev::genesis_key.pub, *pool.generate (nano::dev::genesis->hash ()));
+	{
+		auto transaction (source.store->tx_begin_write ());
+		ASSERT_EQ (nano::process_result::progress, source.ledger.process (transaction, send1).code);
+		source.store->confirmation_height.put (transaction, nano::dev::genesis->account (), { 2, send1.hash () });
+	}
+	auto path (nano::unique_path ());
+	nano::ledger_snapshot snapshot (path);
+	ASSERT_FALSE (snapshot.export_ledger (source.ledger));
+
+	snapshot_ledger_context destination;
+	nano::ledger_snapshot imported (path);
+	ASSERT_FALSE (imported.import_ledger (*destination.store));
+	{
+		auto transaction (destination.store->tx_begin_read ());
+		ASSERT_EQ (nano::dev::genesis->account (), destination.store->frontier.get (transaction, send1.hash ()));
+		ASSERT_TRUE (destination.store->frontier.get (transaction, nano::dev::genesis->hash ()).is_zero ());
+	}
+
+	nano::ledger_snapshot refused (path);
+	ASSERT_TRUE (refused.import_ledger (*source.store));
+	ASSERT_FALSE (refused.error_message ().empty ());
+}
+
+TEST (ledger_snapshot, corrupt_chunk)
+{
+	snapshot_ledger_context source;
+	auto path (nano::unique_path ());
+	nano::ledger_snapshot snapshot (path);
+	ASSERT_FALSE (snapshot.export_ledger (source.ledger));
+	ASSERT_FALSE (snapshot.verify ());
+	{
+		boost::filesystem::fstream stream (path / snapshot.chunks ().front ().file, std::ios::binary | std::ios::in | std::ios::out);
+		char byte;
+		stream.read (&byte, 1);
+		byte = ~byte;
+		stream.seekp (0);
+		stream.write (&byte, 1);
+	}
+	nano::logger_mt logger;
+	auto store (nano::make_store (logger, nano::unique_path ()));
+	ASSERT_FALSE (store->init_error ());
+	nano::ledger_snapshot imported (path);
+	ASSERT_TRUE (imported.import_ledger (*store));
+	ASSERT_FALSE (imported.error_message ().empty ());
+	ASSERT_EQ (0, store->block.count (store->tx_begin_read ()));
+}
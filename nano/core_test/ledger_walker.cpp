@@ -222,4 +222,48 @@ TEST (ledger_walker, ladder_geometry)
 	EXPECT_EQ (amounts_expected_itr, amounts_expected_backwards.crend ());
 }
 
+// A tiny in-memory budget forces the walked blocks and the walk order to spill to disk without changing the result
+TEST (ledger_walker, in_memory_budget)
+{
+	nano::system system{};
+	const auto node = system.add_node ();
+
+	nano::keypair key{};
+	system.wallet (0)->insert_adhoc (nano::dev::genesis_key.prv);
+	std::shared_ptr<nano::block> last_send;
+	for (auto itr = 0; itr != 8; ++itr)
+	{
+		last_send = system.wallet (0)->send_action (nano::dev::genesis_key.pub, key.pub, 1);
+		ASSERT_TRUE (last_send);
+	}
+
+	const auto walk_hashes = [&node, &last_send] (std::size_t in_memory_block_count, bool backward) {
+		std::vector<nano::block_hash> hashes;
+		nano::ledger_walker ledger_walker{ node->ledger, in_memory_block_count };
+		const auto visitor = [&] (const auto & block) {
+			hashes.push_back (block->hash ());
+		};
+		if (backward)
+		{
+			ledger_walker.walk_backward (last_send->hash (), visitor);
+		}
+		else
+		{
+			ledger_walker.walk (last_send->hash (), visitor);
+		}
+		return hashes;
+	};
+
+	const auto expected_backward = walk_hashes (nano::ledger_walker::default_in_memory_block_count, true);
+	ASSERT_EQ (9, expected_backward.size ());
+	EXPECT_EQ (last_send->hash (), expected_backward.front ());
+	EXPECT_EQ (nano::dev::genesis->hash (), expected_backward.back ());
+	EXPECT_EQ (expected_backward, walk_hashes (2, true));
+	EXPECT_EQ (expected_backward, walk_hashes (0, true));
+
+	const auto expected_forward = walk_hashes (nano::ledger_walker::default_in_memory_block_count, false);
+	EXPECT_EQ (std::vector<nano::block_hash> (expected_backward.rbegin (), expected_backward.rend ()), expected_forward);
+	EXPECT_EQ (expected_forward, walk_hashes (2, false));
+}
+
 #endif // _WIN32 -- TODO: keep this until diskhash builds fine on Windows
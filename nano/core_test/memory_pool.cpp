@@ -1,5 +1,6 @@
 #include <nano/lib/memory.hpp>
 #include <nano/node/active_transactions.hpp>
+#include <nano/node/common.hpp>
 #include <nano/secure/common.hpp>
 
 #include <gtest/gtest.h>
@@ -86,15 +87,18 @@ TEST (memory_pool, validate_cleanup)
 	ASSERT_EQ (nano::determine_shared_ptr_pool_size<nano::change_block> (), get_allocated_size<nano::change_block> () - sizeof (size_t));
 	ASSERT_EQ (nano::determine_shared_ptr_pool_size<nano::state_block> (), get_allocated_size<nano::state_block> () - sizeof (size_t));
 	ASSERT_EQ (nano::determine_shared_ptr_pool_size<nano::vote> (), get_allocated_size<nano::vote> () - sizeof (size_t));
+}
 
+TEST (memory_pool, validate_message_cleanup)
+{
+	if (!nano::get_use_memory_pools ())
 	{
-		nano::active_transactions::ordered_cache inactive_votes_cache;
-		nano::account representative{ 1 };
-		nano::block_hash hash{ 1 };
-		uint64_t timestamp{ 1 };
-		nano::inactive_cache_status default_status{};
-		inactive_votes_cache.emplace (std::chrono::steady_clock::now (), hash, representative, timestamp, default_status);
+		return;
 	}
 
-	ASSERT_TRUE (nano::purge_singleton_inactive_votes_cache_pool_memory ());
+	nano::make_shared<nano::keepalive> ();
+	nano::make_shared<nano::publish> (nano::dev::genesis);
+
+	ASSERT_TRUE (nano::purge_shared_ptr_singleton_pool_memory<nano::keepalive> ());
+	ASSERT_TRUE (nano::purge_shared_ptr_singleton_pool_memory<nano::publish> ());
 }
@@ -1046,6 +1046,76 @@ TEST (network, bandwidth_limiter)
 	node.stop ();
 }
 
+// The test must be completed in less than 1 second
+TEST (network, bandwidth_limiter_peer_share)
+{
+	nano::system system;
+	nano::genesis genesis;
+	nano::publish message (genesis.open);
+	auto message_size = message.to_bytes ()->size ();
+	auto message_limit = 4;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.bandwidth_limit = message_limit * message_size;
+	node_config.bandwidth_limit_burst_ratio = 1.0;
+	node_config.bandwidth_limit_peer_share = 0.5;
+	auto & node = *system.add_node (node_config);
+	auto channel1 (node.network.udp_channels.create (node.network.endpoint ()));
+	auto channel2 (node.network.udp_channels.create (node.network.endpoint ()));
+	// The first channel exhausts its share without consuming the share of the second
+	for (auto i = 0; i < message_limit; ++i)
+	{
+		channel1->send (message);
+	}
+	ASSERT_TIMELY (1s, 2 == node.stats.count (nano::stat::type::drop, nano::stat::detail::publish, nano::stat::dir::out));
+	channel2->send (message);
+	channel2->send (message);
+	ASSERT_TIMELY (1s, 2 == node.stats.count (nano::stat::type::drop, nano::stat::detail::publish, nano::stat::dir::out));
+
+	auto const & bandwidth1 (channel1->get_bandwidth ().get (nano::message_type::publish));
+	ASSERT_EQ (2, bandwidth1.messages);
+	ASSERT_EQ (2 * message_size, bandwidth1.bytes);
+	ASSERT_EQ (2, bandwidth1.dropped_messages);
+	ASSERT_EQ (2 * message_size, bandwidth1.dropped_bytes);
+	ASSERT_EQ (2 * message_size, channel1->get_bandwidth ().bytes ());
+	auto const & bandwidth2 (channel2->get_bandwidth ().get (nano::message_type::publish));
+	ASSERT_EQ (2, bandwidth2.messages);
+	ASSERT_EQ (0, bandwidth2.dropped_messages);
+	ASSERT_EQ (0, channel2->get_bandwidth ().get (nano::message_type::confirm_ack).messages);
+
+	node.stop ();
+}
+
+// The test must be completed in less than 1 second
+TEST (network, bandwidth_limiter_peer_share_reset)
+{
+	nano::system system;
+	nano::genesis genesis;
+	nano::publish message (genesis.open);
+	auto message_size = message.to_bytes ()->size ();
+	auto message_limit = 4;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.bandwidth_limit = message_limit * message_size;
+	node_config.bandwidth_limit_burst_ratio = 1.0;
+	node_config.bandwidth_limit_peer_share = 0.5;
+	auto & node = *system.add_node (node_config);
+	auto channel (node.network.udp_channels.create (node.network.endpoint ()));
+	for (auto i = 0; i < message_limit / 2 + 1; ++i)
+	{
+		channel->send (message);
+	}
+	ASSERT_TIMELY (1s, 1 == node.stats.count (nano::stat::type::drop, nano::stat::detail::publish, nano::stat::dir::out));
+	// Doubling the node limit doubles the share of the channel
+	node.set_bandwidth_params (2 * message_limit * message_size, 1.0);
+	for (auto i = 0; i < message_limit; ++i)
+	{
+		channel->send (message);
+	}
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::drop, nano::stat::detail::publish, nano::stat::dir::out));
+	ASSERT_EQ (message_limit / 2 + message_limit, channel->get_bandwidth ().get (nano::message_type::publish).messages);
+
+	node.stop ();
+}
+
 namespace nano
 {
 TEST (peer_exclusion, validate)
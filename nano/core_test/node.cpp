@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 
 #include <boost/filesystem.hpp>
+#include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/variant.hpp>
 
@@ -2436,6 +2437,55 @@ TEST (node, stat_counting)
 	ASSERT_EQ (10, node1.stats.count (nano::stat::type::ledger, nano::stat::dir::in));
 }
 
+// Counters updated concurrently through the lock free path are folded into the entries when read
+TEST (node, stat_counting_threads)
+{
+	nano::stat stats;
+	size_t const thread_count (8);
+	size_t const increments (10000);
+	std::vector<std::thread> threads;
+	for (size_t i (0); i < thread_count; ++i)
+	{
+		threads.emplace_back ([&stats, increments] () {
+			for (size_t j (0); j < increments; ++j)
+			{
+				stats.inc (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in);
+				stats.inc (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::out);
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	ASSERT_EQ (thread_count * increments, stats.count (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in));
+	ASSERT_EQ (thread_count * increments, stats.count (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::out));
+	ASSERT_EQ (thread_count * increments, stats.count (nano::stat::type::ledger, nano::stat::dir::in));
+	ASSERT_EQ (0, stats.count (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::in));
+
+	// Values not yet read are written out when logging
+	stats.inc (nano::stat::type::vote, nano::stat::detail::vote_valid, nano::stat::dir::in);
+	auto sink (stats.log_sink_json ());
+	stats.log_counters (*sink);
+	auto & tree (*static_cast<boost::property_tree::ptree *> (sink->to_object ()));
+	auto entries (tree.get_child ("entries"));
+	ASSERT_TRUE (std::any_of (entries.begin (), entries.end (), [] (auto const & entry_a) {
+		return entry_a.second.template get<std::string> ("type") == "vote" && entry_a.second.template get<std::string> ("detail") == "vote_valid";
+	}));
+
+	// Count observers move all further updates to the locked path
+	std::atomic<uint64_t> observed{ 0 };
+	stats.observe_count (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in, [&observed] (uint64_t, uint64_t new_a) {
+		observed = new_a;
+	});
+	stats.inc (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in);
+	ASSERT_EQ (thread_count * increments + 1, observed);
+
+	stats.clear ();
+	ASSERT_EQ (0, stats.count (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in));
+	ASSERT_EQ (0, stats.count (nano::stat::type::ledger, nano::stat::detail::receive, nano::stat::dir::out));
+}
+
 TEST (node, stat_histogram)
 {
 	nano::system system (1);
@@ -2468,6 +2518,42 @@ TEST (node, stat_histogram)
 	ASSERT_EQ (histogram_ack_out->get_bins ()[1].value, 1);
 }
 
+TEST (node, stat_histogram_latency)
+{
+	auto intervals (nano::stat_histogram::log_linear_intervals (64, 4));
+	std::vector<uint64_t> expected{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28, 32, 40, 48, 56, 64, std::numeric_limits<uint64_t>::max () };
+	ASSERT_EQ (expected, intervals);
+
+	nano::stat stats;
+	stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in);
+	stats.update_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in, 0);
+	stats.update_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in, 1000, 2);
+	stats.update_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in, std::numeric_limits<uint32_t>::max ());
+	auto histogram (stats.get_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in));
+	auto bins (histogram->get_bins ());
+	ASSERT_EQ (1, bins.front ().value);
+	ASSERT_EQ (1, bins.back ().value);
+	auto bin (std::find_if (bins.begin (), bins.end (), [] (auto const & bin_a) { return bin_a.start_inclusive <= 1000 && 1000 < bin_a.end_exclusive; }));
+	ASSERT_NE (bins.end (), bin);
+	ASSERT_EQ (2, bin->value);
+	ASSERT_EQ (2000 + static_cast<uint64_t> (std::numeric_limits<uint32_t>::max ()), histogram->get_sum ());
+
+	// Cumulative buckets, with values beyond the range counted in the +Inf bucket
+	auto sink (stats.log_sink_prometheus ());
+	stats.log_counters (*sink);
+	auto text (sink->to_string ());
+	ASSERT_NE (std::string::npos, text.find ("# TYPE nano_latency_cement histogram\n"));
+	ASSERT_NE (std::string::npos, text.find ("nano_latency_cement_bucket{dir=\"in\",le=\"0\"} 1\n"));
+	ASSERT_NE (std::string::npos, text.find (boost::str (boost::format ("nano_latency_cement_bucket{dir=\"in\",le=\"%1%\"} 3\n") % (bin->end_exclusive - 1))));
+	ASSERT_NE (std::string::npos, text.find ("nano_latency_cement_bucket{dir=\"in\",le=\"+Inf\"} 4\n"));
+	ASSERT_NE (std::string::npos, text.find ("nano_latency_cement_count{dir=\"in\"} 4\n"));
+
+	// Clearing keeps the histogram definition
+	stats.clear ();
+	ASSERT_EQ (0, histogram->get_sum ());
+	ASSERT_EQ (0, histogram->get_bins ().back ().value);
+}
+
 TEST (node, online_reps)
 {
 	nano::system system (1);
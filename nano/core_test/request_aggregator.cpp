@@ -361,6 +361,37 @@ TEST (request_aggregator, unique)
 	ASSERT_TIMELY (3s, 1 == node.stats.count (nano::stat::type::requests, nano::stat::detail::requests_generated_votes));
 }
 
+TEST (request_aggregator, workers)
+{
+	nano::system system;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	node_config.request_aggregator_threads = 4;
+	auto & node (*system.add_node (node_config));
+	system.wallet (0)->insert_adhoc (nano::dev::genesis_key.prv);
+	size_t const pools (8);
+	for (size_t i (0); i < pools; ++i)
+	{
+		// One pool per endpoint, with a hash unknown to the ledger
+		std::vector<std::pair<nano::block_hash, nano::root>> request;
+		request.emplace_back (nano::block_hash (i + 1), nano::root (i + 1));
+		auto channel (node.network.udp_channels.create (nano::endpoint (boost::asio::ip::address_v6::loopback (), nano::get_available_port ())));
+		node.aggregator.add (channel, request);
+	}
+	ASSERT_TIMELY (3s, pools == node.stats.count (nano::stat::type::requests, nano::stat::detail::requests_unknown));
+	ASSERT_TRUE (node.aggregator.empty ());
+	ASSERT_EQ (pools, node.stats.count (nano::stat::type::aggregator, nano::stat::detail::aggregator_accepted));
+	// Every served pool records its latency
+	ASSERT_TIMELY (3s, [&node] () {
+		uint64_t total (0);
+		for (auto const & bin : node.stats.get_histogram (nano::stat::type::aggregator, nano::stat::detail::aggregator_latency, nano::stat::dir::in)->get_bins ())
+		{
+			total += bin.value;
+		}
+		return total;
+	}() == pools);
+}
+
 namespace nano
 {
 TEST (request_aggregator, cannot_vote)
@@ -301,3 +301,64 @@ TEST (socket, concurrent_writes)
 		t.join ();
 	}
 }
+
+TEST (socket, coalesced_writes)
+{
+	auto node_flags = nano::inactive_node_flag_defaults ();
+	node_flags.read_only = false;
+	nano::inactive_node inactivenode (nano::unique_path (), node_flags);
+	auto node = inactivenode.node;
+	// Hold writes back long enough for all of them to be queued
+	node->config.tcp_write_coalesce_delay = std::chrono::milliseconds (100);
+
+	nano::thread_runner runner (node->io_ctx, 1);
+
+	constexpr size_t message_count = 10;
+	auto server_port (nano::get_available_port ());
+	boost::asio::ip::tcp::endpoint endpoint (boost::asio::ip::address_v6::any (), server_port);
+	auto server_socket = std::make_shared<nano::server_socket> (*node, endpoint, 1);
+	boost::system::error_code ec;
+	server_socket->start (ec);
+	ASSERT_FALSE (ec);
+
+	auto read_buffer (std::make_shared<std::vector<uint8_t>> (message_count));
+	nano::util::counted_completion read_completion (1);
+	std::vector<std::shared_ptr<nano::socket>> connections;
+	server_socket->on_connection ([&connections, &read_completion, read_buffer] (std::shared_ptr<nano::socket> const & new_connection, boost::system::error_code const & ec_a) {
+		connections.push_back (new_connection);
+		new_connection->async_read (read_buffer, message_count, [&read_completion] (boost::system::error_code const & ec, size_t size_a) {
+			if (!ec && size_a == message_count)
+			{
+				read_completion.increment ();
+			}
+		});
+		return true;
+	});
+
+	auto client = std::make_shared<nano::socket> (*node, boost::none);
+	nano::util::counted_completion write_completion (message_count);
+	client->async_connect (boost::asio::ip::tcp::endpoint (boost::asio::ip::address_v6::loopback (), server_port), [client, &write_completion] (boost::system::error_code const & ec_a) {
+		for (uint8_t i = 0; i < message_count; ++i)
+		{
+			client->async_write (nano::shared_const_buffer (i), [&write_completion] (boost::system::error_code const & ec, size_t size_a) {
+				if (!ec && size_a == 1)
+				{
+					write_completion.increment ();
+				}
+			});
+		}
+	});
+	ASSERT_FALSE (write_completion.await_count_for (std::chrono::seconds (5)));
+	ASSERT_FALSE (read_completion.await_count_for (std::chrono::seconds (5)));
+	for (uint8_t i = 0; i < message_count; ++i)
+	{
+		ASSERT_EQ (i, (*read_buffer)[i]);
+	}
+	ASSERT_EQ (1, node->stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_write, nano::stat::dir::out));
+	ASSERT_EQ (message_count - 1, node->stats.count (nano::stat::type::tcp, nano::stat::detail::tcp_write_coalesced, nano::stat::dir::out));
+	ASSERT_EQ (message_count, node->stats.count (nano::stat::type::traffic_tcp, nano::stat::detail::all, nano::stat::dir::out));
+
+	node->stop ();
+	runner.stop_event_processing ();
+	runner.join ();
+}
@@ -181,6 +181,73 @@ TEST (telemetry, consolidate_data_remove_outliers)
 	ASSERT_EQ (data, consolidated_telemetry_data);
 }
 
+TEST (telemetry, aggregate)
+{
+	nano::telemetry_aggregate aggregate;
+	ASSERT_EQ (nano::telemetry_data{}, aggregate.consolidated ());
+
+	nano::telemetry_data data;
+	data.account_count = 2;
+	data.block_count = 1;
+	data.cemented_count = 1;
+	data.protocol_version = 12;
+	data.peer_count = 2;
+	data.bandwidth_cap = 100;
+	data.unchecked_count = 3;
+	data.uptime = 6;
+	data.genesis_block = nano::block_hash (3);
+	data.major_version = 20;
+	data.minor_version = 1;
+	data.patch_version = 5;
+	data.pre_release_version = 2;
+	data.maker = 1;
+	data.timestamp = std::chrono::system_clock::time_point (100ms);
+	data.active_difficulty = 10;
+	aggregate.add (data);
+	ASSERT_EQ (data, aggregate.consolidated ());
+
+	nano::telemetry_data outlier;
+	outlier.account_count = 99;
+	outlier.block_count = 99;
+	outlier.cemented_count = 99;
+	outlier.protocol_version = 99;
+	outlier.peer_count = 99;
+	outlier.bandwidth_cap = 0;
+	outlier.unchecked_count = 99;
+	outlier.uptime = 999;
+	outlier.genesis_block = nano::block_hash (99);
+	outlier.major_version = 99;
+	outlier.minor_version = 9;
+	outlier.patch_version = 9;
+	outlier.pre_release_version = 9;
+	outlier.maker = 9;
+	outlier.timestamp = std::chrono::system_clock::time_point (999ms);
+	outlier.active_difficulty = 99;
+
+	// Consolidates the same as recomputing from all of the data, as data is added and removed
+	std::vector<nano::telemetry_data> all_data (20, data);
+	all_data.push_back (outlier);
+	all_data.push_back (outlier);
+	for (size_t i = 1; i < all_data.size (); ++i)
+	{
+		aggregate.add (all_data[i]);
+	}
+	ASSERT_EQ (all_data.size (), aggregate.size ());
+	ASSERT_EQ (nano::consolidate_telemetry_data (all_data), aggregate.consolidated ());
+	ASSERT_EQ (data, aggregate.consolidated ());
+	for (auto i = 0; i < 15; ++i)
+	{
+		aggregate.remove (data);
+		all_data.erase (all_data.begin ());
+	}
+	ASSERT_EQ (nano::consolidate_telemetry_data (all_data), aggregate.consolidated ());
+	ASSERT_NE (data, aggregate.consolidated ());
+	aggregate.remove (outlier);
+	aggregate.remove (outlier);
+	ASSERT_EQ (5, aggregate.size ());
+	ASSERT_EQ (data, aggregate.consolidated ());
+}
+
 TEST (telemetry, signatures)
 {
 	nano::keypair node_id;
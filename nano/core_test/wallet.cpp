@@ -711,6 +711,31 @@ TEST (wallet, work_cache_delayed)
 	ASSERT_GE (nano::work_difficulty (nano::work_version::work_1, block2->hash (), work1), threshold);
 }
 
+// Work precomputed after a send is used by the next send from the same account
+TEST (wallet, work_precompute_cache_hit)
+{
+	nano::system system (1);
+	auto & node1 (*system.nodes[0]);
+	auto wallet (system.wallet (0));
+	wallet->insert_adhoc (nano::dev::genesis_key.prv);
+	nano::keypair key;
+	auto block1 (wallet->send_action (nano::dev::genesis_key.pub, key.pub, 100));
+	ASSERT_NE (nullptr, block1);
+	auto threshold (node1.default_difficulty (nano::work_version::work_1));
+	ASSERT_TIMELY (10s, [&] () {
+		uint64_t work (0);
+		return !wallet->store.work_get (node1.wallets.tx_begin_read (), nano::dev::genesis_key.pub, work) && nano::work_difficulty (nano::work_version::work_1, block1->hash (), work) >= threshold;
+	}());
+	ASSERT_GE (node1.stats.count (nano::stat::type::wallet, nano::stat::detail::work_precompute_generated), 1);
+	ASSERT_TIMELY (5s, 0 == node1.wallets.work_scheduler.in_flight ());
+	auto hits (node1.stats.count (nano::stat::type::wallet, nano::stat::detail::work_cache_hit));
+	auto misses (node1.stats.count (nano::stat::type::wallet, nano::stat::detail::work_cache_miss));
+	auto block2 (wallet->send_action (nano::dev::genesis_key.pub, key.pub, 100));
+	ASSERT_NE (nullptr, block2);
+	ASSERT_EQ (hits + 1, node1.stats.count (nano::stat::type::wallet, nano::stat::detail::work_cache_hit));
+	ASSERT_EQ (misses, node1.stats.count (nano::stat::type::wallet, nano::stat::detail::work_cache_miss));
+}
+
 TEST (wallet, insert_locked)
 {
 	nano::system system (1);
@@ -1201,6 +1226,59 @@ TEST (wallet, search_pending)
 	ASSERT_EQ (send->hash (), receive->link ().as_block_hash ());
 }
 
+// Large wallets scan the pending table in parallel and receive each account's blocks as one batch
+TEST (wallet, search_pending_batch)
+{
+	nano::system system;
+	nano::node_config config (nano::get_available_port (), system.logging);
+	config.enable_voting = false;
+	config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	nano::node_flags flags;
+	flags.disable_search_pending = true;
+	auto & node (*system.add_node (config, flags));
+	auto & wallet (*system.wallet (0));
+
+	std::vector<nano::keypair> keys (nano::wallet::search_pending_parallel_threshold);
+	auto const & destination (keys[keys.size () / 2]);
+	nano::block_builder builder;
+	auto send1 = builder.state ()
+				 .account (nano::dev::genesis->account ())
+				 .previous (nano::dev::genesis->hash ())
+				 .representative (nano::dev::genesis->account ())
+				 .balance (nano::dev::genesis_amount - node.config.receive_minimum.number ())
+				 .link (destination.pub)
+				 .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				 .work (*system.work.generate (nano::dev::genesis->hash ()))
+				 .build_shared ();
+	auto send2 = builder.state ()
+				 .account (nano::dev::genesis->account ())
+				 .previous (send1->hash ())
+				 .representative (nano::dev::genesis->account ())
+				 .balance (nano::dev::genesis_amount - 2 * node.config.receive_minimum.number ())
+				 .link (destination.pub)
+				 .sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+				 .work (*system.work.generate (send1->hash ()))
+				 .build_shared ();
+	ASSERT_EQ (nano::process_result::progress, node.process (*send1).code);
+	ASSERT_EQ (nano::process_result::progress, node.process (*send2).code);
+	nano::blocks_confirm (node, { send2 }, true);
+	ASSERT_TIMELY (5s, node.block_confirmed (send1->hash ()) && node.block_confirmed (send2->hash ()));
+
+	// Keys are inserted after confirmation so the confirmation does not trigger an automatic receive
+	for (auto const & key : keys)
+	{
+		wallet.insert_adhoc (key.prv, false);
+	}
+	ASSERT_FALSE (wallet.search_pending (wallet.wallets.tx_begin_read ()));
+	ASSERT_TIMELY (10s, node.balance (destination.pub) == 2 * node.config.receive_minimum.number ());
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::wallet, nano::stat::detail::receive_batch));
+	ASSERT_EQ (2, node.stats.count (nano::stat::type::wallet, nano::stat::detail::search_pending_found));
+	ASSERT_EQ (keys.size (), node.stats.count (nano::stat::type::wallet, nano::stat::detail::search_pending_accounts));
+	nano::account_info info;
+	ASSERT_FALSE (node.store.account.get (node.store.tx_begin_read (), destination.pub, info));
+	ASSERT_EQ (2, info.block_count);
+}
+
 TEST (wallet, receive_pruned)
 {
 	nano::system system;
@@ -70,7 +70,25 @@ namespace ipc
 		flatbuffers = 0x3,
 
 		/** JSON -> Flatbuffers -> JSON  */
-		flatbuffers_json = 0x4
+		flatbuffers_json = 0x4,
+
+		/**
+		 * Request is preamble followed by 32-bit BE length, 32-bit BE request id and payload bytes. The length includes the request id.
+		 * Response is 32-bit BE length followed by the 32-bit BE request id and payload bytes.
+		 * Payloads are the same as json_v1. Requests are pipelined: the next request is read before the previous one is
+		 * answered, and responses are written as they complete, in any order.
+		 */
+		json_v1_multiplexed = 0x5,
+
+		/** Request/response is same as json_v1_multiplexed, but exposes unsafe RPC's */
+		json_v1_multiplexed_unsafe = 0x6,
+
+		/**
+		 * Request is preamble followed by the 32-bit BE requested ring capacity, on a domain socket only. The node answers with the
+		 * 32-bit BE capacity it chose along with a memfd and two eventfds (SCM_RIGHTS). From then on flatbuffers requests, responses
+		 * and subscription events are exchanged through the shared memory rings, see nano::ipc::shm_channel. Linux only.
+		 */
+		flatbuffers_shm = 0x7
 	};
 
 	/** IPC transport interface */
@@ -336,6 +336,17 @@ nano::shared_const_buffer nano::ipc::prepare_request (nano::ipc::payload_encodin
 	return nano::shared_const_buffer{ std::move (buffer_l) };
 }
 
+nano::shared_const_buffer nano::ipc::prepare_multiplexed_request (uint32_t id_a, std::string const & payload_a)
+{
+	auto buffer_l (get_preamble (nano::ipc::payload_encoding::json_v1_multiplexed));
+	uint32_t be_length = boost::endian::native_to_big (static_cast<uint32_t> (sizeof (id_a) + payload_a.size ()));
+	uint32_t be_id = boost::endian::native_to_big (id_a);
+	buffer_l.insert (buffer_l.end (), reinterpret_cast<uint8_t *> (&be_length), reinterpret_cast<uint8_t *> (&be_length) + sizeof (uint32_t));
+	buffer_l.insert (buffer_l.end (), reinterpret_cast<uint8_t *> (&be_id), reinterpret_cast<uint8_t *> (&be_id) + sizeof (uint32_t));
+	buffer_l.insert (buffer_l.end (), payload_a.begin (), payload_a.end ());
+	return nano::shared_const_buffer{ std::move (buffer_l) };
+}
+
 std::string nano::ipc::request (nano::ipc::payload_encoding encoding_a, nano::ipc::ipc_client & ipc_client, std::string const & rpc_action_a)
 {
 	auto req (prepare_request (encoding_a, rpc_action_a));
@@ -88,5 +88,8 @@ namespace ipc
 	 * the buffer may contain a payload length or end sentinel.
 	 */
 	nano::shared_const_buffer prepare_request (nano::ipc::payload_encoding encoding_a, std::string const & payload_a);
+
+	/** Returns a buffer with a json_v1_multiplexed preamble, followed by 32-bit BE length, 32-bit BE \p id_a and the payload */
+	nano::shared_const_buffer prepare_multiplexed_request (uint32_t id_a, std::string const & payload_a);
 }
 }
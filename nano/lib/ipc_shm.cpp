@@ -0,0 +1,511 @@
+#include <nano/lib/ipc.hpp>
+#include <nano/lib/ipc_shm.hpp>
+#include <nano/lib/utility.hpp>
+
+#if defined(NANO_IPC_SHM)
+#include <boost/endian/conversion.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+std::size_t align_record (std::size_t size_a)
+{
+	return (size_a + 7) & ~std::size_t (7);
+}
+
+nano::error last_error ()
+{
+	return nano::error (std::error_code (errno, std::system_category ()));
+}
+
+void close_fd (int & fd_a)
+{
+	if (fd_a != -1)
+	{
+		::close (fd_a);
+		fd_a = -1;
+	}
+}
+
+void signal_event (int fd_a)
+{
+	uint64_t one (1);
+	auto written (::write (fd_a, &one, sizeof (one)));
+	// Only fails if the counter would overflow, the reader is awake in that case
+	(void)written;
+}
+
+void clear_event (int fd_a)
+{
+	uint64_t counter;
+	auto read (::read (fd_a, &counter, sizeof (counter)));
+	// Fails with EAGAIN if the counter was already cleared, which is fine
+	(void)read;
+}
+
+bool is_power_of_two (std::size_t value_a)
+{
+	return value_a != 0 && (value_a & (value_a - 1)) == 0;
+}
+}
+
+std::size_t constexpr nano::ipc::shm_ring::record_header_size;
+uint32_t constexpr nano::ipc::shm_ring::wrap_marker;
+std::size_t constexpr nano::ipc::shm_channel::min_capacity;
+std::size_t constexpr nano::ipc::shm_channel::max_capacity;
+std::size_t constexpr nano::ipc::shm_channel::default_capacity;
+
+nano::ipc::shm_ring::shm_ring (void * region_a, std::size_t capacity_a, int notify_fd_a) :
+	control (*static_cast<header *> (region_a)),
+	data (static_cast<uint8_t *> (region_a) + sizeof (header)),
+	capacity (capacity_a),
+	notify_fd (notify_fd_a),
+	reader_head (control.head.load ()),
+	writer_tail (control.tail.load ())
+{
+	debug_assert (is_power_of_two (capacity));
+}
+
+bool nano::ipc::shm_ring::write (uint8_t const * data_a, std::size_t size_a)
+{
+	auto result (size_a > max_message_size ());
+	if (!result)
+	{
+		auto record (align_record (record_header_size + size_a));
+		auto tail (writer_tail);
+		auto head (control.head.load (std::memory_order_acquire));
+		auto offset (tail & (capacity - 1));
+		auto contiguous (capacity - offset);
+		// A record which does not fit before the end of the ring also uses up the remainder
+		auto needed (contiguous < record ? contiguous + record : record);
+		// A head ahead of the tail wraps around to a huge distance and reads as full
+		result = tail + needed - head > capacity;
+		if (!result)
+		{
+			if (contiguous < record)
+			{
+				std::memcpy (data + offset, &wrap_marker, sizeof (wrap_marker));
+				tail += contiguous;
+				offset = 0;
+			}
+			auto length (static_cast<uint32_t> (size_a));
+			std::memcpy (data + offset, &length, sizeof (length));
+			std::memcpy (data + offset + record_header_size, data_a, size_a);
+			// Publishing the tail and checking the waiting flag are both sequentially consistent, pairing with arm_notification,
+			// so either the reader sees the new tail or the writer sees the flag
+			writer_tail = tail + record;
+			control.tail.store (writer_tail);
+			if (control.waiting.load () != 0 && control.waiting.exchange (0) != 0)
+			{
+				signal_event (notify_fd);
+			}
+		}
+	}
+	return result;
+}
+
+bool nano::ipc::shm_ring::peek (uint8_t const *& data_a, std::size_t & size_a)
+{
+	auto tail (control.tail.load (std::memory_order_acquire));
+	// The tail is published by the peer, it must lie within one ring of the head
+	corrupt_m = corrupt_m || tail - reader_head > capacity;
+	auto result (true);
+	while (result && !corrupt_m && reader_head != tail)
+	{
+		auto offset (reader_head & (capacity - 1));
+		auto available (tail - reader_head);
+		uint32_t length;
+		std::memcpy (&length, data + offset, sizeof (length));
+		if (length == wrap_marker)
+		{
+			// Records starting at offset zero always fit, a wrap marker there can only come from a broken writer
+			corrupt_m = offset == 0 || capacity - offset > available;
+			if (!corrupt_m)
+			{
+				reader_head += capacity - offset;
+				control.head.store (reader_head, std::memory_order_release);
+			}
+		}
+		else
+		{
+			auto record (align_record (record_header_size + length));
+			corrupt_m = record_header_size + length > capacity - offset || record > available;
+			if (!corrupt_m)
+			{
+				data_a = data + offset + record_header_size;
+				size_a = length;
+				peeked = record;
+				result = false;
+			}
+		}
+	}
+	return result;
+}
+
+void nano::ipc::shm_ring::consume ()
+{
+	debug_assert (peeked != 0);
+	reader_head += peeked;
+	control.head.store (reader_head, std::memory_order_release);
+	peeked = 0;
+}
+
+bool nano::ipc::shm_ring::empty () const
+{
+	return reader_head == control.tail.load ();
+}
+
+bool nano::ipc::shm_ring::corrupt () const
+{
+	return corrupt_m;
+}
+
+bool nano::ipc::shm_ring::arm_notification ()
+{
+	control.waiting.store (1);
+	return empty ();
+}
+
+std::size_t nano::ipc::shm_ring::max_message_size () const
+{
+	return capacity / 2 - record_header_size;
+}
+
+std::size_t nano::ipc::shm_ring::region_size (std::size_t capacity_a)
+{
+	return sizeof (header) + capacity_a;
+}
+
+nano::ipc::shm_channel::~shm_channel ()
+{
+	close ();
+}
+
+nano::error nano::ipc::shm_channel::create (std::size_t capacity_a)
+{
+	close ();
+	capacity_m = min_capacity;
+	while (capacity_m < capacity_a && capacity_m < max_capacity)
+	{
+		capacity_m *= 2;
+	}
+	nano::error result;
+	fds[0] = ::memfd_create ("nano_ipc", MFD_CLOEXEC);
+	fds[1] = ::eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+	fds[2] = ::eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (fds[0] == -1 || fds[1] == -1 || fds[2] == -1)
+	{
+		result = last_error ();
+	}
+	// The extended file is zero filled, which is the initial state of both ring headers
+	else if (::ftruncate (fds[0], static_cast<off_t> (2 * nano::ipc::shm_ring::region_size (capacity_m))) != 0)
+	{
+		result = last_error ();
+	}
+	else
+	{
+		result = map ();
+	}
+	if (result)
+	{
+		close ();
+	}
+	return result;
+}
+
+nano::error nano::ipc::shm_channel::send (int socket_fd_a) const
+{
+	auto big_capacity (boost::endian::native_to_big (static_cast<uint32_t> (capacity_m)));
+	iovec iov{ &big_capacity, sizeof (big_capacity) };
+	alignas (cmsghdr) char control[CMSG_SPACE (sizeof (fds))];
+	std::memset (control, 0, sizeof (control));
+	msghdr message{};
+	message.msg_iov = &iov;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof (control);
+	auto cmsg (CMSG_FIRSTHDR (&message));
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN (sizeof (fds));
+	std::memcpy (CMSG_DATA (cmsg), fds.data (), sizeof (fds));
+	ssize_t sent;
+	do
+	{
+		sent = ::sendmsg (socket_fd_a, &message, MSG_NOSIGNAL);
+	} while (sent == -1 && errno == EINTR);
+	nano::error result;
+	if (sent == -1)
+	{
+		result = last_error ();
+	}
+	else if (sent != sizeof (big_capacity))
+	{
+		result = nano::error ("Short write of shared memory channel");
+	}
+	return result;
+}
+
+nano::error nano::ipc::shm_channel::receive (int socket_fd_a)
+{
+	close ();
+	uint32_t big_capacity (0);
+	iovec iov{ &big_capacity, sizeof (big_capacity) };
+	alignas (cmsghdr) char control[CMSG_SPACE (sizeof (fds))];
+	msghdr message{};
+	message.msg_iov = &iov;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof (control);
+	ssize_t received;
+	do
+	{
+		received = ::recvmsg (socket_fd_a, &message, MSG_CMSG_CLOEXEC);
+	} while (received == -1 && errno == EINTR);
+	nano::error result;
+	if (received == -1)
+	{
+		result = last_error ();
+	}
+	else
+	{
+		auto cmsg (CMSG_FIRSTHDR (&message));
+		if (received != sizeof (big_capacity) || cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN (sizeof (fds)))
+		{
+			result = nano::error ("Shared memory channel was not received");
+		}
+		else
+		{
+			std::memcpy (fds.data (), CMSG_DATA (cmsg), sizeof (fds));
+			capacity_m = boost::endian::big_to_native (big_capacity);
+			struct stat status;
+			if (!is_power_of_two (capacity_m) || capacity_m < min_capacity || capacity_m > max_capacity)
+			{
+				result = nano::error ("Invalid shared memory ring capacity");
+			}
+			else if (::fstat (fds[0], &status) != 0 || static_cast<std::size_t> (status.st_size) < 2 * nano::ipc::shm_ring::region_size (capacity_m))
+			{
+				result = nano::error ("Shared memory is smaller than its rings");
+			}
+			else
+			{
+				result = map ();
+			}
+		}
+	}
+	if (result)
+	{
+		close ();
+	}
+	return result;
+}
+
+nano::error nano::ipc::shm_channel::map ()
+{
+	nano::error result;
+	auto ring_size (nano::ipc::shm_ring::region_size (capacity_m));
+	region = ::mmap (nullptr, 2 * ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+	if (region == MAP_FAILED)
+	{
+		region = nullptr;
+		result = last_error ();
+	}
+	else
+	{
+		mapping_size = 2 * ring_size;
+		request_ring = std::make_unique<nano::ipc::shm_ring> (region, capacity_m, fds[1]);
+		response_ring = std::make_unique<nano::ipc::shm_ring> (static_cast<uint8_t *> (region) + ring_size, capacity_m, fds[2]);
+	}
+	return result;
+}
+
+void nano::ipc::shm_channel::close ()
+{
+	request_ring.reset ();
+	response_ring.reset ();
+	if (region != nullptr)
+	{
+		::munmap (region, mapping_size);
+		region = nullptr;
+		mapping_size = 0;
+	}
+	for (auto & fd : fds)
+	{
+		close_fd (fd);
+	}
+	capacity_m = 0;
+}
+
+nano::ipc::shm_ring & nano::ipc::shm_channel::requests ()
+{
+	debug_assert (request_ring != nullptr);
+	return *request_ring;
+}
+
+nano::ipc::shm_ring & nano::ipc::shm_channel::responses ()
+{
+	debug_assert (response_ring != nullptr);
+	return *response_ring;
+}
+
+int nano::ipc::shm_channel::request_event () const
+{
+	return fds[1];
+}
+
+int nano::ipc::shm_channel::response_event () const
+{
+	return fds[2];
+}
+
+std::size_t nano::ipc::shm_channel::capacity () const
+{
+	return capacity_m;
+}
+
+nano::ipc::shm_client::~shm_client ()
+{
+	close ();
+}
+
+nano::error nano::ipc::shm_client::connect (std::string const & path_a, std::size_t capacity_a)
+{
+	close ();
+	nano::error result;
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path_a.size () >= sizeof (address.sun_path))
+	{
+		result = nano::error ("Domain socket path is too long");
+	}
+	else
+	{
+		std::memcpy (address.sun_path, path_a.c_str (), path_a.size () + 1);
+		socket_fd = ::socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (socket_fd == -1 || ::connect (socket_fd, reinterpret_cast<sockaddr *> (&address), sizeof (address)) != 0)
+		{
+			result = last_error ();
+		}
+		else
+		{
+			// Preamble followed by the requested ring capacity
+			std::vector<uint8_t> request{ 'N', static_cast<uint8_t> (nano::ipc::payload_encoding::flatbuffers_shm), 0, 0 };
+			auto big_capacity (boost::endian::native_to_big (static_cast<uint32_t> (std::min (capacity_a, nano::ipc::shm_channel::max_capacity))));
+			request.insert (request.end (), reinterpret_cast<uint8_t *> (&big_capacity), reinterpret_cast<uint8_t *> (&big_capacity) + sizeof (big_capacity));
+			if (::send (socket_fd, request.data (), request.size (), MSG_NOSIGNAL) != static_cast<ssize_t> (request.size ()))
+			{
+				result = last_error ();
+			}
+			else
+			{
+				result = channel.receive (socket_fd);
+			}
+		}
+	}
+	if (result)
+	{
+		close ();
+	}
+	return result;
+}
+
+nano::error nano::ipc::shm_client::write (uint8_t const * data_a, std::size_t size_a, std::chrono::milliseconds timeout_a)
+{
+	nano::error result;
+	if (socket_fd == -1)
+	{
+		result = nano::error (std::make_error_code (std::errc::not_connected));
+	}
+	else if (size_a > channel.requests ().max_message_size ())
+	{
+		result = nano::error (std::make_error_code (std::errc::message_size));
+	}
+	else
+	{
+		auto deadline (std::chrono::steady_clock::now () + timeout_a);
+		// The node does not signal freed space, a full ring is rare enough to simply poll
+		while (channel.requests ().write (data_a, size_a) && !result)
+		{
+			if (std::chrono::steady_clock::now () >= deadline)
+			{
+				result = nano::error (std::make_error_code (std::errc::timed_out));
+			}
+			else
+			{
+				std::this_thread::sleep_for (std::chrono::microseconds (50));
+			}
+		}
+	}
+	return result;
+}
+
+nano::error nano::ipc::shm_client::read (std::function<void (uint8_t const *, std::size_t)> const & message_a, std::chrono::milliseconds timeout_a)
+{
+	nano::error result;
+	if (socket_fd == -1)
+	{
+		result = nano::error (std::make_error_code (std::errc::not_connected));
+	}
+	else
+	{
+		auto & ring (channel.responses ());
+		auto deadline (std::chrono::steady_clock::now () + timeout_a);
+		uint8_t const * data;
+		std::size_t size;
+		while (ring.peek (data, size) && !result)
+		{
+			if (ring.corrupt ())
+			{
+				result = nano::error ("Shared memory response ring is corrupt");
+			}
+			else if (ring.arm_notification ())
+			{
+				auto remaining (std::chrono::duration_cast<std::chrono::milliseconds> (deadline - std::chrono::steady_clock::now ()));
+				std::array<pollfd, 2> descriptors{ { { channel.response_event (), POLLIN, 0 }, { socket_fd, POLLIN, 0 } } };
+				auto ready (::poll (descriptors.data (), descriptors.size (), static_cast<int> (std::max<int64_t> (remaining.count (), 0))));
+				if (ready == 0)
+				{
+					result = nano::error (std::make_error_code (std::errc::timed_out));
+				}
+				else if (ready == -1 && errno != EINTR)
+				{
+					result = last_error ();
+				}
+				// The node never writes to the socket after the handshake, so any activity means it was closed
+				else if (ready > 0 && descriptors[1].revents != 0)
+				{
+					result = nano::error (std::make_error_code (std::errc::connection_reset));
+				}
+				else if (ready > 0)
+				{
+					clear_event (channel.response_event ());
+				}
+			}
+		}
+		if (!result)
+		{
+			message_a (data, size);
+			ring.consume ();
+		}
+	}
+	return result;
+}
+
+void nano::ipc::shm_client::close ()
+{
+	channel.close ();
+	close_fd (socket_fd);
+}
+#endif
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <nano/lib/errors.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+/** Shared memory transport is built on memfd_create and eventfd, which are Linux specific */
+#if defined(__linux__)
+#define NANO_IPC_SHM 1
+#endif
+
+#if defined(NANO_IPC_SHM)
+namespace nano
+{
+namespace ipc
+{
+	/**
+	 * Single producer, single consumer ring of length-prefixed messages in memory shared by two processes.
+	 * Records are an 8 byte header holding the payload length, followed by the payload, padded to 8 bytes. A record never
+	 * wraps: if it does not fit before the end of the ring, a wrap marker is written and the record starts over at offset zero,
+	 * so readers always see each payload as one contiguous span and can process it in place.
+	 * Head and tail are byte counters which only grow, the writer owns the tail and the reader the head.
+	 * The writer only signals the eventfd if the reader announced it is about to block, which costs nothing while both sides are busy.
+	 * Each side keeps its own counter privately and only publishes it, the counter of the peer and the record headers are validated
+	 * before use, so a broken or hostile peer cannot make the ring access memory outside of its data area.
+	 */
+	class shm_ring final
+	{
+	public:
+		/** Control block at the start of each ring, head and tail are on separate cache lines to avoid false sharing */
+		class header final
+		{
+		public:
+			alignas (64) std::atomic<uint64_t> head;
+			alignas (64) std::atomic<uint64_t> tail;
+			alignas (64) std::atomic<uint32_t> waiting;
+		};
+		static_assert (std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free, "Atomics in shared memory must be lock free");
+
+		/**
+		 * @param region_a Start of region_size (capacity_a) bytes of shared memory, zero filled by the creator
+		 * @param capacity_a Size of the data area, a power of two
+		 * @param notify_fd_a Eventfd signalled when the reader waits for data
+		 */
+		shm_ring (void * region_a, std::size_t capacity_a, int notify_fd_a);
+		/**
+		 * Copies \p size_a bytes from \p data_a into the ring as one message
+		 * @return true if there is not enough free space, the reader has to make progress first
+		 */
+		bool write (uint8_t const * data_a, std::size_t size_a);
+		/**
+		 * Exposes the oldest message in place. The span stays valid until consume () is called
+		 * @return true if the ring is empty or corrupt
+		 */
+		bool peek (uint8_t const *& data_a, std::size_t & size_a);
+		/** Releases the message returned by the last successful peek */
+		void consume ();
+		bool empty () const;
+		/** True once peek found the tail or a record header written by the peer out of bounds, the ring cannot be read any further */
+		bool corrupt () const;
+		/**
+		 * Asks the writer to signal the eventfd on its next write
+		 * @return true if the ring is still empty afterwards, in which case the reader should block on the eventfd
+		 */
+		bool arm_notification ();
+		/** Largest message which always fits into an empty ring, wherever its tail is */
+		std::size_t max_message_size () const;
+
+		static std::size_t region_size (std::size_t capacity_a);
+		static std::size_t constexpr record_header_size{ 8 };
+
+	private:
+		static uint32_t constexpr wrap_marker{ 0xffffffff };
+
+		header & control;
+		uint8_t * data;
+		std::size_t const capacity;
+		int const notify_fd;
+		/** Size of the record returned by peek, only used by the reader */
+		std::size_t peeked{ 0 };
+		/** Private copies of the counters each side owns, the published ones can be overwritten by the peer */
+		uint64_t reader_head;
+		uint64_t writer_tail;
+		bool corrupt_m{ false };
+	};
+
+	/**
+	 * A request ring and a response ring in one memfd mapping, each with an eventfd for notifications.
+	 * The server creates the channel and hands its descriptors to the client over the domain socket the client connected through.
+	 */
+	class shm_channel final
+	{
+	public:
+		shm_channel () = default;
+		shm_channel (shm_channel const &) = delete;
+		~shm_channel ();
+		/** Creates the shared memory and eventfds for rings of \p capacity_a bytes, which is rounded up to a power of two within the supported range */
+		nano::error create (std::size_t capacity_a);
+		/** Sends the ring capacity and the memfd and eventfd descriptors over the connected domain socket \p socket_fd_a */
+		nano::error send (int socket_fd_a) const;
+		/** Receives and maps a channel sent by the peer with send () */
+		nano::error receive (int socket_fd_a);
+		void close ();
+
+		shm_ring & requests ();
+		shm_ring & responses ();
+		int request_event () const;
+		int response_event () const;
+		std::size_t capacity () const;
+
+		static std::size_t constexpr min_capacity{ 4 * 1024 };
+		static std::size_t constexpr max_capacity{ 64 * 1024 * 1024 };
+		static std::size_t constexpr default_capacity{ 1024 * 1024 };
+
+	private:
+		nano::error map ();
+
+		/** Memfd, request eventfd and response eventfd */
+		std::array<int, 3> fds{ { -1, -1, -1 } };
+		std::size_t capacity_m{ 0 };
+		void * region{ nullptr };
+		std::size_t mapping_size{ 0 };
+		std::unique_ptr<nano::ipc::shm_ring> request_ring;
+		std::unique_ptr<nano::ipc::shm_ring> response_ring;
+	};
+
+	/**
+	 * Blocking client for the flatbuffers_shm encoding. The client connects to the node's domain socket, requests a channel and
+	 * then exchanges flatbuffers envelopes through the rings. The socket stays open, closing it ends the session.
+	 * Responses and subscription events arrive through the response ring in the order the node produced them.
+	 * @note A client must only be used from one thread at a time
+	 */
+	class shm_client final
+	{
+	public:
+		~shm_client ();
+		/** Connects to the domain socket at \p path_a and requests rings of \p capacity_a bytes */
+		nano::error connect (std::string const & path_a, std::size_t capacity_a = nano::ipc::shm_channel::default_capacity);
+		/** Copies a flatbuffers envelope into the request ring, waiting up to \p timeout_a for space */
+		nano::error write (uint8_t const * data_a, std::size_t size_a, std::chrono::milliseconds timeout_a);
+		/** Waits up to \p timeout_a for the next message and calls \p message_a with it. The span is only valid during the call */
+		nano::error read (std::function<void (uint8_t const *, std::size_t)> const & message_a, std::chrono::milliseconds timeout_a);
+		void close ();
+
+	private:
+		int socket_fd{ -1 };
+		nano::ipc::shm_channel channel;
+	};
+}
+}
+#endif
@@ -7,6 +7,7 @@ nano::error nano::rocksdb_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("enable", enable, "Whether to use the RocksDB backend for the ledger database.\ntype:bool");
 	toml.put ("memory_multiplier", memory_multiplier, "This will modify how much memory is used represented by 1 (low), 2 (medium), 3 (high). Default is 2.\ntype:uint8");
 	toml.put ("io_threads", io_threads, "Number of threads to use with the background compaction and flushing. Number of hardware threads is recommended.\ntype:uint32");
+	toml.put ("profile", serialize_profile (profile), "Column family tuning profile. standard uses a block cache per table. bootstrap favours bulk inserts, rep favours point lookup latency and archive_rpc keeps index and filter memory bounded on large ledgers. The non standard profiles share a single block cache between tables.\ntype:string,{standard,bootstrap,rep,archive_rpc}");
 	return toml.get_error ();
 }
 
@@ -15,6 +16,10 @@ nano::error nano::rocksdb_config::deserialize_toml (nano::tomlconfig & toml)
 	toml.get_optional<bool> ("enable", enable);
 	toml.get_optional<uint8_t> ("memory_multiplier", memory_multiplier);
 	toml.get_optional<unsigned> ("io_threads", io_threads);
+	if (toml.has_key ("profile"))
+	{
+		profile = deserialize_profile (toml.get<std::string> ("profile"));
+	}
 
 	// Validate ranges
 	if (io_threads == 0)
@@ -25,10 +30,51 @@ nano::error nano::rocksdb_config::deserialize_toml (nano::tomlconfig & toml)
 	{
 		toml.get_error ().set ("memory_multiplier must be either 1, 2 or 3");
 	}
+	if (profile == tuning_profile::invalid)
+	{
+		toml.get_error ().set ("profile must be one of standard, bootstrap, rep or archive_rpc");
+	}
 
 	return toml.get_error ();
 }
 
+std::string nano::rocksdb_config::serialize_profile (tuning_profile profile_a)
+{
+	switch (profile_a)
+	{
+		case tuning_profile::bootstrap:
+			return "bootstrap";
+		case tuning_profile::rep:
+			return "rep";
+		case tuning_profile::archive_rpc:
+			return "archive_rpc";
+		default:
+			return "standard";
+	}
+}
+
+nano::rocksdb_config::tuning_profile nano::rocksdb_config::deserialize_profile (std::string const & string_a)
+{
+	auto result (tuning_profile::invalid);
+	if (string_a == "standard")
+	{
+		result = tuning_profile::standard;
+	}
+	else if (string_a == "bootstrap")
+	{
+		result = tuning_profile::bootstrap;
+	}
+	else if (string_a == "rep")
+	{
+		result = tuning_profile::rep;
+	}
+	else if (string_a == "archive_rpc")
+	{
+		result = tuning_profile::archive_rpc;
+	}
+	return result;
+}
+
 bool nano::rocksdb_config::using_rocksdb_in_tests ()
 {
 	static nano::network_constants network_constants;
@@ -2,6 +2,7 @@
 
 #include <nano/lib/errors.hpp>
 
+#include <string>
 #include <thread>
 
 namespace nano
@@ -16,14 +17,35 @@ public:
 		enable{ using_rocksdb_in_tests () }
 	{
 	}
+	/**
+	 * Named column family tuning profiles.
+	 * standard keeps a separate block cache per column family and full bloom filters everywhere.
+	 * The others share one block cache between column families, use a prefix bloom on pending keyed by account and are tuned for:
+	 * bootstrap - insert heavy, most existence checks miss, larger memtables and fewer compaction stalls
+	 * rep - low latency point lookups on a ledger which mostly fits in memory
+	 * archive_rpc - large ledgers served to RPC, partitioned index and filter blocks kept in the block cache
+	 */
+	enum class tuning_profile
+	{
+		standard,
+		bootstrap,
+		rep,
+		archive_rpc,
+		invalid
+	};
+
 	nano::error serialize_toml (nano::tomlconfig & toml_a) const;
 	nano::error deserialize_toml (nano::tomlconfig & toml_a);
 
+	static std::string serialize_profile (tuning_profile);
+	static tuning_profile deserialize_profile (std::string const &);
+
 	/** To use RocksDB in tests make sure the environment variable TEST_USE_ROCKSDB=1 is set */
 	static bool using_rocksdb_in_tests ();
 
 	bool enable{ false };
 	uint8_t memory_multiplier{ 2 };
 	unsigned io_threads{ std::thread::hardware_concurrency () };
+	tuning_profile profile{ tuning_profile::standard };
 };
 }
@@ -135,7 +135,7 @@ nano::error nano::rpc_config::serialize_toml (nano::tomlconfig & toml) const
 	rpc_process_l.put ("io_threads", rpc_process.io_threads, "Number of threads used to serve IO.\ntype:uint32");
 	rpc_process_l.put ("ipc_address", rpc_process.ipc_address, "Address of IPC server.\ntype:string,ip");
 	rpc_process_l.put ("ipc_port", rpc_process.ipc_port, "Listening port of IPC server.\ntype:uint16");
-	rpc_process_l.put ("num_ipc_connections", rpc_process.num_ipc_connections, "Number of IPC connections to establish.\ntype:uint32");
+	rpc_process_l.put ("num_ipc_connections", rpc_process.num_ipc_connections, "Maximum number of IPC connections to the node. Connections are opened on demand and each one pipelines multiple requests.\ntype:uint32");
 	toml.put_child ("process", rpc_process_l);
 
 	nano::tomlconfig rpc_logging_l;
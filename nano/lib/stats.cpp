@@ -6,8 +6,10 @@
 #include <boost/format.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
+#include <algorithm>
 #include <ctime>
 #include <fstream>
+#include <limits>
 #include <sstream>
 
 nano::error nano::stat_config::deserialize_json (nano::jsonconfig & json)
@@ -208,6 +210,79 @@ public:
 	}
 };
 
+/**
+ * Prometheus text exposition format sink. Counters are written as a single labelled counter family, and
+ * each histogram as its own family named after its type and detail. Histogram bins are cumulative, with
+ * the last bin reported as +Inf since values beyond the defined range are clamped into it.
+ */
+class prometheus_writer : public nano::stat_log_sink
+{
+public:
+	std::ostream & out () override
+	{
+		return sstr;
+	}
+
+	void begin () override
+	{
+		counters.str ("");
+		histograms.str ("");
+		sstr.str ("");
+		last_histogram.clear ();
+	}
+
+	void write_entry (tm &, std::string const & type, std::string const & detail, std::string const & dir, uint64_t value, nano::stat_histogram * histogram) override
+	{
+		counters << "nano_stat_total{type=\"" << type << "\",detail=\"" << detail << "\",dir=\"" << dir << "\"} " << value << "\n";
+		if (histogram != nullptr)
+		{
+			auto name (boost::str (boost::format ("nano_%1%_%2%") % type % detail));
+			// Entries are sorted by key, so directions of the same histogram are adjacent and share the family header
+			if (name != last_histogram)
+			{
+				histograms << "# TYPE " << name << " histogram\n";
+				last_histogram = name;
+			}
+			auto bins (histogram->get_bins ());
+			uint64_t cumulative (0);
+			for (auto i (bins.begin ()), n (bins.end ()); i != n; ++i)
+			{
+				cumulative += i->value;
+				histograms << name << "_bucket{dir=\"" << dir << "\",le=\"";
+				if (std::next (i) == n)
+				{
+					histograms << "+Inf";
+				}
+				else
+				{
+					histograms << (i->end_exclusive - 1);
+				}
+				histograms << "\"} " << cumulative << "\n";
+			}
+			histograms << name << "_sum{dir=\"" << dir << "\"} " << histogram->get_sum () << "\n";
+			histograms << name << "_count{dir=\"" << dir << "\"} " << cumulative << "\n";
+		}
+	}
+
+	void finalize () override
+	{
+		sstr << "# TYPE nano_stat_total counter\n";
+		sstr << counters.str ();
+		sstr << histograms.str ();
+	}
+
+	std::string to_string () override
+	{
+		return sstr.str ();
+	}
+
+private:
+	std::ostringstream sstr;
+	std::ostringstream counters;
+	std::ostringstream histograms;
+	std::string last_histogram;
+};
+
 nano::stat_histogram::stat_histogram (std::initializer_list<uint64_t> intervals_a, size_t bin_count_a)
 {
 	if (bin_count_a == 0)
@@ -243,23 +318,47 @@ nano::stat_histogram::stat_histogram (std::initializer_list<uint64_t> intervals_
 	}
 }
 
+nano::stat_histogram::stat_histogram (std::vector<uint64_t> const & intervals_a)
+{
+	debug_assert (intervals_a.size () > 1);
+	for (auto i (std::next (intervals_a.begin ())), n (intervals_a.end ()); i != n; ++i)
+	{
+		bins.emplace_back (*std::prev (i), *i);
+	}
+}
+
+std::vector<uint64_t> nano::stat_histogram::log_linear_intervals (uint64_t max_a, unsigned sub_bins_a)
+{
+	debug_assert (sub_bins_a > 0);
+	std::vector<uint64_t> result{ 0, 1 };
+	for (uint64_t base (1); base < max_a; base *= 2)
+	{
+		auto step (std::max<uint64_t> (1, base / sub_bins_a));
+		for (auto value (base + step); value <= base * 2; value += step)
+		{
+			result.push_back (value);
+		}
+	}
+	result.push_back (std::numeric_limits<uint64_t>::max ());
+	return result;
+}
+
 void nano::stat_histogram::add (uint64_t index_a, uint64_t addend_a)
 {
 	nano::lock_guard<nano::mutex> lk (histogram_mutex);
 	debug_assert (!bins.empty ());
+	sum += index_a * addend_a;
 
-	// The search for a bin is linear, but we're searching just a few
-	// contiguous items which are likely to be in cache.
+	// Bins are contiguous and sorted, find the first bin ending after index_a
 	bool found_l = false;
-	for (auto & bin : bins)
+	auto bin_l (std::upper_bound (bins.begin (), bins.end (), index_a, [] (uint64_t value_a, nano::stat_histogram::bin const & bin_a) {
+		return value_a < bin_a.end_exclusive;
+	}));
+	if (bin_l != bins.end () && index_a >= bin_l->start_inclusive)
 	{
-		if (index_a >= bin.start_inclusive && index_a < bin.end_exclusive)
-		{
-			bin.value += addend_a;
-			bin.timestamp = std::chrono::system_clock::now ();
-			found_l = true;
-			break;
-		}
+		bin_l->value += addend_a;
+		bin_l->timestamp = std::chrono::system_clock::now ();
+		found_l = true;
 	}
 
 	// Clamp into first or last bin if no suitable bin was found
@@ -276,12 +375,120 @@ void nano::stat_histogram::add (uint64_t index_a, uint64_t addend_a)
 	}
 }
 
+void nano::stat_histogram::clear ()
+{
+	nano::lock_guard<nano::mutex> lk (histogram_mutex);
+	for (auto & bin : bins)
+	{
+		bin.value = 0;
+		bin.timestamp = std::chrono::system_clock::now ();
+	}
+	sum = 0;
+}
+
+uint64_t nano::stat_histogram::get_sum () const
+{
+	nano::lock_guard<nano::mutex> lk (histogram_mutex);
+	return sum;
+}
+
 std::vector<nano::stat_histogram::bin> nano::stat_histogram::get_bins () const
 {
 	nano::lock_guard<nano::mutex> lk (histogram_mutex);
 	return bins;
 }
 
+namespace
+{
+/** Stripe of the calling thread, assigned round robin on first use */
+size_t stripe_index ()
+{
+	static std::atomic<size_t> next{ 0 };
+	static thread_local size_t index (next.fetch_add (1, std::memory_order_relaxed) % nano::stat_counters::stripe_count);
+	return index;
+}
+}
+
+nano::stat_counters::~stat_counters ()
+{
+	for (auto & stripe : stripes)
+	{
+		for (auto & block : stripe.blocks)
+		{
+			delete block.load ();
+		}
+	}
+}
+
+size_t nano::stat_counters::index_of (uint32_t key_a)
+{
+	// Detail and direction, the direction being either in or out
+	debug_assert ((key_a & 0xff) < 2);
+	return ((key_a >> 8) & 0xff) * 2 + (key_a & 0x1);
+}
+
+void nano::stat_counters::add (uint32_t key_a, uint64_t value_a)
+{
+	auto & slot (stripes[stripe_index ()].blocks[(key_a >> 16) & 0xff]);
+	auto block (slot.load (std::memory_order_acquire));
+	if (block == nullptr)
+	{
+		auto created (new nano::stat_counters::block ());
+		if (slot.compare_exchange_strong (block, created, std::memory_order_acq_rel))
+		{
+			block = created;
+		}
+		else
+		{
+			// Another thread sharing this stripe installed a block first
+			delete created;
+		}
+	}
+	block->values[index_of (key_a)].fetch_add (value_a, std::memory_order_relaxed);
+}
+
+uint64_t nano::stat_counters::take (uint32_t key_a)
+{
+	uint64_t result (0);
+	for (auto & stripe : stripes)
+	{
+		auto block (stripe.blocks[(key_a >> 16) & 0xff].load (std::memory_order_acquire));
+		if (block != nullptr)
+		{
+			result += block->values[index_of (key_a)].exchange (0, std::memory_order_relaxed);
+		}
+	}
+	return result;
+}
+
+void nano::stat_counters::take_all (std::function<void (uint32_t, uint64_t)> const & action_a)
+{
+	for (uint32_t type (0); type < 256; ++type)
+	{
+		std::array<uint64_t, 512> totals{};
+		auto found (false);
+		for (auto & stripe : stripes)
+		{
+			auto block (stripe.blocks[type].load (std::memory_order_acquire));
+			if (block != nullptr)
+			{
+				found = true;
+				for (size_t i (0); i < totals.size (); ++i)
+				{
+					totals[i] += block->values[i].exchange (0, std::memory_order_relaxed);
+				}
+			}
+		}
+		for (size_t i (0); found && i < totals.size (); ++i)
+		{
+			if (totals[i] != 0)
+			{
+				action_a (type << 16 | static_cast<uint32_t> (i / 2) << 8 | static_cast<uint32_t> (i % 2), totals[i]);
+			}
+		}
+	}
+}
+
 nano::stat::stat (nano::stat_config config) :
 	config (config)
 {
@@ -319,9 +526,48 @@ std::unique_ptr<nano::stat_log_sink> nano::stat::log_sink_json () const
 	return std::make_unique<json_writer> ();
 }
 
+std::unique_ptr<nano::stat_log_sink> nano::stat::log_sink_prometheus () const
+{
+	return std::make_unique<prometheus_writer> ();
+}
+
+void nano::stat::observe_count (stat::type type, stat::detail detail, stat::dir dir, std::function<void (uint64_t, uint64_t)> observer)
+{
+	// Observers are notified on each update, which requires every update to take the slow path from now on
+	counters_only = false;
+	nano::lock_guard<nano::mutex> guard (stat_mutex);
+	fold_counters ();
+	get_entry_impl (key_of (type, detail, dir), config.interval, config.capacity)->count_observers.add (observer);
+}
+
+uint64_t nano::stat::count (stat::type type, stat::detail detail, stat::dir dir)
+{
+	auto key (key_of (type, detail, dir));
+	nano::lock_guard<nano::mutex> guard (stat_mutex);
+	fold_counters (key);
+	return get_entry_impl (key, config.interval, config.capacity)->counter.get_value ();
+}
+
+void nano::stat::fold_counters (uint32_t key)
+{
+	auto value (counters.take (key));
+	if (value != 0)
+	{
+		get_entry_impl (key, config.interval, config.capacity)->counter.add (value);
+	}
+}
+
+void nano::stat::fold_counters ()
+{
+	counters.take_all ([this] (uint32_t key, uint64_t value) {
+		get_entry_impl (key, config.interval, config.capacity)->counter.add (value);
+	});
+}
+
 void nano::stat::log_counters (stat_log_sink & sink)
 {
 	nano::unique_lock<nano::mutex> lock (stat_mutex);
+	fold_counters ();
 	log_counters_impl (sink);
 }
 
@@ -398,6 +644,12 @@ void nano::stat::define_histogram (stat::type type, stat::detail detail, stat::d
 	entry->histogram = std::make_unique<nano::stat_histogram> (intervals_a, bin_count_a);
 }
 
+void nano::stat::define_latency_histogram (stat::type type, stat::detail detail, stat::dir dir)
+{
+	auto entry (get_entry (key_of (type, detail, dir)));
+	entry->histogram = std::make_unique<nano::stat_histogram> (nano::stat_histogram::log_linear_intervals (std::chrono::microseconds (std::chrono::minutes (1)).count (), 4));
+}
+
 void nano::stat::update_histogram (stat::type type, stat::detail detail, stat::dir dir, uint64_t index_a, uint64_t addend_a)
 {
 	auto entry (get_entry (key_of (type, detail, dir)));
@@ -414,6 +666,12 @@ nano::stat_histogram * nano::stat::get_histogram (stat::type type, stat::detail
 
 void nano::stat::update (uint32_t key_a, uint64_t value)
 {
+	if (counters_only.load (std::memory_order_relaxed))
+	{
+		counters.add (key_a, value);
+		return;
+	}
+
 	static file_writer log_count (config.log_counters_filename);
 	static file_writer log_sample (config.log_samples_filename);
 
@@ -478,6 +736,7 @@ std::chrono::seconds nano::stat::last_reset ()
 
 void nano::stat::stop ()
 {
+	counters_only = false;
 	nano::lock_guard<nano::mutex> guard (stat_mutex);
 	stopped = true;
 }
@@ -485,7 +744,20 @@ void nano::stat::stop ()
 void nano::stat::clear ()
 {
 	nano::unique_lock<nano::mutex> lock (stat_mutex);
-	entries.clear ();
+	fold_counters ();
+	// Histograms are defined once by their users and keep being updated, so only their values are reset
+	for (auto i (entries.begin ()), n (entries.end ()); i != n;)
+	{
+		if (i->second->histogram != nullptr)
+		{
+			i->second->histogram->clear ();
+			++i;
+		}
+		else
+		{
+			i = entries.erase (i);
+		}
+	}
 	timestamp = std::chrono::steady_clock::now ();
 }
 
@@ -564,6 +836,18 @@ std::string nano::stat::type_to_string (uint32_t key)
 		case nano::stat::type::vote_generator:
 			res = "vote_generator";
 			break;
+		case nano::stat::type::latency:
+			res = "latency";
+			break;
+		case nano::stat::type::wallet:
+			res = "wallet";
+			break;
+		case nano::stat::type::inactive_votes_cache:
+			res = "inactive_votes_cache";
+			break;
+		case nano::stat::type::admission:
+			res = "admission";
+			break;
 	}
 	return res;
 }
@@ -640,6 +924,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::gap_source:
 			res = "gap_source";
 			break;
+		case nano::stat::detail::uncemented_dropped:
+			res = "uncemented_dropped";
+			break;
 		case nano::stat::detail::frontier_confirmation_failed:
 			res = "frontier_confirmation_failed";
 			break;
@@ -673,6 +960,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::invocations:
 			res = "invocations";
 			break;
+		case nano::stat::detail::confirmation_drop:
+			res = "confirmation_drop";
+			break;
 		case nano::stat::detail::keepalive:
 			res = "keepalive";
 			break;
@@ -751,6 +1041,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::election_restart:
 			res = "election_restart";
 			break;
+		case nano::stat::detail::election_transitions:
+			res = "election_transitions";
+			break;
 		case nano::stat::detail::blocking:
 			res = "blocking";
 			break;
@@ -763,6 +1056,12 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::tcp_accept_failure:
 			res = "accept_failure";
 			break;
+		case nano::stat::detail::tcp_write:
+			res = "tcp_write";
+			break;
+		case nano::stat::detail::tcp_write_coalesced:
+			res = "tcp_write_coalesced";
+			break;
 		case nano::stat::detail::tcp_write_drop:
 			res = "tcp_write_drop";
 			break;
@@ -823,6 +1122,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::aggregator_dropped:
 			res = "aggregator_dropped";
 			break;
+		case nano::stat::detail::aggregator_latency:
+			res = "aggregator_latency";
+			break;
 		case nano::stat::detail::requests_cached_hashes:
 			res = "requests_cached_hashes";
 			break;
@@ -847,9 +1149,21 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::requests_unknown:
 			res = "requests_unknown";
 			break;
+		case nano::stat::detail::requests_skipped_unsolicited:
+			res = "requests_skipped_unsolicited";
+			break;
 		case nano::stat::detail::duplicate_publish:
 			res = "duplicate_publish";
 			break;
+		case nano::stat::detail::exists_filter_negative:
+			res = "exists_filter_negative";
+			break;
+		case nano::stat::detail::exists_filter_positive:
+			res = "exists_filter_positive";
+			break;
+		case nano::stat::detail::exists_filter_false_positive:
+			res = "exists_filter_false_positive";
+			break;
 		case nano::stat::detail::different_genesis_hash:
 			res = "different_genesis_hash";
 			break;
@@ -886,6 +1200,75 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::invalid_network:
 			res = "invalid_network";
 			break;
+		case nano::stat::detail::block_processor_batch:
+			res = "block_processor_batch";
+			break;
+		case nano::stat::detail::vote_verify:
+			res = "vote_verify";
+			break;
+		case nano::stat::detail::vote_apply:
+			res = "vote_apply";
+			break;
+		case nano::stat::detail::election_confirm:
+			res = "election_confirm";
+			break;
+		case nano::stat::detail::request_loop_tick:
+			res = "request_loop_tick";
+			break;
+		case nano::stat::detail::cement:
+			res = "cement";
+			break;
+		case nano::stat::detail::rpc_action:
+			res = "rpc_action";
+			break;
+		case nano::stat::detail::search_pending_accounts:
+			res = "search_pending_accounts";
+			break;
+		case nano::stat::detail::search_pending_found:
+			res = "search_pending_found";
+			break;
+		case nano::stat::detail::receive_batch:
+			res = "receive_batch";
+			break;
+		case nano::stat::detail::work_precompute_queued:
+			res = "work_precompute_queued";
+			break;
+		case nano::stat::detail::work_precompute_generated:
+			res = "work_precompute_generated";
+			break;
+		case nano::stat::detail::work_cache_hit:
+			res = "work_cache_hit";
+			break;
+		case nano::stat::detail::work_cache_miss:
+			res = "work_cache_miss";
+			break;
+		case nano::stat::detail::insert:
+			res = "insert";
+			break;
+		case nano::stat::detail::evict:
+			res = "evict";
+			break;
+		case nano::stat::detail::voter_replaced:
+			res = "voter_replaced";
+			break;
+		case nano::stat::detail::voter_dropped:
+			res = "voter_dropped";
+			break;
+		case nano::stat::detail::pressure_normal:
+			res = "pressure_normal";
+			break;
+		case nano::stat::detail::pressure_elevated:
+			res = "pressure_elevated";
+			break;
+		case nano::stat::detail::pressure_critical:
+			res = "pressure_critical";
+			break;
+		case nano::stat::detail::bootstrap_throttled:
+			res = "bootstrap_throttled";
+			break;
+		case nano::stat::detail::read_paused:
+			res = "read_paused";
+			break;
 	}
 	return res;
 }
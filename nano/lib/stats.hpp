@@ -5,6 +5,8 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <initializer_list>
 #include <map>
@@ -90,9 +92,24 @@ public:
 	 */
 	stat_histogram (std::initializer_list<uint64_t> intervals_a, size_t bin_count_a = 0);
 
+	/** Create histogram with bins defined by consecutive values of \p intervals_a */
+	explicit stat_histogram (std::vector<uint64_t> const & intervals_a);
+
 	/** Add \p addend_a to the histogram bin into which \p index_a falls */
 	void add (uint64_t index_a, uint64_t addend_a);
 
+	/** Reset the value of all bins, keeping their intervals */
+	void clear ();
+
+	/** Sum of all added values, each weighted by its addend */
+	uint64_t get_sum () const;
+
+	/**
+	 * Returns HDR style intervals, [0, 1) followed by \p sub_bins_a linear bins for each power of two up to \p max_a,
+	 * and a catch-all bin for larger values. Relative resolution is constant across the range while keeping the bin count low.
+	 */
+	static std::vector<uint64_t> log_linear_intervals (uint64_t max_a, unsigned sub_bins_a);
+
 	/** Histogram bin with interval, current value and timestamp of last update */
 	class bin final
 	{
@@ -111,6 +128,7 @@ public:
 private:
 	mutable nano::mutex histogram_mutex;
 	std::vector<bin> bins;
+	uint64_t sum{ 0 };
 };
 
 /**
@@ -149,6 +167,47 @@ public:
 	nano::observer_set<uint64_t, uint64_t> count_observers;
 };
 
+/**
+ * Lock free counters used when an update only has to increment a counter, which is the case unless
+ * sampling, counter logging or count observers are configured.
+ * Counters are striped over a fixed number of cache line aligned stripes, and each thread adds to the
+ * stripe it was assigned on first use. Counter blocks are allocated per stat type on first use.
+ * Accumulated values are moved into the stat entries when counters are read.
+ */
+class stat_counters final
+{
+public:
+	stat_counters () = default;
+	stat_counters (stat_counters const &) = delete;
+	~stat_counters ();
+
+	/** Adds \p value_a to the counter for \p key_a in the calling thread's stripe */
+	void add (uint32_t key_a, uint64_t value_a);
+
+	/** Resets the counter for \p key_a in all stripes and returns the sum of their values */
+	uint64_t take (uint32_t key_a);
+
+	/** Resets all counters, calling \p action_a with each key and its accumulated value if non-zero */
+	void take_all (std::function<void (uint32_t, uint64_t)> const & action_a);
+
+	static size_t constexpr stripe_count = 16;
+
+private:
+	/** Counters of a single stat type, indexed by detail and direction */
+	class alignas (64) block final
+	{
+	public:
+		std::array<std::atomic<uint64_t>, 512> values{};
+	};
+	class alignas (64) stripe final
+	{
+	public:
+		std::array<std::atomic<block *>, 256> blocks{};
+	};
+	static size_t index_of (uint32_t key_a);
+	std::array<stripe, stripe_count> stripes;
+};
+
 /** Log sink interface */
 class stat_log_sink
 {
@@ -242,7 +301,11 @@ public:
 		requests,
 		filter,
 		telemetry,
-		vote_generator
+		vote_generator,
+		latency,
+		wallet,
+		inactive_votes_cache,
+		admission
 	};
 
 	/** Optional detail type */
@@ -273,6 +336,7 @@ public:
 		old,
 		gap_previous,
 		gap_source,
+		uncemented_dropped,
 
 		// message specific
 		keepalive,
@@ -323,6 +387,7 @@ public:
 		election_drop_overflow,
 		election_drop_all,
 		election_restart,
+		election_transitions,
 
 		// udp
 		blocking,
@@ -341,6 +406,8 @@ public:
 		// tcp
 		tcp_accept_success,
 		tcp_accept_failure,
+		tcp_write,
+		tcp_write_coalesced,
 		tcp_write_drop,
 		tcp_write_no_socket_drop,
 		tcp_excluded,
@@ -348,6 +415,7 @@ public:
 
 		// ipc
 		invocations,
+		confirmation_drop,
 
 		// peering
 		handshake,
@@ -360,6 +428,7 @@ public:
 		// [request] aggregator
 		aggregator_accepted,
 		aggregator_dropped,
+		aggregator_latency,
 
 		// requests
 		requests_cached_hashes,
@@ -370,10 +439,16 @@ public:
 		requests_cached_late_votes,
 		requests_cannot_vote,
 		requests_unknown,
+		requests_skipped_unsolicited,
 
 		// duplicate
 		duplicate_publish,
 
+		// exists filter
+		exists_filter_negative,
+		exists_filter_positive,
+		exists_filter_false_positive,
+
 		// telemetry
 		invalid_signature,
 		different_genesis_hash,
@@ -387,7 +462,38 @@ public:
 		generator_broadcasts,
 		generator_replies,
 		generator_replies_discarded,
-		generator_spacing
+		generator_spacing,
+
+		// latency
+		block_processor_batch,
+		vote_verify,
+		vote_apply,
+		election_confirm,
+		request_loop_tick,
+		cement,
+		rpc_action,
+
+		// wallet
+		search_pending_accounts,
+		search_pending_found,
+		receive_batch,
+		work_precompute_queued,
+		work_precompute_generated,
+		work_cache_hit,
+		work_cache_miss,
+
+		// inactive votes cache
+		insert,
+		evict,
+		voter_replaced,
+		voter_dropped,
+
+		// admission control
+		pressure_normal,
+		pressure_elevated,
+		pressure_critical,
+		bootstrap_throttled,
+		read_paused
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
@@ -465,6 +571,9 @@ public:
 	 */
 	void define_histogram (stat::type type, stat::detail detail, stat::dir dir, std::initializer_list<uint64_t> intervals_a, size_t bin_count_a = 0);
 
+	/** Define a histogram of latencies in microseconds, with log-linear bins from 1us to about a minute */
+	void define_latency_histogram (stat::type type, stat::detail detail, stat::dir dir);
+
 	/**
 	 * Update histogram
 	 *
@@ -534,10 +643,7 @@ public:
 	 * To avoid recursion, the observer callback must only use the received counts, not query the stat object.
 	 * @param observer The observer receives the old and the new count.
 	 */
-	void observe_count (stat::type type, stat::detail detail, stat::dir dir, std::function<void (uint64_t, uint64_t)> observer)
-	{
-		get_entry (key_of (type, detail, dir))->count_observers.add (observer);
-	}
+	void observe_count (stat::type type, stat::detail detail, stat::dir dir, std::function<void (uint64_t, uint64_t)> observer);
 
 	/** Returns a potentially empty list of the last N samples, where N is determined by the 'capacity' configuration */
 	boost::circular_buffer<stat_datapoint> * samples (stat::type type, stat::detail detail, stat::dir dir)
@@ -552,15 +658,12 @@ public:
 	}
 
 	/** Returns current value for the given counter at the detail level */
-	uint64_t count (stat::type type, stat::detail detail, stat::dir dir = stat::dir::in)
-	{
-		return get_entry (key_of (type, detail, dir))->counter.get_value ();
-	}
+	uint64_t count (stat::type type, stat::detail detail, stat::dir dir = stat::dir::in);
 
 	/** Returns the number of seconds since clear() was last called, or node startup if it's never called. */
 	std::chrono::seconds last_reset ();
 
-	/** Clear all stats */
+	/** Clear all stats. Histogram definitions are kept, with all bins emptied */
 	void clear ();
 
 	/** Log counters to the given log link */
@@ -572,6 +675,9 @@ public:
 	/** Returns a new JSON log sink */
 	std::unique_ptr<stat_log_sink> log_sink_json () const;
 
+	/** Returns a new log sink writing counters and histograms in the Prometheus text exposition format */
+	std::unique_ptr<stat_log_sink> log_sink_prometheus () const;
+
 	/** Returns string representation of detail */
 	static std::string detail_to_string (uint32_t key);
 
@@ -604,6 +710,12 @@ private:
 	 */
 	void update (uint32_t key, uint64_t value);
 
+	/** Moves the value accumulated in the lock free counters for \p key into its stat entry. Must be called with stat_mutex held */
+	void fold_counters (uint32_t key);
+
+	/** Moves all values accumulated in the lock free counters into their stat entries. Must be called with stat_mutex held */
+	void fold_counters ();
+
 	/** Unlocked implementation of log_counters() to avoid using recursive locking */
 	void log_counters_impl (stat_log_sink & sink);
 
@@ -616,6 +728,12 @@ private:
 	/** Configuration deserialized from config.json */
 	nano::stat_config config;
 
+	/** Counts that only need incrementing bypass the stat_mutex and are added to these counters instead */
+	nano::stat_counters counters;
+
+	/** Whether updates can use the lock free counters. Cleared when sampling, counter logging or count observers are used, or when stopped */
+	std::atomic<bool> counters_only{ !config.sampling_enabled && config.log_interval_counters == 0 };
+
 	/** Stat entries are sorted by key to simplify processing of log output */
 	std::map<uint32_t, std::shared_ptr<nano::stat_entry>> entries;
 	std::chrono::steady_clock::time_point log_last_count_writeout{ std::chrono::steady_clock::now () };
@@ -86,6 +86,10 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 			break;
 		case nano::thread_role::name::election_scheduler:
 			thread_role_name_string = "Election Sched";
+			break;
+		case nano::thread_role::name::block_prefetch:
+			thread_role_name_string = "Block prefetch";
+			break;
 	}
 
 	/*
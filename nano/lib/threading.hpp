@@ -38,7 +38,8 @@ namespace thread_role
 		state_block_signature_verification,
 		epoch_upgrader,
 		db_parallel_traversal,
-		election_scheduler
+		election_scheduler,
+		block_prefetch
 	};
 	/*
 	 * Get/Set the identifier for the current thread
@@ -271,6 +271,82 @@ account_info account_info_rpc (boost::asio::io_context & ioc, tcp::resolver::res
 	return account_info;
 }
 
+/** Fires account_block_count requests at a fixed rate for the given duration and returns the latency of each request in microseconds */
+std::vector<uint64_t> rpc_latency_step (boost::asio::io_context & ioc, tcp::resolver::results_type const & results, int qps, std::chrono::seconds duration)
+{
+	boost::property_tree::ptree request;
+	request.put ("action", "account_block_count");
+	request.put ("account", nano::dev::genesis->account ().to_account ());
+	std::stringstream ostream;
+	boost::property_tree::write_json (ostream, request);
+	auto const body = ostream.str ();
+
+	auto const total = static_cast<int> (qps * duration.count ());
+	auto latencies = std::make_shared<std::vector<uint64_t>> ();
+	auto mutex = std::make_shared<std::mutex> ();
+	std::atomic<int> remaining{ total };
+	std::promise<void> promise;
+	auto const interval = std::chrono::microseconds (1000000 / qps);
+	auto const start = std::chrono::steady_clock::now ();
+	for (auto i = 0; i < total; ++i)
+	{
+		boost::asio::spawn (ioc, [&ioc, &results, &body, &remaining, &promise, latencies, mutex, when = start + i * interval] (boost::asio::yield_context yield) {
+			boost::asio::steady_timer timer (ioc, when);
+			timer.async_wait (yield);
+			auto const sent = std::chrono::steady_clock::now ();
+			socket_type socket (ioc);
+			boost::beast::flat_buffer buffer;
+			http::request<http::string_body> req;
+			http::response<http::string_body> res;
+			boost::system::error_code ec;
+			boost::asio::async_connect (socket, results.cbegin (), results.cend (), yield[ec]);
+			if (!ec)
+			{
+				req.method (http::verb::post);
+				req.version (11);
+				req.target ("/");
+				req.body () = body;
+				req.prepare_payload ();
+				http::async_write (socket, req, yield[ec]);
+			}
+			if (!ec)
+			{
+				http::async_read (socket, buffer, res, yield[ec]);
+			}
+			if (!ec && res.result () == http::status::ok)
+			{
+				std::lock_guard<std::mutex> guard (*mutex);
+				latencies->push_back (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - sent).count ());
+			}
+			socket.shutdown (tcp::socket::shutdown_both, ec);
+			if (--remaining == 0)
+			{
+				promise.set_value ();
+			}
+		});
+	}
+	if (total > 0 && promise.get_future ().wait_for (duration + std::chrono::seconds (30)) != std::future_status::ready)
+	{
+		throw std::runtime_error ("RPC latency step timed out");
+	}
+	std::lock_guard<std::mutex> guard (*mutex);
+	return *latencies;
+}
+
+/** Reports p50/p99 RPC latency at a doubling request rate, starting at 100 requests per second */
+void measure_rpc_latency (boost::asio::io_context & ioc, tcp::resolver::results_type const & results, int steps)
+{
+	for (auto i = 0, qps = 100; i < steps; ++i, qps *= 2)
+	{
+		auto latencies = rpc_latency_step (ioc, results, qps, std::chrono::seconds (5));
+		std::sort (latencies.begin (), latencies.end ());
+		auto percentile = [&latencies] (double fraction) {
+			return latencies.empty () ? 0 : latencies[std::min (latencies.size () - 1, static_cast<size_t> (fraction * latencies.size ()))];
+		};
+		std::cout << "RPC latency at " << qps << " requests/s: p50 " << percentile (0.50) << "us, p99 " << percentile (0.99) << "us, " << latencies.size () << "/" << qps * 5 << " succeeded" << std::endl;
+	}
+}
+
 /** This launches a node and fires a lot of send/recieve RPC requests at it (configurable), then other nodes are tested to make sure they observe these blocks as well. */
 int main (int argc, char * const * argv)
 {
@@ -285,6 +361,7 @@ int main (int argc, char * const * argv)
 		("send_count,s", boost::program_options::value<int> ()->default_value (2000), "How many send blocks to generate")
 		("simultaneous_process_calls", boost::program_options::value<int> ()->default_value (20), "Number of simultaneous rpc sends to do")
 		("destination_count", boost::program_options::value<int> ()->default_value (2), "How many destination accounts to choose between")
+		("rpc_latency_steps", boost::program_options::value<int> ()->default_value (0), "Number of doubling request rates, starting at 100 per second, to measure p50/p99 RPC latency at once sends are processed")
 		("node_path", boost::program_options::value<std::string> (), "The path to the nano_node to test")
 		("rpc_path", boost::program_options::value<std::string> (), "The path to the nano_rpc to test");
 	// clang-format on
@@ -305,6 +382,7 @@ int main (int argc, char * const * argv)
 	auto destination_count = vm.find ("destination_count")->second.as<int> ();
 	auto send_count = vm.find ("send_count")->second.as<int> ();
 	auto simultaneous_process_calls = vm.find ("simultaneous_process_calls")->second.as<int> ();
+	auto rpc_latency_steps = vm.find ("rpc_latency_steps")->second.as<int> ();
 
 	boost::system::error_code err;
 	auto running_executable_filepath = boost::dll::program_location (err);
@@ -387,7 +465,7 @@ int main (int argc, char * const * argv)
 	tcp::resolver resolver{ ioc };
 	auto const primary_node_results = resolver.resolve ("::1", std::to_string (rpc_port_start));
 
-	std::thread t ([send_count, &ioc, &primary_node_results, &resolver, &node_count, &destination_count] () {
+	std::thread t ([send_count, rpc_latency_steps, &ioc, &primary_node_results, &resolver, &node_count, &destination_count] () {
 		for (int i = 0; i < node_count; ++i)
 		{
 			keepalive_rpc (ioc, primary_node_results, peering_port_start + i);
@@ -455,6 +533,8 @@ int main (int argc, char * const * argv)
 
 		std::cout << "\rPrimary node processed transactions                " << std::endl;
 
+		measure_rpc_latency (ioc, primary_node_results, rpc_latency_steps);
+
 		std::cout << "Waiting for nodes to catch up..." << std::endl;
 
 		std::map<std::string, account_info> known_account_info;
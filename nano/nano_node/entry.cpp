@@ -2,10 +2,12 @@
 #include <nano/lib/cli.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/nano_node/daemon.hpp>
+#include <nano/node/block_prefetcher.hpp>
 #include <nano/node/cli.hpp>
 #include <nano/node/daemonconfig.hpp>
 #include <nano/node/ipc/ipc_server.hpp>
 #include <nano/node/json_handler.hpp>
+#include <nano/node/ledger_snapshot.hpp>
 #include <nano/node/node.hpp>
 
 #include <boost/dll/runtime_symbol_info.hpp>
@@ -89,8 +91,13 @@ int main (int argc, char * const * argv)
 		("debug_sys_logging", "Test the system logger")
 		("debug_verify_profile", "Profile signature verification")
 		("debug_verify_profile_batch", "Profile batch signature verification")
-		("debug_profile_bootstrap", "Profile bootstrap style blocks processing (at least 10GB of free storage space required)")
+		("debug_profile_bootstrap", "Profile bootstrap style blocks processing (at least 10GB of free storage space required). With RocksDB, compare with --rocksdb_bulk_ingest for ingestion without conflict tracking")
+		("debug_profile_snapshot", "Profile exporting the cemented ledger to a snapshot and importing it into an empty ledger, to compare with debug_profile_bootstrap")
 		("debug_profile_sign", "Profile signature generation")
+		("debug_profile_message_parse", "Profile parsing of realtime messages received from tcp connections, with and without memory pools")
+		("debug_profile_cementing_reads", "Profile reading account chains and their receive sources the way confirmation height iterates them, for <count> accounts (default 10000) with <threads> prefetch threads (default 2, 0 disables prefetching). Drop the OS page cache before each run to compare cold cache throughput")
+		("debug_profile_rocksdb", "Profile block, account and receivable lookups on the RocksDB ledger with each tuning profile")
+		("debug_profile_stats", "Profile stat counter increments from 16 threads, with lock free counters and with every update taking the stat lock")
 		("debug_profile_process", "Profile active blocks processing (only for nano_dev_network)")
 		("debug_profile_votes", "Profile votes processing (only for nano_dev_network)")
 		("debug_profile_frontiers_confirmation", "Profile frontiers confirmation speed (only for nano_dev_network)")
@@ -885,6 +892,77 @@ int main (int argc, char * const * argv)
 				std::cerr << boost::str (boost::format ("%|1$ 12d|\n") % std::chrono::duration_cast<std::chrono::microseconds> (end1 - begin1).count ());
 			}
 		}
+		else if (vm.count ("debug_profile_message_parse"))
+		{
+			size_t const count (1000000);
+			nano::keypair key;
+			auto block (std::make_shared<nano::state_block> (key.pub, 0, key.pub, 0, key.pub, key.prv, key.pub, 0));
+			auto vote (std::make_shared<nano::vote> (key.pub, key.prv, 0, std::vector<nano::block_hash> (12, block->hash ())));
+			auto publish_bytes (nano::publish (block).to_bytes ());
+			auto confirm_req_bytes (nano::confirm_req (block->hash (), block->root ()).to_bytes ());
+			auto confirm_ack_bytes (nano::confirm_ack (vote).to_bytes ());
+			auto use_memory_pools (nano::get_use_memory_pools ());
+			auto profile = [count] (std::string const & name_a, std::vector<uint8_t> const & bytes_a, auto const & parse_a) {
+				for (auto use_memory_pools_l : { true, false })
+				{
+					nano::set_use_memory_pools (use_memory_pools_l);
+					auto begin (std::chrono::high_resolution_clock::now ());
+					for (size_t i (0); i < count; ++i)
+					{
+						auto error (false);
+						nano::bufferstream stream (bytes_a.data (), bytes_a.size ());
+						nano::message_header header (error, stream);
+						release_assert (!error);
+						std::shared_ptr<nano::message> message (parse_a (error, stream, header));
+						release_assert (!error);
+					}
+					auto end (std::chrono::high_resolution_clock::now ());
+					std::cerr << boost::str (boost::format ("%1% messages %2%: %3% ns/message (memory pools %4%)\n") % count % name_a % (std::chrono::duration_cast<std::chrono::nanoseconds> (end - begin).count () / count) % (use_memory_pools_l ? "enabled" : "disabled"));
+				}
+			};
+			profile ("publish", *publish_bytes, [] (bool & error_a, nano::stream & stream_a, nano::message_header const & header_a) {
+				return nano::make_shared<nano::publish> (error_a, stream_a, header_a);
+			});
+			profile ("confirm_req", *confirm_req_bytes, [] (bool & error_a, nano::stream & stream_a, nano::message_header const & header_a) {
+				return nano::make_shared<nano::confirm_req> (error_a, stream_a, header_a);
+			});
+			profile ("confirm_ack", *confirm_ack_bytes, [] (bool & error_a, nano::stream & stream_a, nano::message_header const & header_a) {
+				return nano::make_shared<nano::confirm_ack> (error_a, stream_a, header_a);
+			});
+			nano::set_use_memory_pools (use_memory_pools);
+		}
+		else if (vm.count ("debug_profile_stats"))
+		{
+			size_t const thread_count (16);
+			size_t const count (1000000);
+			auto profile = [thread_count, count] (std::string const & name_a, nano::stat_config const & config_a) {
+				nano::stat stats (config_a);
+				std::vector<std::thread> threads;
+				auto begin (std::chrono::high_resolution_clock::now ());
+				for (size_t i (0); i < thread_count; ++i)
+				{
+					threads.emplace_back ([&stats, count] () {
+						for (size_t j (0); j < count; ++j)
+						{
+							stats.inc (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in);
+						}
+					});
+				}
+				for (auto & thread : threads)
+				{
+					thread.join ();
+				}
+				auto end (std::chrono::high_resolution_clock::now ());
+				release_assert (stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in) == thread_count * count);
+				auto us (std::chrono::duration_cast<std::chrono::microseconds> (end - begin).count ());
+				std::cerr << boost::str (boost::format ("%1% increments from %2% threads (%3%): %4% us, %5% increments/s\n") % (thread_count * count) % thread_count % name_a % us % (thread_count * count * 1000000 / std::max<decltype (us)> (us, 1)));
+			};
+			profile ("lock free counters", nano::stat_config{});
+			// Enabling sampling, even without any sample interval, sends every update through the stat lock
+			nano::stat_config locked;
+			locked.sampling_enabled = true;
+			profile ("locked", locked);
+		}
 		else if (vm.count ("debug_profile_process"))
 		{
 			nano::network_constants::set_active_network (nano::networks::nano_dev_network);
@@ -1859,6 +1937,175 @@ int main (int argc, char * const * argv)
 			std::cout << boost::str (boost::format ("%|1$ 12d| seconds \n%2% blocks per second") % seconds % (block_count * us_in_second / time)) << std::endl;
 			release_assert (node.node->ledger.cache.block_count == block_count);
 		}
+		else if (vm.count ("debug_profile_cementing_reads"))
+		{
+			unsigned prefetch_threads (nano::block_prefetcher::default_threads);
+			auto threads_it = vm.find ("threads");
+			if (threads_it != vm.end () && !boost::conversion::try_lexical_convert (threads_it->second.as<std::string> (), prefetch_threads))
+			{
+				std::cerr << "Invalid threads count\n";
+				return -1;
+			}
+			size_t account_count (10000);
+			auto count_it = vm.find ("count");
+			if (count_it != vm.end () && !boost::conversion::try_lexical_convert (count_it->second.as<std::string> (), account_count))
+			{
+				std::cerr << "Invalid count\n";
+				return -1;
+			}
+			auto inactive_node = nano::default_inactive_node (data_path, vm);
+			auto node = inactive_node->node;
+			std::vector<nano::block_hash> open_blocks;
+			{
+				auto transaction (node->store.tx_begin_read ());
+				for (auto i (node->store.account.begin (transaction)), n (node->store.account.end ()); i != n && open_blocks.size () < account_count; ++i)
+				{
+					open_blocks.push_back (i->second.open_block);
+				}
+			}
+			nano::block_prefetcher prefetcher (node->ledger, prefetch_threads);
+			uint64_t block_count (0);
+			auto begin (std::chrono::steady_clock::now ());
+			{
+				auto transaction (node->store.tx_begin_read ());
+				for (auto const & open : open_blocks)
+				{
+					prefetcher.chain (open, nano::block_prefetcher::max_chain_length, nano::block_prefetcher::direction::successor, true);
+					auto hash (open);
+					while (!hash.is_zero ())
+					{
+						auto block (node->store.block.get (transaction, hash));
+						release_assert (block != nullptr);
+						auto source (block->source ());
+						if (source.is_zero ())
+						{
+							source = block->link ().as_block_hash ();
+						}
+						if (!source.is_zero () && !node->ledger.is_epoch_link (source))
+						{
+							node->store.block.exists (transaction, source);
+						}
+						hash = block->sideband ().successor;
+						++block_count;
+					}
+				}
+			}
+			prefetcher.stop ();
+			auto time (std::max<int64_t> (1, std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin).count ()));
+			std::cout << boost::str (boost::format ("%1% blocks in %2% accounts read in %3% ms with %4% prefetch threads, %5% blocks per second") % block_count % open_blocks.size () % (time / 1000) % prefetch_threads % (block_count * 1000000 / time)) << std::endl;
+		}
+		else if (vm.count ("debug_profile_rocksdb"))
+		{
+			nano::logger_mt logger;
+			nano::rocksdb_config rocksdb_config;
+			rocksdb_config.enable = true;
+			// Sample existing blocks and their accounts, plus as many hashes which are not in the ledger
+			size_t const samples (64 * 1024);
+			std::vector<nano::block_hash> existing;
+			std::vector<nano::account> accounts;
+			std::vector<nano::block_hash> missing;
+			{
+				auto store (nano::make_store (logger, data_path, true, true, rocksdb_config));
+				if (store->init_error ())
+				{
+					std::cerr << "RocksDB ledger could not be opened" << std::endl;
+					result = -1;
+				}
+				else
+				{
+					auto transaction (store->tx_begin_read ());
+					for (size_t i (0); i < samples; ++i)
+					{
+						auto block (store->block.random (transaction));
+						if (block != nullptr)
+						{
+							existing.push_back (block->hash ());
+							accounts.push_back (block->account ().is_zero () ? block->sideband ().account : block->account ());
+						}
+						nano::block_hash hash;
+						nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+						missing.push_back (hash);
+					}
+				}
+			}
+			for (auto profile : { nano::rocksdb_config::tuning_profile::standard, nano::rocksdb_config::tuning_profile::bootstrap, nano::rocksdb_config::tuning_profile::rep, nano::rocksdb_config::tuning_profile::archive_rpc })
+			{
+				if (result != 0)
+				{
+					break;
+				}
+				rocksdb_config.profile = profile;
+				auto store (nano::make_store (logger, data_path, true, true, rocksdb_config));
+				auto transaction (store->tx_begin_read ());
+				auto time = [] (auto const & action_a) {
+					auto begin (std::chrono::steady_clock::now ());
+					action_a ();
+					return std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - begin).count ();
+				};
+				auto lookups = [&] () {
+					for (auto const & hash : existing)
+					{
+						release_assert (store->block.exists (transaction, hash));
+					}
+				};
+				auto misses = [&] () {
+					for (auto const & hash : missing)
+					{
+						store->block.exists (transaction, hash);
+					}
+				};
+				auto account_reads = [&] () {
+					nano::account_info info;
+					for (auto const & account : accounts)
+					{
+						store->account.get (transaction, account, info);
+					}
+				};
+				auto receivable_scans = [&] () {
+					for (auto const & account : accounts)
+					{
+						for (auto i (store->pending.begin (transaction, nano::pending_key (account, 0))), n (store->pending.end ()); i != n && i->first.account == account; ++i)
+						{
+						}
+					}
+				};
+				// The first pass warms the block cache
+				lookups ();
+				account_reads ();
+				auto per_op = [] (int64_t us_a, size_t count_a) {
+					return static_cast<double> (us_a) / std::max<size_t> (count_a, 1);
+				};
+				std::cout << boost::str (boost::format ("%1%: block hit %2% us, block miss %3% us, account %4% us, receivable scan %5% us") % nano::rocksdb_config::serialize_profile (profile) % per_op (time (lookups), existing.size ()) % per_op (time (misses), missing.size ()) % per_op (time (account_reads), accounts.size ()) % per_op (time (receivable_scans), accounts.size ())) << std::endl;
+			}
+		}
+		else if (vm.count ("debug_profile_snapshot"))
+		{
+			auto snapshot_path (nano::unique_path ());
+			nano::ledger_snapshot snapshot (snapshot_path);
+			uint64_t block_count (0);
+			auto begin (std::chrono::high_resolution_clock::now ());
+			{
+				auto node_flags = nano::inactive_node_flag_defaults ();
+				nano::update_flags (node_flags, vm);
+				node_flags.generate_cache.cemented_count = true;
+				nano::inactive_node inactive_node (data_path, node_flags);
+				block_count = inactive_node.node->ledger.cache.cemented_count;
+				std::cout << boost::str (boost::format ("Exporting snapshot, %1% cemented blocks in ledger...") % block_count) << std::endl;
+				release_assert (!snapshot.export_ledger (inactive_node.node->ledger), snapshot.error_message ());
+			}
+			auto exported (std::chrono::high_resolution_clock::now ());
+			auto node_flags = nano::inactive_node_flag_defaults ();
+			node_flags.read_only = false;
+			nano::update_flags (node_flags, vm);
+			nano::inactive_node node (nano::unique_path (), node_flags);
+			release_assert (!snapshot.import_ledger (node.node->store), snapshot.error_message ());
+			auto end (std::chrono::high_resolution_clock::now ());
+			auto export_time (std::chrono::duration_cast<std::chrono::microseconds> (exported - begin).count ());
+			auto import_time (std::chrono::duration_cast<std::chrono::microseconds> (end - exported).count ());
+			auto us_in_second (1000000);
+			nano::remove_temporary_directories ();
+			std::cout << boost::str (boost::format ("Export %|1$ 12d| seconds, %2% chunks\nImport %|3$ 12d| seconds (time to usable ledger)\n%4% blocks per second") % (export_time / us_in_second) % snapshot.chunks ().size () % (import_time / us_in_second) % (block_count * us_in_second / std::max<int64_t> (import_time, 1))) << std::endl;
+		}
 		else if (vm.count ("debug_peers"))
 		{
 			auto inactive_node = nano::default_inactive_node (data_path, vm);
@@ -25,16 +25,25 @@ nano::active_transactions::active_transactions (nano::node & node_a, nano::confi
 	generator{ node_a.config, node_a.ledger, node_a.wallets, node_a.vote_processor, node_a.history, node_a.network, node_a.stats, false },
 	final_generator{ node_a.config, node_a.ledger, node_a.wallets, node_a.vote_processor, node_a.history, node_a.network, node_a.stats, true },
 	election_time_to_live{ node_a.network_params.network.is_dev_network () ? 0s : 2s },
+	inactive_votes_cache{ node_a.flags.inactive_votes_cache_size, node_a.stats },
 	thread ([this] () {
 		nano::thread_role::set (nano::thread_role::name::request_loop);
 		request_loop ();
 	})
 {
+	node.stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::election_confirm, nano::stat::dir::in);
+	node.stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::request_loop_tick, nano::stat::dir::in);
+
 	// Register a callback which will get called after a block is cemented
 	confirmation_height_processor.add_cemented_observer ([this] (std::shared_ptr<nano::block> const & callback_block_a) {
 		this->block_cemented_callback (callback_block_a);
 	});
 
+	// Register a callback which will get called after all blocks of a cemented batch were notified
+	confirmation_height_processor.add_cemented_batch_observer ([this] (std::vector<std::shared_ptr<nano::block>> const &) {
+		this->block_cemented_batch_callback ();
+	});
+
 	// Register a callback which will get called if a block is already cemented
 	confirmation_height_processor.add_block_already_cemented_observer ([this] (nano::block_hash const & hash_a) {
 		this->block_already_cemented_callback (hash_a);
@@ -247,19 +256,29 @@ void nano::active_transactions::block_cemented_callback (std::shared_ptr<nano::b
 
 		if (cemented_bootstrap_count_reached && was_active && low_active_elections ())
 		{
-			// Start or vote for the next unconfirmed block
-			scheduler.activate (account, transaction);
+			// Start or vote for the next unconfirmed block, once the whole batch is cemented
+			cemented_activations.push_back (account);
 
 			// Start or vote for the next unconfirmed block in the destination account
 			auto const & destination (node.ledger.block_destination (transaction, *block_a));
 			if (!destination.is_zero () && destination != account)
 			{
-				scheduler.activate (destination, transaction);
+				cemented_activations.push_back (destination);
 			}
 		}
 	}
 }
 
+void nano::active_transactions::block_cemented_batch_callback ()
+{
+	if (!cemented_activations.empty ())
+	{
+		std::vector<nano::account> accounts;
+		accounts.swap (cemented_activations);
+		scheduler.activate (std::move (accounts), node.store.tx_begin_read ());
+	}
+}
+
 void nano::active_transactions::add_election_winner_details (nano::block_hash const & hash_a, std::shared_ptr<nano::election> const & election_a)
 {
 	nano::lock_guard<nano::mutex> guard (election_winner_details_mutex);
@@ -291,9 +310,30 @@ int64_t nano::active_transactions::vacancy () const
 void nano::active_transactions::request_confirm (nano::unique_lock<nano::mutex> & lock_a)
 {
 	debug_assert (lock_a.owns_lock ());
+	auto const tick_start (std::chrono::steady_clock::now ());
 
-	size_t const this_loop_target_l (roots.size ());
-	auto const elections_l{ list_active_impl (this_loop_target_l) };
+	std::vector<std::shared_ptr<nano::election>> elections_l;
+	{
+		nano::lock_guard<nano::mutex> guard (transitions_mutex);
+		auto const due_l (transitions.upper_bound (std::chrono::steady_clock::now ()));
+		for (auto i (transitions.begin ()); i != due_l; ++i)
+		{
+			auto election_l (i->second.lock ());
+			if (election_l != nullptr && election_l->scheduled_transition.load () == i->first.time_since_epoch ())
+			{
+				election_l->scheduled_transition = std::chrono::steady_clock::duration::zero ();
+				elections_l.push_back (election_l);
+			}
+		}
+		transitions.erase (transitions.begin (), due_l);
+	}
+	// Skip elections erased since they were scheduled
+	elections_l.erase (std::remove_if (elections_l.begin (), elections_l.end (), [this] (auto const & election_a) {
+		auto existing (roots.get<tag_root> ().find (election_a->qualified_root));
+		return existing == roots.get<tag_root> ().end () || existing->election != election_a;
+	}),
+	elections_l.end ());
+	size_t const this_loop_target_l (elections_l.size ());
 
 	lock_a.unlock ();
 
@@ -307,7 +347,7 @@ void nano::active_transactions::request_confirm (nano::unique_lock<nano::mutex>
 	nano::timer<std::chrono::milliseconds> elapsed (nano::timer_state::started);
 
 	/*
-	 * Loop through active elections in descending order of proof-of-work difficulty, requesting confirmation
+	 * Loop through the due elections in order of their scheduled transition, requesting confirmation
 	 *
 	 * Only up to a certain amount of elections are queued for confirmation request and block rebroadcasting. The remaining elections can still be confirmed if votes arrive
 	 * Elections extending the soft config.active_elections_size limit are flushed after a certain time-to-live cutoff
@@ -337,11 +377,17 @@ void nano::active_transactions::request_confirm (nano::unique_lock<nano::mutex>
 			}
 			erase (election_l->qualified_root);
 		}
+		else
+		{
+			schedule (election_l, election_l->next_transition ());
+		}
 	}
+	node.stats.add (nano::stat::type::election, nano::stat::detail::election_transitions, nano::stat::dir::in, this_loop_target_l);
 
 	solicitor.flush ();
 	generator_session.flush ();
 	final_generator_session.flush ();
+	node.stats.update_histogram (nano::stat::type::latency, nano::stat::detail::request_loop_tick, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - tick_start).count ());
 	lock_a.lock ();
 
 	if (node.config.logging.timing_logging ())
@@ -350,6 +396,17 @@ void nano::active_transactions::request_confirm (nano::unique_lock<nano::mutex>
 	}
 }
 
+void nano::active_transactions::schedule (std::shared_ptr<nano::election> const & election_a, std::chrono::steady_clock::time_point const & time_a)
+{
+	nano::lock_guard<nano::mutex> guard (transitions_mutex);
+	auto const scheduled_l (election_a->scheduled_transition.load ());
+	if (scheduled_l == std::chrono::steady_clock::duration::zero () || time_a.time_since_epoch () < scheduled_l)
+	{
+		election_a->scheduled_transition = time_a.time_since_epoch ();
+		transitions.emplace (time_a, election_a);
+	}
+}
+
 void nano::active_transactions::cleanup_election (nano::unique_lock<nano::mutex> & lock_a, nano::election const & election)
 {
 	if (!election.confirmed ())
@@ -363,7 +420,7 @@ void nano::active_transactions::cleanup_election (nano::unique_lock<nano::mutex>
 		auto erased (blocks.erase (hash));
 		(void)erased;
 		debug_assert (erased == 1);
-		erase_inactive_votes_cache (hash);
+		inactive_votes_cache.erase (hash);
 	}
 	roots.get<tag_root> ().erase (roots.get<tag_root> ().find (election.qualified_root));
 
@@ -586,8 +643,17 @@ void nano::active_transactions::request_loop ()
 
 		if (!stopped)
 		{
+			// Wake up early for a transition due before the next interval
+			auto next_transition_l (std::chrono::steady_clock::time_point::max ());
+			{
+				nano::lock_guard<nano::mutex> guard (transitions_mutex);
+				if (!transitions.empty ())
+				{
+					next_transition_l = transitions.begin ()->first;
+				}
+			}
 			const auto min_sleep_l = std::chrono::milliseconds (node.network_params.network.request_interval_ms / 2);
-			const auto wakeup_l = std::max (stamp_l + std::chrono::milliseconds (node.network_params.network.request_interval_ms), std::chrono::steady_clock::now () + min_sleep_l);
+			const auto wakeup_l = std::max (std::min (stamp_l + std::chrono::milliseconds (node.network_params.network.request_interval_ms), next_transition_l), std::chrono::steady_clock::now () + min_sleep_l);
 			condition.wait_until (lock, wakeup_l, [&wakeup_l, &stopped = stopped] { return stopped || std::chrono::steady_clock::now () >= wakeup_l; });
 		}
 	}
@@ -736,37 +802,83 @@ void nano::active_transactions::prioritize_frontiers_for_confirmation (nano::tra
 		}
 
 		nano::timer<std::chrono::milliseconds> timer (nano::timer_state::started);
-		auto i (node.store.account.begin (transaction_a, next_frontier_account));
-		auto n (node.store.account.end ());
-		for (; i != n && should_iterate (); ++i)
+		if (!node.ledger.uncemented.complete ())
 		{
-			auto const & account (i->first);
-			auto const & info (i->second);
-			if (priority_wallet_cementable_frontiers.find (account) == priority_wallet_cementable_frontiers.end ())
+			// The uncemented index left accounts out, the whole accounts table has to be traversed
+			auto i (node.store.account.begin (transaction_a, next_frontier_account));
+			auto n (node.store.account.end ());
+			for (; i != n && should_iterate (); ++i)
 			{
-				if (expired_optimistic_election_infos.get<tag_account> ().count (account) == 0)
+				auto const & account (i->first);
+				auto const & info (i->second);
+				if (priority_wallet_cementable_frontiers.find (account) == priority_wallet_cementable_frontiers.end ())
 				{
-					nano::confirmation_height_info confirmation_height_info;
-					node.store.confirmation_height.get (transaction_a, account, confirmation_height_info);
-					auto insert_newed = prioritize_account_for_confirmation (priority_cementable_frontiers, priority_cementable_frontiers_size, account, info, confirmation_height_info.height);
-					if (insert_newed)
+					if (expired_optimistic_election_infos.get<tag_account> ().count (account) == 0)
 					{
-						++num_new_inserted;
+						nano::confirmation_height_info confirmation_height_info;
+						node.store.confirmation_height.get (transaction_a, account, confirmation_height_info);
+						auto insert_newed = prioritize_account_for_confirmation (priority_cementable_frontiers, priority_cementable_frontiers_size, account, info, confirmation_height_info.height);
+						if (insert_newed)
+						{
+							++num_new_inserted;
+						}
 					}
 				}
+				next_frontier_account = account.number () + 1;
+				if (timer.since_start () >= ledger_account_traversal_max_time_a)
+				{
+					break;
+				}
 			}
-			next_frontier_account = account.number () + 1;
-			if (timer.since_start () >= ledger_account_traversal_max_time_a)
+
+			// Go back to the beginning when we have reached the end of the accounts and start with wallet accounts next time
+			if (i == n)
 			{
-				break;
+				next_frontier_account = 0;
+				skip_wallets = false;
 			}
 		}
-
-		// Go back to the beginning when we have reached the end of the accounts and start with wallet accounts next time
-		if (i == n)
+		else
 		{
-			next_frontier_account = 0;
-			skip_wallets = false;
+			// Only accounts in the uncemented index can have uncemented blocks, so the accounts table is not traversed
+			auto done (false);
+			while (!done && should_iterate ())
+			{
+				auto frontiers (node.ledger.uncemented.next (next_frontier_account, uncemented_batch_size));
+				auto i (frontiers.begin ());
+				auto n (frontiers.end ());
+				for (; i != n && should_iterate (); ++i)
+				{
+					auto const & [account, entry] = *i;
+					if (priority_wallet_cementable_frontiers.find (account) == priority_wallet_cementable_frontiers.end ())
+					{
+						if (expired_optimistic_election_infos.get<tag_account> ().count (account) == 0)
+						{
+							nano::account_info info;
+							info.head = entry.head;
+							info.block_count = entry.block_count;
+							auto insert_newed = prioritize_account_for_confirmation (priority_cementable_frontiers, priority_cementable_frontiers_size, account, info, entry.cemented_height);
+							if (insert_newed)
+							{
+								++num_new_inserted;
+							}
+						}
+					}
+					next_frontier_account = account.number () + 1;
+					if (timer.since_start () >= ledger_account_traversal_max_time_a)
+					{
+						break;
+					}
+				}
+
+				// Go back to the beginning when we have reached the end of the accounts and start with wallet accounts next time
+				if (i == n && frontiers.size () < uncemented_batch_size)
+				{
+					next_frontier_account = 0;
+					skip_wallets = false;
+				}
+				done = i != n || frontiers.size () < uncemented_batch_size || timer.since_start () >= ledger_account_traversal_max_time_a;
+			}
 		}
 	}
 }
@@ -789,6 +901,8 @@ void nano::active_transactions::stop ()
 	final_generator.stop ();
 	lock.lock ();
 	roots.clear ();
+	nano::lock_guard<nano::mutex> guard (transitions_mutex);
+	transitions.clear ();
 }
 
 nano::election_insertion_result nano::active_transactions::insert_impl (nano::unique_lock<nano::mutex> & lock_a, std::shared_ptr<nano::block> const & block_a, boost::optional<nano::uint128_t> const & previous_balance_a, nano::election_behavior election_behavior_a, std::function<void (std::shared_ptr<nano::block> const &)> const & confirmation_action_a)
@@ -825,7 +939,8 @@ nano::election_insertion_result nano::active_transactions::insert_impl (nano::un
 				election_behavior_a);
 				roots.get<tag_root> ().emplace (nano::active_transactions::conflict_info{ root, result.election, epoch, previous_balance });
 				blocks.emplace (hash, result.election);
-				auto const cache = find_inactive_votes_cache_impl (hash);
+				schedule (result.election, result.election->next_transition ());
+				auto const cache = inactive_votes_cache.find (hash);
 				lock_a.unlock ();
 				result.election->insert_inactive_votes_cache (cache);
 				node.stats.inc (nano::stat::type::election, nano::stat::detail::election_start);
@@ -1058,7 +1173,7 @@ bool nano::active_transactions::publish (std::shared_ptr<nano::block> const & bl
 		{
 			lock.lock ();
 			blocks.emplace (block_a->hash (), election);
-			auto const cache = find_inactive_votes_cache_impl (block_a->hash ());
+			auto const cache = inactive_votes_cache.find (block_a->hash ());
 			lock.unlock ();
 			election->insert_inactive_votes_cache (cache);
 			node.stats.inc (nano::stat::type::election, nano::stat::detail::election_block_conflict);
@@ -1121,73 +1236,26 @@ size_t nano::active_transactions::priority_wallet_cementable_frontiers_size ()
 
 size_t nano::active_transactions::inactive_votes_cache_size ()
 {
-	nano::lock_guard<nano::mutex> guard (mutex);
 	return inactive_votes_cache.size ();
 }
 
 void nano::active_transactions::add_inactive_votes_cache (nano::unique_lock<nano::mutex> & lock_a, nano::block_hash const & hash_a, nano::account const & representative_a, uint64_t const timestamp_a)
 {
 	// Check principal representative status
-	if (node.ledger.weight (representative_a) > node.minimum_principal_weight ())
+	auto const weight (node.ledger.weight (representative_a));
+	if (weight > node.minimum_principal_weight ())
 	{
 		/** It is important that the new vote is added to the cache before calling inactive_votes_bootstrap_check
 		 * This guarantees consistency when a vote is received while also receiving the corresponding block
 		 */
-		auto & inactive_by_hash (inactive_votes_cache.get<tag_hash> ());
-		auto existing (inactive_by_hash.find (hash_a));
-		if (existing != inactive_by_hash.end ())
-		{
-			if (existing->needs_eval ())
-			{
-				auto is_new (false);
-				inactive_by_hash.modify (existing, [representative_a, timestamp_a, &is_new] (nano::inactive_cache_information & info) {
-					auto it = std::find_if (info.voters.begin (), info.voters.end (), [&representative_a] (auto const & item_a) { return item_a.first == representative_a; });
-					is_new = (it == info.voters.end ());
-					if (is_new)
-					{
-						info.arrival = std::chrono::steady_clock::now ();
-						info.voters.emplace_back (representative_a, timestamp_a);
-					}
-				});
-
-				if (is_new)
-				{
-					auto const old_status = existing->status;
-					auto const status = inactive_votes_bootstrap_check (lock_a, existing->voters, hash_a, existing->status);
-					if (status != old_status)
-					{
-						// The lock has since been released
-						existing = inactive_by_hash.find (hash_a);
-						if (existing != inactive_by_hash.end ())
-						{
-							inactive_by_hash.modify (existing, [status] (nano::inactive_cache_information & info) {
-								info.status = status;
-							});
-						}
-					}
-				}
-			}
-		}
-		else
+		nano::inactive_cache_status previously;
+		size_t voters (0);
+		if (!inactive_votes_cache.vote (hash_a, representative_a, timestamp_a, weight, previously, voters))
 		{
-			auto & inactive_by_arrival (inactive_votes_cache.get<tag_arrival> ());
-			nano::inactive_cache_status default_status{};
-			inactive_by_arrival.emplace (nano::inactive_cache_information{ std::chrono::steady_clock::now (), hash_a, representative_a, timestamp_a, default_status });
-			auto const status (inactive_votes_bootstrap_check (lock_a, representative_a, hash_a, default_status));
-			if (status != default_status)
-			{
-				// The lock has since been released
-				existing = inactive_by_hash.find (hash_a);
-				if (existing != inactive_by_hash.end ())
-				{
-					inactive_by_hash.modify (existing, [status] (nano::inactive_cache_information & info) {
-						info.status = status;
-					});
-				}
-			}
-			if (inactive_votes_cache.size () > node.flags.inactive_votes_cache_size)
+			auto const status (inactive_votes_bootstrap_check (lock_a, previously.tally, voters, hash_a, previously));
+			if (status != previously)
 			{
-				inactive_by_arrival.erase (inactive_by_arrival.begin ());
+				inactive_votes_cache.update (hash_a, status);
 			}
 		}
 	}
@@ -1196,7 +1264,7 @@ void nano::active_transactions::add_inactive_votes_cache (nano::unique_lock<nano
 void nano::active_transactions::trigger_inactive_votes_cache_election (std::shared_ptr<nano::block> const & block_a)
 {
 	nano::unique_lock<nano::mutex> lock (mutex);
-	auto const status = find_inactive_votes_cache_impl (block_a->hash ()).status;
+	auto const status = inactive_votes_cache.find (block_a->hash ()).status;
 	if (status.election_started)
 	{
 		insert_impl (lock, block_a);
@@ -1205,37 +1273,15 @@ void nano::active_transactions::trigger_inactive_votes_cache_election (std::shar
 
 nano::inactive_cache_information nano::active_transactions::find_inactive_votes_cache (nano::block_hash const & hash_a)
 {
-	nano::lock_guard<nano::mutex> guard (mutex);
-	return find_inactive_votes_cache_impl (hash_a);
-}
-
-nano::inactive_cache_information nano::active_transactions::find_inactive_votes_cache_impl (nano::block_hash const & hash_a)
-{
-	auto & inactive_by_hash (inactive_votes_cache.get<tag_hash> ());
-	auto existing (inactive_by_hash.find (hash_a));
-	if (existing != inactive_by_hash.end ())
-	{
-		return *existing;
-	}
-	else
-	{
-		return nano::inactive_cache_information{};
-	}
+	return inactive_votes_cache.find (hash_a);
 }
 
 void nano::active_transactions::erase_inactive_votes_cache (nano::block_hash const & hash_a)
 {
-	inactive_votes_cache.get<tag_hash> ().erase (hash_a);
+	inactive_votes_cache.erase (hash_a);
 }
 
-nano::inactive_cache_status nano::active_transactions::inactive_votes_bootstrap_check (nano::unique_lock<nano::mutex> & lock_a, nano::account const & voter_a, nano::block_hash const & hash_a, nano::inactive_cache_status const & previously_a)
-{
-	debug_assert (lock_a.owns_lock ());
-	lock_a.unlock ();
-	return inactive_votes_bootstrap_check_impl (lock_a, node.ledger.weight (voter_a), 1, hash_a, previously_a);
-}
-
-nano::inactive_cache_status nano::active_transactions::inactive_votes_bootstrap_check (nano::unique_lock<nano::mutex> & lock_a, std::vector<std::pair<nano::account, uint64_t>> const & voters_a, nano::block_hash const & hash_a, nano::inactive_cache_status const & previously_a)
+nano::inactive_cache_status nano::active_transactions::inactive_votes_bootstrap_check (nano::unique_lock<nano::mutex> & lock_a, nano::uint128_t const & tally_a, size_t voters_size_a, nano::block_hash const & hash_a, nano::inactive_cache_status const & previously_a)
 {
 	/** Perform checks on accumulated tally from inactive votes
 	 * These votes are generally either for unconfirmed blocks or old confirmed blocks
@@ -1243,19 +1289,6 @@ nano::inactive_cache_status nano::active_transactions::inactive_votes_bootstrap_
 	 */
 	debug_assert (lock_a.owns_lock ());
 	lock_a.unlock ();
-
-	nano::uint128_t tally;
-	for (auto const & [voter, timestamp] : voters_a)
-	{
-		tally += node.ledger.weight (voter);
-	}
-
-	return inactive_votes_bootstrap_check_impl (lock_a, tally, voters_a.size (), hash_a, previously_a);
-}
-
-nano::inactive_cache_status nano::active_transactions::inactive_votes_bootstrap_check_impl (nano::unique_lock<nano::mutex> & lock_a, nano::uint128_t const & tally_a, size_t voters_size_a, nano::block_hash const & hash_a, nano::inactive_cache_status const & previously_a)
-{
-	debug_assert (!lock_a.owns_lock ());
 	nano::inactive_cache_status status (previously_a);
 	const unsigned election_start_voters_min = node.network_params.network.is_dev_network () ? 2 : node.network_params.network.is_beta_network () ? 5 : 15;
 	status.tally = tally_a;
@@ -1296,11 +1329,6 @@ nano::inactive_cache_status nano::active_transactions::inactive_votes_bootstrap_
 	return status;
 }
 
-bool nano::purge_singleton_inactive_votes_cache_pool_memory ()
-{
-	return boost::singleton_pool<boost::fast_pool_allocator_tag, sizeof (nano::active_transactions::ordered_cache::node_type)>::purge_memory ();
-}
-
 size_t nano::active_transactions::election_winner_details_size ()
 {
 	nano::lock_guard<nano::mutex> guard (election_winner_details_mutex);
@@ -1347,7 +1375,7 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (ac
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "priority_wallet_cementable_frontiers", active_transactions.priority_wallet_cementable_frontiers_size (), sizeof (nano::cementable_account) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "priority_cementable_frontiers", active_transactions.priority_cementable_frontiers_size (), sizeof (nano::cementable_account) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "expired_optimistic_election_infos", active_transactions.expired_optimistic_election_infos_size, sizeof (decltype (active_transactions.expired_optimistic_election_infos)::value_type) }));
-	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "inactive_votes_cache", active_transactions.inactive_votes_cache_size (), sizeof (nano::gap_information) }));
+	composite->add_component (active_transactions.inactive_votes_cache.collect_container_info ("inactive_votes_cache"));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "optimistic_elections_count", active_transactions.optimistic_elections_count, 0 })); // This isn't an extra container, is just to expose the count easily
 	composite->add_component (collect_container_info (active_transactions.generator, "generator"));
 	return composite;
@@ -2,6 +2,7 @@
 
 #include <nano/lib/numbers.hpp>
 #include <nano/node/election.hpp>
+#include <nano/node/inactive_votes_cache.hpp>
 #include <nano/node/voting.hpp>
 #include <nano/secure/common.hpp>
 
@@ -18,6 +19,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -51,43 +53,6 @@ public:
 	nano::qualified_root root;
 };
 
-class inactive_cache_status final
-{
-public:
-	bool bootstrap_started{ false };
-	bool election_started{ false }; // Did item reach config threshold to start an impromptu election?
-	bool confirmed{ false }; // Did item reach votes quorum? (minimum config value)
-	nano::uint128_t tally{ 0 }; // Last votes tally for block
-
-	bool operator!= (inactive_cache_status const other) const
-	{
-		return bootstrap_started != other.bootstrap_started || election_started != other.election_started || confirmed != other.confirmed || tally != other.tally;
-	}
-};
-
-class inactive_cache_information final
-{
-public:
-	inactive_cache_information () = default;
-	inactive_cache_information (std::chrono::steady_clock::time_point arrival, nano::block_hash hash, nano::account initial_rep_a, uint64_t initial_timestamp_a, nano::inactive_cache_status status) :
-		arrival (arrival),
-		hash (hash),
-		status (status)
-	{
-		voters.reserve (8);
-		voters.emplace_back (initial_rep_a, initial_timestamp_a);
-	}
-
-	std::chrono::steady_clock::time_point arrival;
-	nano::block_hash hash;
-	nano::inactive_cache_status status;
-	std::vector<std::pair<nano::account, uint64_t>> voters;
-	bool needs_eval () const
-	{
-		return !status.bootstrap_started || !status.election_started || !status.confirmed;
-	}
-};
-
 class expired_optimistic_election_info final
 {
 public:
@@ -135,7 +100,6 @@ class active_transactions final
 	class tag_root {};
 	class tag_sequence {};
 	class tag_uncemented {};
-	class tag_arrival {};
 	class tag_hash {};
 	class tag_expired_time {};
 	class tag_election_started {};
@@ -172,6 +136,8 @@ public:
 	bool publish (std::shared_ptr<nano::block> const &);
 	boost::optional<nano::election_status_type> confirm_block (nano::transaction const &, std::shared_ptr<nano::block> const &);
 	void block_cemented_callback (std::shared_ptr<nano::block> const &);
+	// Activates the successors of the blocks cemented in the batch, which block_cemented_callback queued up
+	void block_cemented_batch_callback ();
 	void block_already_cemented_callback (nano::block_hash const &);
 
 	int64_t vacancy () const;
@@ -203,32 +169,22 @@ public:
 	nano::vote_generator generator;
 	nano::vote_generator final_generator;
 
-#ifdef MEMORY_POOL_DISABLED
-	using allocator = std::allocator<nano::inactive_cache_information>;
-#else
-	using allocator = boost::fast_pool_allocator<nano::inactive_cache_information>;
-#endif
-
-	// clang-format off
-	using ordered_cache = boost::multi_index_container<nano::inactive_cache_information,
-	mi::indexed_by<
-		mi::ordered_non_unique<mi::tag<tag_arrival>,
-			mi::member<nano::inactive_cache_information, std::chrono::steady_clock::time_point, &nano::inactive_cache_information::arrival>>,
-		mi::hashed_unique<mi::tag<tag_hash>,
-			mi::member<nano::inactive_cache_information, nano::block_hash, &nano::inactive_cache_information::hash>>>, allocator>;
-	// clang-format on
-
 private:
 	nano::mutex election_winner_details_mutex{ mutex_identifier (mutexes::election_winner_details) };
 
 	std::unordered_map<nano::block_hash, std::shared_ptr<nano::election>> election_winner_details;
+	// Accounts to activate once every block of the cemented batch has been notified, only used by the confirmation height processor thread
+	std::vector<nano::account> cemented_activations;
 
 	// Call action with confirmed block, may be different than what we started with
 	// clang-format off
 	nano::election_insertion_result insert_impl (nano::unique_lock<nano::mutex> &, std::shared_ptr<nano::block> const&, boost::optional<nano::uint128_t> const & = boost::none, nano::election_behavior = nano::election_behavior::normal, std::function<void(std::shared_ptr<nano::block>const&)> const & = nullptr);
 	// clang-format on
 	void request_loop ();
+	// Calls transition_time on the elections whose scheduled transition is due
 	void request_confirm (nano::unique_lock<nano::mutex> &);
+	// Schedules the next transition of an election at \p time_a unless an earlier one is already scheduled
+	void schedule (std::shared_ptr<nano::election> const &, std::chrono::steady_clock::time_point const & time_a);
 	void erase (nano::qualified_root const &);
 	// Erase all blocks from active and, if not confirmed, clear digests from network filters
 	void cleanup_election (nano::unique_lock<nano::mutex> & lock_a, nano::election const &);
@@ -239,6 +195,10 @@ private:
 	bool started{ false };
 	std::atomic<bool> stopped{ false };
 
+	/** Deadline queue of election transitions. Entries superseded by an earlier schedule or outliving their election are skipped when due */
+	std::multimap<std::chrono::steady_clock::time_point, std::weak_ptr<nano::election>> transitions;
+	nano::mutex transitions_mutex;
+
 	// Maximum time an election can be kept active if it is extending the container
 	std::chrono::seconds const election_time_to_live;
 
@@ -296,12 +256,12 @@ private:
 	bool should_do_frontiers_confirmation () const;
 	static size_t constexpr max_priority_cementable_frontiers{ 100000 };
 	static size_t constexpr confirmed_frontiers_max_pending_size{ 10000 };
+	/** Number of uncemented index entries copied out per lock when prioritizing frontiers */
+	static size_t constexpr uncemented_batch_size{ 1024 };
 	static std::chrono::minutes constexpr expired_optimistic_election_info_cutoff{ 30 };
-	ordered_cache inactive_votes_cache;
-	nano::inactive_cache_status inactive_votes_bootstrap_check (nano::unique_lock<nano::mutex> &, std::vector<std::pair<nano::account, uint64_t>> const &, nano::block_hash const &, nano::inactive_cache_status const &);
-	nano::inactive_cache_status inactive_votes_bootstrap_check (nano::unique_lock<nano::mutex> &, nano::account const &, nano::block_hash const &, nano::inactive_cache_status const &);
-	nano::inactive_cache_status inactive_votes_bootstrap_check_impl (nano::unique_lock<nano::mutex> &, nano::uint128_t const &, size_t, nano::block_hash const &, nano::inactive_cache_status const &);
-	nano::inactive_cache_information find_inactive_votes_cache_impl (nano::block_hash const &);
+	nano::inactive_votes_cache inactive_votes_cache;
+	// Checks the running tally and voter count of an inactive votes cache entry against the election and bootstrap thresholds, releasing the mutex meanwhile
+	nano::inactive_cache_status inactive_votes_bootstrap_check (nano::unique_lock<nano::mutex> &, nano::uint128_t const &, size_t, nano::block_hash const &, nano::inactive_cache_status const &);
 	boost::thread thread;
 
 	friend class election;
@@ -316,8 +276,8 @@ private:
 	friend class node_deferred_dependent_elections_Test;
 	friend class active_transactions_pessimistic_elections_Test;
 	friend class frontiers_confirmation_expired_optimistic_elections_removal_Test;
+	friend class active_transactions_schedule_transitions_Test;
 };
 
-bool purge_singleton_inactive_votes_cache_pool_memory ();
 std::unique_ptr<container_info_component> collect_container_info (active_transactions & active_transactions, std::string const & name);
 }
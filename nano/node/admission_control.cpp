@@ -0,0 +1,92 @@
+#include <nano/lib/stats.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/node/admission_control.hpp>
+
+#include <algorithm>
+
+std::chrono::milliseconds constexpr nano::admission_control::default_max_drain_time;
+std::chrono::milliseconds constexpr nano::admission_control::sample_interval;
+std::chrono::milliseconds constexpr nano::admission_control::read_pause;
+
+namespace
+{
+// Weight given to the processing rate of the latest sample
+double constexpr rate_weight = 1.0 / 4;
+}
+
+nano::admission_control::admission_control (nano::stat & stats_a, std::chrono::milliseconds max_drain_time_a) :
+	stats (stats_a),
+	max_drain_time (max_drain_time_a),
+	last_sample (std::chrono::steady_clock::now ())
+{
+}
+
+void nano::admission_control::add (std::function<std::size_t ()> const & size_a, std::size_t capacity_a, std::function<uint64_t ()> const & processed_a)
+{
+	debug_assert (capacity_a > 0);
+	queue queue_l;
+	queue_l.size = size_a;
+	queue_l.capacity = std::max<std::size_t> (capacity_a, 1);
+	queue_l.processed = processed_a;
+	queue_l.last_processed = processed_a ();
+	nano::lock_guard<nano::mutex> guard (mutex);
+	queues.push_back (std::move (queue_l));
+}
+
+nano::admission_control::pressure nano::admission_control::level () const
+{
+	return current.load ();
+}
+
+bool nano::admission_control::throttle_bootstrap ()
+{
+	auto result (level () != pressure::normal);
+	if (result)
+	{
+		stats.inc (nano::stat::type::admission, nano::stat::detail::bootstrap_throttled);
+	}
+	return result;
+}
+
+bool nano::admission_control::pause_read (std::function<bool ()> const & principal_representative_a)
+{
+	auto result (level () == pressure::critical && !principal_representative_a ());
+	if (result)
+	{
+		stats.inc (nano::stat::type::admission, nano::stat::detail::read_paused);
+	}
+	return result;
+}
+
+void nano::admission_control::sample (std::chrono::steady_clock::time_point const & now_a)
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	// Samples are normally sample_interval apart, the floor only avoids dividing by zero
+	auto seconds (std::max (std::chrono::duration<double> (now_a - last_sample).count (), 0.001));
+	last_sample = now_a;
+	auto result (pressure::normal);
+	for (auto & queue_l : queues)
+	{
+		auto size_l (queue_l.size ());
+		auto processed_l (queue_l.processed ());
+		auto rate_l ((processed_l - queue_l.last_processed) / seconds);
+		queue_l.last_processed = processed_l;
+		queue_l.rate += (rate_l - queue_l.rate) * rate_weight;
+		if (queue_l.rate < min_rate)
+		{
+			// The smoothed rate only decays towards zero, an idle queue must not look like a slow one
+			queue_l.rate = 0;
+		}
+		auto fill (static_cast<double> (size_l) / queue_l.capacity);
+		// A queue which is not being drained at all, or only holds a small backlog, is only judged by how full it is
+		auto slow (fill >= drain_threshold && queue_l.rate > 0 && size_l / queue_l.rate > std::chrono::duration<double> (max_drain_time).count ());
+		auto pressure_l (fill >= critical_threshold ? pressure::critical : (fill >= elevated_threshold || slow) ? pressure::elevated : pressure::normal);
+		result = std::max (result, pressure_l);
+	}
+	if (result != current.load ())
+	{
+		current = result;
+		auto detail (result == pressure::critical ? nano::stat::detail::pressure_critical : result == pressure::elevated ? nano::stat::detail::pressure_elevated : nano::stat::detail::pressure_normal);
+		stats.inc (nano::stat::type::admission, detail);
+	}
+}
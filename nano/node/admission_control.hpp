@@ -0,0 +1,79 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace nano
+{
+class stat;
+
+/**
+ * Decides which producers to slow down based on the depth and processing rate of the node's work queues (block processor, vote processor and tcp message manager).
+ * The node samples the queues every sample_interval from a worker task and publishes the result, so producers only read an atomic. A queue is elevated once it is
+ * half full or holds a backlog of at least drain_threshold which would take longer than max_drain_time to drain at the recently observed processing rate,
+ * and critical once it is nearly full. The most pressured queue decides for all producers:
+ * - elevated: bootstrap pulls and pushes wait, leaving the remaining capacity to live traffic
+ * - critical: reads from realtime connections of peers which are not principal representatives pause as well
+ * Live traffic is otherwise admitted until a queue is full and drops, as before.
+ * @note This class is thread-safe
+ */
+class admission_control final
+{
+public:
+	enum class pressure : uint8_t
+	{
+		normal,
+		elevated,
+		critical
+	};
+
+	explicit admission_control (nano::stat &, std::chrono::milliseconds max_drain_time_a = default_max_drain_time);
+	/** Watches a queue holding \p size_a items out of \p capacity_a, \p processed_a returns the number of items taken out of it so far */
+	void add (std::function<std::size_t ()> const & size_a, std::size_t capacity_a, std::function<uint64_t ()> const & processed_a);
+	/** Pressure of the most pressured queue as of the last sample */
+	nano::admission_control::pressure level () const;
+	/** Returns true if bootstrap traffic should wait before feeding more blocks to the node */
+	bool throttle_bootstrap ();
+	/**
+	 * Returns true if the next read from a realtime connection should be delayed by read_pause, reads from principal representatives are never delayed
+	 * @param principal_representative_a Tells whether the peer is a principal representative, only called under critical pressure
+	 */
+	bool pause_read (std::function<bool ()> const & principal_representative_a);
+	/** Measures every queue and publishes the resulting pressure, called every sample_interval */
+	void sample (std::chrono::steady_clock::time_point const & now_a = std::chrono::steady_clock::now ());
+
+	static double constexpr elevated_threshold{ 0.5 };
+	static double constexpr critical_threshold{ 0.8 };
+	/** Smaller backlogs are only judged by how full the queue is */
+	static double constexpr drain_threshold{ 0.1 };
+	/** Processing rates below this many items per second are treated as stalled */
+	static double constexpr min_rate{ 1.0 };
+	static std::chrono::milliseconds constexpr default_max_drain_time{ 5000 };
+	static std::chrono::milliseconds constexpr sample_interval{ 100 };
+	static std::chrono::milliseconds constexpr read_pause{ 100 };
+
+private:
+	class queue final
+	{
+	public:
+		std::function<std::size_t ()> size;
+		std::size_t capacity;
+		std::function<uint64_t ()> processed;
+		uint64_t last_processed{ 0 };
+		/** Smoothed items processed per second */
+		double rate{ 0 };
+	};
+	nano::stat & stats;
+	std::chrono::milliseconds const max_drain_time;
+	std::vector<queue> queues;
+	std::chrono::steady_clock::time_point last_sample;
+	std::atomic<nano::admission_control::pressure> current{ pressure::normal };
+	nano::mutex mutex;
+};
+}
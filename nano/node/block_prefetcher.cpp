@@ -0,0 +1,103 @@
+#include <nano/lib/threading.hpp>
+#include <nano/node/block_prefetcher.hpp>
+#include <nano/secure/ledger.hpp>
+#include <nano/secure/store.hpp>
+
+nano::block_prefetcher::block_prefetcher (nano::ledger const & ledger_a, unsigned threads_a, uint64_t max_queued_tasks_a) :
+	ledger{ ledger_a },
+	threads{ threads_a },
+	max_queued_tasks{ max_queued_tasks_a }
+{
+}
+
+nano::block_prefetcher::~block_prefetcher ()
+{
+	stop ();
+}
+
+void nano::block_prefetcher::chain (nano::block_hash const & start_a, uint64_t count_a, direction direction_a, bool sources_a, visitor const & visitor_a)
+{
+	if (threads == 0 || stopped || start_a.is_zero () || count_a == 0)
+	{
+		return;
+	}
+	nano::lock_guard<nano::mutex> guard{ mutex };
+	// stop () may have run since the check above, it must not be followed by a new pool
+	if (stopped)
+	{
+		return;
+	}
+	if (!pool)
+	{
+		pool = std::make_unique<nano::thread_pool> (threads, nano::thread_role::name::block_prefetch);
+	}
+	if (pool->num_queued_tasks () >= max_queued_tasks)
+	{
+		return;
+	}
+	pool->push_task ([this, start = start_a, count = std::min (count_a, max_chain_length), direction_a, sources_a, visitor_a, generation_l = generation.load ()] () {
+		auto transaction (ledger.store.tx_begin_read ());
+		auto current (start);
+		for (uint64_t i (0); i < count && !current.is_zero () && generation_l == generation && !stopped; ++i)
+		{
+			auto block (ledger.store.block.get (transaction, current));
+			if (block == nullptr)
+			{
+				break;
+			}
+			if (sources_a)
+			{
+				auto source_l (block->source ());
+				if (source_l.is_zero ())
+				{
+					source_l = block->link ().as_block_hash ();
+				}
+				if (!source_l.is_zero () && !ledger.is_epoch_link (source_l))
+				{
+					// Sources are spread over the ledger, reading them from other threads keeps the chain read ahead moving
+					source (source_l, generation_l);
+				}
+			}
+			current = direction_a == direction::successor ? block->sideband ().successor : block->previous ();
+			if (visitor_a && !visitor_a (block))
+			{
+				break;
+			}
+		}
+	});
+}
+
+void nano::block_prefetcher::source (nano::block_hash const & hash_a, uint64_t generation_a)
+{
+	nano::lock_guard<nano::mutex> guard{ mutex };
+	// Called from prefetch threads, stop () may already have taken the pool
+	if (pool != nullptr && pool->num_queued_tasks () < max_queued_tasks)
+	{
+		pool->push_task ([this, hash_a, generation_a] () {
+			if (generation_a == generation && !stopped)
+			{
+				ledger.store.block.exists (ledger.store.tx_begin_read (), hash_a);
+			}
+		});
+	}
+}
+
+void nano::block_prefetcher::cancel ()
+{
+	++generation;
+}
+
+void nano::block_prefetcher::stop ()
+{
+	stopped = true;
+	std::unique_ptr<nano::thread_pool> pool_l;
+	{
+		nano::lock_guard<nano::mutex> guard{ mutex };
+		pool_l = std::move (pool);
+	}
+	// Joined without the lock held, a running chain prefetch may still be waiting for it to queue a source read
+	if (pool_l)
+	{
+		pool_l->stop ();
+	}
+}
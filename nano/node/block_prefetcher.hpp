@@ -0,0 +1,64 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/lib/numbers.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace nano
+{
+class block;
+class ledger;
+class thread_pool;
+
+/**
+ * Reads blocks ahead of a sequential walk along an account chain on background threads.
+ * A walk reading one block at a time stalls on every page fault into the memory mapped ledger (LMDB is opened with MDB_NORDAHEAD) or every RocksDB block read.
+ * Reading ahead from other threads keeps several of those reads in flight, so the walker mostly finds its blocks in the page or block cache.
+ * Prefetching warms caches, the walker still reads each block itself unless it collects the prefetched blocks through a visitor.
+ * @note This class is thread-safe. Threads are only started by the first prefetch.
+ */
+class block_prefetcher final
+{
+public:
+	enum class direction
+	{
+		successor,
+		previous
+	};
+
+	using visitor = std::function<bool (std::shared_ptr<nano::block> const &)>;
+
+	/** Prefetches are dropped while \p max_queued_tasks_a are waiting, a walker which outruns its prefetches would otherwise keep queuing reads it has already done itself */
+	explicit block_prefetcher (nano::ledger const &, unsigned threads_a = default_threads, uint64_t max_queued_tasks_a = default_max_queued_tasks);
+	~block_prefetcher ();
+	/**
+	 * Reads up to \p count_a blocks starting at \p start_a in \p direction_a. With \p sources_a, the source blocks of receives found on the way are read as well
+	 * @param visitor_a Called from a prefetch thread with every block read along the chain, returning false ends the prefetch
+	 */
+	void chain (nano::block_hash const & start_a, uint64_t count_a, direction direction_a, bool sources_a, visitor const & visitor_a = nullptr);
+	/** Discards prefetches which have not completed yet */
+	void cancel ();
+	/** Discards pending prefetches and joins the threads, later prefetches are ignored */
+	void stop ();
+
+	static unsigned constexpr default_threads = 2;
+	/** A single prefetch reads no further ahead than this, blocks much further ahead may be evicted again before the walker gets there */
+	static uint64_t constexpr max_chain_length = 4096;
+	static uint64_t constexpr default_max_queued_tasks = 256;
+
+private:
+	void source (nano::block_hash const &, uint64_t generation_a);
+
+	nano::ledger const & ledger;
+	unsigned const threads;
+	uint64_t const max_queued_tasks;
+	std::atomic<uint64_t> generation{ 0 };
+	std::atomic<bool> stopped{ false };
+	nano::mutex mutex;
+	std::unique_ptr<nano::thread_pool> pool;
+};
+}
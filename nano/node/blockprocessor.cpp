@@ -31,6 +31,7 @@ nano::block_processor::block_processor (nano::node & node_a, nano::write_databas
 	write_database_queue (write_database_queue_a),
 	state_block_signature_verification (node.checker, node.ledger.network_params.ledger.epochs, node.config, node.logger, node.flags.block_processor_verification_size)
 {
+	node.stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::block_processor_batch, nano::stat::dir::in);
 	state_block_signature_verification.blocks_verified_callback = [this] (std::deque<nano::unchecked_info> & items, std::vector<int> const & verifications, std::vector<nano::block_hash> const & hashes, std::vector<nano::signature> const & blocks_signatures) {
 		this->process_verified_state_blocks (items, verifications, hashes, blocks_signatures);
 	};
@@ -235,6 +236,7 @@ void nano::block_processor::process_batch (nano::unique_lock<nano::mutex> & lock
 	nano::timer<std::chrono::milliseconds> timer_l;
 	lock_a.lock ();
 	timer_l.start ();
+	auto batch_start (std::chrono::steady_clock::now ());
 	// Processing blocks
 	unsigned number_of_blocks_processed (0), number_of_forced_processed (0);
 	auto deadline_reached = [&timer_l, deadline = node.config.block_processor_batch_max_time] { return timer_l.after_deadline (deadline); };
@@ -296,12 +298,17 @@ void nano::block_processor::process_batch (nano::unique_lock<nano::mutex> & lock
 			}
 		}
 		number_of_blocks_processed++;
+		++total_processed;
 		process_one (transaction, post_events, info, force);
 		lock_a.lock ();
 	}
 	awaiting_write = false;
 	lock_a.unlock ();
 
+	if (number_of_blocks_processed != 0)
+	{
+		node.stats.update_histogram (nano::stat::type::latency, nano::stat::detail::block_processor_batch, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - batch_start).count ());
+	}
 	if (node.config.logging.timing_logging () && number_of_blocks_processed != 0 && timer_l.stop () > std::chrono::milliseconds (100))
 	{
 		node.logger.always_log (boost::str (boost::format ("Processed %1% blocks (%2% blocks were forced) in %3% %4%") % number_of_blocks_processed % number_of_forced_processed % timer_l.value ().count () % timer_l.unit ()));
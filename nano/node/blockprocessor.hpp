@@ -66,6 +66,8 @@ public:
 	nano::process_return process_one (nano::write_transaction const &, block_post_events &, nano::unchecked_info, const bool = false, nano::block_origin const = nano::block_origin::remote);
 	nano::process_return process_one (nano::write_transaction const &, block_post_events &, std::shared_ptr<nano::block> const &);
 	std::atomic<bool> flushing{ false };
+	/** Blocks taken out of the queues and processed since startup */
+	std::atomic<uint64_t> total_processed{ 0 };
 	// Delay required for average network propagartion before requesting confirmation
 	static std::chrono::milliseconds constexpr confirmation_request_delay{ 1500 };
 
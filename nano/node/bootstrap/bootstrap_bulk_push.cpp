@@ -120,7 +120,7 @@ nano::bulk_push_server::bulk_push_server (std::shared_ptr<nano::bootstrap_server
 
 void nano::bulk_push_server::throttled_receive ()
 {
-	if (!connection->node->block_processor.half_full ())
+	if (!connection->node->admission.throttle_bootstrap ())
 	{
 		receive ();
 	}
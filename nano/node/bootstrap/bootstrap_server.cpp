@@ -145,20 +145,33 @@ void nano::bootstrap_server::stop ()
 
 void nano::bootstrap_server::receive ()
 {
-	// Increase timeout to receive TCP header (idle server socket)
-	socket->set_timeout (node->network_params.node.idle_timeout);
 	auto this_l (shared_from_this ());
-	socket->async_read (receive_buffer, 8, [this_l] (boost::system::error_code const & ec, size_t size_a) {
-		// Set remote_endpoint
-		if (this_l->remote_endpoint.port () == 0)
-		{
-			this_l->remote_endpoint = this_l->socket->remote_endpoint ();
-		}
-		// Decrease timeout to default
-		this_l->socket->set_timeout (this_l->node->config.tcp_io_timeout);
-		// Receive header
-		this_l->receive_header_action (ec, size_a);
-	});
+	// Under pressure, reads from realtime peers which are not principal representatives wait for the node's queues to drain
+	if (is_realtime_connection () && node->admission.pause_read ([this] () { return is_principal_representative (); }))
+	{
+		node->workers.add_timed_task (std::chrono::steady_clock::now () + nano::admission_control::read_pause, [this_l] () {
+			if (!this_l->stopped)
+			{
+				this_l->receive ();
+			}
+		});
+	}
+	else
+	{
+		// Increase timeout to receive TCP header (idle server socket)
+		socket->set_timeout (node->network_params.node.idle_timeout);
+		socket->async_read (receive_buffer, 8, [this_l] (boost::system::error_code const & ec, size_t size_a) {
+			// Set remote_endpoint
+			if (this_l->remote_endpoint.port () == 0)
+			{
+				this_l->remote_endpoint = this_l->socket->remote_endpoint ();
+			}
+			// Decrease timeout to default
+			this_l->socket->set_timeout (this_l->node->config.tcp_io_timeout);
+			// Receive header
+			this_l->receive_header_action (ec, size_a);
+		});
+	}
 }
 
 void nano::bootstrap_server::receive_header_action (boost::system::error_code const & ec, size_t size_a)
@@ -203,7 +216,7 @@ void nano::bootstrap_server::receive_header_action (boost::system::error_code co
 					node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::bulk_push, nano::stat::dir::in);
 					if (is_bootstrap_connection ())
 					{
-						add_request (std::make_unique<nano::bulk_push> (header));
+						add_request (std::make_shared<nano::bulk_push> (header));
 					}
 					break;
 				}
@@ -251,7 +264,7 @@ void nano::bootstrap_server::receive_header_action (boost::system::error_code co
 						if (cache_exceeded)
 						{
 							last_telemetry_req = std::chrono::steady_clock::now ();
-							add_request (std::make_unique<nano::telemetry_req> (header));
+							add_request (nano::make_shared<nano::telemetry_req> (header));
 						}
 						else
 						{
@@ -294,7 +307,7 @@ void nano::bootstrap_server::receive_bulk_pull_action (boost::system::error_code
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::bulk_pull> (error, stream, header_a));
+		auto request (std::make_shared<nano::bulk_pull> (error, stream, header_a));
 		if (!error)
 		{
 			if (node->config.logging.bulk_pull_logging ())
@@ -303,7 +316,7 @@ void nano::bootstrap_server::receive_bulk_pull_action (boost::system::error_code
 			}
 			if (is_bootstrap_connection () && !node->flags.disable_bootstrap_bulk_pull_server)
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				add_request (request);
 			}
 			receive ();
 		}
@@ -317,7 +330,7 @@ void nano::bootstrap_server::receive_bulk_pull_account_action (boost::system::er
 		auto error (false);
 		debug_assert (size_a == header_a.payload_length_bytes ());
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::bulk_pull_account> (error, stream, header_a));
+		auto request (std::make_shared<nano::bulk_pull_account> (error, stream, header_a));
 		if (!error)
 		{
 			if (node->config.logging.bulk_pull_logging ())
@@ -326,7 +339,7 @@ void nano::bootstrap_server::receive_bulk_pull_account_action (boost::system::er
 			}
 			if (is_bootstrap_connection () && !node->flags.disable_bootstrap_bulk_pull_server)
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				add_request (request);
 			}
 			receive ();
 		}
@@ -339,7 +352,7 @@ void nano::bootstrap_server::receive_frontier_req_action (boost::system::error_c
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::frontier_req> (error, stream, header_a));
+		auto request (std::make_shared<nano::frontier_req> (error, stream, header_a));
 		if (!error)
 		{
 			if (node->config.logging.bulk_pull_logging ())
@@ -348,7 +361,7 @@ void nano::bootstrap_server::receive_frontier_req_action (boost::system::error_c
 			}
 			if (is_bootstrap_connection ())
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				add_request (request);
 			}
 			receive ();
 		}
@@ -368,12 +381,12 @@ void nano::bootstrap_server::receive_keepalive_action (boost::system::error_code
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::keepalive> (error, stream, header_a));
+		auto request (nano::make_shared<nano::keepalive> (error, stream, header_a));
 		if (!error)
 		{
 			if (is_realtime_connection ())
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				add_request (request);
 			}
 			receive ();
 		}
@@ -393,12 +406,12 @@ void nano::bootstrap_server::receive_telemetry_ack_action (boost::system::error_
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::telemetry_ack> (error, stream, header_a));
+		auto request (nano::make_shared<nano::telemetry_ack> (error, stream, header_a));
 		if (!error)
 		{
 			if (is_realtime_connection ())
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				add_request (request);
 			}
 			receive ();
 		}
@@ -421,14 +434,14 @@ void nano::bootstrap_server::receive_publish_action (boost::system::error_code c
 		{
 			auto error (false);
 			nano::bufferstream stream (receive_buffer->data (), size_a);
-			auto request (std::make_unique<nano::publish> (error, stream, header_a, digest));
+			auto request (nano::make_shared<nano::publish> (error, stream, header_a, digest));
 			if (!error)
 			{
 				if (is_realtime_connection ())
 				{
 					if (!nano::work_validate_entry (*request->block))
 					{
-						add_request (std::unique_ptr<nano::message> (request.release ()));
+						add_request (request);
 					}
 					else
 					{
@@ -459,12 +472,12 @@ void nano::bootstrap_server::receive_confirm_req_action (boost::system::error_co
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::confirm_req> (error, stream, header_a));
+		auto request (nano::make_shared<nano::confirm_req> (error, stream, header_a));
 		if (!error)
 		{
 			if (is_realtime_connection ())
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				add_request (request);
 			}
 			receive ();
 		}
@@ -481,7 +494,7 @@ void nano::bootstrap_server::receive_confirm_ack_action (boost::system::error_co
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::confirm_ack> (error, stream, header_a));
+		auto request (nano::make_shared<nano::confirm_ack> (error, stream, header_a));
 		if (!error)
 		{
 			if (is_realtime_connection ())
@@ -504,7 +517,7 @@ void nano::bootstrap_server::receive_confirm_ack_action (boost::system::error_co
 				}
 				if (process_vote)
 				{
-					add_request (std::unique_ptr<nano::message> (request.release ()));
+					add_request (request);
 				}
 			}
 			receive ();
@@ -522,12 +535,12 @@ void nano::bootstrap_server::receive_node_id_handshake_action (boost::system::er
 	{
 		auto error (false);
 		nano::bufferstream stream (receive_buffer->data (), size_a);
-		auto request (std::make_unique<nano::node_id_handshake> (error, stream, header_a));
+		auto request (nano::make_shared<nano::node_id_handshake> (error, stream, header_a));
 		if (!error)
 		{
 			if (socket->type () == nano::socket::type_t::undefined && !node->flags.disable_tcp_realtime)
 			{
-				add_request (std::unique_ptr<nano::message> (request.release ()));
+				add_request (request);
 			}
 			receive ();
 		}
@@ -538,12 +551,12 @@ void nano::bootstrap_server::receive_node_id_handshake_action (boost::system::er
 	}
 }
 
-void nano::bootstrap_server::add_request (std::unique_ptr<nano::message> message_a)
+void nano::bootstrap_server::add_request (std::shared_ptr<nano::message> const & message_a)
 {
 	debug_assert (message_a != nullptr);
 	nano::unique_lock<nano::mutex> lock (mutex);
 	auto start (requests.empty ());
-	requests.push (std::move (message_a));
+	requests.push (message_a);
 	if (start)
 	{
 		run_next (lock);
@@ -610,34 +623,35 @@ namespace
 class request_response_visitor : public nano::message_visitor
 {
 public:
-	explicit request_response_visitor (std::shared_ptr<nano::bootstrap_server> const & connection_a) :
-		connection (connection_a)
+	request_response_visitor (std::shared_ptr<nano::bootstrap_server> const & connection_a, std::shared_ptr<nano::message> const & request_a) :
+		connection (connection_a),
+		request (request_a)
 	{
 	}
-	void keepalive (nano::keepalive const & message_a) override
+	void keepalive (nano::keepalive const &) override
 	{
-		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ std::make_shared<nano::keepalive> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket });
+		put_message ();
 	}
-	void publish (nano::publish const & message_a) override
+	void publish (nano::publish const &) override
 	{
-		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ std::make_shared<nano::publish> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket });
+		put_message ();
 	}
-	void confirm_req (nano::confirm_req const & message_a) override
+	void confirm_req (nano::confirm_req const &) override
 	{
-		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ std::make_shared<nano::confirm_req> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket });
+		put_message ();
 	}
-	void confirm_ack (nano::confirm_ack const & message_a) override
+	void confirm_ack (nano::confirm_ack const &) override
 	{
-		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ std::make_shared<nano::confirm_ack> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket });
+		put_message ();
 	}
-	void bulk_pull (nano::bulk_pull const &) override
+	void bulk_pull (nano::bulk_pull const & message_a) override
 	{
-		auto response (std::make_shared<nano::bulk_pull_server> (connection, std::unique_ptr<nano::bulk_pull> (static_cast<nano::bulk_pull *> (connection->requests.front ().release ()))));
+		auto response (std::make_shared<nano::bulk_pull_server> (connection, std::make_unique<nano::bulk_pull> (message_a)));
 		response->send_next ();
 	}
-	void bulk_pull_account (nano::bulk_pull_account const &) override
+	void bulk_pull_account (nano::bulk_pull_account const & message_a) override
 	{
-		auto response (std::make_shared<nano::bulk_pull_account_server> (connection, std::unique_ptr<nano::bulk_pull_account> (static_cast<nano::bulk_pull_account *> (connection->requests.front ().release ()))));
+		auto response (std::make_shared<nano::bulk_pull_account_server> (connection, std::make_unique<nano::bulk_pull_account> (message_a)));
 		response->send_frontier ();
 	}
 	void bulk_push (nano::bulk_push const &) override
@@ -645,18 +659,18 @@ public:
 		auto response (std::make_shared<nano::bulk_push_server> (connection));
 		response->throttled_receive ();
 	}
-	void frontier_req (nano::frontier_req const &) override
+	void frontier_req (nano::frontier_req const & message_a) override
 	{
-		auto response (std::make_shared<nano::frontier_req_server> (connection, std::unique_ptr<nano::frontier_req> (static_cast<nano::frontier_req *> (connection->requests.front ().release ()))));
+		auto response (std::make_shared<nano::frontier_req_server> (connection, std::make_unique<nano::frontier_req> (message_a)));
 		response->send_next ();
 	}
-	void telemetry_req (nano::telemetry_req const & message_a) override
+	void telemetry_req (nano::telemetry_req const &) override
 	{
-		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ std::make_shared<nano::telemetry_req> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket });
+		put_message ();
 	}
-	void telemetry_ack (nano::telemetry_ack const & message_a) override
+	void telemetry_ack (nano::telemetry_ack const &) override
 	{
-		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ std::make_shared<nano::telemetry_ack> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket });
+		put_message ();
 	}
 	void node_id_handshake (nano::node_id_handshake const & message_a) override
 	{
@@ -714,21 +728,26 @@ public:
 		nano::account node_id (connection->remote_node_id);
 		nano::socket::type_t type = connection->socket->type ();
 		debug_assert (node_id.is_zero () || type == nano::socket::type_t::realtime);
-		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ std::make_shared<nano::node_id_handshake> (message_a), connection->remote_endpoint, connection->remote_node_id, connection->socket });
+		put_message ();
+	}
+	void put_message ()
+	{
+		connection->node->network.tcp_message_manager.put_message (nano::tcp_message_item{ request, connection->remote_endpoint, connection->remote_node_id, connection->socket });
 	}
 	std::shared_ptr<nano::bootstrap_server> connection;
+	std::shared_ptr<nano::message> request;
 };
 }
 
 void nano::bootstrap_server::run_next (nano::unique_lock<nano::mutex> & lock_a)
 {
 	debug_assert (!requests.empty ());
-	request_response_visitor visitor (shared_from_this ());
 	auto type (requests.front ()->header.type);
 	if (type == nano::message_type::bulk_pull || type == nano::message_type::bulk_pull_account || type == nano::message_type::bulk_push || type == nano::message_type::frontier_req || type == nano::message_type::node_id_handshake)
 	{
 		// Bootstrap & node ID (realtime start)
-		// Request removed from queue in request_response_visitor. For bootstrap with requests.front ().release (), for node ID with finish_request ()
+		// Request removed from queue with finish_request () once the response completes
+		request_response_visitor visitor (shared_from_this (), requests.front ());
 		requests.front ()->visit (visitor);
 	}
 	else
@@ -738,6 +757,7 @@ void nano::bootstrap_server::run_next (nano::unique_lock<nano::mutex> & lock_a)
 		requests.pop ();
 		auto timeout_check (requests.empty ());
 		lock_a.unlock ();
+		request_response_visitor visitor (shared_from_this (), request);
 		request->visit (visitor);
 		if (timeout_check)
 		{
@@ -766,3 +786,14 @@ bool nano::bootstrap_server::is_realtime_connection ()
 {
 	return socket->type () == nano::socket::type_t::realtime || socket->type () == nano::socket::type_t::realtime_response_server;
 }
+
+bool nano::bootstrap_server::is_principal_representative ()
+{
+	auto result (false);
+	if (!remote_node_id.is_zero ())
+	{
+		auto channel (node->network.find_node_id (remote_node_id));
+		result = channel != nullptr && node->rep_crawler.is_pr (*channel);
+	}
+	return result;
+}
@@ -51,18 +51,20 @@ public:
 	void receive_confirm_ack_action (boost::system::error_code const &, size_t, nano::message_header const &);
 	void receive_node_id_handshake_action (boost::system::error_code const &, size_t, nano::message_header const &);
 	void receive_telemetry_ack_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a);
-	void add_request (std::unique_ptr<nano::message>);
+	void add_request (std::shared_ptr<nano::message> const &);
 	void finish_request ();
 	void finish_request_async ();
 	void timeout ();
 	void run_next (nano::unique_lock<nano::mutex> & lock_a);
 	bool is_bootstrap_connection ();
 	bool is_realtime_connection ();
+	bool is_principal_representative ();
 	std::shared_ptr<std::vector<uint8_t>> receive_buffer;
 	std::shared_ptr<nano::socket> socket;
 	std::shared_ptr<nano::node> node;
 	nano::mutex mutex;
-	std::queue<std::unique_ptr<nano::message>> requests;
+	/** Realtime messages are allocated from memory pools when parsed and handed to the tcp message manager without copying */
+	std::queue<std::shared_ptr<nano::message>> requests;
 	std::atomic<bool> stopped{ false };
 	// Remote enpoint used to remove response channel even after socket closing
 	nano::tcp_endpoint remote_endpoint{ boost::asio::ip::address_v6::any (), 0 };
@@ -3,6 +3,8 @@
 #include <nano/node/cli.hpp>
 #include <nano/node/common.hpp>
 #include <nano/node/daemonconfig.hpp>
+#include <nano/node/ledger_snapshot.hpp>
+#include <nano/node/lmdb/lmdb.hpp>
 #include <nano/node/node.hpp>
 
 #include <boost/format.hpp>
@@ -47,8 +49,10 @@ void nano::add_node_options (boost::program_options::options_description & descr
 	("account_create", "Insert next deterministic key in to <wallet>")
 	("account_get", "Get account number for the <key>")
 	("account_key", "Get the public key for <account>")
-	("vacuum", "Compact database. If data_path is missing, the database in data directory is compacted.")
+	("vacuum", "Compact database. If data_path is missing, the database in data directory is compacted. An interrupted vacuum resumes when run again")
 	("snapshot", "Compact database and create snapshot, functions similar to vacuum but does not replace the existing database")
+	("snapshot_export", "Export a chunked, checksummed snapshot of the cemented ledger into the <file> directory")
+	("snapshot_import", "Verify and bulk load a ledger snapshot from the <file> directory into a data_path without an existing ledger")
 	("data_path", boost::program_options::value<std::string> (), "Use the supplied path as the data directory")
 	("network", boost::program_options::value<std::string> (), "Use the supplied network (live, test, beta or dev)")
 	("clear_send_ids", "Remove all send IDs from the database (dangerous: not intended for production use)")
@@ -105,6 +109,7 @@ void nano::add_node_flag_options (boost::program_options::options_description &
 		("enable_pruning", "Enable experimental ledger pruning")
 		("allow_bootstrap_peers_duplicates", "Allow multiple connections to same peer in bootstrap attempts")
 		("fast_bootstrap", "Increase bootstrap speed for high end nodes with higher limits")
+		("rocksdb_bulk_ingest", "RocksDB only. Serialize ledger writes through the write database queue and apply them as plain write batches without transaction conflict tracking, for initial sync")
 		("block_processor_batch_size", boost::program_options::value<std::size_t>(), "Increase block processor transaction batch write size, default 0 (limited by config block_processor_batch_max_time), 256k for fast_bootstrap")
 		("block_processor_full_size", boost::program_options::value<std::size_t>(), "Increase block processor allowed blocks queue size before dropping live network packets and holding bootstrap download, default 65536, 1 million for fast_bootstrap")
 		("block_processor_verification_size", boost::program_options::value<std::size_t>(), "Increase batch signature verification size in block processor, default 0 (limited by config signature_checker_threads), unlimited for fast_bootstrap")
@@ -142,6 +147,7 @@ std::error_code nano::update_flags (nano::node_flags & flags_a, boost::program_o
 	flags_a.enable_pruning = (vm.count ("enable_pruning") > 0);
 	flags_a.allow_bootstrap_peers_duplicates = (vm.count ("allow_bootstrap_peers_duplicates") > 0);
 	flags_a.fast_bootstrap = (vm.count ("fast_bootstrap") > 0);
+	flags_a.rocksdb_bulk_ingest = (vm.count ("rocksdb_bulk_ingest") > 0);
 	if (flags_a.fast_bootstrap)
 	{
 		flags_a.disable_block_processor_unchecked_deletion = true;
@@ -247,7 +253,19 @@ bool copy_database (boost::filesystem::path const & data_path, boost::program_op
 			node.node->store.rebuild_db (store.tx_begin_write ());
 		}
 
-		success = node.node->copy_with_compaction (output_path);
+		if (auto mdb_store_l = dynamic_cast<nano::mdb_store *> (&store))
+		{
+			success = mdb_store_l->copy_db (output_path, [] (nano::mdb_compactor::table_progress const & progress_a) {
+				if (progress_a.done)
+				{
+					std::cout << "Copied " << progress_a.to_string () << std::endl;
+				}
+			});
+		}
+		else
+		{
+			success = node.node->copy_with_compaction (output_path);
+		}
 	}
 	else
 	{
@@ -454,6 +472,73 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 			std::cerr << "Snapshot failed (unknown reason)" << std::endl;
 		}
 	}
+	else if (vm.count ("snapshot_export"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			boost::filesystem::path snapshot_path (vm["file"].as<std::string> ());
+			auto inactive_node = nano::default_inactive_node (data_path, vm);
+			std::cout << "Exporting cemented ledger snapshot to " << snapshot_path << ", this may take a while..." << std::endl;
+			nano::ledger_snapshot snapshot (snapshot_path);
+			if (!snapshot.export_ledger (inactive_node->node->ledger))
+			{
+				std::cout << boost::str (boost::format ("Snapshot export completed, %1% chunks written\n") % snapshot.chunks ().size ());
+			}
+			else
+			{
+				std::cerr << "Snapshot export failed: " << snapshot.error_message () << std::endl;
+				ec = nano::error_cli::generic;
+			}
+		}
+		else
+		{
+			std::cerr << "snapshot_export command requires one <file> option\n";
+			ec = nano::error_cli::invalid_arguments;
+		}
+	}
+	else if (vm.count ("snapshot_import"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			boost::filesystem::path snapshot_path (vm["file"].as<std::string> ());
+			auto node_flags = nano::inactive_node_flag_defaults ();
+			node_flags.read_only = false;
+			nano::update_flags (node_flags, vm);
+			nano::inactive_node node (data_path, node_flags);
+			if (!node.node->init_error ())
+			{
+				auto & store (node.node->store);
+				if (store.block.count (store.tx_begin_read ()) <= 1)
+				{
+					std::cout << "Importing ledger snapshot from " << snapshot_path << ", this may take a while..." << std::endl;
+					nano::ledger_snapshot snapshot (snapshot_path);
+					if (!snapshot.import_ledger (store))
+					{
+						std::cout << "Snapshot import completed" << std::endl;
+					}
+					else
+					{
+						std::cerr << "Snapshot import failed: " << snapshot.error_message () << std::endl;
+						ec = nano::error_cli::generic;
+					}
+				}
+				else
+				{
+					std::cerr << "Snapshot import requires a data_path without an existing ledger\n";
+					ec = nano::error_cli::invalid_arguments;
+				}
+			}
+			else
+			{
+				database_write_lock_error (ec);
+			}
+		}
+		else
+		{
+			std::cerr << "snapshot_import command requires one <file> option\n";
+			ec = nano::error_cli::invalid_arguments;
+		}
+	}
 	else if (vm.count ("migrate_database_lmdb_to_rocksdb"))
 	{
 		auto data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : nano::working_path ();
@@ -583,6 +668,7 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 						{
 							node.node->store.confirmation_height.clear (transaction, account);
 						}
+						node.node->ledger.uncemented.invalidate ();
 
 						std::cout << "Confirmation height of account " << account_str << " is set to " << conf_height_reset_num << std::endl;
 					}
@@ -602,6 +688,7 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 			{
 				auto transaction (node.node->store.tx_begin_write ());
 				reset_confirmation_heights (transaction, node.node->store);
+				node.node->ledger.uncemented.invalidate ();
 				std::cout << "Confirmation heights of all accounts (except genesis which is set to 1) are set to 0" << std::endl;
 			}
 		}
@@ -49,6 +49,40 @@ uint64_t nano::ip_address_hash_raw (boost::asio::ip::address const & ip_a, uint1
 	return result;
 }
 
+std::string nano::message_type_to_string (nano::message_type type_a)
+{
+	switch (type_a)
+	{
+		case nano::message_type::invalid:
+			return "invalid";
+		case nano::message_type::not_a_type:
+			return "not_a_type";
+		case nano::message_type::keepalive:
+			return "keepalive";
+		case nano::message_type::publish:
+			return "publish";
+		case nano::message_type::confirm_req:
+			return "confirm_req";
+		case nano::message_type::confirm_ack:
+			return "confirm_ack";
+		case nano::message_type::bulk_pull:
+			return "bulk_pull";
+		case nano::message_type::bulk_push:
+			return "bulk_push";
+		case nano::message_type::frontier_req:
+			return "frontier_req";
+		case nano::message_type::node_id_handshake:
+			return "node_id_handshake";
+		case nano::message_type::bulk_pull_account:
+			return "bulk_pull_account";
+		case nano::message_type::telemetry_req:
+			return "telemetry_req";
+		case nano::message_type::telemetry_ack:
+			return "telemetry_ack";
+	}
+	return "unknown";
+}
+
 nano::message_header::message_header (nano::message_type type_a) :
 	network (nano::network_constants::active_network),
 	version_max (get_protocol_constants ().protocol_version),
@@ -1554,7 +1588,18 @@ std::chrono::seconds nano::telemetry_cache_cutoffs::network_to_time (network_con
 	return std::chrono::seconds{ (network_constants.is_live_network () || network_constants.is_test_network ()) ? live : network_constants.is_beta_network () ? beta : dev };
 }
 
+void nano::message_memory_pool_purge ()
+{
+	nano::purge_shared_ptr_singleton_pool_memory<nano::keepalive> ();
+	nano::purge_shared_ptr_singleton_pool_memory<nano::publish> ();
+	nano::purge_shared_ptr_singleton_pool_memory<nano::confirm_req> ();
+	nano::purge_shared_ptr_singleton_pool_memory<nano::confirm_ack> ();
+	nano::purge_shared_ptr_singleton_pool_memory<nano::node_id_handshake> ();
+	nano::purge_shared_ptr_singleton_pool_memory<nano::telemetry_req> ();
+	nano::purge_shared_ptr_singleton_pool_memory<nano::telemetry_ack> ();
+}
+
 nano::node_singleton_memory_pool_purge_guard::node_singleton_memory_pool_purge_guard () :
-	cleanup_guard ({ nano::block_memory_pool_purge, nano::purge_shared_ptr_singleton_pool_memory<nano::vote>, nano::purge_shared_ptr_singleton_pool_memory<nano::election>, nano::purge_singleton_inactive_votes_cache_pool_memory })
+	cleanup_guard ({ nano::block_memory_pool_purge, nano::message_memory_pool_purge, nano::purge_shared_ptr_singleton_pool_memory<nano::vote>, nano::purge_shared_ptr_singleton_pool_memory<nano::election> })
 {
 }
@@ -177,6 +177,8 @@ enum class message_type : uint8_t
 	telemetry_ack = 0x0d
 };
 
+std::string message_type_to_string (nano::message_type);
+
 enum class bulk_pull_account_flags : uint8_t
 {
 	pending_hash_and_amount = 0x0,
@@ -492,6 +494,9 @@ public:
 	static std::chrono::seconds network_to_time (network_constants const & network_constants);
 };
 
+/** Deallocates the memory pools of realtime messages parsed from tcp connections (invalidates all existing pointers) */
+void message_memory_pool_purge ();
+
 /** Helper guard which contains all the necessary purge (remove all memory even if used) functions */
 class node_singleton_memory_pool_purge_guard
 {
@@ -20,7 +20,8 @@ nano::confirmation_height_bounded::confirmation_height_bounded (nano::ledger & l
 	batch_write_size (batch_write_size_a),
 	notify_observers_callback (notify_observers_callback_a),
 	notify_block_already_cemented_observers_callback (notify_block_already_cemented_observers_callback_a),
-	awaiting_processing_size_callback (awaiting_processing_size_callback_a)
+	awaiting_processing_size_callback (awaiting_processing_size_callback_a),
+	prefetcher (ledger_a)
 {
 }
 
@@ -160,6 +161,8 @@ void nano::confirmation_height_bounded::process (std::shared_ptr<nano::block> or
 		bool hit_receive = false;
 		if (!already_cemented)
 		{
+			// Read the chain up to the top level block, and the sources of its receives, ahead of iterating it
+			prefetcher.chain (current, block->sideband ().height - block_height + 1, nano::block_prefetcher::direction::successor, true);
 			hit_receive = iterate (transaction, block_height, current, checkpoints, top_most_non_receive_block_hash, top_level_hash, receive_source_pairs, account);
 		}
 
@@ -380,6 +383,12 @@ void nano::confirmation_height_bounded::cement_blocks (nano::write_guard & scope
 		{
 			const auto & pending = pending_writes.front ();
 			const auto & account = pending.account;
+			if (pending_writes.size () > 1)
+			{
+				// Read the blocks of the next account to cement while this one is written
+				auto const & next_pending (pending_writes[1]);
+				prefetcher.chain (next_pending.bottom_hash, next_pending.top_height - next_pending.bottom_height + 1, nano::block_prefetcher::direction::successor, false);
+			}
 
 			auto write_confirmation_height = [&account, &ledger = ledger, &transaction] (uint64_t num_blocks_cemented, uint64_t confirmation_height, nano::block_hash const & confirmed_frontier) {
 #ifndef NDEBUG
@@ -390,8 +399,14 @@ void nano::confirmation_height_bounded::cement_blocks (nano::write_guard & scope
 				debug_assert (block != nullptr);
 				debug_assert (block->sideband ().height == confirmation_height_info.height + num_blocks_cemented);
 #endif
-				ledger.store.confirmation_height.put (transaction, account, nano::confirmation_height_info{ confirmation_height, confirmed_frontier });
+				nano::confirmation_height_info cemented_info{ confirmation_height, confirmed_frontier };
+				ledger.store.confirmation_height.put (transaction, account, cemented_info);
+				ledger.uncemented.cemented (account, cemented_info);
 				ledger.cache.cemented_count += num_blocks_cemented;
+				if (ledger.cache.cemented_count == ledger.cache.block_count)
+				{
+					ledger.uncemented.all_cemented ();
+				}
 				ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed, nano::stat::dir::in, num_blocks_cemented);
 				ledger.stats.add (nano::stat::type::confirmation_height, nano::stat::detail::blocks_confirmed_bounded, nano::stat::dir::in, num_blocks_cemented);
 			};
@@ -560,6 +575,11 @@ void nano::confirmation_height_bounded::clear_process_vars ()
 	accounts_confirmed_info_size = 0;
 }
 
+void nano::confirmation_height_bounded::stop ()
+{
+	prefetcher.stop ();
+}
+
 nano::confirmation_height_bounded::receive_chain_details::receive_chain_details (nano::account const & account_a, uint64_t height_a, nano::block_hash const & hash_a, nano::block_hash const & top_level_a, boost::optional<nano::block_hash> next_a, uint64_t bottom_height_a, nano::block_hash const & bottom_most_a) :
 	account (account_a),
 	height (height_a),
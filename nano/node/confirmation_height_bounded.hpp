@@ -3,6 +3,7 @@
 #include <nano/lib/numbers.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/lib/timer.hpp>
+#include <nano/node/block_prefetcher.hpp>
 #include <nano/secure/store.hpp>
 
 #include <boost/circular_buffer.hpp>
@@ -22,6 +23,8 @@ public:
 	confirmation_height_bounded (nano::ledger &, nano::write_database_queue &, std::chrono::milliseconds, nano::logging const &, nano::logger_mt &, std::atomic<bool> &, uint64_t &, std::function<void (std::vector<std::shared_ptr<nano::block>> const &)> const &, std::function<void (nano::block_hash const &)> const &, std::function<uint64_t ()> const &);
 	bool pending_empty () const;
 	void clear_process_vars ();
+	/** Stops prefetching, called once the processor is stopped */
+	void stop ();
 	void process (std::shared_ptr<nano::block> original_block);
 	void cement_blocks (nano::write_guard & scoped_write_guard_a);
 
@@ -128,6 +131,7 @@ private:
 	std::function<void (std::vector<std::shared_ptr<nano::block>> const &)> notify_observers_callback;
 	std::function<void (nano::block_hash const &)> notify_block_already_cemented_observers_callback;
 	std::function<uint64_t ()> awaiting_processing_size_callback;
+	nano::block_prefetcher prefetcher;
 	nano::network_params network_params;
 
 	friend std::unique_ptr<nano::container_info_component> collect_container_info (confirmation_height_bounded &, std::string const & name_a);
@@ -1,5 +1,6 @@
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/numbers.hpp>
+#include <nano/lib/stats.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/node/confirmation_height_processor.hpp>
@@ -14,6 +15,7 @@
 nano::confirmation_height_processor::confirmation_height_processor (nano::ledger & ledger_a, nano::write_database_queue & write_database_queue_a, std::chrono::milliseconds batch_separate_pending_min_time_a, nano::logging const & logging_a, nano::logger_mt & logger_a, boost::latch & latch, confirmation_height_mode mode_a) :
 	ledger (ledger_a),
 	write_database_queue (write_database_queue_a),
+	cemented_count_last (ledger_a.cache.cemented_count),
 	// clang-format off
 unbounded_processor (ledger_a, write_database_queue_a, batch_separate_pending_min_time_a, logging_a, logger_a, stopped, batch_write_size, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
 bounded_processor (ledger_a, write_database_queue_a, batch_separate_pending_min_time_a, logging_a, logger_a, stopped, batch_write_size, [this](auto & cemented_blocks) { this->notify_observers (cemented_blocks); }, [this](auto const & block_hash_a) { this->notify_observers (block_hash_a); }, [this]() { return this->awaiting_processing_size (); }),
@@ -25,6 +27,7 @@ bounded_processor (ledger_a, write_database_queue_a, batch_separate_pending_min_
 		this->run (mode_a);
 	})
 {
+	ledger.stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in);
 }
 
 nano::confirmation_height_processor::~confirmation_height_processor ()
@@ -39,6 +42,9 @@ void nano::confirmation_height_processor::stop ()
 		stopped = true;
 	}
 	condition.notify_one ();
+	// Prefetches still queued for a walk which is about to be abandoned are of no use
+	bounded_processor.stop ();
+	unbounded_processor.stop ();
 	if (thread.joinable ())
 	{
 		thread.join ();
@@ -68,6 +74,7 @@ void nano::confirmation_height_processor::run (confirmation_height_mode mode_a)
 			// Don't want to mix up pending writes across different processors
 			auto valid_unbounded = (mode_a == confirmation_height_mode::automatic && blocks_within_automatic_unbounded_selection && bounded_processor.pending_empty ());
 			auto force_unbounded = (!unbounded_processor.pending_empty () || mode_a == confirmation_height_mode::unbounded);
+			auto start (std::chrono::steady_clock::now ());
 			if (force_unbounded || valid_unbounded)
 			{
 				debug_assert (bounded_processor.pending_empty ());
@@ -79,6 +86,7 @@ void nano::confirmation_height_processor::run (confirmation_height_mode mode_a)
 				debug_assert (unbounded_processor.pending_empty ());
 				bounded_processor.process (original_block);
 			}
+			update_cement_latency (start);
 
 			lk.lock ();
 		}
@@ -101,8 +109,10 @@ void nano::confirmation_height_processor::run (confirmation_height_mode mode_a)
 				{
 					debug_assert (unbounded_processor.pending_empty ());
 					{
+						auto start (std::chrono::steady_clock::now ());
 						auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
 						bounded_processor.cement_blocks (scoped_write_guard);
+						update_cement_latency (start);
 					}
 					lock_and_cleanup ();
 				}
@@ -110,8 +120,10 @@ void nano::confirmation_height_processor::run (confirmation_height_mode mode_a)
 				{
 					debug_assert (bounded_processor.pending_empty ());
 					{
+						auto start (std::chrono::steady_clock::now ());
 						auto scoped_write_guard = write_database_queue.wait (nano::writer::confirmation_height);
 						unbounded_processor.cement_blocks (scoped_write_guard);
+						update_cement_latency (start);
 					}
 					lock_and_cleanup ();
 				}
@@ -136,6 +148,21 @@ void nano::confirmation_height_processor::run (confirmation_height_mode mode_a)
 	}
 }
 
+/** Records the time spent since \p start_a, together with earlier time not yet attributed, spread over the blocks cemented since the last update */
+void nano::confirmation_height_processor::update_cement_latency (std::chrono::steady_clock::time_point const & start_a)
+{
+	cement_elapsed += std::chrono::steady_clock::now () - start_a;
+	uint64_t const cemented_count (ledger.cache.cemented_count);
+	if (cemented_count > cemented_count_last)
+	{
+		auto const cemented (cemented_count - cemented_count_last);
+		auto const elapsed (std::chrono::duration_cast<std::chrono::microseconds> (cement_elapsed).count ());
+		ledger.stats.update_histogram (nano::stat::type::latency, nano::stat::detail::cement, nano::stat::dir::in, elapsed / cemented, cemented);
+		cement_elapsed = std::chrono::steady_clock::duration{ 0 };
+	}
+	cemented_count_last = cemented_count;
+}
+
 // Pausing only affects processing new blocks, not the current one being processed. Currently only used in tests
 void nano::confirmation_height_processor::pause ()
 {
@@ -176,6 +203,12 @@ void nano::confirmation_height_processor::add_cemented_observer (std::function<v
 	cemented_observers.push_back (callback_a);
 }
 
+// Not thread-safe, only call before this processor has begun cementing
+void nano::confirmation_height_processor::add_cemented_batch_observer (std::function<void (std::vector<std::shared_ptr<nano::block>> const &)> const & callback_a)
+{
+	cemented_batch_observers.push_back (callback_a);
+}
+
 // Not thread-safe, only call before this processor has begun cementing
 void nano::confirmation_height_processor::add_block_already_cemented_observer (std::function<void (nano::block_hash const &)> const & callback_a)
 {
@@ -191,6 +224,10 @@ void nano::confirmation_height_processor::notify_observers (std::vector<std::sha
 			observer (block_callback_data);
 		}
 	}
+	for (auto const & observer : cemented_batch_observers)
+	{
+		observer (cemented_blocks);
+	}
 }
 
 void nano::confirmation_height_processor::notify_observers (nano::block_hash const & hash_already_cemented_a)
@@ -45,6 +45,8 @@ public:
 	nano::block_hash current () const;
 
 	void add_cemented_observer (std::function<void (std::shared_ptr<nano::block> const &)> const &);
+	/** Called once per written batch, after the cemented observers were called for each block of the batch */
+	void add_cemented_batch_observer (std::function<void (std::vector<std::shared_ptr<nano::block>> const &)> const &);
 	void add_block_already_cemented_observer (std::function<void (nano::block_hash const &)> const &);
 
 private:
@@ -85,6 +87,7 @@ private:
 	std::atomic<bool> stopped{ false };
 	// No mutex needed for the observers as these should be set up during initialization of the node
 	std::vector<std::function<void (std::shared_ptr<nano::block> const &)>> cemented_observers;
+	std::vector<std::function<void (std::vector<std::shared_ptr<nano::block>> const &)>> cemented_batch_observers;
 	std::vector<std::function<void (nano::block_hash const &)>> block_already_cemented_observers;
 
 	nano::ledger & ledger;
@@ -92,12 +95,16 @@ private:
 	/** The maximum amount of blocks to write at once. This is dynamically modified by the bounded processor based on previous write performance **/
 	uint64_t batch_write_size{ 16384 };
 	nano::network_params network_params;
+	/** Processing time not yet attributed to cemented blocks, blocks walked by one call are often written by a later one */
+	std::chrono::steady_clock::duration cement_elapsed{ 0 };
+	uint64_t cemented_count_last;
 
 	confirmation_height_unbounded unbounded_processor;
 	confirmation_height_bounded bounded_processor;
 	std::thread thread;
 
 	void set_next_hash ();
+	void update_cement_latency (std::chrono::steady_clock::time_point const &);
 	void notify_observers (std::vector<std::shared_ptr<nano::block>> const &);
 	void notify_observers (nano::block_hash const &);
 
@@ -18,7 +18,8 @@ nano::confirmation_height_unbounded::confirmation_height_unbounded (nano::ledger
 	batch_write_size (batch_write_size_a),
 	notify_observers_callback (notify_observers_callback_a),
 	notify_block_already_cemented_observers_callback (notify_block_already_cemented_observers_callback_a),
-	awaiting_processing_size_callback (awaiting_processing_size_callback_a)
+	awaiting_processing_size_callback (awaiting_processing_size_callback_a),
+	prefetcher (ledger_a)
 {
 }
 
@@ -194,6 +195,11 @@ void nano::confirmation_height_unbounded::collect_unconfirmed_receive_and_source
 	debug_assert (block_a->hash () == hash_a);
 	auto hash (hash_a);
 	auto num_to_confirm = block_height_a - confirmation_height_a;
+	// Blocks below the top one are read from the store one at a time, read them and the sources of receives ahead
+	if (num_to_confirm > 1)
+	{
+		prefetcher.chain (block_a->previous (), num_to_confirm - 1, nano::block_prefetcher::direction::previous, true);
+	}
 
 	// Handle any sends above a receive
 	auto is_original_block = (hash == original_block->hash ());
@@ -406,7 +412,13 @@ void nano::confirmation_height_unbounded::cement_blocks (nano::write_guard & sco
 				debug_assert (pending.num_blocks_confirmed == pending.height - confirmation_height);
 				confirmation_height = pending.height;
 				ledger.cache.cemented_count += pending.num_blocks_confirmed;
-				ledger.store.confirmation_height.put (transaction, pending.account, { confirmation_height, pending.hash });
+				nano::confirmation_height_info cemented_info{ confirmation_height, pending.hash };
+				ledger.store.confirmation_height.put (transaction, pending.account, cemented_info);
+				ledger.uncemented.cemented (pending.account, cemented_info);
+				if (ledger.cache.cemented_count == ledger.cache.block_count)
+				{
+					ledger.uncemented.all_cemented ();
+				}
 
 				// Reverse it so that the callbacks start from the lowest newly cemented block and move upwards
 				std::reverse (pending.block_callback_data.begin (), pending.block_callback_data.end ());
@@ -472,6 +484,11 @@ void nano::confirmation_height_unbounded::clear_process_vars ()
 	}
 }
 
+void nano::confirmation_height_unbounded::stop ()
+{
+	prefetcher.stop ();
+}
+
 bool nano::confirmation_height_unbounded::has_iterated_over_block (nano::block_hash const & hash_a) const
 {
 	nano::lock_guard<nano::mutex> guard (block_cache_mutex);
@@ -1,15 +1,20 @@
 #include <nano/node/confirmation_solicitor.hpp>
 #include <nano/node/election.hpp>
+#include <nano/node/node.hpp>
 #include <nano/node/nodeconfig.hpp>
 
+#include <algorithm>
+
 using namespace std::chrono_literals;
 
 nano::confirmation_solicitor::confirmation_solicitor (nano::network & network_a, nano::node_config const & config_a) :
 	max_block_broadcasts (config_a.network_params.network.is_dev_network () ? 4 : 30),
 	max_election_requests (50),
 	max_election_broadcasts (std::max<size_t> (network_a.fanout () / 2, 1)),
+	unsolicited_grace (2 * config_a.network_params.network.request_interval_ms),
 	network (network_a),
-	config (config_a)
+	config (config_a),
+	tracker (network_a.node.rep_crawler.tracker)
 {
 }
 
@@ -17,13 +22,39 @@ void nano::confirmation_solicitor::prepare (std::vector<nano::representative> co
 {
 	debug_assert (!prepared);
 	requests.clear ();
+	requested.clear ();
 	rebroadcasted = 0;
+	tracker.cleanup ();
+	std::vector<nano::account> accounts;
+	accounts.reserve (representatives_a.size ());
+	std::transform (representatives_a.begin (), representatives_a.end (), std::back_inserter (accounts), [] (auto const & rep_a) { return rep_a.account; });
+	stats = tracker.stats (accounts);
 	/** Two copies are required as representatives can be erased from \p representatives_requests */
 	representatives_requests = representatives_a;
 	representatives_broadcasts = representatives_a;
+	// Ask first the representatives expected to deliver the most weight soonest, without statistics this keeps the order by weight
+	auto priority = [this] (nano::representative const & rep_a) {
+		auto const & stats_l (rep_stats (rep_a.account));
+		return rep_a.weight.number ().convert_to<double> () * stats_l.reply_ratio / std::max<double> (1, stats_l.rtt.count ());
+	};
+	std::stable_sort (representatives_requests.begin (), representatives_requests.end (), [&priority] (nano::representative const & lhs, nano::representative const & rhs) {
+		return priority (lhs) > priority (rhs);
+	});
 	prepared = true;
 }
 
+nano::rep_tracker::rep_stats const & nano::confirmation_solicitor::rep_stats (nano::account const & account_a) const
+{
+	auto existing (stats.find (account_a));
+	return existing != stats.end () ? existing->second : default_stats;
+}
+
+size_t nano::confirmation_solicitor::max_channel_requests (nano::rep_tracker::rep_stats const & stats_a) const
+{
+	auto const max_requests (config.confirm_req_batches_max * nano::network::confirm_req_hashes_max);
+	return std::max<size_t> (nano::network::confirm_req_hashes_max, static_cast<size_t> (max_requests * stats_a.reply_ratio));
+}
+
 bool nano::confirmation_solicitor::broadcast (nano::election const & election_a)
 {
 	debug_assert (prepared);
@@ -57,22 +88,30 @@ bool nano::confirmation_solicitor::add (nano::election const & election_a)
 	debug_assert (prepared);
 	bool error (true);
 	unsigned count = 0;
-	auto const max_channel_requests (config.confirm_req_batches_max * nano::network::confirm_req_hashes_max);
+	auto const elapsed (std::chrono::steady_clock::now () - election_a.election_start);
 	auto const & hash (election_a.status.winner->hash ());
 	for (auto i (representatives_requests.begin ()); i != representatives_requests.end () && count < max_election_requests;)
 	{
 		bool full_queue (false);
 		auto rep (*i);
+		auto const & stats_l (rep_stats (rep.account));
 		auto existing (election_a.last_votes.find (rep.account));
 		bool const exists (existing != election_a.last_votes.end ());
 		bool const is_final (exists && (!election_a.is_quorum.load () || existing->second.timestamp == std::numeric_limits<uint64_t>::max ()));
 		bool const different (exists && existing->second.hash != hash);
-		if (!exists || !is_final || different)
+		// Representatives which reliably vote unprompted are likely to vote before a request reaches them
+		bool const expect_vote (!exists && stats_l.votes_unsolicited () && elapsed < 2 * stats_l.rtt + unsolicited_grace);
+		if (expect_vote)
+		{
+			network.node.stats.inc (nano::stat::type::requests, nano::stat::detail::requests_skipped_unsolicited, nano::stat::dir::out);
+		}
+		else if (!exists || !is_final || different)
 		{
 			auto & request_queue (requests[rep.channel]);
-			if (request_queue.size () < max_channel_requests)
+			if (request_queue.size () < max_channel_requests (stats_l))
 			{
 				request_queue.emplace_back (election_a.status.winner->hash (), election_a.status.winner->root ());
+				requested.emplace_back (rep.account, hash);
 				count += different ? 0 : 1;
 				error = false;
 			}
@@ -109,5 +148,9 @@ void nano::confirmation_solicitor::flush ()
 			channel->send (req);
 		}
 	}
+	for (auto const & [account, hash] : requested)
+	{
+		tracker.requested (account, hash);
+	}
 	prepared = false;
 }
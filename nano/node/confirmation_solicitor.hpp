@@ -3,6 +3,7 @@
 #include <nano/node/network.hpp>
 #include <nano/node/repcrawler.hpp>
 
+#include <chrono>
 #include <unordered_map>
 
 namespace nano
@@ -10,7 +11,11 @@ namespace nano
 class election;
 class node;
 class node_config;
-/** This class accepts elections that need further votes before they can be confirmed and bundles them in to single confirm_req packets */
+/**
+ * This class accepts elections that need further votes before they can be confirmed and bundles them in to single confirm_req packets.
+ * Representatives are asked in order of expected weight delivered per round trip, using the statistics of the rep crawler's tracker.
+ * Representatives which rarely answer get smaller batches and those which reliably vote unprompted are only asked once their vote is overdue.
+ */
 class confirmation_solicitor final
 {
 public:
@@ -29,16 +34,26 @@ public:
 	size_t const max_election_requests;
 	/** Maximum amount of directed broadcasts to be sent per election */
 	size_t const max_election_broadcasts;
+	/** Time given to representatives which vote unprompted on top of twice their round trip time before they are asked */
+	std::chrono::milliseconds const unsolicited_grace;
 
 private:
+	nano::rep_tracker::rep_stats const & rep_stats (nano::account const &) const;
+	/** Maximum amount of hashes requested from the channel of a representative, in proportion to its reply ratio */
+	size_t max_channel_requests (nano::rep_tracker::rep_stats const &) const;
+
 	nano::network & network;
 	nano::node_config const & config;
+	nano::rep_tracker & tracker;
 
 	unsigned rebroadcasted{ 0 };
 	std::vector<nano::representative> representatives_requests;
 	std::vector<nano::representative> representatives_broadcasts;
 	using vector_root_hashes = std::vector<std::pair<nano::block_hash, nano::root>>;
 	std::unordered_map<std::shared_ptr<nano::transport::channel>, vector_root_hashes> requests;
+	std::vector<std::pair<nano::account, nano::block_hash>> requested;
+	std::unordered_map<nano::account, nano::rep_tracker::rep_stats> stats;
+	nano::rep_tracker::rep_stats const default_stats{};
 	bool prepared{ false };
 };
 }
@@ -45,8 +45,11 @@ void nano::election::confirm_once (nano::unique_lock<nano::mutex> & lock_a, nano
 	{
 		node.active.election_winner_details.emplace (status.winner->hash (), shared_from_this ());
 		election_winners_lk.unlock ();
+		node.active.schedule (shared_from_this (), std::chrono::steady_clock::time_point (state_start.load ()) + base_latency () * confirmed_duration_factor);
+		auto duration (std::chrono::steady_clock::now () - election_start);
 		status.election_end = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::system_clock::now ().time_since_epoch ());
-		status.election_duration = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - election_start);
+		status.election_duration = std::chrono::duration_cast<std::chrono::milliseconds> (duration);
+		node.stats.update_histogram (nano::stat::type::latency, nano::stat::detail::election_confirm, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (duration).count ());
 		status.confirmation_request_count = confirmation_request_count;
 		status.block_count = nano::narrow_cast<decltype (status.block_count)> (last_blocks.size ());
 		status.voter_count = nano::narrow_cast<decltype (status.voter_count)> (last_votes.size ());
@@ -128,7 +131,7 @@ bool nano::election::state_change (nano::election::state_t expected_a, nano::ele
 
 void nano::election::send_confirm_req (nano::confirmation_solicitor & solicitor_a)
 {
-	if ((base_latency () * (optimistic () ? 10 : 5)) < (std::chrono::steady_clock::now () - last_req))
+	if (confirm_req_interval () < (std::chrono::steady_clock::now () - last_req))
 	{
 		nano::lock_guard<nano::mutex> guard (mutex);
 		if (!solicitor_a.add (*this))
@@ -141,7 +144,10 @@ void nano::election::send_confirm_req (nano::confirmation_solicitor & solicitor_
 
 void nano::election::transition_active ()
 {
-	state_change (nano::election::state_t::passive, nano::election::state_t::active);
+	if (!state_change (nano::election::state_t::passive, nano::election::state_t::active))
+	{
+		node.active.schedule (shared_from_this (), std::chrono::steady_clock::now ());
+	}
 }
 
 bool nano::election::confirmed () const
@@ -156,7 +162,7 @@ bool nano::election::failed () const
 
 void nano::election::broadcast_block (nano::confirmation_solicitor & solicitor_a)
 {
-	if (base_latency () * 15 < std::chrono::steady_clock::now () - last_block)
+	if (broadcast_interval () < std::chrono::steady_clock::now () - last_block)
 	{
 		nano::lock_guard<nano::mutex> guard (mutex);
 		if (!solicitor_a.broadcast (*this))
@@ -193,9 +199,7 @@ bool nano::election::transition_time (nano::confirmation_solicitor & solicitor_a
 			debug_assert (false);
 			break;
 	}
-	auto const optimistic_expiration_time = node.network_params.network.is_dev_network () ? 500 : 60 * 1000;
-	auto const expire_time = std::chrono::milliseconds (optimistic () ? optimistic_expiration_time : 5 * 60 * 1000);
-	if (!confirmed () && expire_time < std::chrono::steady_clock::now () - election_start)
+	if (!confirmed () && time_to_live () < std::chrono::steady_clock::now () - election_start)
 	{
 		nano::lock_guard<nano::mutex> guard (mutex);
 		// It is possible the election confirmed while acquiring the mutex
@@ -213,6 +217,49 @@ bool nano::election::transition_time (nano::confirmation_solicitor & solicitor_a
 	return result;
 }
 
+std::chrono::steady_clock::time_point nano::election::next_transition () const
+{
+	std::chrono::steady_clock::time_point result;
+	std::chrono::steady_clock::time_point const state_start_l (state_start.load ());
+	switch (state_m)
+	{
+		case nano::election::state_t::passive:
+			result = state_start_l + base_latency () * passive_duration_factor;
+			break;
+		case nano::election::state_t::active:
+			result = std::min (last_block + broadcast_interval (), last_req + confirm_req_interval ());
+			break;
+		case nano::election::state_t::confirmed:
+			result = state_start_l + base_latency () * confirmed_duration_factor;
+			break;
+		case nano::election::state_t::expired_unconfirmed:
+		case nano::election::state_t::expired_confirmed:
+			result = std::chrono::steady_clock::now ();
+			break;
+	}
+	if (!confirmed ())
+	{
+		result = std::min (result, election_start + time_to_live ());
+	}
+	return result;
+}
+
+std::chrono::milliseconds nano::election::confirm_req_interval () const
+{
+	return base_latency () * (optimistic () ? 10 : 5);
+}
+
+std::chrono::milliseconds nano::election::broadcast_interval () const
+{
+	return base_latency () * 15;
+}
+
+std::chrono::milliseconds nano::election::time_to_live () const
+{
+	auto const optimistic_expiration_time = node.network_params.network.is_dev_network () ? 500 : 60 * 1000;
+	return std::chrono::milliseconds (optimistic () ? optimistic_expiration_time : 5 * 60 * 1000);
+}
+
 bool nano::election::have_quorum (nano::tally_t const & tally_a) const
 {
 	auto i (tally_a.begin ());
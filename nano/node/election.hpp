@@ -82,9 +82,17 @@ private: // State management
 	bool valid_change (nano::election::state_t, nano::election::state_t) const;
 	bool state_change (nano::election::state_t, nano::election::state_t);
 
+	std::chrono::milliseconds confirm_req_interval () const;
+	std::chrono::milliseconds broadcast_interval () const;
+	std::chrono::milliseconds time_to_live () const;
+	/** Time of the live entry in active_transactions::transitions, zero when there is none. Managed by active_transactions */
+	std::atomic<std::chrono::steady_clock::duration> scheduled_transition{ std::chrono::steady_clock::duration::zero () };
+
 public: // State transitions
 	bool transition_time (nano::confirmation_solicitor &);
 	void transition_active ();
+	/** Earliest time at which transition_time may change state, request confirmation or broadcast. Reads state only written by transition_time, so it must be called from the same thread */
+	std::chrono::steady_clock::time_point next_transition () const;
 
 public: // Status
 	bool confirmed () const;
@@ -156,5 +164,6 @@ public: // Only used in tests
 	friend class confirmation_solicitor_bypass_max_requests_cap_Test;
 	friend class votes_add_existing_Test;
 	friend class votes_add_old_Test;
+	friend class active_transactions_schedule_transitions_Test;
 };
 }
@@ -1,6 +1,8 @@
 #include <nano/node/election_scheduler.hpp>
 #include <nano/node/node.hpp>
 
+#include <algorithm>
+
 nano::election_scheduler::election_scheduler (nano::node & node) :
 	node{ node },
 	stopped{ false },
@@ -22,8 +24,48 @@ void nano::election_scheduler::manual (std::shared_ptr<nano::block> const & bloc
 }
 
 void nano::election_scheduler::activate (nano::account const & account_a, nano::transaction const & transaction)
+{
+	uint64_t modified;
+	auto block (activatable (account_a, transaction, modified));
+	if (block != nullptr)
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		priority.push (modified, block);
+		notify ();
+	}
+}
+
+void nano::election_scheduler::activate (std::vector<nano::account> accounts_a, nano::transaction const & transaction)
+{
+	// Looking accounts up in key order makes consecutive reads hit neighbouring database pages
+	std::sort (accounts_a.begin (), accounts_a.end ());
+	accounts_a.erase (std::unique (accounts_a.begin (), accounts_a.end ()), accounts_a.end ());
+	std::vector<std::pair<uint64_t, std::shared_ptr<nano::block>>> blocks;
+	blocks.reserve (accounts_a.size ());
+	for (auto const & account : accounts_a)
+	{
+		uint64_t modified;
+		auto block (activatable (account, transaction, modified));
+		if (block != nullptr)
+		{
+			blocks.emplace_back (modified, std::move (block));
+		}
+	}
+	if (!blocks.empty ())
+	{
+		nano::lock_guard<nano::mutex> lock{ mutex };
+		for (auto const & [modified, block] : blocks)
+		{
+			priority.push (modified, block);
+		}
+		notify ();
+	}
+}
+
+std::shared_ptr<nano::block> nano::election_scheduler::activatable (nano::account const & account_a, nano::transaction const & transaction, uint64_t & modified_a) const
 {
 	debug_assert (!account_a.is_zero ());
+	std::shared_ptr<nano::block> result;
 	nano::account_info account_info;
 	if (!node.store.account.get (transaction, account_a, account_info))
 	{
@@ -37,12 +79,12 @@ void nano::election_scheduler::activate (nano::account const & account_a, nano::
 			debug_assert (block != nullptr);
 			if (node.ledger.dependents_confirmed (transaction, *block))
 			{
-				nano::lock_guard<nano::mutex> lock{ mutex };
-				priority.push (account_info.modified, block);
-				notify ();
+				modified_a = account_info.modified;
+				result = block;
 			}
 		}
 	}
+	return result;
 }
 
 void nano::election_scheduler::stop ()
@@ -10,6 +10,7 @@
 #include <deque>
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace nano
 {
@@ -25,6 +26,8 @@ public:
 	void manual (std::shared_ptr<nano::block> const &, boost::optional<nano::uint128_t> const & = boost::none, nano::election_behavior = nano::election_behavior::normal, std::function<void (std::shared_ptr<nano::block> const &)> const & = nullptr);
 	// Activates the first unconfirmed block of \p account_a
 	void activate (nano::account const &, nano::transaction const &);
+	// Activates the first unconfirmed block of each of \p accounts_a, looked up in key order and queued under a single lock
+	void activate (std::vector<nano::account> accounts_a, nano::transaction const &);
 	void stop ();
 	// Blocks until no more elections can be activated or there are no more elections to activate
 	void flush ();
@@ -35,6 +38,8 @@ public:
 
 private:
 	void run ();
+	// Returns the first unconfirmed block of \p account_a if its dependents are confirmed, otherwise nullptr
+	std::shared_ptr<nano::block> activatable (nano::account const & account_a, nano::transaction const &, uint64_t & modified_a) const;
 	bool empty_locked () const;
 	bool priority_queue_predicate () const;
 	bool manual_queue_predicate () const;
@@ -0,0 +1,224 @@
+#include <nano/crypto_lib/random_pool.hpp>
+#include <nano/lib/stats.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/node/inactive_votes_cache.hpp>
+
+#include <algorithm>
+
+nano::inactive_votes_cache::inactive_votes_cache (std::size_t max_size_a, nano::stat & stats_a) :
+	stats (stats_a),
+	entries (std::max<std::size_t> (max_size_a, 1))
+{
+	debug_assert (entries.size () < empty);
+	unused.reserve (entries.size ());
+	for (auto i (entries.size ()); i > 0; --i)
+	{
+		unused.push_back (static_cast<uint32_t> (i - 1));
+	}
+	std::size_t table_size (2);
+	while (table_size < entries.size () * 2)
+	{
+		table_size *= 2;
+	}
+	table.resize (table_size, empty);
+	nano::random_pool::generate_block (key, key.size ());
+}
+
+bool nano::inactive_votes_cache::vote (nano::block_hash const & hash_a, nano::account const & representative_a, uint64_t timestamp_a, nano::uint128_t const & weight_a, nano::inactive_cache_status & status_a, std::size_t & voters_a)
+{
+	auto result (true);
+	auto now (std::chrono::steady_clock::now ());
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing (position (hash_a));
+	uint32_t index;
+	if (existing != not_found)
+	{
+		index = table[existing];
+	}
+	else
+	{
+		index = allocate ();
+		auto & entry_l (entries[index]);
+		entry_l.hash = hash_a;
+		entry_l.arrival = now;
+		entry_l.status = nano::inactive_cache_status{};
+		entry_l.voter_count = 0;
+		auto i (home (hash_a));
+		while (table[i] != empty)
+		{
+			i = (i + 1) & (table.size () - 1);
+		}
+		table[i] = index;
+		stats.inc (nano::stat::type::inactive_votes_cache, nano::stat::detail::insert);
+	}
+	auto & entry_l (entries[index]);
+	entry_l.referenced = true;
+	auto const & status_l (entry_l.status);
+	if (!status_l.bootstrap_started || !status_l.election_started || !status_l.confirmed)
+	{
+		auto begin (entry_l.voters.begin ());
+		auto end (begin + entry_l.voter_count);
+		if (std::none_of (begin, end, [&representative_a] (voter const & voter_a) { return voter_a.account == representative_a; }))
+		{
+			if (entry_l.voter_count < max_voters)
+			{
+				*end = voter{ representative_a, timestamp_a, weight_a };
+				++entry_l.voter_count;
+				entry_l.status.tally += weight_a;
+				result = false;
+			}
+			else
+			{
+				auto lightest (std::min_element (begin, end, [] (voter const & first_a, voter const & second_a) { return first_a.weight < second_a.weight; }));
+				if (lightest->weight.number () < weight_a)
+				{
+					entry_l.status.tally -= lightest->weight.number ();
+					entry_l.status.tally += weight_a;
+					*lightest = voter{ representative_a, timestamp_a, weight_a };
+					result = false;
+					stats.inc (nano::stat::type::inactive_votes_cache, nano::stat::detail::voter_replaced);
+				}
+				else
+				{
+					stats.inc (nano::stat::type::inactive_votes_cache, nano::stat::detail::voter_dropped);
+				}
+			}
+		}
+	}
+	if (!result)
+	{
+		entry_l.arrival = now;
+		status_a = entry_l.status;
+		voters_a = entry_l.voter_count;
+		stats.inc (nano::stat::type::inactive_votes_cache, nano::stat::detail::vote_new);
+	}
+	return result;
+}
+
+void nano::inactive_votes_cache::update (nano::block_hash const & hash_a, nano::inactive_cache_status const & status_a)
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing (position (hash_a));
+	if (existing != not_found)
+	{
+		auto & status_l (entries[table[existing]].status);
+		status_l.bootstrap_started |= status_a.bootstrap_started;
+		status_l.election_started |= status_a.election_started;
+		status_l.confirmed |= status_a.confirmed;
+	}
+}
+
+nano::inactive_cache_information nano::inactive_votes_cache::find (nano::block_hash const & hash_a) const
+{
+	nano::inactive_cache_information result;
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing (position (hash_a));
+	if (existing != not_found)
+	{
+		auto const & entry_l (entries[table[existing]]);
+		result.arrival = entry_l.arrival;
+		result.hash = entry_l.hash;
+		result.status = entry_l.status;
+		result.voters.reserve (entry_l.voter_count);
+		std::for_each (entry_l.voters.begin (), entry_l.voters.begin () + entry_l.voter_count, [&result] (voter const & voter_a) {
+			result.voters.emplace_back (voter_a.account, voter_a.timestamp);
+		});
+	}
+	return result;
+}
+
+void nano::inactive_votes_cache::erase (nano::block_hash const & hash_a)
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing (position (hash_a));
+	if (existing != not_found)
+	{
+		auto index (table[existing]);
+		entries[index].referenced = false;
+		remove (existing);
+		unused.push_back (index);
+	}
+}
+
+std::size_t nano::inactive_votes_cache::size () const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	return entries.size () - unused.size ();
+}
+
+std::size_t nano::inactive_votes_cache::capacity () const
+{
+	return entries.size ();
+}
+
+std::size_t nano::inactive_votes_cache::home (nano::block_hash const & hash_a) const
+{
+	uint64_t digest;
+	siphash_t siphash (key, static_cast<unsigned int> (key.size ()));
+	siphash.CalculateDigest (reinterpret_cast<uint8_t *> (&digest), hash_a.bytes.data (), hash_a.bytes.size ());
+	return digest & (table.size () - 1);
+}
+
+// Must be called with the mutex held
+std::size_t nano::inactive_votes_cache::position (nano::block_hash const & hash_a) const
+{
+	auto result (not_found);
+	for (auto i (home (hash_a)); result == not_found && table[i] != empty; i = (i + 1) & (table.size () - 1))
+	{
+		if (entries[table[i]].hash == hash_a)
+		{
+			result = i;
+		}
+	}
+	return result;
+}
+
+// Must be called with the mutex held
+void nano::inactive_votes_cache::remove (std::size_t position_a)
+{
+	auto const mask (table.size () - 1);
+	auto hole (position_a);
+	for (auto i ((hole + 1) & mask); table[i] != empty; i = (i + 1) & mask)
+	{
+		// An entry may move back into the hole unless its home lies cyclically after the hole, up to its current position
+		auto home_l (home (entries[table[i]].hash));
+		if (((i - home_l) & mask) >= ((i - hole) & mask))
+		{
+			table[hole] = table[i];
+			hole = i;
+		}
+	}
+	table[hole] = empty;
+}
+
+// Must be called with the mutex held
+uint32_t nano::inactive_votes_cache::allocate ()
+{
+	uint32_t result;
+	if (!unused.empty ())
+	{
+		result = unused.back ();
+		unused.pop_back ();
+	}
+	else
+	{
+		// Every entry is in use, referenced entries get a second chance until the hand finds one which is not
+		while (entries[hand].referenced)
+		{
+			entries[hand].referenced = false;
+			hand = (hand + 1) % entries.size ();
+		}
+		result = static_cast<uint32_t> (hand);
+		hand = (hand + 1) % entries.size ();
+		auto existing (position (entries[result].hash));
+		debug_assert (existing != not_found);
+		remove (existing);
+		stats.inc (nano::stat::type::inactive_votes_cache, nano::stat::detail::evict);
+	}
+	return result;
+}
+
+std::unique_ptr<nano::container_info_component> nano::inactive_votes_cache::collect_container_info (std::string const & name) const
+{
+	return std::make_unique<container_info_leaf> (container_info{ name, size (), sizeof (entry) });
+}
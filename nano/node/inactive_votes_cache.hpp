@@ -0,0 +1,118 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/lib/numbers.hpp>
+
+#include <crypto/cryptopp/seckey.h>
+#include <crypto/cryptopp/siphash.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nano
+{
+class container_info_component;
+class stat;
+
+class inactive_cache_status final
+{
+public:
+	bool bootstrap_started{ false };
+	bool election_started{ false }; // Did item reach config threshold to start an impromptu election?
+	bool confirmed{ false }; // Did item reach votes quorum? (minimum config value)
+	nano::uint128_t tally{ 0 }; // Last votes tally for block
+
+	bool operator!= (inactive_cache_status const other) const
+	{
+		return bootstrap_started != other.bootstrap_started || election_started != other.election_started || confirmed != other.confirmed || tally != other.tally;
+	}
+};
+
+class inactive_cache_information final
+{
+public:
+	std::chrono::steady_clock::time_point arrival;
+	nano::block_hash hash;
+	nano::inactive_cache_status status;
+	std::vector<std::pair<nano::account, uint64_t>> voters;
+	bool needs_eval () const
+	{
+		return !status.bootstrap_started || !status.election_started || !status.confirmed;
+	}
+};
+
+/**
+ * Votes from principal representatives for blocks without an election, kept until the block arrives or the votes are enough to start an election or bootstrap.
+ * Entries are preallocated and found through an open addressing table with linear probing, keyed by a salted SipHash of the block hash, so caching a vote never allocates.
+ * Each entry holds up to max_voters voters inline along with the running tally of their weights. Once full, a new voter only replaces the lightest voter if it is heavier.
+ * When every entry is in use the oldest entry not voted for since the previous pass of the CLOCK hand is evicted.
+ * @note This class is thread-safe
+ */
+class inactive_votes_cache final
+{
+public:
+	inactive_votes_cache (std::size_t max_size_a, nano::stat &);
+	/**
+	 * Adds the vote of \p representative_a with weight \p weight_a for \p hash_a, creating the entry if there is none.
+	 * On success \p status_a receives the entry status including the new tally and \p voters_a the number of voters in the entry.
+	 * @return true if the vote was not added because the representative already voted, the entry needs no further evaluation or the entry is full of heavier voters
+	 */
+	bool vote (nano::block_hash const & hash_a, nano::account const & representative_a, uint64_t timestamp_a, nano::uint128_t const & weight_a, nano::inactive_cache_status & status_a, std::size_t & voters_a);
+	/** Records the flags of \p status_a in the entry for \p hash_a, keeping its tally. Flags which are already set stay set */
+	void update (nano::block_hash const & hash_a, nano::inactive_cache_status const & status_a);
+	/** Returns a copy of the entry for \p hash_a, with no voters if there is no such entry */
+	nano::inactive_cache_information find (nano::block_hash const & hash_a) const;
+	void erase (nano::block_hash const & hash_a);
+	std::size_t size () const;
+	std::size_t capacity () const;
+	std::unique_ptr<nano::container_info_component> collect_container_info (std::string const &) const;
+
+	static std::size_t constexpr max_voters{ 16 };
+
+private:
+	class voter final
+	{
+	public:
+		nano::account account;
+		uint64_t timestamp;
+		nano::amount weight;
+	};
+	class entry final
+	{
+	public:
+		nano::block_hash hash;
+		std::chrono::steady_clock::time_point arrival;
+		nano::inactive_cache_status status;
+		std::array<voter, max_voters> voters;
+		uint8_t voter_count{ 0 };
+		/** Set when voted for, cleared by the CLOCK hand */
+		bool referenced{ false };
+	};
+	using siphash_t = CryptoPP::SipHash<2, 4, false>;
+
+	std::size_t home (nano::block_hash const &) const;
+	/** Returns the table position holding \p hash_a, or not_found */
+	std::size_t position (nano::block_hash const & hash_a) const;
+	/** Clears table position \p position_a, shifting back the entries probed past it */
+	void remove (std::size_t position_a);
+	/** Returns the index of an unused entry, evicting one if every entry is in use */
+	uint32_t allocate ();
+
+	static std::size_t constexpr not_found{ std::numeric_limits<std::size_t>::max () };
+	static uint32_t constexpr empty{ std::numeric_limits<uint32_t>::max () };
+
+	nano::stat & stats;
+	std::vector<entry> entries;
+	std::vector<uint32_t> unused;
+	/** Indices into entries, sized to a power of two at least twice the number of entries */
+	std::vector<uint32_t> table;
+	std::size_t hand{ 0 };
+	CryptoPP::SecByteBlock key{ siphash_t::KEYLENGTH };
+	mutable nano::mutex mutex;
+};
+}
@@ -3,9 +3,27 @@
 #include <nano/node/ipc/flatbuffers_util.hpp>
 #include <nano/secure/common.hpp>
 
-std::unique_ptr<nanoapi::BlockStateT> nano::ipc::flatbuffers_builder::from (nano::state_block const & block_a, nano::amount const & amount_a, bool is_state_send_a)
+nanoapi::BlockSubType nano::ipc::flatbuffers_builder::state_subtype (nano::state_block const & block_a, nano::amount const & amount_a, bool is_state_send_a)
 {
 	static nano::network_params params;
+	auto result (nanoapi::BlockSubType::BlockSubType_receive);
+	if (is_state_send_a)
+	{
+		result = nanoapi::BlockSubType::BlockSubType_send;
+	}
+	else if (block_a.link ().is_zero ())
+	{
+		result = nanoapi::BlockSubType::BlockSubType_change;
+	}
+	else if (amount_a == 0 && params.ledger.epochs.is_epoch_link (block_a.link ()))
+	{
+		result = nanoapi::BlockSubType::BlockSubType_epoch;
+	}
+	return result;
+}
+
+std::unique_ptr<nanoapi::BlockStateT> nano::ipc::flatbuffers_builder::from (nano::state_block const & block_a, nano::amount const & amount_a, bool is_state_send_a)
+{
 	auto block (std::make_unique<nanoapi::BlockStateT> ());
 	block->account = block_a.account ().to_account ();
 	block->hash = block_a.hash ().to_string ();
@@ -17,22 +35,7 @@ std::unique_ptr<nanoapi::BlockStateT> nano::ipc::flatbuffers_builder::from (nano
 	block_a.signature.encode_hex (block->signature);
 	block->work = nano::to_string_hex (block_a.work);
 
-	if (is_state_send_a)
-	{
-		block->subtype = nanoapi::BlockSubType::BlockSubType_send;
-	}
-	else if (block_a.link ().is_zero ())
-	{
-		block->subtype = nanoapi::BlockSubType::BlockSubType_change;
-	}
-	else if (amount_a == 0 && params.ledger.epochs.is_epoch_link (block_a.link ()))
-	{
-		block->subtype = nanoapi::BlockSubType::BlockSubType_epoch;
-	}
-	else
-	{
-		block->subtype = nanoapi::BlockSubType::BlockSubType_receive;
-	}
+	block->subtype = state_subtype (block_a, amount_a, is_state_send_a);
 	return block;
 }
 
@@ -118,3 +121,109 @@ nanoapi::BlockUnion nano::ipc::flatbuffers_builder::block_to_union (nano::block
 	}
 	return u;
 }
+
+flatbuffers::Offset<void> nano::ipc::flatbuffers_builder::build (flatbuffers::FlatBufferBuilder & fbb_a, nano::block const & block_a, nano::amount const & amount_a, bool is_state_send_a, nanoapi::Block & type_a)
+{
+	// Strings must be created before starting the table which refers to them
+	auto hash (fbb_a.CreateString (block_a.hash ().to_string ()));
+	std::string signature_l;
+	block_a.block_signature ().encode_hex (signature_l);
+	auto signature (fbb_a.CreateString (signature_l));
+	auto work (fbb_a.CreateString (nano::to_string_hex (block_a.block_work ())));
+	flatbuffers::Offset<void> result;
+	switch (block_a.type ())
+	{
+		case nano::block_type::state:
+		{
+			auto const & state (static_cast<nano::state_block const &> (block_a));
+			auto account (fbb_a.CreateString (state.account ().to_account ()));
+			auto previous (fbb_a.CreateString (state.previous ().to_string ()));
+			auto representative (fbb_a.CreateString (state.representative ().to_account ()));
+			auto balance (fbb_a.CreateString (state.balance ().to_string_dec ()));
+			auto link (fbb_a.CreateString (state.link ().to_string ()));
+			auto link_as_account (fbb_a.CreateString (state.link ().to_account ()));
+			nanoapi::BlockStateBuilder builder (fbb_a);
+			builder.add_hash (hash);
+			builder.add_account (account);
+			builder.add_previous (previous);
+			builder.add_representative (representative);
+			builder.add_balance (balance);
+			builder.add_link (link);
+			builder.add_link_as_account (link_as_account);
+			builder.add_signature (signature);
+			builder.add_work (work);
+			builder.add_subtype (state_subtype (state, amount_a, is_state_send_a));
+			result = builder.Finish ().Union ();
+			type_a = nanoapi::Block::Block_BlockState;
+			break;
+		}
+		case nano::block_type::send:
+		{
+			auto const & send (static_cast<nano::send_block const &> (block_a));
+			auto previous (fbb_a.CreateString (send.previous ().to_string ()));
+			auto destination (fbb_a.CreateString (send.hashables.destination.to_account ()));
+			auto balance (fbb_a.CreateString (send.balance ().to_string_dec ()));
+			nanoapi::BlockSendBuilder builder (fbb_a);
+			builder.add_hash (hash);
+			builder.add_previous (previous);
+			builder.add_destination (destination);
+			builder.add_balance (balance);
+			builder.add_signature (signature);
+			builder.add_work (work);
+			result = builder.Finish ().Union ();
+			type_a = nanoapi::Block::Block_BlockSend;
+			break;
+		}
+		case nano::block_type::receive:
+		{
+			auto const & receive (static_cast<nano::receive_block const &> (block_a));
+			auto previous (fbb_a.CreateString (receive.previous ().to_string ()));
+			auto source (fbb_a.CreateString (receive.source ().to_string ()));
+			nanoapi::BlockReceiveBuilder builder (fbb_a);
+			builder.add_hash (hash);
+			builder.add_previous (previous);
+			builder.add_source (source);
+			builder.add_signature (signature);
+			builder.add_work (work);
+			result = builder.Finish ().Union ();
+			type_a = nanoapi::Block::Block_BlockReceive;
+			break;
+		}
+		case nano::block_type::open:
+		{
+			auto const & open (static_cast<nano::open_block const &> (block_a));
+			auto account (fbb_a.CreateString (open.account ().to_account ()));
+			auto source (fbb_a.CreateString (open.source ().to_string ()));
+			auto representative (fbb_a.CreateString (open.representative ().to_account ()));
+			nanoapi::BlockOpenBuilder builder (fbb_a);
+			builder.add_hash (hash);
+			builder.add_account (account);
+			builder.add_source (source);
+			builder.add_representative (representative);
+			builder.add_signature (signature);
+			builder.add_work (work);
+			result = builder.Finish ().Union ();
+			type_a = nanoapi::Block::Block_BlockOpen;
+			break;
+		}
+		case nano::block_type::change:
+		{
+			auto const & change (static_cast<nano::change_block const &> (block_a));
+			auto previous (fbb_a.CreateString (change.previous ().to_string ()));
+			auto representative (fbb_a.CreateString (change.representative ().to_account ()));
+			nanoapi::BlockChangeBuilder builder (fbb_a);
+			builder.add_hash (hash);
+			builder.add_previous (previous);
+			builder.add_representative (representative);
+			builder.add_signature (signature);
+			builder.add_work (work);
+			result = builder.Finish ().Union ();
+			type_a = nanoapi::Block::Block_BlockChange;
+			break;
+		}
+		default:
+			debug_assert (false);
+			type_a = nanoapi::Block::Block_NONE;
+	}
+	return result;
+}
@@ -4,6 +4,8 @@
 
 #include <memory>
 
+#include <flatbuffers/flatbuffers.h>
+
 namespace nano
 {
 class amount;
@@ -27,6 +29,13 @@ namespace ipc
 		static std::unique_ptr<nanoapi::BlockReceiveT> from (nano::receive_block const & block_a);
 		static std::unique_ptr<nanoapi::BlockOpenT> from (nano::open_block const & block_a);
 		static std::unique_ptr<nanoapi::BlockChangeT> from (nano::change_block const & block_a);
+		/**
+		 * Builds the block table directly into \p fbb_a, without going through the object API
+		 * @param type_a Receives the union type of the block
+		 * @return Offset of the block table, to be stored in a Block union field
+		 */
+		static flatbuffers::Offset<void> build (flatbuffers::FlatBufferBuilder & fbb_a, nano::block const & block_a, nano::amount const & amount_a, bool is_state_send_a, nanoapi::Block & type_a);
+		static nanoapi::BlockSubType state_subtype (nano::state_block const & block_a, nano::amount const & amount_a, bool is_state_send_a);
 	};
 }
 }
@@ -6,6 +6,12 @@
 #include <nano/node/ipc/ipc_server.hpp>
 #include <nano/node/node.hpp>
 
+#include <boost/optional.hpp>
+
+#include <array>
+
+size_t constexpr nano::ipc::broker::max_outstanding_confirmations;
+
 nano::ipc::broker::broker (nano::node & node_a) :
 	node (node_a)
 {
@@ -20,6 +26,31 @@ std::shared_ptr<flatbuffers::Parser> nano::ipc::subscriber::get_parser (nano::ip
 	return parser;
 }
 
+nano::ipc::confirmation_subscription::confirmation_subscription (std::weak_ptr<nano::ipc::subscriber> const & subscriber_a, std::shared_ptr<nanoapi::TopicConfirmationT> const & topic_a) :
+	subscriber (subscriber_a),
+	topic (topic_a)
+{
+	using Filter = nanoapi::TopicConfirmationTypeFilter;
+	if (auto & options = topic_a->options)
+	{
+		auto conf_filter (options->confirmation_type_filter);
+		active = conf_filter != Filter::TopicConfirmationTypeFilter_inactive;
+		inactive = conf_filter == Filter::TopicConfirmationTypeFilter_all || conf_filter == Filter::TopicConfirmationTypeFilter_inactive;
+		all_local_accounts = options->all_local_accounts;
+		account_filter = all_local_accounts || !options->accounts.empty ();
+		for (auto const & account_text : options->accounts)
+		{
+			nano::account account;
+			if (!account.decode_account (account_text))
+			{
+				accounts.insert (account);
+			}
+		}
+		include_block = options->include_block;
+		include_election_info = options->include_election_info;
+	}
+}
+
 void nano::ipc::broker::start ()
 {
 	node.observers.blocks.add ([this_l = shared_from_this ()] (nano::election_status const & status_a, std::vector<nano::vote_with_weight_info> const & votes_a, nano::account const & account_a, nano::amount const & amount_a, bool is_state_send_a) {
@@ -31,36 +62,7 @@ void nano::ipc::broker::start ()
 			// is that broadcast is called only to not find any live sessions.
 			if (this_l->confirmation_subscriber_count () > 0)
 			{
-				auto confirmation (std::make_shared<nanoapi::EventConfirmationT> ());
-
-				confirmation->account = account_a.to_account ();
-				confirmation->amount = amount_a.to_string_dec ();
-				switch (status_a.type)
-				{
-					case nano::election_status_type::active_confirmed_quorum:
-						confirmation->confirmation_type = nanoapi::TopicConfirmationType::TopicConfirmationType_active_quorum;
-						break;
-					case nano::election_status_type::active_confirmation_height:
-						confirmation->confirmation_type = nanoapi::TopicConfirmationType::TopicConfirmationType_active_confirmation_height;
-						break;
-					case nano::election_status_type::inactive_confirmation_height:
-						confirmation->confirmation_type = nanoapi::TopicConfirmationType::TopicConfirmationType_inactive;
-						break;
-					default:
-						debug_assert (false);
-						break;
-				};
-				confirmation->confirmation_type = nanoapi::TopicConfirmationType::TopicConfirmationType_active_quorum;
-				confirmation->block = nano::ipc::flatbuffers_builder::block_to_union (*status_a.winner, amount_a, is_state_send_a);
-				confirmation->election_info = std::make_unique<nanoapi::ElectionInfoT> ();
-				confirmation->election_info->duration = status_a.election_duration.count ();
-				confirmation->election_info->time = status_a.election_end.count ();
-				confirmation->election_info->tally = status_a.tally.to_string_dec ();
-				confirmation->election_info->block_count = status_a.block_count;
-				confirmation->election_info->voter_count = status_a.voter_count;
-				confirmation->election_info->request_count = status_a.confirmation_request_count;
-
-				this_l->broadcast (confirmation);
+				this_l->broadcast (status_a, account_a, amount_a, is_state_send_a);
 			}
 		}
 		catch (nano::error const & err)
@@ -109,114 +111,145 @@ void nano::ipc::broker::subscribe (std::weak_ptr<nano::ipc::subscriber> const &
 	subscribe_or_unsubscribe (node.logger, subscribers.get (), subscriber_a, confirmation_a);
 }
 
-void nano::ipc::broker::broadcast (std::shared_ptr<nanoapi::EventConfirmationT> const & confirmation_a)
+void nano::ipc::broker::broadcast (nano::election_status const & status_a, nano::account const & account_a, nano::amount const & amount_a, bool is_state_send_a)
 {
-	using Filter = nanoapi::TopicConfirmationTypeFilter;
-	decltype (confirmation_a->election_info) election_info;
-	nanoapi::BlockUnion block;
-	auto itr (confirmation_subscribers->begin ());
-	while (itr != confirmation_subscribers->end ())
+	auto confirmation_type (nanoapi::TopicConfirmationType::TopicConfirmationType_active_quorum);
+	switch (status_a.type)
 	{
-		if (auto subscriber_l = itr->subscriber.lock ())
-		{
-			auto should_filter = [this, &itr, confirmation_a] () {
-				debug_assert (itr->topic->options != nullptr);
-				auto conf_filter (itr->topic->options->confirmation_type_filter);
-
-				bool should_filter_conf_type_l (true);
-				bool all_filter = conf_filter == Filter::TopicConfirmationTypeFilter_all;
-				bool inactive_filter = conf_filter == Filter::TopicConfirmationTypeFilter_inactive;
-				bool active_filter = conf_filter == Filter::TopicConfirmationTypeFilter_active || conf_filter == Filter::TopicConfirmationTypeFilter_active_quorum || conf_filter == Filter::TopicConfirmationTypeFilter_active_confirmation_height;
+		case nano::election_status_type::active_confirmed_quorum:
+			break;
+		case nano::election_status_type::active_confirmation_height:
+			confirmation_type = nanoapi::TopicConfirmationType::TopicConfirmationType_active_confirmation_height;
+			break;
+		case nano::election_status_type::inactive_confirmation_height:
+			confirmation_type = nanoapi::TopicConfirmationType::TopicConfirmationType_inactive;
+			break;
+		default:
+			debug_assert (false);
+			break;
+	};
+	auto inactive (confirmation_type == nanoapi::TopicConfirmationType::TopicConfirmationType_inactive);
 
-				if ((confirmation_a->confirmation_type == nanoapi::TopicConfirmationType::TopicConfirmationType_active_quorum || confirmation_a->confirmation_type == nanoapi::TopicConfirmationType::TopicConfirmationType_active_confirmation_height) && (all_filter || active_filter))
-				{
-					should_filter_conf_type_l = false;
-				}
-				else if (confirmation_a->confirmation_type == nanoapi::TopicConfirmationType::TopicConfirmationType_inactive && (all_filter || inactive_filter))
-				{
-					should_filter_conf_type_l = false;
-				}
-
-				bool should_filter_account_l (itr->topic->options->all_local_accounts || !itr->topic->options->accounts.empty ());
-				auto state (confirmation_a->block.AsBlockState ());
-				if (state && !should_filter_conf_type_l)
-				{
-					if (itr->topic->options->all_local_accounts)
-					{
-						auto transaction_l (this->node.wallets.tx_begin_read ());
-						nano::account source_l (0), destination_l (0);
-						auto decode_source_ok_l (!source_l.decode_account (state->account));
-						auto decode_destination_ok_l (!destination_l.decode_account (state->link_as_account));
-						(void)decode_source_ok_l;
-						(void)decode_destination_ok_l;
-						debug_assert (decode_source_ok_l && decode_destination_ok_l);
-						if (this->node.wallets.exists (transaction_l, source_l) || this->node.wallets.exists (transaction_l, destination_l))
-						{
-							should_filter_account_l = false;
-						}
-					}
+	// Account filters only apply to state blocks, matching either the account or the link as an account
+	auto state (dynamic_cast<nano::state_block const *> (status_a.winner.get ()));
+	boost::optional<bool> local_l;
+	auto local = [this, state, &local_l] () {
+		if (!local_l)
+		{
+			auto transaction_l (node.wallets.tx_begin_read ());
+			local_l = node.wallets.exists (transaction_l, state->account ()) || node.wallets.exists (transaction_l, state->link ().as_account ());
+		}
+		return *local_l;
+	};
 
-					if (std::find (itr->topic->options->accounts.begin (), itr->topic->options->accounts.end (), state->account) != itr->topic->options->accounts.end () || std::find (itr->topic->options->accounts.begin (), itr->topic->options->accounts.end (), state->link_as_account) != itr->topic->options->accounts.end ())
-					{
-						should_filter_account_l = false;
-					}
-				}
+	// Flatbuffers, and their JSON conversions, indexed by include_block * 2 + include_election_info. Built on first use.
+	std::array<std::shared_ptr<flatbuffers::FlatBufferBuilder>, 4> buffers;
+	std::array<std::shared_ptr<std::string>, 4> json;
+	auto build = [&status_a, &account_a, &amount_a, is_state_send_a, confirmation_type] (bool include_block_a, bool include_election_info_a) {
+		nano::ipc::flatbuffer_producer producer;
+		auto fbb (producer.get_shared_flatbuffer ());
+		auto account (fbb->CreateString (account_a.to_account ()));
+		auto amount (fbb->CreateString (amount_a.to_string_dec ()));
+		auto hash (fbb->CreateString (status_a.winner->hash ().to_string ()));
+		flatbuffers::Offset<void> block;
+		nanoapi::Block block_type{ nanoapi::Block::Block_NONE };
+		if (include_block_a)
+		{
+			block = nano::ipc::flatbuffers_builder::build (*fbb, *status_a.winner, amount_a, is_state_send_a, block_type);
+		}
+		flatbuffers::Offset<nanoapi::ElectionInfo> election_info;
+		if (include_election_info_a)
+		{
+			auto tally (fbb->CreateString (status_a.tally.to_string_dec ()));
+			nanoapi::ElectionInfoBuilder info (*fbb);
+			info.add_duration (status_a.election_duration.count ());
+			info.add_time (status_a.election_end.count ());
+			info.add_tally (tally);
+			info.add_block_count (status_a.block_count);
+			info.add_voter_count (status_a.voter_count);
+			info.add_request_count (status_a.confirmation_request_count);
+			election_info = info.Finish ();
+		}
+		nanoapi::EventConfirmationBuilder builder (*fbb);
+		builder.add_confirmation_type (confirmation_type);
+		builder.add_account (account);
+		builder.add_amount (amount);
+		builder.add_hash (hash);
+		if (include_block_a)
+		{
+			builder.add_block_type (block_type);
+			builder.add_block (block);
+		}
+		if (include_election_info_a)
+		{
+			builder.add_election_info (election_info);
+		}
+		producer.create_builder_response (builder);
+		return fbb;
+	};
 
-				return should_filter_conf_type_l || should_filter_account_l;
-			};
-			// Apply any filters
-			auto & options (itr->topic->options);
-			if (options)
+	auto subscribers (confirmation_subscribers.lock ());
+	auto itr (subscribers->begin ());
+	while (itr != subscribers->end ())
+	{
+		if (auto subscriber_l = itr->subscriber.lock ())
+		{
+			auto & subscription (*itr);
+			auto matches (inactive ? subscription.inactive : subscription.active);
+			if (matches && subscription.account_filter)
 			{
-				if (!options->include_election_info)
-				{
-					election_info = std::move (confirmation_a->election_info);
-					confirmation_a->election_info = nullptr;
-				}
-				if (!options->include_block)
-				{
-					block = confirmation_a->block;
-					confirmation_a->block.Reset ();
-				}
+				matches = state != nullptr && ((subscription.accounts.count (state->account ()) > 0 || subscription.accounts.count (state->link ().as_account ()) > 0) || (subscription.all_local_accounts && local ()));
 			}
-			if (!options || !should_filter ())
+			if (matches && *subscription.outstanding >= max_outstanding_confirmations)
 			{
-				auto fb (nano::ipc::flatbuffer_producer::make_buffer (*confirmation_a));
-
+				++subscription.dropped;
+				node.stats.inc (nano::stat::type::ipc, nano::stat::detail::confirmation_drop);
+			}
+			else if (matches)
+			{
+				auto index ((subscription.include_block ? 2 : 0) + (subscription.include_election_info ? 1 : 0));
+				if (!buffers[index])
+				{
+					buffers[index] = build (subscription.include_block, subscription.include_election_info);
+				}
+				auto fb (buffers[index]);
+				auto outstanding (subscription.outstanding);
+				++*outstanding;
 				if (subscriber_l->get_active_encoding () == nano::ipc::payload_encoding::flatbuffers_json)
 				{
-					auto parser (subscriber_l->get_parser (node.config.ipc_config));
-
-					// Convert response to JSON
-					auto json (std::make_shared<std::string> ());
-					if (!flatbuffers::GenerateText (*parser, fb->GetBufferPointer (), json.get ()))
+					if (!json[index])
 					{
-						throw nano::error ("Couldn't serialize response to JSON");
-					}
+						auto parser (subscriber_l->get_parser (node.config.ipc_config));
 
-					subscriber_l->async_send_message (reinterpret_cast<uint8_t const *> (json->data ()), json->size (), [json] (const nano::error & err) {});
+						// Convert response to JSON
+						json[index] = std::make_shared<std::string> ();
+						if (!flatbuffers::GenerateText (*parser, fb->GetBufferPointer (), json[index].get ()))
+						{
+							--*outstanding;
+							throw nano::error ("Couldn't serialize response to JSON");
+						}
+					}
+					auto json_l (json[index]);
+					subscriber_l->async_send_message (reinterpret_cast<uint8_t const *> (json_l->data ()), json_l->size (), [json_l, outstanding] (const nano::error & err) {
+						--*outstanding;
+					});
 				}
 				else
 				{
-					subscriber_l->async_send_message (fb->GetBufferPointer (), fb->GetSize (), [fb] (const nano::error & err) {});
+					subscriber_l->async_send_message (fb->GetBufferPointer (), fb->GetSize (), [fb, outstanding] (const nano::error & err) {
+						--*outstanding;
+					});
 				}
 			}
-
-			// Restore full object, the next subscriber may request it
-			if (election_info)
-			{
-				confirmation_a->election_info = std::move (election_info);
-			}
-			if (block.type != nanoapi::Block::Block_NONE)
-			{
-				confirmation_a->block = block;
-			}
-
 			++itr;
 		}
 		else
 		{
-			itr = confirmation_subscribers->erase (itr);
+			if (itr->dropped > 0)
+			{
+				node.logger.always_log (boost::str (boost::format ("IPC: %1% confirmations were dropped for a closed session") % itr->dropped));
+			}
+			itr = subscribers->erase (itr);
 		}
 	}
 }
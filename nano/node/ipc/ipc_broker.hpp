@@ -3,11 +3,13 @@
 #include <nano/ipc_flatbuffers_lib/generated/flatbuffers/nanoapi_generated.h>
 #include <nano/lib/ipc.hpp>
 #include <nano/lib/locks.hpp>
+#include <nano/lib/numbers.hpp>
 #include <nano/node/ipc/ipc_broker.hpp>
 #include <nano/node/node_rpc_config.hpp>
 
 #include <atomic>
 #include <mutex>
+#include <unordered_set>
 
 namespace flatbuffers
 {
@@ -17,6 +19,7 @@ namespace nano
 {
 class node;
 class error;
+class election_status;
 namespace ipc
 {
 	class ipc_config;
@@ -70,6 +73,33 @@ namespace ipc
 		std::shared_ptr<TopicType> topic;
 	};
 
+	/**
+	 * Confirmation subscription with the topic options compiled for matching, so each broadcast only does set lookups.
+	 * Account filters are parsed once on subscription, invalid accounts are dropped as they can never match.
+	 */
+	class confirmation_subscription final
+	{
+	public:
+		confirmation_subscription (std::weak_ptr<nano::ipc::subscriber> const & subscriber_a, std::shared_ptr<nanoapi::TopicConfirmationT> const & topic_a);
+
+		std::weak_ptr<nano::ipc::subscriber> subscriber;
+		std::shared_ptr<nanoapi::TopicConfirmationT> topic;
+		/** Active (quorum or confirmation height) confirmations are sent */
+		bool active{ true };
+		/** Inactive confirmations are sent */
+		bool inactive{ true };
+		/** Only confirmations of state blocks whose account or link is local, or one of the accounts, are sent */
+		bool account_filter{ false };
+		bool all_local_accounts{ false };
+		std::unordered_set<nano::account> accounts;
+		bool include_block{ true };
+		bool include_election_info{ true };
+		/** Confirmations handed to the session and not completed yet, shared with the completion handlers */
+		std::shared_ptr<std::atomic<size_t>> outstanding{ std::make_shared<std::atomic<size_t>> (0) };
+		/** Confirmations not sent because too many were outstanding */
+		uint64_t dropped{ 0 };
+	};
+
 	/**
 	 * The broker manages subscribers and performs message broadcasting
 	 * @note Add subscribe overloads for new topics
@@ -92,12 +122,18 @@ namespace ipc
 		/** Sends a notification to the session associated with the given service (if the session has subscribed to TopicServiceStop) */
 		void service_stop (std::string const & service_name_a);
 
+		/** Confirmations are dropped for a subscriber while this many are still being sent to it */
+		static size_t constexpr max_outstanding_confirmations{ 1024 };
+
 	private:
-		/** Broadcast block confirmations */
-		void broadcast (std::shared_ptr<nanoapi::EventConfirmationT> const & confirmation_a);
+		/**
+		 * Broadcast a block confirmation. The EventConfirmation flatbuffer is built at most once per combination of
+		 * include_block and include_election_info in use, and shared by every matching subscriber.
+		 */
+		void broadcast (nano::election_status const & status_a, nano::account const & account_a, nano::amount const & amount_a, bool is_state_send_a);
 
 		nano::node & node;
-		mutable nano::locked<std::vector<subscription<nanoapi::TopicConfirmationT>>> confirmation_subscribers;
+		mutable nano::locked<std::vector<confirmation_subscription>> confirmation_subscribers;
 		mutable nano::locked<std::vector<subscription<nanoapi::TopicServiceStopT>>> service_stop_subscribers;
 	};
 }
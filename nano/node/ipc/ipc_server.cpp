@@ -1,9 +1,11 @@
 #include <nano/boost/asio/bind_executor.hpp>
 #include <nano/boost/asio/local/stream_protocol.hpp>
 #include <nano/boost/asio/read.hpp>
+#include <nano/boost/asio/steady_timer.hpp>
 #include <nano/boost/asio/strand.hpp>
 #include <nano/lib/config.hpp>
 #include <nano/lib/ipc.hpp>
+#include <nano/lib/ipc_shm.hpp>
 #include <nano/lib/locks.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/lib/timer.hpp>
@@ -18,9 +20,15 @@
 #include <boost/asio/signal_set.hpp>
 #include <boost/endian/conversion.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#if defined(NANO_IPC_SHM)
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <unistd.h>
+#endif
 
 #include <atomic>
 #include <chrono>
+#include <cstring>
 #include <list>
 
 #include <flatbuffers/flatbuffers.h>
@@ -70,6 +78,19 @@ public:
 			{
 				if (auto session_l = session_m.lock ())
 				{
+#if defined(NANO_IPC_SHM)
+					if (session_l->shm)
+					{
+						session_l->shm_queued_write (boost::asio::buffer (data_a, length_a), [broadcast_completion_handler_a] (boost::system::error_code const & ec_a, size_t size_a) {
+							if (broadcast_completion_handler_a)
+							{
+								nano::error error_l (ec_a);
+								broadcast_completion_handler_a (error_l);
+							}
+						});
+						return;
+					}
+#endif
 					auto big_endian_length = std::make_shared<uint32_t> (boost::endian::native_to_big (static_cast<uint32_t> (length_a)));
 					boost::array<boost::asio::const_buffer, 2> buffers = {
 						boost::asio::buffer (big_endian_length.get (), sizeof (std::uint32_t)),
@@ -138,7 +159,7 @@ public:
 		return subscriber;
 	}
 
-	/** Write a fixed array of buffers through the queue. Once the last item is completed, the callback is invoked */
+	/** Write a fixed array of buffers through the queue. Once the last item is completed, the callback is invoked. If the queue is full, the callback is invoked with an error */
 	template <std::size_t N>
 	void queued_write (boost::array<boost::asio::const_buffer, N> & buffers, std::function<void (boost::system::error_code const &, size_t)> callback_a)
 	{
@@ -154,6 +175,10 @@ public:
 				}
 				this_l->send_queue.emplace_back (queue_item{ buffers[N - 1], callback_a });
 			}
+			else if (callback_a)
+			{
+				callback_a (boost::asio::error::no_buffer_space, 0);
+			}
 			if (!write_in_progress)
 			{
 				this_l->write_queued_messages ();
@@ -177,6 +202,10 @@ public:
 			{
 				this_l->send_queue.emplace_back (queue_item{ buffer_a, callback_a });
 			}
+			else if (callback_a)
+			{
+				callback_a (boost::asio::error::no_buffer_space, 0);
+			}
 			if (!write_in_progress)
 			{
 				this_l->write_queued_messages ();
@@ -210,6 +239,209 @@ public:
 		}));
 	}
 
+#if defined(NANO_IPC_SHM)
+	/** Queue a message for the response ring. Once it is copied into the ring, the callback is invoked */
+	void shm_queued_write (boost::asio::const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, size_t)> callback_a)
+	{
+		auto this_l (this->shared_from_this ());
+		boost::asio::post (strand, boost::asio::bind_executor (strand, [buffer_a, callback_a, this_l] () {
+			this_l->shm_write (buffer_a, callback_a);
+		}));
+	}
+
+	/** Must be called through the strand */
+	void shm_write (boost::asio::const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, size_t)> callback_a)
+	{
+		auto flush_in_progress = !shm_send_queue.empty ();
+		if (shm_send_queue.size () < queue_size_max)
+		{
+			shm_send_queue.emplace_back (queue_item{ buffer_a, callback_a });
+		}
+		else if (callback_a)
+		{
+			callback_a (boost::asio::error::no_buffer_space, 0);
+		}
+		if (!flush_in_progress)
+		{
+			shm_progress = std::chrono::steady_clock::now ();
+			shm_flush ();
+		}
+	}
+
+	/**
+	 * Copy queued messages into the response ring until it is full, then retry shortly. The client is given io_timeout
+	 * to make room before the session is closed. Must be called through the strand.
+	 */
+	void shm_flush ()
+	{
+		auto & ring (shm->responses ());
+		auto full (false);
+		while (!shm_send_queue.empty () && !full)
+		{
+			auto & item (shm_send_queue.front ());
+			boost::system::error_code ec;
+			if (item.buffer.size () > ring.max_message_size ())
+			{
+				ec = boost::asio::error::message_size;
+			}
+			else
+			{
+				full = ring.write (static_cast<uint8_t const *> (item.buffer.data ()), item.buffer.size ());
+			}
+			if (!full)
+			{
+				if (item.callback)
+				{
+					item.callback (ec, item.buffer.size ());
+				}
+				shm_send_queue.pop_front ();
+				shm_progress = std::chrono::steady_clock::now ();
+			}
+		}
+		if (full)
+		{
+			if (std::chrono::steady_clock::now () - shm_progress > std::chrono::seconds (config_transport.io_timeout))
+			{
+				if (node.config.logging.log_ipc ())
+				{
+					node.logger.always_log ("IPC: Shared memory client stopped reading");
+				}
+				close ();
+			}
+			else
+			{
+				auto this_l (this->shared_from_this ());
+				shm_retry_timer->expires_after (std::chrono::milliseconds (1));
+				shm_retry_timer->async_wait (boost::asio::bind_executor (strand, [this_l] (boost::system::error_code const & ec) {
+					if (!ec)
+					{
+						this_l->shm_flush ();
+					}
+				}));
+			}
+		}
+		else if (shm_reading_paused)
+		{
+			shm_reading_paused = false;
+			shm_read_requests ();
+		}
+	}
+
+	/** Handler for payload_encoding::flatbuffers_shm. Creates the rings and passes them to the client, which sent the capacity it wants */
+	void handle_shm_handshake ()
+	{
+		boost::endian::big_to_native_inplace (buffer_size);
+		nano::error error_l;
+		if constexpr (std::is_same<SOCKET_TYPE, boost::asio::local::stream_protocol::socket>::value)
+		{
+			auto shm_l (std::make_unique<nano::ipc::shm_channel> ());
+			error_l = shm_l->create (buffer_size);
+			if (!error_l)
+			{
+				error_l = shm_l->send (socket.native_handle ());
+			}
+			// The descriptor owns the fd it is given, so it gets a duplicate of the one owned by the channel
+			auto request_event_l (error_l ? -1 : ::dup (shm_l->request_event ()));
+			if (!error_l && request_event_l == -1)
+			{
+				error_l = std::error_code (errno, std::system_category ());
+			}
+			if (!error_l)
+			{
+				shm_request_event = std::make_unique<boost::asio::posix::stream_descriptor> (io_ctx, request_event_l);
+				shm_retry_timer = std::make_unique<boost::asio::steady_timer> (io_ctx);
+				shm = std::move (shm_l);
+				await_shm_close ();
+				shm_read_requests ();
+			}
+		}
+		else
+		{
+			error_l.set ("Shared memory is only supported on domain sockets");
+		}
+		if (error_l && node.config.logging.log_ipc ())
+		{
+			node.logger.always_log ("IPC: Could not set up shared memory: ", error_l.get_message ());
+		}
+	}
+
+	/**
+	 * Process the requests in the request ring, then wait for the client to signal more. Reading pauses while responses are
+	 * waiting for space in the response ring. Must be called through the strand.
+	 */
+	void shm_read_requests ()
+	{
+		auto & ring (shm->requests ());
+		uint8_t const * data;
+		size_t size;
+		size_t processed (0);
+		while (shm_send_queue.empty () && processed < shm_batch_max && !ring.peek (data, size))
+		{
+			// Requests are copied out of the ring before being verified, so the client cannot change them while they are parsed
+			buffer.assign (data, data + size);
+			ring.consume ();
+			handle_shm_request ();
+			++processed;
+		}
+		auto this_l (this->shared_from_this ());
+		if (ring.corrupt ())
+		{
+			if (node.config.logging.log_ipc ())
+			{
+				node.logger.always_log ("IPC: Closing shared memory session, the client corrupted the request ring");
+			}
+			close ();
+		}
+		else if (!shm_send_queue.empty ())
+		{
+			shm_reading_paused = true;
+		}
+		else if (processed == shm_batch_max || !ring.arm_notification ())
+		{
+			// More requests are pending, yield the strand so broadcasts are interleaved
+			boost::asio::post (strand, boost::asio::bind_executor (strand, [this_l] () {
+				this_l->shm_read_requests ();
+			}));
+		}
+		else
+		{
+			shm_request_event->async_read_some (boost::asio::buffer (&shm_event_counter, sizeof (shm_event_counter)), boost::asio::bind_executor (strand, [this_l] (boost::system::error_code const & ec, size_t size_a) {
+				if (!ec)
+				{
+					this_l->shm_read_requests ();
+				}
+			}));
+		}
+	}
+
+	/** Process the flatbuffers request in the buffer. The response handler is called before process returns, still on the strand */
+	void handle_shm_request ()
+	{
+		session_timer.restart ();
+		if (!flatbuffers_handler)
+		{
+			flatbuffers_handler = std::make_shared<nano::ipc::flatbuffers_handler> (node, server, get_subscriber (), node.config.ipc_config);
+		}
+		auto this_l (this->shared_from_this ());
+		flatbuffers_handler->process (buffer.data (), buffer.size (), [this_l] (std::shared_ptr<flatbuffers::FlatBufferBuilder> const & fbb) {
+			if (this_l->node.config.logging.log_ipc ())
+			{
+				this_l->node.logger.always_log (boost::str (boost::format ("IPC/Flatbuffer shared memory request completed in: %1% %2%") % this_l->session_timer.stop ().count () % this_l->session_timer.unit ()));
+			}
+			this_l->shm_write (boost::asio::buffer (fbb->GetBufferPointer (), fbb->GetSize ()), [fbb] (boost::system::error_code const & error_a, size_t size_a) {});
+		});
+	}
+
+	/** Clients do not write to the socket after the handshake, it is kept open to tell when the client goes away */
+	void await_shm_close ()
+	{
+		auto this_l (this->shared_from_this ());
+		socket.async_read_some (boost::asio::buffer (&shm_close_byte, sizeof (shm_close_byte)), boost::asio::bind_executor (strand, [this_l] (boost::system::error_code const & ec, size_t size_a) {
+			this_l->close ();
+		}));
+	}
+#endif
+
 	/**
 	 * Async read of exactly \p size_a bytes. The callback is invoked only when all the data is available and
 	 * no error has occurred. On error, the error is logged, the read cycle stops and the session ends. Clients
@@ -297,6 +529,54 @@ public:
 		handler->process_request (allow_unsafe && config_transport.allow_unsafe);
 	}
 
+	/**
+	 * Handler for payload_encoding::json_v1_multiplexed. The response is tagged with \p id_a and written as soon as it is
+	 * available, while the session is already reading the next request.
+	 */
+	void handle_multiplexed_json_query (bool allow_unsafe, uint32_t id_a, std::string const & body_a)
+	{
+		auto start (std::chrono::steady_clock::now ());
+		auto this_l (this->shared_from_this ());
+		auto response_handler_l ([this_l, id_a, start] (std::string const & body) {
+			auto big_length = boost::endian::native_to_big (static_cast<uint32_t> (sizeof (id_a) + body.size ()));
+			auto big_id = boost::endian::native_to_big (id_a);
+			auto buffer (std::make_shared<std::vector<uint8_t>> ());
+			buffer->reserve (2 * sizeof (uint32_t) + body.size ());
+			buffer->insert (buffer->end (), reinterpret_cast<std::uint8_t *> (&big_length), reinterpret_cast<std::uint8_t *> (&big_length) + sizeof (std::uint32_t));
+			buffer->insert (buffer->end (), reinterpret_cast<std::uint8_t *> (&big_id), reinterpret_cast<std::uint8_t *> (&big_id) + sizeof (std::uint32_t));
+			buffer->insert (buffer->end (), body.begin (), body.end ());
+			if (this_l->node.config.logging.log_ipc ())
+			{
+				this_l->node.logger.always_log (boost::str (boost::format ("IPC/RPC multiplexed request %1% completed in: %2% microseconds") % id_a % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count ()));
+			}
+			this_l->queued_write (boost::asio::buffer (buffer->data (), buffer->size ()), [this_l, buffer] (boost::system::error_code const & error_a, size_t size_a) {
+				if (error_a)
+				{
+					if (this_l->node.config.logging.log_ipc ())
+					{
+						this_l->node.logger.always_log ("IPC: Write failed: ", error_a.message ());
+					}
+					// The client would wait for the dropped response forever, closing fails all its requests in flight instead
+					this_l->close ();
+				}
+				else if (this_l->multiplexed_in_flight-- == multiplexed_in_flight_max)
+				{
+					// Reading was paused when the last request came in
+					this_l->read_next_request ();
+				}
+			});
+		});
+
+		node.stats.inc (nano::stat::type::ipc, nano::stat::detail::invocations);
+		auto handler (std::make_shared<nano::json_handler> (node, server.node_rpc_config, body_a, response_handler_l, [&server = server] () {
+			server.stop ();
+			server.node.workers.add_timed_task (std::chrono::steady_clock::now () + std::chrono::seconds (3), [&io_ctx = server.node.io_ctx] () {
+				io_ctx.stop ();
+			});
+		}));
+		handler->process_request (allow_unsafe && config_transport.allow_unsafe);
+	}
+
 	/** Async request reader */
 	void read_next_request ()
 	{
@@ -327,6 +607,35 @@ public:
 					});
 				});
 			}
+			else if (encoding == static_cast<uint8_t> (nano::ipc::payload_encoding::json_v1_multiplexed) || encoding == static_cast<uint8_t> (nano::ipc::payload_encoding::json_v1_multiplexed_unsafe))
+			{
+				auto allow_unsafe (encoding == static_cast<uint8_t> (nano::ipc::payload_encoding::json_v1_multiplexed_unsafe));
+				// Length of request id and payload
+				this_l->async_read_exactly (&this_l->buffer_size, sizeof (this_l->buffer_size), [this_l, allow_unsafe] () {
+					boost::endian::big_to_native_inplace (this_l->buffer_size);
+					if (this_l->buffer_size >= sizeof (uint32_t))
+					{
+						this_l->buffer.resize (this_l->buffer_size);
+						this_l->async_read_exactly (this_l->buffer.data (), this_l->buffer_size, [this_l, allow_unsafe] () {
+							uint32_t id;
+							std::memcpy (&id, this_l->buffer.data (), sizeof (id));
+							boost::endian::big_to_native_inplace (id);
+							std::string body (reinterpret_cast<char *> (this_l->buffer.data ()) + sizeof (id), this_l->buffer.size () - sizeof (id));
+							// Start reading the next request before handling this one, so requests are processed concurrently. Once the
+							// client has multiplexed_in_flight_max requests in flight, the next one is read after a response is written.
+							if (++this_l->multiplexed_in_flight < multiplexed_in_flight_max)
+							{
+								this_l->read_next_request ();
+							}
+							this_l->handle_multiplexed_json_query (allow_unsafe, id, body);
+						});
+					}
+					else if (this_l->node.config.logging.log_ipc ())
+					{
+						this_l->node.logger.always_log ("IPC: Multiplexed request is missing its id");
+					}
+				});
+			}
 			else if (encoding == static_cast<uint8_t> (nano::ipc::payload_encoding::flatbuffers) || encoding == static_cast<uint8_t> (nano::ipc::payload_encoding::flatbuffers_json))
 			{
 				// Length of payload
@@ -398,6 +707,15 @@ public:
 					});
 				});
 			}
+#if defined(NANO_IPC_SHM)
+			else if (encoding == static_cast<uint8_t> (nano::ipc::payload_encoding::flatbuffers_shm))
+			{
+				// Requested ring capacity
+				this_l->async_read_exactly (&this_l->buffer_size, sizeof (this_l->buffer_size), [this_l] () {
+					this_l->handle_shm_handshake ();
+				});
+			}
+#endif
 			else if (this_l->node.config.logging.log_ipc ())
 			{
 				this_l->node.logger.always_log ("IPC: Unsupported payload encoding");
@@ -411,6 +729,13 @@ public:
 		boost::system::error_code ec_ignored;
 		socket.shutdown (boost::asio::ip::tcp::socket::shutdown_both, ec_ignored);
 		socket.close (ec_ignored);
+#if defined(NANO_IPC_SHM)
+		if (shm_request_event)
+		{
+			shm_request_event->close (ec_ignored);
+			shm_retry_timer->cancel (ec_ignored);
+		}
+#endif
 	}
 
 private:
@@ -422,6 +747,8 @@ private:
 		std::function<void (boost::system::error_code const &, size_t)> callback;
 	};
 	size_t const queue_size_max = 64 * 1024;
+	/** Multiplexed requests a session handles at the same time, the RPC server keeps at most rpc_request_processor::pipeline_depth in flight */
+	static size_t constexpr multiplexed_in_flight_max = 256;
 
 	nano::ipc::ipc_server & server;
 	nano::node & node;
@@ -453,6 +780,9 @@ private:
 	/** The send queue is protected by always being accessed through the strand */
 	std::deque<queue_item> send_queue;
 
+	/** Multiplexed requests read but not yet answered, only accessed through the strand */
+	size_t multiplexed_in_flight{ 0 };
+
 	/** A socket of the given asio type */
 	SOCKET_TYPE socket;
 
@@ -470,6 +800,34 @@ private:
 
 	/** Session subscriber */
 	std::shared_ptr<nano::ipc::subscriber> subscriber;
+#if defined(NANO_IPC_SHM)
+	/** Shared memory rings, set once on a flatbuffers_shm handshake */
+	std::unique_ptr<nano::ipc::shm_channel> shm;
+
+	/** Readable when the client signals new requests */
+	std::unique_ptr<boost::asio::posix::stream_descriptor> shm_request_event;
+
+	/** Receives the eventfd counter */
+	uint64_t shm_event_counter{ 0 };
+
+	/** Receives the byte which is never sent after the handshake */
+	uint8_t shm_close_byte{ 0 };
+
+	/** Messages waiting for space in the response ring, protected by the strand */
+	std::deque<queue_item> shm_send_queue;
+
+	/** Retries shm_flush while the response ring is full */
+	std::unique_ptr<boost::asio::steady_timer> shm_retry_timer;
+
+	/** Last time a message was copied into the response ring, or the queue started filling up */
+	std::chrono::steady_clock::time_point shm_progress;
+
+	/** Set while requests are left in the request ring until queued messages are written */
+	bool shm_reading_paused{ false };
+
+	/** Requests processed before yielding the strand */
+	size_t const shm_batch_max = 64;
+#endif
 };
 
 /** Domain and TCP socket transport */
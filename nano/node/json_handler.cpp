@@ -18,6 +18,7 @@
 namespace
 {
 void construct_json (nano::container_info_component * component, boost::property_tree::ptree & parent);
+void construct_metrics (nano::container_info_component * component, std::string const & path, std::ostream & counts, std::ostream & sizes);
 using ipc_json_handler_no_arg_func_map = std::unordered_map<std::string, std::function<void (nano::json_handler *)>>;
 ipc_json_handler_no_arg_func_map create_ipc_json_handler_no_arg_func_map ();
 auto ipc_json_handler_no_arg_funcs = create_ipc_json_handler_no_arg_func_map ();
@@ -28,7 +29,10 @@ const char * epoch_as_string (nano::epoch);
 nano::json_handler::json_handler (nano::node & node_a, nano::node_rpc_config const & node_rpc_config_a, std::string const & body_a, std::function<void (std::string const &)> const & response_a, std::function<void ()> stop_callback_a) :
 	body (body_a),
 	node (node_a),
-	response (response_a),
+	response ([&stats = node_a.stats, response_a, start = std::chrono::steady_clock::now ()] (std::string const & response_body_a) {
+		stats.update_histogram (nano::stat::type::latency, nano::stat::detail::rpc_action, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count ());
+		response_a (response_body_a);
+	}),
 	stop_callback (stop_callback_a),
 	node_rpc_config (node_rpc_config_a)
 {
@@ -2876,6 +2880,64 @@ void nano::json_handler::peers ()
 	response_errors ();
 }
 
+void nano::json_handler::peers_bandwidth ()
+{
+	auto count (count_optional_impl (std::numeric_limits<uint64_t>::max ()));
+	if (!ec)
+	{
+		auto peers_list (node.network.list (std::numeric_limits<size_t>::max ()));
+		// Heaviest peers first
+		std::vector<std::pair<uint64_t, std::shared_ptr<nano::transport::channel>>> by_bytes;
+		by_bytes.reserve (peers_list.size ());
+		for (auto const & channel : peers_list)
+		{
+			by_bytes.emplace_back (channel->get_bandwidth ().bytes (), channel);
+		}
+		auto top (std::min<size_t> (count, by_bytes.size ()));
+		std::partial_sort (by_bytes.begin (), by_bytes.begin () + top, by_bytes.end (), [] (auto const & lhs, auto const & rhs) {
+			return lhs.first > rhs.first;
+		});
+		boost::property_tree::ptree peers_l;
+		for (auto i (by_bytes.begin ()), n (by_bytes.begin () + top); i != n; ++i)
+		{
+			auto const & channel (i->second);
+			auto const & bandwidth (channel->get_bandwidth ());
+			boost::property_tree::ptree peer_l;
+			auto node_id_l (channel->get_node_id_optional ());
+			peer_l.put ("node_id", node_id_l.is_initialized () ? node_id_l.get ().to_node_id () : "");
+			uint64_t messages (0);
+			uint64_t dropped_bytes (0);
+			uint64_t dropped_messages (0);
+			boost::property_tree::ptree types_l;
+			for (size_t type (0); type < nano::bandwidth_counters::message_type_count; ++type)
+			{
+				auto type_l (static_cast<nano::message_type> (type));
+				auto const & counters (bandwidth.get (type_l));
+				if (counters.messages > 0 || counters.dropped_messages > 0)
+				{
+					boost::property_tree::ptree type_entry;
+					type_entry.put ("bytes", counters.bytes.load ());
+					type_entry.put ("messages", counters.messages.load ());
+					type_entry.put ("dropped_bytes", counters.dropped_bytes.load ());
+					type_entry.put ("dropped_messages", counters.dropped_messages.load ());
+					types_l.add_child (nano::message_type_to_string (type_l), type_entry);
+					messages += counters.messages;
+					dropped_bytes += counters.dropped_bytes;
+					dropped_messages += counters.dropped_messages;
+				}
+			}
+			peer_l.put ("bytes", i->first);
+			peer_l.put ("messages", messages);
+			peer_l.put ("dropped_bytes", dropped_bytes);
+			peer_l.put ("dropped_messages", dropped_messages);
+			peer_l.add_child ("types", types_l);
+			peers_l.push_back (boost::property_tree::ptree::value_type (channel->to_string (), peer_l));
+		}
+		response_l.add_child ("peers", peers_l);
+	}
+	response_errors ();
+}
+
 void nano::json_handler::pending ()
 {
 	auto account (account_impl ());
@@ -3742,6 +3804,24 @@ void nano::json_handler::stats ()
 	{
 		construct_json (collect_container_info (node, "node").get (), response_l);
 	}
+	else if (type == "metrics")
+	{
+		// Counters, histograms and container sizes in the Prometheus text format, served by the RPC server on GET /metrics
+		auto metrics_sink (node.stats.log_sink_prometheus ());
+		node.stats.log_counters (*metrics_sink);
+		std::ostringstream counts;
+		std::ostringstream sizes;
+		construct_metrics (collect_container_info (node, "node").get (), "", counts, sizes);
+		std::ostringstream metrics;
+		metrics << metrics_sink->to_string ();
+		metrics << "# TYPE nano_stat_duration_seconds gauge\n";
+		metrics << "nano_stat_duration_seconds " << node.stats.last_reset ().count () << "\n";
+		metrics << "# TYPE nano_container_count gauge\n";
+		metrics << counts.str ();
+		metrics << "# TYPE nano_container_bytes gauge\n";
+		metrics << sizes.str ();
+		response_l.put ("metrics", metrics.str ());
+	}
 	else if (type == "samples")
 	{
 		node.stats.log_samples (*sink);
@@ -3899,9 +3979,9 @@ void nano::json_handler::telemetry ()
 		auto output_raw = raw.value_or (false);
 		if (node.telemetry)
 		{
-			auto telemetry_responses = node.telemetry->get_metrics ();
 			if (output_raw)
 			{
+				auto telemetry_responses = node.telemetry->get_metrics ();
 				boost::property_tree::ptree metrics;
 				for (auto & telemetry_metrics : telemetry_responses)
 				{
@@ -3925,13 +4005,7 @@ void nano::json_handler::telemetry ()
 			else
 			{
 				nano::jsonconfig config_l;
-				std::vector<nano::telemetry_data> telemetry_datas;
-				telemetry_datas.reserve (telemetry_responses.size ());
-				std::transform (telemetry_responses.begin (), telemetry_responses.end (), std::back_inserter (telemetry_datas), [] (auto const & endpoint_telemetry_data) {
-					return endpoint_telemetry_data.second;
-				});
-
-				auto average_telemetry_metrics = nano::consolidate_telemetry_data (telemetry_datas);
+				auto average_telemetry_metrics = node.telemetry->get_consolidated_metrics ();
 				// Don't add node_id/signature in consolidated metrics
 				auto const should_ignore_identification_metrics = true;
 				auto err = average_telemetry_metrics.serialize_json (config_l, should_ignore_identification_metrics);
@@ -5098,6 +5172,26 @@ void construct_json (nano::container_info_component * component, boost::property
 	parent.add_child (composite->get_name (), current);
 }
 
+void construct_metrics (nano::container_info_component * component, std::string const & path, std::ostream & counts, std::ostream & sizes)
+{
+	if (!component->is_composite ())
+	{
+		auto & leaf_info = static_cast<nano::container_info_leaf *> (component)->get_info ();
+		auto labels (boost::str (boost::format ("{container=\"%1%%2%\"} ") % path % leaf_info.name));
+		counts << "nano_container_count" << labels << leaf_info.count << "\n";
+		sizes << "nano_container_bytes" << labels << leaf_info.count * leaf_info.sizeof_element << "\n";
+	}
+	else
+	{
+		auto composite = static_cast<nano::container_info_composite *> (component);
+		auto path_l (path + composite->get_name () + "/");
+		for (auto & child : composite->get_children ())
+		{
+			construct_metrics (child.get (), path_l, counts, sizes);
+		}
+	}
+}
+
 // Any RPC handlers which require no arguments (excl default arguments) should go here.
 // This is to prevent large if/else chains which compilers can have limits for (MSVC for instance has 128).
 ipc_json_handler_no_arg_func_map create_ipc_json_handler_no_arg_func_map ()
@@ -5158,6 +5252,7 @@ ipc_json_handler_no_arg_func_map create_ipc_json_handler_no_arg_func_map ()
 	no_arg_funcs.emplace ("password_enter", &nano::json_handler::password_enter);
 	no_arg_funcs.emplace ("wallet_unlock", &nano::json_handler::password_enter);
 	no_arg_funcs.emplace ("peers", &nano::json_handler::peers);
+	no_arg_funcs.emplace ("peers_bandwidth", &nano::json_handler::peers_bandwidth);
 	no_arg_funcs.emplace ("pending", &nano::json_handler::pending);
 	no_arg_funcs.emplace ("pending_exists", &nano::json_handler::pending_exists);
 	no_arg_funcs.emplace ("process", &nano::json_handler::process);
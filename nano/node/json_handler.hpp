@@ -81,6 +81,7 @@ public:
 	void password_enter ();
 	void password_valid (bool = false);
 	void peers ();
+	void peers_bandwidth ();
 	void pending ();
 	void pending_exists ();
 	void process ();
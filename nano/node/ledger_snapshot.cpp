@@ -0,0 +1,554 @@
+#include <nano/lib/config.hpp>
+#include <nano/lib/stats.hpp>
+#include <nano/lib/stream.hpp>
+#include <nano/lib/threading.hpp>
+#include <nano/node/ledger_snapshot.hpp>
+#include <nano/secure/ledger.hpp>
+#include <nano/secure/store.hpp>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <crypto/blake2/blake2.h>
+
+char const * const nano::ledger_snapshot::manifest_name = "manifest.json";
+
+namespace
+{
+nano::uint256_union chunk_checksum (std::vector<uint8_t> const & data_a)
+{
+	nano::uint256_union result;
+	blake2b_state state;
+	blake2b_init (&state, sizeof (result.bytes));
+	blake2b_update (&state, data_a.data (), data_a.size ());
+	blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
+	return result;
+}
+
+bool read_file (boost::filesystem::path const & path_a, std::vector<uint8_t> & data_a)
+{
+	boost::filesystem::ifstream stream (path_a, std::ios::binary);
+	auto error (!stream.good ());
+	if (!error)
+	{
+		data_a.assign (std::istreambuf_iterator<char> (stream), std::istreambuf_iterator<char> ());
+		error = stream.bad ();
+	}
+	return error;
+}
+
+void serialize (nano::stream & stream_a, nano::account_info const & info_a)
+{
+	nano::write (stream_a, info_a.head.bytes);
+	nano::write (stream_a, info_a.representative.bytes);
+	nano::write (stream_a, info_a.open_block.bytes);
+	nano::write (stream_a, info_a.balance.bytes);
+	nano::write (stream_a, info_a.modified);
+	nano::write (stream_a, info_a.block_count);
+	nano::write (stream_a, info_a.epoch_m);
+}
+
+void serialize (nano::stream & stream_a, nano::pending_key const & key_a, nano::pending_info const & info_a)
+{
+	nano::write (stream_a, key_a.account.bytes);
+	nano::write (stream_a, key_a.hash.bytes);
+	nano::write (stream_a, info_a.source.bytes);
+	nano::write (stream_a, info_a.amount.bytes);
+	nano::write (stream_a, info_a.epoch);
+}
+
+/** Accumulates serialized entries of a single table and writes them out as checksummed chunk files */
+class chunk_writer final
+{
+public:
+	chunk_writer (boost::filesystem::path const & path_a, std::string const & table_a, std::size_t entries_per_chunk_a, std::vector<nano::ledger_snapshot::chunk> & chunks_a) :
+		path (path_a),
+		table (table_a),
+		entries_per_chunk (entries_per_chunk_a),
+		chunks (chunks_a)
+	{
+	}
+
+	~chunk_writer ()
+	{
+		flush ();
+	}
+
+	template <typename Serializer>
+	void add (Serializer const & serializer_a)
+	{
+		{
+			nano::vectorstream stream (buffer);
+			serializer_a (stream);
+		}
+		if (++entries == entries_per_chunk)
+		{
+			flush ();
+		}
+	}
+
+	void flush ()
+	{
+		if (entries > 0)
+		{
+			nano::ledger_snapshot::chunk chunk;
+			chunk.table = table;
+			chunk.file = boost::str (boost::format ("%1%.%2%.chunk") % table % index++);
+			chunk.entries = entries;
+			chunk.checksum = chunk_checksum (buffer);
+			boost::filesystem::ofstream stream (path / chunk.file, std::ios::binary | std::ios::trunc);
+			stream.write (reinterpret_cast<char const *> (buffer.data ()), buffer.size ());
+			release_assert (stream.good ());
+			chunks.push_back (chunk);
+			buffer.clear ();
+			entries = 0;
+		}
+	}
+
+private:
+	boost::filesystem::path const & path;
+	std::string const table;
+	std::size_t const entries_per_chunk;
+	std::vector<nano::ledger_snapshot::chunk> & chunks;
+	std::vector<uint8_t> buffer;
+	std::size_t entries{ 0 };
+	unsigned index{ 0 };
+};
+}
+
+nano::ledger_snapshot::ledger_snapshot (boost::filesystem::path const & path_a, std::size_t entries_per_chunk_a) :
+	path (path_a),
+	entries_per_chunk (std::max<std::size_t> (entries_per_chunk_a, 1))
+{
+}
+
+bool nano::ledger_snapshot::export_ledger (nano::ledger & ledger_a)
+{
+	auto & store (ledger_a.store);
+	// A single read transaction keeps all tables consistent with each other
+	auto transaction (store.tx_begin_read ());
+	if (ledger_a.pruning || store.pruned.count (transaction) != 0)
+	{
+		return set_error ("Pruned ledgers cannot be exported");
+	}
+
+	boost::filesystem::create_directories (path);
+	chunks_m.clear ();
+	store_version = store.version.get (transaction);
+
+	auto cemented_height = [&store, &transaction] (nano::account const & account_a) {
+		nano::confirmation_height_info confirmation_height_info;
+		store.confirmation_height.get (transaction, account_a, confirmation_height_info);
+		return confirmation_height_info.height;
+	};
+
+	// Receivables whose receive block is not cemented yet, they are still pending in the cemented view of the ledger
+	std::vector<std::pair<nano::pending_key, nano::pending_info>> restored_pending;
+	std::unordered_map<nano::account, nano::uint128_t> rep_weights;
+	{
+		chunk_writer accounts (path, "accounts", entries_per_chunk, chunks_m);
+		chunk_writer frontiers (path, "frontiers", entries_per_chunk, chunks_m);
+		chunk_writer confirmation_heights (path, "confirmation_height", entries_per_chunk, chunks_m);
+		for (auto i (store.account.begin (transaction)), n (store.account.end ()); i != n; ++i)
+		{
+			nano::account const & account (i->first);
+			nano::account_info info (i->second);
+			nano::confirmation_height_info confirmation_height_info;
+			store.confirmation_height.get (transaction, account, confirmation_height_info);
+
+			// Walk uncemented blocks and restore receivables consumed by them
+			for (auto hash (info.head); !hash.is_zero () && hash != confirmation_height_info.frontier;)
+			{
+				auto block (store.block.get (transaction, hash));
+				release_assert (block != nullptr);
+				nano::block_hash source (0);
+				if (block->type () == nano::block_type::state)
+				{
+					if (block->sideband ().details.is_receive)
+					{
+						source = block->link ().as_block_hash ();
+					}
+				}
+				else
+				{
+					source = block->source ();
+				}
+				if (!source.is_zero () && ledger_a.block_confirmed (transaction, source))
+				{
+					restored_pending.emplace_back (nano::pending_key (account, source), nano::pending_info (ledger_a.account (transaction, source), ledger_a.amount (transaction, hash), store.block.version (transaction, source)));
+				}
+				hash = block->previous ();
+			}
+
+			if (confirmation_height_info.height == 0)
+			{
+				// Nothing cemented for this account
+				continue;
+			}
+			if (confirmation_height_info.height < info.block_count)
+			{
+				// Rewind the account to its cemented frontier
+				auto frontier (store.block.get (transaction, confirmation_height_info.frontier));
+				release_assert (frontier != nullptr);
+				auto representative_block (store.block.get (transaction, ledger_a.representative (transaction, confirmation_height_info.frontier)));
+				release_assert (representative_block != nullptr);
+				auto const & sideband (frontier->sideband ());
+				info = nano::account_info (confirmation_height_info.frontier, representative_block->representative (), info.open_block, sideband.balance, sideband.timestamp, confirmation_height_info.height, sideband.details.epoch);
+			}
+			accounts.add ([&account, &info] (nano::stream & stream_a) {
+				nano::write (stream_a, account.bytes);
+				serialize (stream_a, info);
+			});
+			confirmation_heights.add ([&account, &confirmation_height_info] (nano::stream & stream_a) {
+				nano::write (stream_a, account.bytes);
+				confirmation_height_info.serialize (stream_a);
+			});
+			if (store.block.get_no_sideband (transaction, info.head)->type () != nano::block_type::state)
+			{
+				frontiers.add ([&account, &info] (nano::stream & stream_a) {
+					nano::write (stream_a, info.head.bytes);
+					nano::write (stream_a, account.bytes);
+				});
+			}
+			rep_weights[info.representative] += info.balance.number ();
+		}
+	}
+	{
+		chunk_writer blocks (path, "blocks", entries_per_chunk, chunks_m);
+		for (auto i (store.block.begin (transaction)), n (store.block.end ()); i != n; ++i)
+		{
+			auto sideband (i->second.sideband);
+			auto const & block (*i->second.block);
+			// Only legacy send, receive and change blocks rely on the sideband for their account
+			auto height (cemented_height (block.account ().is_zero () ? sideband.account : block.account ()));
+			if (sideband.height <= height)
+			{
+				if (sideband.height == height)
+				{
+					// The successor of a cemented frontier is not part of the snapshot
+					sideband.successor.clear ();
+				}
+				blocks.add ([&hash = i->first, &block, &sideband] (nano::stream & stream_a) {
+					std::vector<uint8_t> data;
+					{
+						nano::vectorstream data_stream (data);
+						nano::serialize_block (data_stream, block);
+						sideband.serialize (data_stream, block.type ());
+					}
+					nano::write (stream_a, hash.bytes);
+					nano::write (stream_a, static_cast<uint32_t> (data.size ()));
+					nano::write (stream_a, data);
+				});
+			}
+		}
+	}
+	{
+		chunk_writer pending (path, "pending", entries_per_chunk, chunks_m);
+		for (auto i (store.pending.begin (transaction)), n (store.pending.end ()); i != n; ++i)
+		{
+			if (ledger_a.block_confirmed (transaction, i->first.hash))
+			{
+				pending.add ([&key = i->first, &info = i->second] (nano::stream & stream_a) {
+					serialize (stream_a, key, info);
+				});
+			}
+		}
+		for (auto const & [key, info] : restored_pending)
+		{
+			pending.add ([&key = key, &info = info] (nano::stream & stream_a) {
+				serialize (stream_a, key, info);
+			});
+		}
+	}
+	{
+		chunk_writer weights (path, "rep_weights", entries_per_chunk, chunks_m);
+		for (auto const & [representative, weight] : rep_weights)
+		{
+			weights.add ([&representative = representative, weight = nano::amount (weight)] (nano::stream & stream_a) {
+				nano::write (stream_a, representative.bytes);
+				nano::write (stream_a, weight.bytes);
+			});
+		}
+	}
+	write_manifest (store_version);
+	return false;
+}
+
+bool nano::ledger_snapshot::verify ()
+{
+	auto error (read_manifest ());
+	if (!error)
+	{
+		std::atomic<std::size_t> next{ 0 };
+		std::atomic<bool> mismatch{ false };
+		auto const thread_count (std::max (1u, std::min<unsigned> (std::thread::hardware_concurrency (), static_cast<unsigned> (chunks_m.size ()))));
+		std::vector<std::thread> threads;
+		threads.reserve (thread_count);
+		for (unsigned thread (0); thread < thread_count; ++thread)
+		{
+			threads.emplace_back ([this, &next, &mismatch] () {
+				nano::thread_role::set (nano::thread_role::name::db_parallel_traversal);
+				std::vector<uint8_t> data;
+				for (auto index (next++); index < chunks_m.size () && !mismatch; index = next++)
+				{
+					auto const & chunk (chunks_m[index]);
+					if (read_file (path / chunk.file, data) || chunk_checksum (data) != chunk.checksum)
+					{
+						mismatch = true;
+					}
+				}
+			});
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		if (mismatch)
+		{
+			error = set_error ("Snapshot chunk checksum mismatch");
+		}
+	}
+	return error;
+}
+
+bool nano::ledger_snapshot::import_ledger (nano::store & store_a)
+{
+	auto error (verify ());
+	if (!error && store_version != store_a.version.get (store_a.tx_begin_read ()))
+	{
+		error = set_error (boost::str (boost::format ("Snapshot database version %1% does not match the store version") % store_version));
+	}
+	if (!error && store_a.block.count (store_a.tx_begin_read ()) > 1)
+	{
+		error = set_error ("Snapshots can only be imported into a store holding at most the genesis block");
+	}
+	std::unordered_map<nano::account, nano::uint128_t> rep_weights;
+	for (auto i (chunks_m.begin ()), n (chunks_m.end ()); i != n && !error; ++i)
+	{
+		error = load_chunk (store_a, *i, rep_weights);
+	}
+	if (!error)
+	{
+		// Representative weights are derived from the accounts table, recomputing them checks the loaded ledger as a whole
+		nano::stat stats;
+		nano::generate_cache generate_cache;
+		generate_cache.cemented_count = false;
+		generate_cache.unchecked_count = false;
+		generate_cache.account_count = false;
+		generate_cache.block_count = false;
+		generate_cache.uncemented = false;
+		nano::ledger ledger (store_a, stats, generate_cache);
+		auto const computed (ledger.cache.rep_weights.get_rep_amounts ());
+		for (auto const & [representative, weight] : rep_weights)
+		{
+			auto existing (computed.find (representative));
+			if (existing == computed.end () || existing->second != weight)
+			{
+				error = set_error (boost::str (boost::format ("Representative weight mismatch for %1%") % representative.to_account ()));
+				break;
+			}
+		}
+		for (auto i (computed.begin ()), n (computed.end ()); i != n && !error; ++i)
+		{
+			if (!i->second.is_zero () && rep_weights.find (i->first) == rep_weights.end ())
+			{
+				error = set_error (boost::str (boost::format ("Unexpected representative weight for %1%") % i->first.to_account ()));
+			}
+		}
+	}
+	return error;
+}
+
+bool nano::ledger_snapshot::load_chunk (nano::store & store_a, chunk const & chunk_a, std::unordered_map<nano::account, nano::uint128_t> & rep_weights_a)
+{
+	std::vector<uint8_t> data;
+	if (read_file (path / chunk_a.file, data))
+	{
+		return set_error ("Unable to read snapshot chunk " + chunk_a.file);
+	}
+	nano::bufferstream stream (data.data (), data.size ());
+	auto error (false);
+	try
+	{
+		if (chunk_a.table == "blocks")
+		{
+			auto transaction (store_a.tx_begin_write ({ nano::tables::blocks }));
+			for (uint64_t i (0); i < chunk_a.entries; ++i)
+			{
+				nano::block_hash hash;
+				uint32_t size;
+				std::vector<uint8_t> block;
+				nano::read (stream, hash.bytes);
+				nano::read (stream, size);
+				nano::read (stream, block, size);
+				store_a.block.raw_put (transaction, block, hash);
+			}
+		}
+		else if (chunk_a.table == "accounts")
+		{
+			auto transaction (store_a.tx_begin_write ({ nano::tables::accounts, nano::tables::frontiers }));
+			for (uint64_t i (0); i < chunk_a.entries && !error; ++i)
+			{
+				nano::account account;
+				nano::account_info info;
+				nano::read (stream, account.bytes);
+				error = info.deserialize (stream);
+				if (!error)
+				{
+					// An initialized store already holds the genesis account, its frontier row is replaced by the one in the snapshot
+					nano::account_info existing;
+					if (!store_a.account.get (transaction, account, existing) && existing.head != info.head && !store_a.frontier.get (transaction, existing.head).is_zero ())
+					{
+						store_a.frontier.del (transaction, existing.head);
+					}
+					store_a.account.put (transaction, account, info);
+				}
+			}
+		}
+		else if (chunk_a.table == "confirmation_height")
+		{
+			auto transaction (store_a.tx_begin_write ({ nano::tables::confirmation_height }));
+			for (uint64_t i (0); i < chunk_a.entries && !error; ++i)
+			{
+				nano::account account;
+				nano::confirmation_height_info info;
+				nano::read (stream, account.bytes);
+				error = info.deserialize (stream);
+				if (!error)
+				{
+					store_a.confirmation_height.put (transaction, account, info);
+				}
+			}
+		}
+		else if (chunk_a.table == "pending")
+		{
+			auto transaction (store_a.tx_begin_write ({ nano::tables::pending }));
+			for (uint64_t i (0); i < chunk_a.entries && !error; ++i)
+			{
+				nano::pending_key key;
+				nano::pending_info info;
+				error = key.deserialize (stream) || info.deserialize (stream);
+				if (!error)
+				{
+					store_a.pending.put (transaction, key, info);
+				}
+			}
+		}
+		else if (chunk_a.table == "frontiers")
+		{
+			auto transaction (store_a.tx_begin_write ({ nano::tables::frontiers }));
+			for (uint64_t i (0); i < chunk_a.entries; ++i)
+			{
+				nano::block_hash hash;
+				nano::account account;
+				nano::read (stream, hash.bytes);
+				nano::read (stream, account.bytes);
+				store_a.frontier.put (transaction, hash, account);
+			}
+		}
+		else if (chunk_a.table == "rep_weights")
+		{
+			for (uint64_t i (0); i < chunk_a.entries; ++i)
+			{
+				nano::account representative;
+				nano::amount weight;
+				nano::read (stream, representative.bytes);
+				nano::read (stream, weight.bytes);
+				rep_weights_a[representative] = weight.number ();
+			}
+		}
+		else
+		{
+			error = true;
+		}
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	if (error)
+	{
+		set_error ("Malformed snapshot chunk " + chunk_a.file);
+	}
+	return error;
+}
+
+void nano::ledger_snapshot::write_manifest (int store_version_a) const
+{
+	boost::property_tree::ptree manifest;
+	manifest.put ("format_version", format_version);
+	manifest.put ("network", nano::network_constants ().get_current_network_as_string ());
+	manifest.put ("store_version", store_version_a);
+	boost::property_tree::ptree chunks_l;
+	for (auto const & chunk : chunks_m)
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("table", chunk.table);
+		entry.put ("file", chunk.file);
+		entry.put ("entries", chunk.entries);
+		entry.put ("checksum", chunk.checksum.to_string ());
+		chunks_l.push_back (std::make_pair ("", entry));
+	}
+	manifest.add_child ("chunks", chunks_l);
+	boost::property_tree::write_json ((path / manifest_name).string (), manifest);
+}
+
+bool nano::ledger_snapshot::read_manifest ()
+{
+	chunks_m.clear ();
+	boost::property_tree::ptree manifest;
+	try
+	{
+		boost::property_tree::read_json ((path / manifest_name).string (), manifest);
+	}
+	catch (boost::property_tree::json_parser_error const &)
+	{
+		return set_error ("Unable to read snapshot manifest");
+	}
+	if (manifest.get<unsigned> ("format_version", 0) != format_version)
+	{
+		return set_error ("Unsupported snapshot format version");
+	}
+	if (manifest.get<std::string> ("network", "") != nano::network_constants ().get_current_network_as_string ())
+	{
+		return set_error ("Snapshot was exported from a different network");
+	}
+	store_version = manifest.get<int> ("store_version", 0);
+	auto error (false);
+	for (auto const & entry : manifest.get_child ("chunks", boost::property_tree::ptree ()))
+	{
+		chunk chunk;
+		chunk.table = entry.second.get<std::string> ("table", "");
+		chunk.file = entry.second.get<std::string> ("file", "");
+		chunk.entries = entry.second.get<uint64_t> ("entries", 0);
+		error |= chunk.checksum.decode_hex (entry.second.get<std::string> ("checksum", ""));
+		chunks_m.push_back (chunk);
+	}
+	if (error)
+	{
+		set_error ("Malformed snapshot manifest");
+	}
+	return error;
+}
+
+std::vector<nano::ledger_snapshot::chunk> const & nano::ledger_snapshot::chunks () const
+{
+	return chunks_m;
+}
+
+std::string const & nano::ledger_snapshot::error_message () const
+{
+	return error_message_m;
+}
+
+bool nano::ledger_snapshot::set_error (std::string const & message_a)
+{
+	error_message_m = message_a;
+	return true;
+}
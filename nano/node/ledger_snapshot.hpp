@@ -0,0 +1,68 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nano
+{
+class ledger;
+class store;
+
+/**
+ * Exports and imports a compact snapshot of the cemented part of the ledger.
+ * A snapshot is a directory holding a manifest and a set of chunk files per table (blocks, accounts, confirmation_height, pending, frontiers and rep_weights).
+ * Each chunk is checksummed with blake2b so that chunks can be verified in parallel before being bulk loaded into an empty or genesis only store.
+ * Uncemented blocks are left out, accounts are rewound to their cemented frontier and receivables consumed by uncemented receives are restored.
+ */
+class ledger_snapshot final
+{
+public:
+	class chunk final
+	{
+	public:
+		std::string table;
+		std::string file;
+		uint64_t entries{ 0 };
+		nano::uint256_union checksum{ 0 };
+	};
+
+	explicit ledger_snapshot (boost::filesystem::path const & path_a, std::size_t entries_per_chunk_a = default_entries_per_chunk);
+
+	/** Writes the cemented ledger contents into the snapshot directory. Pruned ledgers are not supported. Returns true on error */
+	bool export_ledger (nano::ledger & ledger_a);
+
+	/**
+	 * Verifies every chunk checksum in parallel, then loads all tables into \p store_a and checks the resulting representative weights. Returns true on error
+	 * @note Each chunk is loaded in its own write transaction, so the import is not atomic. On error \p store_a may hold a partial ledger and should be discarded
+	 */
+	bool import_ledger (nano::store & store_a);
+
+	/** Reads the manifest and verifies every chunk checksum in parallel. Returns true on error */
+	bool verify ();
+
+	std::vector<chunk> const & chunks () const;
+	std::string const & error_message () const;
+
+	static std::size_t constexpr default_entries_per_chunk = 64 * 1024;
+	static unsigned constexpr format_version = 1;
+	static char const * const manifest_name;
+
+private:
+	bool read_manifest ();
+	void write_manifest (int store_version_a) const;
+	bool load_chunk (nano::store &, chunk const &, std::unordered_map<nano::account, nano::uint128_t> &);
+	bool set_error (std::string const &);
+
+	boost::filesystem::path const path;
+	std::size_t const entries_per_chunk;
+	std::vector<chunk> chunks_m;
+	int store_version{ 0 };
+	std::string error_message_m;
+};
+}
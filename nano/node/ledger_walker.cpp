@@ -12,16 +12,25 @@
 #include <limits>
 #include <utility>
 
-nano::ledger_walker::ledger_walker (nano::ledger const & ledger_a) :
+nano::ledger_walker::ledger_walker (nano::ledger const & ledger_a, std::size_t in_memory_block_count_a, unsigned prefetch_threads_a) :
 	ledger{ ledger_a },
+	in_memory_block_count{ in_memory_block_count_a },
+	prefetch_threads{ prefetch_threads_a },
 	use_in_memory_walked_blocks{ true },
 	walked_blocks{},
 	walked_blocks_disk{},
-	blocks_to_walk{}
+	blocks_to_walk{},
+	// Keep the backlog short, branches queued too far ahead are likely to be walked before being prefetched
+	prefetcher{ ledger_a, prefetch_threads_a, prefetch_threads_a * 4u }
 {
 	debug_assert (!ledger.store.init_error ());
 }
 
+nano::ledger_walker::~ledger_walker ()
+{
+	prefetcher.stop ();
+}
+
 void nano::ledger_walker::walk_backward (nano::block_hash const & start_block_hash_a, should_visit_callback const & should_visit_callback_a, visitor_callback const & visitor_callback_a)
 {
 	const auto transaction = ledger.store.tx_begin_read ();
@@ -30,21 +39,24 @@ void nano::ledger_walker::walk_backward (nano::block_hash const & start_block_ha
 	while (!blocks_to_walk.empty ())
 	{
 		const auto block = dequeue_block (transaction);
-		if (!should_visit_callback_a (block))
+		// Dependencies are enqueued without checking that they exist, missing (pruned) blocks are skipped here
+		if (block == nullptr || !should_visit_callback_a (block))
 		{
 			continue;
 		}
 
 		visitor_callback_a (block);
+		// Only the last enqueued dependency is walked next, the others are independent branches that can be loaded ahead of time
+		std::optional<nano::block_hash> deferred;
 		for (const auto & hash : ledger.dependent_blocks (transaction, *block))
 		{
-			if (!hash.is_zero ())
+			if (!hash.is_zero () && enqueue_block (hash))
 			{
-				const auto dependent_block = ledger.store.block.get (transaction, hash);
-				if (dependent_block)
+				if (deferred)
 				{
-					enqueue_block (dependent_block);
+					prefetch (*deferred);
 				}
+				deferred = hash;
 			}
 		}
 	}
@@ -55,18 +67,38 @@ void nano::ledger_walker::walk_backward (nano::block_hash const & start_block_ha
 void nano::ledger_walker::walk (nano::block_hash const & end_block_hash_a, should_visit_callback const & should_visit_callback_a, visitor_callback const & visitor_callback_a)
 {
 	std::uint64_t last_walked_block_order_index = 0;
-	dht::DiskHash<nano::block_hash> walked_blocks_order{ nano::unique_path ().c_str (), static_cast<int> (std::to_string (std::numeric_limits<std::uint64_t>::max ()).size ()) + 1, dht::DHOpenRW };
+	std::vector<nano::block_hash> walked_blocks_order;
+	std::optional<dht::DiskHash<nano::block_hash>> walked_blocks_order_disk;
+	auto const order_key_size = static_cast<int> (std::to_string (std::numeric_limits<std::uint64_t>::max ()).size ()) + 1;
 
 	walk_backward (end_block_hash_a,
 	should_visit_callback_a,
 	[&] (const auto & block) {
-		walked_blocks_order.insert (std::to_string (++last_walked_block_order_index).c_str (), block->hash ());
+		++last_walked_block_order_index;
+		if (!walked_blocks_order_disk && walked_blocks_order.size () < in_memory_block_count)
+		{
+			walked_blocks_order.push_back (block->hash ());
+			return;
+		}
+
+		if (!walked_blocks_order_disk)
+		{
+			walked_blocks_order_disk.emplace (nano::unique_path ().c_str (), order_key_size, dht::DHOpenRW);
+			for (std::uint64_t index = 0; index != walked_blocks_order.size (); ++index)
+			{
+				walked_blocks_order_disk->insert (std::to_string (index + 1).c_str (), walked_blocks_order[index]);
+			}
+
+			decltype (walked_blocks_order){}.swap (walked_blocks_order);
+		}
+
+		walked_blocks_order_disk->insert (std::to_string (last_walked_block_order_index).c_str (), block->hash ());
 	});
 
 	const auto transaction = ledger.store.tx_begin_read ();
 	for (auto walked_block_order_index = last_walked_block_order_index; walked_block_order_index != 0; --walked_block_order_index)
 	{
-		const auto * block_hash = walked_blocks_order.lookup (std::to_string (walked_block_order_index).c_str ());
+		const auto * block_hash = walked_blocks_order_disk ? walked_blocks_order_disk->lookup (std::to_string (walked_block_order_index).c_str ()) : &walked_blocks_order[walked_block_order_index - 1];
 		if (!block_hash)
 		{
 			debug_assert (false);
@@ -104,18 +136,15 @@ void nano::ledger_walker::walk (nano::block_hash const & end_block_hash_a, visit
 	visitor_callback_a);
 }
 
-void nano::ledger_walker::enqueue_block (nano::block_hash block_hash_a)
+bool nano::ledger_walker::enqueue_block (nano::block_hash block_hash_a)
 {
-	if (add_to_walked_blocks (block_hash_a))
+	auto const added = add_to_walked_blocks (block_hash_a);
+	if (added)
 	{
 		blocks_to_walk.emplace (std::move (block_hash_a));
 	}
-}
 
-void nano::ledger_walker::enqueue_block (std::shared_ptr<nano::block> const & block_a)
-{
-	debug_assert (block_a);
-	enqueue_block (block_a->hash ());
+	return added;
 }
 
 bool nano::ledger_walker::add_to_walked_blocks (nano::block_hash const & block_hash_a)
@@ -124,7 +153,7 @@ bool nano::ledger_walker::add_to_walked_blocks (nano::block_hash const & block_h
 	{
 		if (walked_blocks.size () < in_memory_block_count)
 		{
-			return walked_blocks.emplace (block_hash_a).second;
+			return walked_blocks.insert (block_hash_a);
 		}
 
 		use_in_memory_walked_blocks = false;
@@ -132,15 +161,14 @@ bool nano::ledger_walker::add_to_walked_blocks (nano::block_hash const & block_h
 		debug_assert (!walked_blocks_disk.has_value ());
 		walked_blocks_disk.emplace (nano::unique_path ().c_str (), sizeof (nano::block_hash::bytes) + 1, dht::DHOpenRW);
 
-		for (const auto & walked_block_hash : walked_blocks)
-		{
+		walked_blocks.for_each ([this] (const auto & walked_block_hash) {
 			if (!add_to_walked_blocks_disk (walked_block_hash))
 			{
 				debug_assert (false);
 			}
-		}
+		});
 
-		decltype (walked_blocks){}.swap (walked_blocks);
+		walked_blocks.clear ();
 	}
 
 	return add_to_walked_blocks_disk (block_hash_a);
@@ -163,18 +191,135 @@ void nano::ledger_walker::clear_queue ()
 {
 	use_in_memory_walked_blocks = true;
 
-	decltype (walked_blocks){}.swap (walked_blocks);
+	walked_blocks.clear ();
 	walked_blocks_disk.reset ();
 
 	decltype (blocks_to_walk){}.swap (blocks_to_walk);
+
+	// Prefetches of this walk are discarded
+	prefetcher.cancel ();
+	nano::lock_guard<nano::mutex> guard{ prefetch_mutex };
+	decltype (prefetched_blocks){}.swap (prefetched_blocks);
+}
+
+void nano::ledger_walker::prefetch (nano::block_hash const & block_hash_a)
+{
+	prefetcher.chain (block_hash_a, prefetch_depth, nano::block_prefetcher::direction::previous, false, [this] (std::shared_ptr<nano::block> const & block_a) {
+		nano::lock_guard<nano::mutex> guard{ prefetch_mutex };
+		// Stop once the cache is full or this chain is already being prefetched
+		return prefetched_blocks.size () < max_prefetched_blocks && prefetched_blocks.emplace (block_a->hash (), block_a).second;
+	});
 }
 
 std::shared_ptr<nano::block> nano::ledger_walker::dequeue_block (nano::transaction const & transaction_a)
 {
-	auto block = ledger.store.block.get (transaction_a, blocks_to_walk.top ());
+	const auto block_hash = blocks_to_walk.top ();
 	blocks_to_walk.pop ();
 
-	return block;
+	std::shared_ptr<nano::block> block;
+	if (prefetch_threads != 0)
+	{
+		nano::lock_guard<nano::mutex> guard{ prefetch_mutex };
+		auto existing = prefetched_blocks.find (block_hash);
+		if (existing != prefetched_blocks.end ())
+		{
+			block = std::move (existing->second);
+			prefetched_blocks.erase (existing);
+		}
+	}
+
+	return block ? block : ledger.store.block.get (transaction_a, block_hash);
+}
+
+bool nano::ledger_walker::walked_set::insert (nano::block_hash const & block_hash_a)
+{
+	if (block_hash_a.is_zero ())
+	{
+		const auto inserted = !contains_zero;
+		contains_zero = true;
+		count += inserted ? 1 : 0;
+		return inserted;
+	}
+
+	// Keep the load factor at or below 3/4 so probe sequences stay short
+	if ((count + 1) * 4 > slots.size () * 3)
+	{
+		grow ();
+	}
+
+	const auto mask = slots.size () - 1;
+	for (auto index = block_hash_a.qwords[0] & mask;; index = (index + 1) & mask)
+	{
+		if (slots[index].is_zero ())
+		{
+			slots[index] = block_hash_a;
+			++count;
+			return true;
+		}
+
+		if (slots[index] == block_hash_a)
+		{
+			return false;
+		}
+	}
+}
+
+void nano::ledger_walker::walked_set::grow ()
+{
+	decltype (slots) old_slots (std::max<std::size_t> (64, slots.size () * 2));
+	old_slots.swap (slots);
+	const auto mask = slots.size () - 1;
+	for (const auto & block_hash : old_slots)
+	{
+		if (!block_hash.is_zero ())
+		{
+			auto index = block_hash.qwords[0] & mask;
+			while (!slots[index].is_zero ())
+			{
+				index = (index + 1) & mask;
+			}
+
+			slots[index] = block_hash;
+		}
+	}
+}
+
+void nano::ledger_walker::walked_set::clear ()
+{
+	decltype (slots){}.swap (slots);
+	count = 0;
+	contains_zero = false;
+}
+
+bool nano::ledger_walker::walked_set::empty () const
+{
+	return count == 0;
+}
+
+std::size_t nano::ledger_walker::walked_set::size () const
+{
+	return count;
+}
+
+std::size_t nano::ledger_walker::walked_set::bucket_count () const
+{
+	return slots.size ();
+}
+
+void nano::ledger_walker::walked_set::for_each (std::function<void (nano::block_hash const &)> const & action_a) const
+{
+	if (contains_zero)
+	{
+		action_a (nano::block_hash{ 0 });
+	}
+
+	for (const auto & block_hash : slots)
+	{
+		if (!block_hash.is_zero ())
+		{
+			action_a (block_hash);
+		}
+	}
 }
 
 #endif // _WIN32 -- TODO: keep this until diskhash builds fine on Windows
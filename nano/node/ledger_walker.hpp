@@ -3,14 +3,17 @@
 
 #pragma once
 
+#include <nano/lib/locks.hpp>
 #include <nano/lib/numbers.hpp>
+#include <nano/node/block_prefetcher.hpp>
 
 #include <cstddef>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <stack>
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 #include <diskhash.hpp>
 
@@ -20,14 +23,19 @@ class block;
 class ledger;
 class transaction;
 
-/** Walks the ledger starting from a start block and applying a depth-first search algorithm */
+/**
+ * Walks the ledger starting from a start block and applying a depth-first search algorithm
+ * Walked blocks are tracked in memory until \p in_memory_block_count is reached, after which they spill to a disk hash.
+ * While walking, the deferred branches of the dependency graph are prefetched in parallel by \p prefetch_threads threads.
+ */
 class ledger_walker final
 {
 public:
 	using should_visit_callback = std::function<bool (std::shared_ptr<nano::block> const &)>;
 	using visitor_callback = std::function<void (std::shared_ptr<nano::block> const &)>;
 
-	explicit ledger_walker (nano::ledger const & ledger_a);
+	explicit ledger_walker (nano::ledger const & ledger_a, std::size_t in_memory_block_count_a = default_in_memory_block_count, unsigned prefetch_threads_a = default_prefetch_threads);
+	~ledger_walker ();
 
 	/** Start traversing (in a backwards direction -- towards genesis) from \p start_block_hash_a until \p should_visit_callback_a returns false, calling \p visitor_callback_a at each block. Prefer 'walk' instead, if possible. */
 	void walk_backward (nano::block_hash const & start_block_hash_a, should_visit_callback const & should_visit_callback_a, visitor_callback const & visitor_callback_a);
@@ -39,22 +47,52 @@ public:
 	void walk_backward (nano::block_hash const & start_block_hash_a, visitor_callback const & visitor_callback_a);
 	void walk (nano::block_hash const & end_block_hash_a, visitor_callback const & visitor_callback_a);
 
-	/** How many blocks will be held in the in-memory hash before using the disk hash for walking. */
-	// TODO TSB: make this 65536
-	static constexpr std::size_t in_memory_block_count = 0;
+	/** How many blocks will be held in the in-memory hash before using the disk hash for walking, about 16MB worth of hashes. */
+	static constexpr std::size_t default_in_memory_block_count = 256 * 1024;
+	static constexpr unsigned default_prefetch_threads = 2;
+	/** How many blocks along the previous chain of a deferred branch are loaded by a single prefetch task */
+	static constexpr std::size_t prefetch_depth = 64;
+	static constexpr std::size_t max_prefetched_blocks = 64 * 1024;
 
 private:
+	/** Compact open addressing set of block hashes using linear probing, the zero hash marks empty slots */
+	class walked_set final
+	{
+	public:
+		/** Returns true if \p block_hash_a was not in the set yet */
+		bool insert (nano::block_hash const & block_hash_a);
+		void clear ();
+		bool empty () const;
+		std::size_t size () const;
+		std::size_t bucket_count () const;
+		void for_each (std::function<void (nano::block_hash const &)> const & action_a) const;
+
+	private:
+		void grow ();
+
+		std::vector<nano::block_hash> slots;
+		std::size_t count{ 0 };
+		bool contains_zero{ false };
+	};
+
 	nano::ledger const & ledger;
+	std::size_t const in_memory_block_count;
+	unsigned const prefetch_threads;
 	bool use_in_memory_walked_blocks;
-	std::unordered_set<nano::block_hash> walked_blocks;
+	walked_set walked_blocks;
 	std::optional<dht::DiskHash<bool>> walked_blocks_disk;
 	std::stack<nano::block_hash> blocks_to_walk;
 
-	void enqueue_block (nano::block_hash block_hash_a);
-	void enqueue_block (std::shared_ptr<nano::block> const & block_a);
+	nano::mutex prefetch_mutex;
+	std::unordered_map<nano::block_hash, std::shared_ptr<nano::block>> prefetched_blocks;
+	/** Declared last so its threads are joined before the blocks they fill in are destroyed */
+	nano::block_prefetcher prefetcher;
+
+	bool enqueue_block (nano::block_hash block_hash_a);
 	bool add_to_walked_blocks (nano::block_hash const & block_hash_a);
 	bool add_to_walked_blocks_disk (nano::block_hash const & block_hash_a);
 	void clear_queue ();
+	void prefetch (nano::block_hash const & block_hash_a);
 	std::shared_ptr<nano::block> dequeue_block (nano::transaction const & transaction_a);
 
 	friend class ledger_walker_genesis_account_longer_Test;
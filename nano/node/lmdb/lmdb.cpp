@@ -928,7 +928,23 @@ std::string nano::mdb_store::error_string (int status) const
 
 bool nano::mdb_store::copy_db (boost::filesystem::path const & destination_file)
 {
-	return !mdb_env_copy2 (env.environment, destination_file.string ().c_str (), MDB_CP_COMPACT);
+	return copy_db (destination_file, [this] (nano::mdb_compactor::table_progress const & progress_a) {
+		if (progress_a.done)
+		{
+			logger.always_log ("Copied table ", progress_a.to_string ());
+		}
+	});
+}
+
+bool nano::mdb_store::copy_db (boost::filesystem::path const & destination_file, std::function<void (nano::mdb_compactor::table_progress const &)> const & progress_a)
+{
+	nano::mdb_compactor compactor (env.environment, destination_file);
+	auto error (compactor.run (progress_a));
+	if (error)
+	{
+		logger.always_log ("Database copy failed: ", compactor.error_message ());
+	}
+	return !error;
 }
 
 void nano::mdb_store::rebuild_db (nano::write_transaction const & transaction_a)
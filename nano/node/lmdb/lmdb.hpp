@@ -4,6 +4,7 @@
 #include <nano/lib/lmdbconfig.hpp>
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/numbers.hpp>
+#include <nano/node/lmdb/lmdb_compactor.hpp>
 #include <nano/node/lmdb/lmdb_env.hpp>
 #include <nano/node/lmdb/lmdb_iterator.hpp>
 #include <nano/node/lmdb/lmdb_txn.hpp>
@@ -235,6 +236,8 @@ public:
 	int del (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a) const;
 
 	bool copy_db (boost::filesystem::path const & destination_file) override;
+	/** Compacting copy which calls \p progress_a after each batch copied. An interrupted copy resumes when called again with the same destination. Returns true on success */
+	bool copy_db (boost::filesystem::path const & destination_file, std::function<void (nano::mdb_compactor::table_progress const &)> const & progress_a);
 	void rebuild_db (nano::write_transaction const & transaction_a) override;
 
 	template <typename Key, typename Value>
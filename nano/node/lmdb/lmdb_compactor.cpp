@@ -0,0 +1,557 @@
+#include <nano/lib/locks.hpp>
+#include <nano/lib/stream.hpp>
+#include <nano/lib/threading.hpp>
+#include <nano/node/lmdb/lmdb_compactor.hpp>
+#include <nano/secure/buffer.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+char const * const nano::mdb_compactor::progress_table = "compactor_progress";
+
+namespace
+{
+// Key of the checkpoint holding the last transaction id of the source when the copy started, checkpoints of tables are keyed by "table:" and their name
+std::string const source_txnid_key ("source_txnid");
+std::string const table_key_prefix ("table:");
+
+MDB_val to_val (std::string const & string_a)
+{
+	return MDB_val{ string_a.size (), const_cast<char *> (string_a.data ()) };
+}
+
+MDB_val to_val (std::vector<uint8_t> const & bytes_a)
+{
+	return MDB_val{ bytes_a.size (), const_cast<uint8_t *> (bytes_a.data ()) };
+}
+
+void append (std::vector<uint8_t> & buffer_a, MDB_val const & val_a)
+{
+	auto size_l (static_cast<uint32_t> (val_a.mv_size));
+	auto size_bytes (reinterpret_cast<uint8_t const *> (&size_l));
+	buffer_a.insert (buffer_a.end (), size_bytes, size_bytes + sizeof (size_l));
+	auto data_l (reinterpret_cast<uint8_t const *> (val_a.mv_data));
+	buffer_a.insert (buffer_a.end (), data_l, data_l + val_a.mv_size);
+}
+
+MDB_val extract (uint8_t const *& position_a)
+{
+	uint32_t size_l;
+	std::copy (position_a, position_a + sizeof (size_l), reinterpret_cast<uint8_t *> (&size_l));
+	MDB_val result{ size_l, const_cast<uint8_t *> (position_a + sizeof (size_l)) };
+	position_a += sizeof (size_l) + size_l;
+	return result;
+}
+
+bool equals (MDB_val const & val_a, std::vector<uint8_t> const & bytes_a)
+{
+	return val_a.mv_size == bytes_a.size () && std::equal (bytes_a.begin (), bytes_a.end (), reinterpret_cast<uint8_t const *> (val_a.mv_data));
+}
+}
+
+/** A table being copied along with its checkpoint */
+class nano::mdb_compactor::table final
+{
+public:
+	std::string name;
+	MDB_dbi source_dbi{ 0 };
+	MDB_dbi destination_dbi{ 0 };
+	unsigned flags{ 0 };
+	/** Last key and, for tables with duplicates, last value written to the destination */
+	std::vector<uint8_t> last_key;
+	std::vector<uint8_t> last_value;
+	bool dupsort () const
+	{
+		return (flags & MDB_DUPSORT) != 0;
+	}
+	std::vector<uint8_t> serialize (nano::mdb_compactor::table_progress const & progress_a) const
+	{
+		std::vector<uint8_t> result;
+		{
+			nano::vectorstream stream (result);
+			nano::write (stream, progress_a.entries);
+			nano::write (stream, progress_a.bytes);
+			nano::write (stream, static_cast<uint8_t> (progress_a.done));
+			nano::write (stream, static_cast<uint32_t> (last_key.size ()));
+			nano::write (stream, last_key);
+			nano::write (stream, static_cast<uint32_t> (last_value.size ()));
+			nano::write (stream, last_value);
+		}
+		return result;
+	}
+	bool deserialize (MDB_val const & value_a, nano::mdb_compactor::table_progress & progress_a)
+	{
+		auto result (false);
+		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value_a.mv_data), value_a.mv_size);
+		try
+		{
+			uint8_t done_l;
+			uint32_t size_l;
+			nano::read (stream, progress_a.entries);
+			nano::read (stream, progress_a.bytes);
+			nano::read (stream, done_l);
+			nano::read (stream, size_l);
+			nano::read (stream, last_key, size_l);
+			nano::read (stream, size_l);
+			nano::read (stream, last_value, size_l);
+			progress_a.done = done_l != 0;
+			progress_a.resumed = progress_a.entries;
+			progress_a.resumed_bytes = progress_a.bytes;
+		}
+		catch (std::runtime_error const &)
+		{
+			result = true;
+		}
+		return result;
+	}
+};
+
+/** Records read from one table, serialized as 32 bit lengths followed by the key and the value */
+class nano::mdb_compactor::batch final
+{
+public:
+	std::size_t table{ 0 };
+	std::vector<uint8_t> data;
+	uint64_t entries{ 0 };
+	/** Set on the last batch of a table, which may be empty */
+	bool done{ false };
+	std::chrono::steady_clock::time_point started;
+	std::string error;
+};
+
+/** Bounded queue between the readers and the writer, readers block while the writer is behind */
+class nano::mdb_compactor::batch_queue final
+{
+public:
+	explicit batch_queue (std::size_t capacity_a) :
+		capacity (capacity_a)
+	{
+	}
+	/** Returns true if the queue was stopped */
+	bool push (batch && batch_a)
+	{
+		nano::unique_lock<nano::mutex> lock (mutex);
+		condition.wait (lock, [this] () { return stopped || batches.size () < capacity; });
+		if (!stopped)
+		{
+			batches.push_back (std::move (batch_a));
+			condition.notify_all ();
+		}
+		return stopped;
+	}
+	batch pop ()
+	{
+		nano::unique_lock<nano::mutex> lock (mutex);
+		condition.wait (lock, [this] () { return !batches.empty (); });
+		auto result (std::move (batches.front ()));
+		batches.pop_front ();
+		condition.notify_all ();
+		return result;
+	}
+	void stop ()
+	{
+		nano::lock_guard<nano::mutex> guard (mutex);
+		stopped = true;
+		condition.notify_all ();
+	}
+	bool is_stopped ()
+	{
+		nano::lock_guard<nano::mutex> guard (mutex);
+		return stopped;
+	}
+
+private:
+	std::size_t const capacity;
+	std::deque<batch> batches;
+	bool stopped{ false };
+	nano::mutex mutex;
+	nano::condition_variable condition;
+};
+
+std::string nano::mdb_compactor::table_progress::to_string () const
+{
+	auto milliseconds (std::chrono::duration_cast<std::chrono::milliseconds> (elapsed).count ());
+	auto megabytes (bytes / (1024.0 * 1024.0));
+	std::ostringstream stream;
+	stream << std::fixed << std::setprecision (1) << name << ": " << entries << " entries, " << megabytes << " MiB in " << milliseconds << " ms";
+	if (milliseconds > 0)
+	{
+		stream << " (" << (bytes - resumed_bytes) / (1024.0 * 1024.0) * 1000 / milliseconds << " MiB/s)";
+	}
+	if (resumed > 0)
+	{
+		stream << ", resumed after " << resumed << " entries";
+	}
+	return stream.str ();
+}
+
+nano::mdb_compactor::mdb_compactor (MDB_env * source_a, boost::filesystem::path const & destination_a, unsigned threads_a, std::size_t batch_size_a) :
+	source (source_a),
+	destination (destination_a),
+	threads (std::max (1u, threads_a)),
+	batch_size (std::max<std::size_t> (batch_size_a, 1))
+{
+}
+
+nano::mdb_compactor::~mdb_compactor ()
+{
+	close_destination ();
+}
+
+unsigned nano::mdb_compactor::default_threads ()
+{
+	return std::max (1u, std::thread::hardware_concurrency ());
+}
+
+bool nano::mdb_compactor::run (std::function<void (table_progress const &)> const & progress_a)
+{
+	tables_m.clear ();
+	progress_m.clear ();
+	MDB_envinfo info;
+	mdb_env_info (source, &info);
+	source_map_size = info.me_mapsize;
+	MDB_txn * txn (nullptr);
+	auto status (mdb_txn_begin (source, nullptr, MDB_RDONLY, &txn));
+	auto error (status != MDB_SUCCESS && set_error ("Could not begin a read transaction on the source", status));
+	if (!error)
+	{
+		// Every reader has to see this same state of the source
+		source_txnid = mdb_txn_id (txn);
+		// Named tables are the keys of the unnamed main table
+		MDB_dbi main_dbi;
+		MDB_cursor * cursor (nullptr);
+		error = mdb_dbi_open (txn, nullptr, 0, &main_dbi) != MDB_SUCCESS || mdb_cursor_open (txn, main_dbi, &cursor) != MDB_SUCCESS;
+		MDB_val key;
+		MDB_val value;
+		for (status = error ? MDB_NOTFOUND : mdb_cursor_get (cursor, &key, &value, MDB_FIRST); !error && status == MDB_SUCCESS; status = mdb_cursor_get (cursor, &key, &value, MDB_NEXT))
+		{
+			table table_l;
+			table_l.name.assign (reinterpret_cast<char const *> (key.mv_data), key.mv_size);
+			MDB_stat stat;
+			error = mdb_dbi_open (txn, table_l.name.c_str (), 0, &table_l.source_dbi) != MDB_SUCCESS || mdb_dbi_flags (txn, table_l.source_dbi, &table_l.flags) != MDB_SUCCESS || mdb_stat (txn, table_l.source_dbi, &stat) != MDB_SUCCESS;
+			if (!error)
+			{
+				table_progress progress_l;
+				progress_l.name = table_l.name;
+				progress_l.total = stat.ms_entries;
+				tables_m.push_back (std::move (table_l));
+				progress_m.push_back (std::move (progress_l));
+			}
+			else
+			{
+				set_error ("Could not open source table " + table_l.name);
+			}
+		}
+		if (cursor != nullptr)
+		{
+			mdb_cursor_close (cursor);
+		}
+		// Committing makes the table handles opened by this transaction available to the readers
+		status = mdb_txn_commit (txn);
+		error = error || (status != MDB_SUCCESS && set_error ("Could not list source tables", status));
+	}
+	if (!error)
+	{
+		if (open_destination (false) || load_checkpoints ())
+		{
+			// Not a resumable copy of this source, start over
+			close_destination ();
+			error_message_m.clear ();
+			boost::system::error_code ec;
+			boost::filesystem::remove (destination, ec);
+			error = (ec && set_error ("Could not remove " + destination.string () + ": " + ec.message ())) || open_destination (true);
+		}
+		error = error || create_tables ();
+	}
+	if (!error)
+	{
+		std::size_t remaining (std::count_if (progress_m.begin (), progress_m.end (), [] (table_progress const & progress_l) { return !progress_l.done; }));
+		auto const thread_count (std::min<std::size_t> (threads, remaining));
+		// Each reader fills one batch while the queue holds one more per reader and the writer appends another, bounding memory to (2 * readers + 1) batches
+		batch_queue queue (thread_count);
+		std::atomic<std::size_t> next (0);
+		std::vector<std::thread> readers;
+		readers.reserve (thread_count);
+		for (std::size_t i (0); i < thread_count; ++i)
+		{
+			readers.emplace_back ([this, &queue, &next] () {
+				nano::thread_role::set (nano::thread_role::name::db_parallel_traversal);
+				for (auto index (next++); index < tables_m.size () && !queue.is_stopped (); index = next++)
+				{
+					if (!progress_m[index].done)
+					{
+						read (tables_m[index], queue);
+					}
+				}
+			});
+		}
+		while (!error && remaining > 0)
+		{
+			auto batch_l (queue.pop ());
+			if (!batch_l.error.empty ())
+			{
+				error = set_error (batch_l.error);
+			}
+			else
+			{
+				error = write (batch_l, progress_a);
+				if (!error && batch_l.done)
+				{
+					--remaining;
+				}
+				error = error || (stopped && set_error ("Copy stopped, it can be resumed"));
+			}
+		}
+		queue.stop ();
+		for (auto & reader : readers)
+		{
+			reader.join ();
+		}
+	}
+	if (!error)
+	{
+		MDB_txn * txn_l (nullptr);
+		status = mdb_txn_begin (destination_env, nullptr, 0, &txn_l);
+		if (status == MDB_SUCCESS)
+		{
+			status = mdb_drop (txn_l, progress_dbi, 1);
+			status = status == MDB_SUCCESS ? mdb_txn_commit (txn_l) : (mdb_txn_abort (txn_l), status);
+		}
+		error = (status != MDB_SUCCESS && set_error ("Could not remove the checkpoints", status)) || (mdb_env_sync (destination_env, 1) != MDB_SUCCESS && set_error ("Could not sync the destination"));
+	}
+	close_destination ();
+	return error;
+}
+
+void nano::mdb_compactor::stop ()
+{
+	stopped = true;
+}
+
+std::vector<nano::mdb_compactor::table_progress> const & nano::mdb_compactor::tables () const
+{
+	return progress_m;
+}
+
+std::string const & nano::mdb_compactor::error_message () const
+{
+	return error_message_m;
+}
+
+bool nano::mdb_compactor::open_destination (bool fresh_a)
+{
+	auto status (mdb_env_create (&destination_env));
+	if (status == MDB_SUCCESS)
+	{
+		// One more table for the checkpoints. There is a single writer and nobody else opens the file until the copy is complete, so it needs no lock file
+		status = mdb_env_set_maxdbs (destination_env, static_cast<MDB_dbi> (tables_m.size () + 1));
+		status = status == MDB_SUCCESS ? mdb_env_set_mapsize (destination_env, source_map_size) : status;
+		status = status == MDB_SUCCESS ? mdb_env_open (destination_env, destination.string ().c_str (), MDB_NOSUBDIR | MDB_NOTLS | MDB_NOLOCK, 00600) : status;
+	}
+	auto result (status != MDB_SUCCESS && set_error ("Could not open " + destination.string (), status));
+	if (!result)
+	{
+		MDB_txn * txn (nullptr);
+		status = mdb_txn_begin (destination_env, nullptr, 0, &txn);
+		if (status == MDB_SUCCESS)
+		{
+			// An existing file without checkpoints is a complete copy or not a copy at all, either way it is replaced
+			status = mdb_dbi_open (txn, progress_table, fresh_a ? MDB_CREATE : 0, &progress_dbi);
+			if (status == MDB_SUCCESS && fresh_a)
+			{
+				auto key (to_val (source_txnid_key));
+				MDB_val value{ sizeof (source_txnid), &source_txnid };
+				status = mdb_put (txn, progress_dbi, &key, &value, 0);
+			}
+			status = status == MDB_SUCCESS ? mdb_txn_commit (txn) : (mdb_txn_abort (txn), status);
+		}
+		result = status != MDB_SUCCESS && set_error ("Could not open the checkpoints", status);
+	}
+	return result;
+}
+
+void nano::mdb_compactor::close_destination ()
+{
+	if (destination_env != nullptr)
+	{
+		mdb_env_close (destination_env);
+		destination_env = nullptr;
+	}
+}
+
+/** Reads the checkpoint of every table. Returns true if the checkpoints are missing or were made for another state of the source */
+bool nano::mdb_compactor::load_checkpoints ()
+{
+	MDB_txn * txn (nullptr);
+	auto result (mdb_txn_begin (destination_env, nullptr, MDB_RDONLY, &txn) != MDB_SUCCESS);
+	if (!result)
+	{
+		auto key (to_val (source_txnid_key));
+		MDB_val value;
+		result = mdb_get (txn, progress_dbi, &key, &value) != MDB_SUCCESS || value.mv_size != sizeof (source_txnid) || std::memcmp (value.mv_data, &source_txnid, sizeof (source_txnid)) != 0;
+		for (std::size_t i (0); !result && i < tables_m.size (); ++i)
+		{
+			auto name_l (table_key_prefix + tables_m[i].name);
+			auto key_l (to_val (name_l));
+			auto status (mdb_get (txn, progress_dbi, &key_l, &value));
+			result = status != MDB_NOTFOUND && (status != MDB_SUCCESS || tables_m[i].deserialize (value, progress_m[i]));
+		}
+		mdb_txn_abort (txn);
+	}
+	return result;
+}
+
+bool nano::mdb_compactor::create_tables ()
+{
+	MDB_txn * txn (nullptr);
+	auto status (mdb_txn_begin (destination_env, nullptr, 0, &txn));
+	for (auto i (tables_m.begin ()), n (tables_m.end ()); status == MDB_SUCCESS && i != n; ++i)
+	{
+		status = mdb_dbi_open (txn, i->name.c_str (), MDB_CREATE | (i->flags & ~MDB_CREATE), &i->destination_dbi);
+	}
+	if (txn != nullptr)
+	{
+		status = status == MDB_SUCCESS ? mdb_txn_commit (txn) : (mdb_txn_abort (txn), status);
+	}
+	return status != MDB_SUCCESS && set_error ("Could not create the destination tables", status);
+}
+
+/** Appends the records of \p batch_a and commits them along with the table checkpoint */
+bool nano::mdb_compactor::write (batch const & batch_a, std::function<void (table_progress const &)> const & progress_a)
+{
+	auto & table_l (tables_m[batch_a.table]);
+	auto & progress_l (progress_m[batch_a.table]);
+	MDB_txn * txn (nullptr);
+	MDB_cursor * cursor (nullptr);
+	auto status (mdb_txn_begin (destination_env, nullptr, 0, &txn));
+	status = status == MDB_SUCCESS ? mdb_cursor_open (txn, table_l.destination_dbi, &cursor) : status;
+	auto position (batch_a.data.data ());
+	auto const end (position + batch_a.data.size ());
+	MDB_val key{ 0, nullptr };
+	MDB_val value{ 0, nullptr };
+	while (status == MDB_SUCCESS && position != end)
+	{
+		auto previous (key);
+		key = extract (position);
+		value = extract (position);
+		// Duplicates of the previous key are appended to its values, a new key is appended to the table
+		auto same_key (table_l.dupsort () && (previous.mv_data != nullptr ? previous.mv_size == key.mv_size && std::memcmp (previous.mv_data, key.mv_data, key.mv_size) == 0 : equals (key, table_l.last_key)));
+		status = mdb_cursor_put (cursor, &key, &value, same_key ? MDB_APPENDDUP : MDB_APPEND);
+		progress_l.bytes += key.mv_size + value.mv_size;
+	}
+	if (cursor != nullptr)
+	{
+		mdb_cursor_close (cursor);
+	}
+	if (status == MDB_SUCCESS)
+	{
+		if (key.mv_data != nullptr)
+		{
+			table_l.last_key.assign (reinterpret_cast<uint8_t const *> (key.mv_data), reinterpret_cast<uint8_t const *> (key.mv_data) + key.mv_size);
+			if (table_l.dupsort ())
+			{
+				table_l.last_value.assign (reinterpret_cast<uint8_t const *> (value.mv_data), reinterpret_cast<uint8_t const *> (value.mv_data) + value.mv_size);
+			}
+		}
+		progress_l.entries += batch_a.entries;
+		progress_l.done = batch_a.done;
+		progress_l.elapsed = std::chrono::steady_clock::now () - batch_a.started;
+		auto name_l (table_key_prefix + table_l.name);
+		auto checkpoint_key (to_val (name_l));
+		auto checkpoint (table_l.serialize (progress_l));
+		auto checkpoint_value (to_val (checkpoint));
+		status = mdb_put (txn, progress_dbi, &checkpoint_key, &checkpoint_value, 0);
+	}
+	if (txn != nullptr)
+	{
+		status = status == MDB_SUCCESS ? mdb_txn_commit (txn) : (mdb_txn_abort (txn), status);
+	}
+	auto result (status != MDB_SUCCESS && set_error ("Could not write to table " + table_l.name, status));
+	if (!result && progress_a)
+	{
+		progress_a (progress_l);
+	}
+	return result;
+}
+
+/** Reads \p table_a from its checkpoint onwards in batches of at least batch_size bytes, runs on a reader thread */
+void nano::mdb_compactor::read (table & table_a, batch_queue & queue_a)
+{
+	batch batch_l;
+	batch_l.table = static_cast<std::size_t> (&table_a - tables_m.data ());
+	batch_l.started = std::chrono::steady_clock::now ();
+	MDB_txn * txn (nullptr);
+	MDB_cursor * cursor (nullptr);
+	auto status (mdb_txn_begin (source, nullptr, MDB_RDONLY, &txn));
+	status = status == MDB_SUCCESS ? mdb_cursor_open (txn, table_a.source_dbi, &cursor) : status;
+	MDB_val key{ 0, nullptr };
+	MDB_val value{ 0, nullptr };
+	auto changed (status == MDB_SUCCESS && mdb_txn_id (txn) != source_txnid);
+	if (status == MDB_SUCCESS && !changed)
+	{
+		if (table_a.last_key.empty ())
+		{
+			status = mdb_cursor_get (cursor, &key, &value, MDB_FIRST);
+		}
+		else
+		{
+			key = to_val (table_a.last_key);
+			value = to_val (table_a.last_value);
+			status = mdb_cursor_get (cursor, &key, &value, table_a.dupsort () ? MDB_GET_BOTH : MDB_SET_KEY);
+			status = status == MDB_SUCCESS ? mdb_cursor_get (cursor, &key, &value, MDB_NEXT) : status;
+		}
+	}
+	auto stopped_l (false);
+	for (; !stopped_l && !changed && status == MDB_SUCCESS; status = mdb_cursor_get (cursor, &key, &value, MDB_NEXT))
+	{
+		append (batch_l.data, key);
+		append (batch_l.data, value);
+		++batch_l.entries;
+		if (batch_l.data.size () >= batch_size)
+		{
+			auto started_l (batch_l.started);
+			stopped_l = queue_a.push (std::move (batch_l));
+			batch_l = batch{};
+			batch_l.table = static_cast<std::size_t> (&table_a - tables_m.data ());
+			batch_l.started = started_l;
+		}
+	}
+	if (cursor != nullptr)
+	{
+		mdb_cursor_close (cursor);
+	}
+	if (txn != nullptr)
+	{
+		mdb_txn_abort (txn);
+	}
+	if (!stopped_l)
+	{
+		batch_l.done = !changed && status == MDB_NOTFOUND;
+		if (changed)
+		{
+			batch_l.error = "The source was written to during the copy";
+		}
+		else if (!batch_l.done)
+		{
+			batch_l.error = "Could not read table " + table_a.name + ": " + mdb_strerror (status);
+		}
+		queue_a.push (std::move (batch_l));
+	}
+}
+
+bool nano::mdb_compactor::set_error (std::string const & message_a)
+{
+	error_message_m = message_a;
+	return true;
+}
+
+bool nano::mdb_compactor::set_error (std::string const & message_a, int status_a)
+{
+	return set_error (message_a + ": " + mdb_strerror (status_a));
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <lmdb/libraries/liblmdb/lmdb.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Compacting copy of an LMDB environment into a new file, an alternative to mdb_env_copy2 with MDB_CP_COMPACT which copies tables in parallel and can resume.
+ * Reader threads each walk one table at a time in their own read transaction and hand byte bounded batches of records, in key order, to the calling thread.
+ * LMDB allows a single writer, so the calling thread appends every batch with MDB_APPEND and commits it together with a checkpoint of the last record copied.
+ * A copy which was interrupted resumes after its last committed batch, unless the source was written to since the copy started, in which case it starts over.
+ * The checkpoints are removed once every table has been copied.
+ */
+class mdb_compactor final
+{
+public:
+	class table_progress final
+	{
+	public:
+		std::string name;
+		/** Entries and bytes of keys and values copied so far, including those copied before resuming */
+		uint64_t entries{ 0 };
+		uint64_t bytes{ 0 };
+		/** Entries in the source table */
+		uint64_t total{ 0 };
+		/** Time spent copying the table in this run */
+		std::chrono::steady_clock::duration elapsed{ 0 };
+		/** Entries and bytes copied by an earlier, interrupted run */
+		uint64_t resumed{ 0 };
+		uint64_t resumed_bytes{ 0 };
+		bool done{ false };
+		/** Entries, size and throughput of this run in a single line */
+		std::string to_string () const;
+	};
+
+	/**
+	 * @param source_a Open environment to copy. Other threads may keep reading it but it must not be written to until the copy is complete
+	 * @param destination_a File the copy is written to. It is replaced unless it holds a copy of the same source which can be resumed
+	 */
+	mdb_compactor (MDB_env * source_a, boost::filesystem::path const & destination_a, unsigned threads_a = default_threads (), std::size_t batch_size_a = default_batch_size);
+	~mdb_compactor ();
+	/** Copies every table, calling \p progress_a from the calling thread after each committed batch. Returns true on error */
+	bool run (std::function<void (table_progress const &)> const & progress_a = nullptr);
+	/** Makes run () return with an error after the batch being written, leaving the destination resumable. Can be called from any thread */
+	void stop ();
+	std::vector<table_progress> const & tables () const;
+	std::string const & error_message () const;
+
+	static unsigned default_threads ();
+	/** Bytes of records per batch, large enough to amortise a commit while keeping the (2 * threads + 1) batches held at once small */
+	static std::size_t constexpr default_batch_size{ 4 * 1024 * 1024 };
+	/** Table in the destination holding the checkpoints while the copy is incomplete */
+	static char const * const progress_table;
+
+private:
+	class table;
+	class batch;
+	class batch_queue;
+
+	bool open_destination (bool fresh_a);
+	void close_destination ();
+	bool load_checkpoints ();
+	bool create_tables ();
+	bool write (batch const &, std::function<void (table_progress const &)> const &);
+	void read (table &, batch_queue &);
+	bool set_error (std::string const &);
+	bool set_error (std::string const &, int status_a);
+
+	MDB_env * const source;
+	boost::filesystem::path const destination;
+	unsigned const threads;
+	std::size_t const batch_size;
+	MDB_env * destination_env{ nullptr };
+	MDB_dbi progress_dbi{ 0 };
+	uint64_t source_txnid{ 0 };
+	std::size_t source_map_size{ 0 };
+	std::vector<table> tables_m;
+	std::vector<table_progress> progress_m;
+	std::atomic<bool> stopped{ false };
+	std::string error_message_m;
+};
+}
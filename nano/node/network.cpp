@@ -27,6 +27,7 @@ nano::network::network (nano::node & node_a, uint16_t port_a) :
 	buffer_container (node_a.stats, nano::network::buffer_size, 4096), // 2Mb receive buffer
 	resolver (node_a.io_ctx),
 	limiter (node_a.config.bandwidth_limit_burst_ratio, node_a.config.bandwidth_limit),
+	peer_limit (static_cast<size_t> (node_a.config.bandwidth_limit * node_a.config.bandwidth_limit_peer_share)),
 	tcp_message_manager (node_a.config.tcp_incoming_connections_max),
 	node (node_a),
 	publish_filter (256 * 1024),
@@ -812,6 +813,8 @@ void nano::network::erase (nano::transport::channel const & channel_a)
 void nano::network::set_bandwidth_params (double limit_burst_ratio_a, size_t limit_a)
 {
 	limiter.reset (limit_burst_ratio_a, limit_a);
+	peer_limit = static_cast<size_t> (limit_a * node.config.bandwidth_limit_peer_share);
+	++limits_generation;
 }
 
 nano::message_buffer_manager::message_buffer_manager (nano::stat & stats_a, size_t size, size_t count) :
@@ -933,6 +936,7 @@ nano::tcp_message_item nano::tcp_message_manager::get_message ()
 	{
 		result = std::move (entries.front ());
 		entries.pop_front ();
+		++total_processed;
 	}
 	else
 	{
@@ -943,6 +947,17 @@ nano::tcp_message_item nano::tcp_message_manager::get_message ()
 	return result;
 }
 
+std::size_t nano::tcp_message_manager::size ()
+{
+	nano::lock_guard<nano::mutex> lock (mutex);
+	return entries.size ();
+}
+
+std::size_t nano::tcp_message_manager::capacity () const
+{
+	return max_entries;
+}
+
 void nano::tcp_message_manager::stop ()
 {
 	{
@@ -74,6 +74,10 @@ public:
 	nano::tcp_message_item get_message ();
 	// Stop container and notify waiting threads
 	void stop ();
+	std::size_t size ();
+	std::size_t capacity () const;
+	// Messages handed to consumers since startup
+	std::atomic<uint64_t> total_processed{ 0 };
 
 private:
 	nano::mutex mutex;
@@ -190,6 +194,10 @@ public:
 	boost::asio::ip::udp::resolver resolver;
 	std::vector<boost::thread> packet_processing_threads;
 	nano::bandwidth_limiter limiter;
+	/** Share of the bandwidth limit each channel is limited to, zero when the node is unlimited or the limit is not shared */
+	std::atomic<size_t> peer_limit;
+	/** Incremented whenever the limits are reset, so channels reset their own limiter */
+	std::atomic<uint64_t> limits_generation{ 0 };
 	nano::peer_exclusion excluded_peers;
 	nano::tcp_message_manager tcp_message_manager;
 	nano::node & node;
@@ -12,6 +12,7 @@
 #include <nano/test_common/system.hpp>
 
 #include <boost/filesystem.hpp>
+#include <boost/polymorphic_cast.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 #include <algorithm>
@@ -76,6 +77,7 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (re
 	auto sizeof_element = sizeof (decltype (rep_crawler.active)::value_type);
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "active", count, sizeof_element }));
+	composite->add_component (rep_crawler.tracker.collect_container_info ("tracker"));
 	return composite;
 }
 
@@ -85,7 +87,7 @@ nano::node::node (boost::asio::io_context & io_ctx_a, uint16_t peering_port_a, b
 }
 
 nano::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::path const & application_path_a, nano::node_config const & config_a, nano::work_pool & work_a, nano::node_flags flags_a, unsigned seq) :
-	write_database_queue (!flags_a.force_use_write_database_queue && (config_a.rocksdb_config.enable)),
+	write_database_queue (!flags_a.force_use_write_database_queue && !flags_a.rocksdb_bulk_ingest && (config_a.rocksdb_config.enable)),
 	io_ctx (io_ctx_a),
 	node_initialized_latch (1),
 	config (config_a),
@@ -112,6 +114,7 @@ nano::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::path co
 	vote_processor (checker, active, observers, stats, config, flags, logger, online_reps, rep_crawler, ledger, network_params),
 	warmed_up (0),
 	block_processor (*this, write_database_queue),
+	admission (stats),
 	online_reps (ledger, config),
 	history{ config.network_params.voting },
 	vote_uniquer (block_uniquer),
@@ -123,6 +126,10 @@ nano::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::path co
 	startup_time (std::chrono::steady_clock::now ()),
 	node_seq (seq)
 {
+	stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::rpc_action, nano::stat::dir::in);
+	admission.add ([this] () { return block_processor.size (); }, flags.block_processor_full_size, [this] () { return block_processor.total_processed.load (); });
+	admission.add ([this] () { return vote_processor.size (); }, flags.vote_processor_capacity, [this] () { return vote_processor.total_processed.load (); });
+	admission.add ([this] () { return network.tcp_message_manager.size (); }, network.tcp_message_manager.capacity (), [this] () { return network.tcp_message_manager.total_processed.load (); });
 	if (!init_error ())
 	{
 		telemetry->start ();
@@ -287,6 +294,7 @@ nano::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::path co
 		});
 		observers.vote.add ([this] (std::shared_ptr<nano::vote> vote_a, std::shared_ptr<nano::transport::channel> const & channel_a, nano::vote_code code_a) {
 			debug_assert (code_a != nano::vote_code::invalid);
+			this->rep_crawler.tracker.vote (*vote_a);
 			// The vote_code::vote is handled inside the election
 			if (code_a == nano::vote_code::indeterminate)
 			{
@@ -430,6 +438,19 @@ nano::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::path co
 				std::exit (1);
 			}
 		}
+
+		if (flags.rocksdb_bulk_ingest && config.rocksdb_config.enable && !flags.read_only)
+		{
+			// Ledger writers are serialized by the write database queue, so their writes cannot conflict
+			logger.always_log ("RocksDB bulk ingest enabled, ledger writes skip transaction conflict tracking");
+			boost::polymorphic_downcast<nano::rocksdb_store *> (&store)->set_untracked_writes (true);
+		}
+
+		if (config.exists_filter_mb > 0)
+		{
+			logger.always_log (boost::str (boost::format ("Populating %1% MB exists filter") % config.exists_filter_mb));
+			ledger.enable_exists_filter (static_cast<std::size_t> (config.exists_filter_mb) * 1024 * 1024);
+		}
 	}
 	node_initialized_latch.count_down ();
 }
@@ -616,6 +637,7 @@ void nano::node::start ()
 	}
 	ongoing_rep_calculation ();
 	ongoing_peer_store ();
+	ongoing_admission_sample ();
 	ongoing_online_weight_calculation_queue ();
 	bool tcp_enabled (false);
 	if (config.tcp_incoming_connections_max > 0 && !(flags.disable_bootstrap_listener && flags.disable_tcp_realtime))
@@ -856,6 +878,18 @@ void nano::node::ongoing_peer_store ()
 	});
 }
 
+void nano::node::ongoing_admission_sample ()
+{
+	admission.sample ();
+	std::weak_ptr<nano::node> node_w (shared_from_this ());
+	workers.add_timed_task (std::chrono::steady_clock::now () + nano::admission_control::sample_interval, [node_w] () {
+		if (auto node_l = node_w.lock ())
+		{
+			node_l->ongoing_admission_sample ();
+		}
+	});
+}
+
 void nano::node::backup_wallet ()
 {
 	auto transaction (wallets.tx_begin_read ());
@@ -1443,7 +1477,7 @@ void nano::node::set_bandwidth_params (size_t limit, double ratio)
 {
 	config.bandwidth_limit_burst_ratio = ratio;
 	config.bandwidth_limit = limit;
-	network.set_bandwidth_params (limit, ratio);
+	network.set_bandwidth_params (ratio, limit);
 	logger.always_log (boost::str (boost::format ("set_bandwidth_params(%1%, %2%)") % limit % ratio));
 }
 
@@ -1745,12 +1779,14 @@ void nano::node::populate_backlog ()
 	{
 		auto transaction = store.tx_begin_read ();
 		auto count = 0;
+		std::vector<nano::account> accounts;
 		for (auto i = store.account.begin (transaction, next), n = store.account.end (); !stopped && i != n && count < chunk_size; ++i, ++count, ++total)
 		{
 			auto const & account = i->first;
-			scheduler.activate (account, transaction);
+			accounts.push_back (account);
 			next = account.number () + 1;
 		}
+		scheduler.activate (std::move (accounts), transaction);
 		done = store.account.begin (transaction, next) == store.account.end ();
 	}
 }
@@ -1814,6 +1850,7 @@ nano::node_flags const & nano::inactive_node_flag_defaults ()
 	node_flags.generate_cache.cemented_count = false;
 	node_flags.generate_cache.unchecked_count = false;
 	node_flags.generate_cache.account_count = false;
+	node_flags.generate_cache.uncemented = false;
 	node_flags.disable_bootstrap_listener = true;
 	node_flags.disable_tcp_realtime = true;
 	return node_flags;
@@ -95,6 +95,8 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("vote_generator_threshold", vote_generator_threshold, "Number of bundled hashes required for an additional generator delay.\ntype:uint64,[1..11]");
 	toml.put ("unchecked_cutoff_time", unchecked_cutoff_time.count (), "Number of seconds before deleting an unchecked entry.\nWarning: lower values (e.g., 3600 seconds, or 1 hour) may result in unsuccessful bootstraps, especially a bootstrap from scratch.\ntype:seconds");
 	toml.put ("tcp_io_timeout", tcp_io_timeout.count (), "Timeout for TCP connect-, read- and write operations.\nWarning: a low value (e.g., below 5 seconds) may result in TCP connections failing.\ntype:seconds");
+	toml.put ("tcp_write_coalesce_bytes", tcp_write_coalesce_bytes, "Maximum number of bytes from queued outbound messages gathered into a single socket write.\ntype:uint64,[1..]");
+	toml.put ("tcp_write_coalesce_delay", tcp_write_coalesce_delay.count (), "Time an idle socket waits for further outbound messages before writing, allowing them to be gathered into a single write. Zero writes immediately, messages queued while a write is in progress are always gathered.\ntype:milliseconds");
 	toml.put ("pow_sleep_interval", pow_sleep_interval.count (), "Time to sleep between batch work generation attempts. Reduces max CPU usage at the expense of a longer generation time.\ntype:nanoseconds");
 	toml.put ("external_address", external_address, "The external address of this node (NAT). If not set, the node will request this information via UPnP.\ntype:string,ip");
 	toml.put ("external_port", external_port, "The external port number of this node (NAT). Only used if external_address is set.\ntype:uint16");
@@ -104,12 +106,15 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("active_elections_size", active_elections_size, "Number of active elections. Elections beyond this limit have limited survival time.\nWarning: modifying this value may result in a lower confirmation rate.\ntype:uint64,[250..]");
 	toml.put ("bandwidth_limit", bandwidth_limit, "Outbound traffic limit in bytes/sec after which messages will be dropped.\nNote: changing to unlimited bandwidth (0) is not recommended for limited connections.\ntype:uint64");
 	toml.put ("bandwidth_limit_burst_ratio", bandwidth_limit_burst_ratio, "Burst ratio for outbound traffic shaping.\ntype:double");
+	toml.put ("bandwidth_limit_peer_share", bandwidth_limit_peer_share, "Fraction of the outbound traffic limit a single peer may use before its messages are dropped, giving each peer a fair share when the limit is reached. Disabled (0) by default.\ntype:double,[0..1]");
 	toml.put ("conf_height_processor_batch_min_time", conf_height_processor_batch_min_time.count (), "Minimum write batching time when there are blocks pending confirmation height.\ntype:milliseconds");
 	toml.put ("backup_before_upgrade", backup_before_upgrade, "Backup the ledger database before performing upgrades.\nWarning: uses more disk storage and increases startup time when upgrading.\ntype:bool");
 	toml.put ("max_work_generate_multiplier", max_work_generate_multiplier, "Maximum allowed difficulty multiplier for work generation.\ntype:double,[1..]");
 	toml.put ("frontiers_confirmation", serialize_frontiers_confirmation (frontiers_confirmation), "Mode controlling frontier confirmation rate.\ntype:string,{auto,always,disabled}");
 	toml.put ("max_queued_requests", max_queued_requests, "Limit for number of queued confirmation requests for one channel, after which new requests are dropped until the queue drops below this value.\ntype:uint32");
+	toml.put ("request_aggregator_threads", request_aggregator_threads, "Number of threads dedicated to answering confirmation requests from queued per-peer request pools. Defaults to the number of CPU threads / 4, and at least 1.\ntype:uint64,[1..]");
 	toml.put ("confirm_req_batches_max", confirm_req_batches_max, "Limit for the number of confirmation requests for one channel per request attempt\ntype:uint32");
+	toml.put ("exists_filter_mb", exists_filter_mb, "Size in megabytes of an in-memory bloom filter over block, account and receivable keys, letting lookups for missing entries skip the database. About 1 MB per million ledger entries, populated at startup. Disabled (0) by default.\ntype:uint32");
 
 	auto work_peers_l (toml.create_array ("work_peers", "A list of \"address:port\" entries to identify work peers."));
 	for (auto i (work_peers.begin ()), n (work_peers.end ()); i != n; ++i)
@@ -307,6 +312,11 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		toml.get ("tcp_io_timeout", tcp_io_timeout_l);
 		tcp_io_timeout = std::chrono::seconds (tcp_io_timeout_l);
 
+		toml.get<size_t> ("tcp_write_coalesce_bytes", tcp_write_coalesce_bytes);
+		auto tcp_write_coalesce_delay_l (tcp_write_coalesce_delay.count ());
+		toml.get ("tcp_write_coalesce_delay", tcp_write_coalesce_delay_l);
+		tcp_write_coalesce_delay = std::chrono::milliseconds (tcp_write_coalesce_delay_l);
+
 		toml.get<uint16_t> ("peering_port", peering_port);
 		toml.get<unsigned> ("bootstrap_fraction_numerator", bootstrap_fraction_numerator);
 		toml.get<unsigned> ("election_hint_weight_percent", election_hint_weight_percent);
@@ -342,6 +352,7 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		toml.get<size_t> ("active_elections_size", active_elections_size);
 		toml.get<size_t> ("bandwidth_limit", bandwidth_limit);
 		toml.get<double> ("bandwidth_limit_burst_ratio", bandwidth_limit_burst_ratio);
+		toml.get<double> ("bandwidth_limit_peer_share", bandwidth_limit_peer_share);
 		toml.get<bool> ("backup_before_upgrade", backup_before_upgrade);
 
 		auto conf_height_processor_batch_min_time_l (conf_height_processor_batch_min_time.count ());
@@ -353,6 +364,8 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 
 		toml.get<uint32_t> ("max_queued_requests", max_queued_requests);
 		toml.get<uint32_t> ("confirm_req_batches_max", confirm_req_batches_max);
+		toml.get<uint32_t> ("exists_filter_mb", exists_filter_mb);
+		toml.get<unsigned> ("request_aggregator_threads", request_aggregator_threads);
 
 		if (toml.has_key ("frontiers_confirmation"))
 		{
@@ -426,6 +439,18 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		{
 			toml.get_error ().set ("bootstrap_frontier_request_count must be greater than or equal to 1024");
 		}
+		if (bandwidth_limit_peer_share < 0 || bandwidth_limit_peer_share > 1)
+		{
+			toml.get_error ().set ("bandwidth_limit_peer_share must be a number between 0 and 1");
+		}
+		if (request_aggregator_threads == 0)
+		{
+			toml.get_error ().set ("request_aggregator_threads must be non-zero");
+		}
+		if (tcp_write_coalesce_bytes == 0)
+		{
+			toml.get_error ().set ("tcp_write_coalesce_bytes must be non-zero");
+		}
 	}
 	catch (std::runtime_error const & ex)
 	{
@@ -84,6 +84,10 @@ public:
 	std::chrono::seconds tcp_io_timeout{ (network_params.network.is_dev_network () && !is_sanitizer_build) ? std::chrono::seconds (5) : std::chrono::seconds (15) };
 	std::chrono::nanoseconds pow_sleep_interval{ 0 };
 	size_t active_elections_size{ 5000 };
+	/** Maximum number of bytes gathered from a socket write queue into a single write */
+	size_t tcp_write_coalesce_bytes{ 64 * 1024 };
+	/** Time an idle socket waits for more writes before flushing, zero writes immediately */
+	std::chrono::milliseconds tcp_write_coalesce_delay{ 0 };
 	/** Default maximum incoming TCP connections, including realtime network & bootstrap */
 	unsigned tcp_incoming_connections_max{ 2048 };
 	bool use_memory_pools{ true };
@@ -94,12 +98,18 @@ public:
 	size_t bandwidth_limit{ 10 * 1024 * 1024 };
 	/** By default, allow bursts of 15MB/s (not sustainable) */
 	double bandwidth_limit_burst_ratio{ 3. };
+	/** Fraction of bandwidth_limit a single channel may use for droppable traffic, 0 disables per channel limits */
+	double bandwidth_limit_peer_share{ 0. };
 	std::chrono::milliseconds conf_height_processor_batch_min_time{ 50 };
 	bool backup_before_upgrade{ false };
 	double max_work_generate_multiplier{ 64. };
 	uint32_t max_queued_requests{ 512 };
+	/** Number of threads serving queued confirmation requests */
+	unsigned request_aggregator_threads{ std::max<unsigned> (1, std::thread::hardware_concurrency () / 4) };
 	/** Maximum amount of confirmation requests (batches) to be sent to each channel */
 	uint32_t confirm_req_batches_max{ network_params.network.is_dev_network () ? 1u : 2u };
+	/** Size of the bloom filter answering lookups for missing blocks, accounts and receivables without a database read, 0 disables it */
+	uint32_t exists_filter_mb{ 0 };
 	std::chrono::seconds max_pruning_age{ !network_params.network.is_beta_network () ? std::chrono::seconds (24 * 60 * 60) : std::chrono::seconds (5 * 60) }; // 1 day; 5 minutes for beta network
 	uint64_t max_pruning_depth{ 0 };
 	nano::rocksdb_config rocksdb_config;
@@ -146,6 +156,8 @@ public:
 	bool disable_search_pending{ false }; // For testing only
 	bool enable_pruning{ false };
 	bool fast_bootstrap{ false };
+	/** RocksDB only, serializes ledger writers through the write database queue so writes can skip transaction conflict tracking */
+	bool rocksdb_bulk_ingest{ false };
 	bool read_only{ false };
 	bool disable_connection_cleanup{ false };
 	nano::confirmation_height_mode confirmation_height_processor_mode{ nano::confirmation_height_mode::automatic };
@@ -0,0 +1,152 @@
+#include <nano/lib/utility.hpp>
+#include <nano/node/rep_tracker.hpp>
+
+namespace
+{
+// Weights given to a new observation, round trip times follow the usual TCP smoothing
+double constexpr rtt_weight = 1.0 / 8;
+double constexpr ratio_weight = 1.0 / 16;
+
+void average (double & average_a, double sample_a, double weight_a)
+{
+	average_a += (sample_a - average_a) * weight_a;
+}
+}
+
+std::chrono::milliseconds constexpr nano::rep_tracker::default_rtt;
+std::chrono::seconds constexpr nano::rep_tracker::request_timeout;
+
+bool nano::rep_tracker::rep_stats::votes_unsolicited () const
+{
+	return samples >= unsolicited_min_samples && unsolicited_ratio >= unsolicited_threshold;
+}
+
+void nano::rep_tracker::requested (nano::account const & account_a, nano::block_hash const & hash_a)
+{
+	auto now (std::chrono::steady_clock::now ());
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing_rep (reps.find (account_a));
+	if (existing_rep == reps.end ())
+	{
+		if (reps.size () >= max_reps)
+		{
+			auto oldest (std::min_element (reps.begin (), reps.end (), [] (auto const & lhs, auto const & rhs) {
+				return lhs.second.last_request < rhs.second.last_request;
+			}));
+			reps.erase (oldest);
+		}
+		existing_rep = reps.emplace (account_a, rep_stats{}).first;
+	}
+	existing_rep->second.last_request = now;
+	auto existing (outstanding.get<tag_hash> ().equal_range (hash_a));
+	auto found (std::any_of (existing.first, existing.second, [&account_a] (outstanding_request const & request_a) {
+		return request_a.account == account_a;
+	}));
+	// Only the first request is timed, repeated requests are answered by the same vote
+	if (!found)
+	{
+		if (outstanding.size () >= max_outstanding)
+		{
+			outstanding.get<tag_time> ().erase (outstanding.get<tag_time> ().begin ());
+		}
+		outstanding.insert (outstanding_request{ account_a, hash_a, now });
+	}
+}
+
+void nano::rep_tracker::vote (nano::vote const & vote_a)
+{
+	auto now (std::chrono::steady_clock::now ());
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing_rep (reps.find (vote_a.account));
+	if (existing_rep != reps.end ())
+	{
+		auto & stats_l (existing_rep->second);
+		for (auto const & hash : vote_a)
+		{
+			auto existing (outstanding.get<tag_hash> ().equal_range (hash));
+			auto request (std::find_if (existing.first, existing.second, [&vote_a] (outstanding_request const & request_a) {
+				return request_a.account == vote_a.account;
+			}));
+			if (request != existing.second)
+			{
+				double rtt_l (stats_l.rtt.count ());
+				average (rtt_l, std::chrono::duration_cast<std::chrono::milliseconds> (now - request->time).count (), rtt_weight);
+				stats_l.rtt = std::chrono::milliseconds (static_cast<int64_t> (rtt_l));
+				average (stats_l.reply_ratio, 1.0, ratio_weight);
+				average (stats_l.unsolicited_ratio, 0.0, ratio_weight);
+				outstanding.get<tag_hash> ().erase (request);
+			}
+			else
+			{
+				average (stats_l.unsolicited_ratio, 1.0, ratio_weight);
+			}
+			++stats_l.samples;
+		}
+	}
+}
+
+void nano::rep_tracker::cleanup ()
+{
+	auto cutoff (std::chrono::steady_clock::now () - request_timeout);
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto & by_time (outstanding.get<tag_time> ());
+	while (!by_time.empty () && by_time.begin ()->time < cutoff)
+	{
+		timed_out (*by_time.begin ());
+		by_time.erase (by_time.begin ());
+	}
+}
+
+// Must be called with the mutex held
+void nano::rep_tracker::timed_out (outstanding_request const & request_a)
+{
+	auto existing (reps.find (request_a.account));
+	if (existing != reps.end ())
+	{
+		average (existing->second.reply_ratio, 0.0, ratio_weight);
+		++existing->second.samples;
+	}
+}
+
+std::unordered_map<nano::account, nano::rep_tracker::rep_stats> nano::rep_tracker::stats (std::vector<nano::account> const & accounts_a) const
+{
+	std::unordered_map<nano::account, rep_stats> result;
+	nano::lock_guard<nano::mutex> guard (mutex);
+	for (auto const & account : accounts_a)
+	{
+		auto existing (reps.find (account));
+		if (existing != reps.end ())
+		{
+			result.emplace (account, existing->second);
+		}
+	}
+	return result;
+}
+
+nano::rep_tracker::rep_stats nano::rep_tracker::stats (nano::account const & account_a) const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing (reps.find (account_a));
+	return existing != reps.end () ? existing->second : rep_stats{};
+}
+
+std::size_t nano::rep_tracker::size () const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	return reps.size ();
+}
+
+std::unique_ptr<nano::container_info_component> nano::rep_tracker::collect_container_info (std::string const & name) const
+{
+	std::size_t reps_count;
+	std::size_t outstanding_count;
+	{
+		nano::lock_guard<nano::mutex> guard (mutex);
+		reps_count = reps.size ();
+		outstanding_count = outstanding.size ();
+	}
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "reps", reps_count, sizeof (decltype (reps)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "outstanding", outstanding_count, sizeof (outstanding_request) }));
+	return composite;
+}
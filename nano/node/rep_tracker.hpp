@@ -0,0 +1,100 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/lib/numbers.hpp>
+#include <nano/secure/common.hpp>
+
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mi = boost::multi_index;
+
+namespace nano
+{
+class container_info_component;
+
+/**
+ * Tracks how each representative responds to confirm_req, fed by the requests sent by the confirmation solicitor and the rep crawler and by every observed vote.
+ * Per representative it keeps moving averages of the round trip time, of the share of requests answered before request_timeout and of the share of votes which arrived without having been requested.
+ * Only representatives which were sent a request are tracked, votes from other accounts are ignored so throwaway voting keys cannot fill the table.
+ * Once max_reps are tracked, the representative requested least recently makes room for a new one.
+ * @note This class is thread-safe
+ */
+class rep_tracker final
+{
+public:
+	class rep_stats final
+	{
+	public:
+		/** Moving average of the time between a request and the vote answering it */
+		std::chrono::milliseconds rtt{ default_rtt };
+		/** Moving average of the share of requests answered within request_timeout */
+		double reply_ratio{ 1.0 };
+		/** Moving average of the share of votes for hashes which were not requested from the representative */
+		double unsolicited_ratio{ 0.0 };
+		/** Number of answered, timed out and unsolicited observations folded into the averages */
+		uint64_t samples{ 0 };
+		/** When a request was last sent to the representative */
+		std::chrono::steady_clock::time_point last_request;
+
+		/** Whether the representative reliably votes without being asked */
+		bool votes_unsolicited () const;
+	};
+
+	/** Records that \p hash_a was requested from \p account_a now */
+	void requested (nano::account const & account_a, nano::block_hash const & hash_a);
+	/** Matches the hashes of \p vote_a against outstanding requests to its account, votes from accounts which were never requested are ignored */
+	void vote (nano::vote const & vote_a);
+	/** Counts requests left unanswered for longer than request_timeout */
+	void cleanup ();
+	/** Returns the statistics of each of \p accounts_a which has any */
+	std::unordered_map<nano::account, rep_stats> stats (std::vector<nano::account> const & accounts_a) const;
+	rep_stats stats (nano::account const & account_a) const;
+	std::size_t size () const;
+	std::unique_ptr<nano::container_info_component> collect_container_info (std::string const &) const;
+
+	static std::chrono::milliseconds constexpr default_rtt{ 250 };
+	static std::chrono::seconds constexpr request_timeout{ 5 };
+	static double constexpr unsolicited_threshold{ 0.9 };
+	static uint64_t constexpr unsolicited_min_samples{ 16 };
+	static std::size_t constexpr max_outstanding{ 64 * 1024 };
+	static std::size_t constexpr max_reps{ 4 * 1024 };
+
+private:
+	class outstanding_request final
+	{
+	public:
+		nano::account account;
+		nano::block_hash hash;
+		std::chrono::steady_clock::time_point time;
+	};
+	class tag_hash
+	{
+	};
+	class tag_time
+	{
+	};
+
+	void timed_out (outstanding_request const &);
+
+	// clang-format off
+	boost::multi_index_container<outstanding_request,
+	mi::indexed_by<
+		mi::hashed_non_unique<mi::tag<tag_hash>,
+			mi::member<outstanding_request, nano::block_hash, &outstanding_request::hash>>,
+		mi::ordered_non_unique<mi::tag<tag_time>,
+			mi::member<outstanding_request, std::chrono::steady_clock::time_point, &outstanding_request::time>>>>
+	outstanding;
+	// clang-format on
+	std::unordered_map<nano::account, rep_stats> reps;
+	mutable nano::mutex mutex;
+};
+}
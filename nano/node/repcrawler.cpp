@@ -146,7 +146,7 @@ void nano::rep_crawler::query (std::vector<std::shared_ptr<nano::transport::chan
 	for (auto i (channels_a.begin ()), n (channels_a.end ()); i != n; ++i)
 	{
 		debug_assert (*i != nullptr);
-		on_rep_request (*i);
+		on_rep_request (*i, hash_root.first);
 		node.network.send_confirm_req (*i, hash_root);
 	}
 
@@ -233,7 +233,7 @@ nano::uint128_t nano::rep_crawler::total_weight () const
 	return result;
 }
 
-void nano::rep_crawler::on_rep_request (std::shared_ptr<nano::transport::channel> const & channel_a)
+void nano::rep_crawler::on_rep_request (std::shared_ptr<nano::transport::channel> const & channel_a, nano::block_hash const & hash_a)
 {
 	nano::lock_guard<nano::mutex> lock (probable_reps_mutex);
 	if (channel_a->get_tcp_endpoint ().address () != boost::asio::ip::address_v6::any ())
@@ -247,6 +247,7 @@ void nano::rep_crawler::on_rep_request (std::shared_ptr<nano::transport::channel
 			channel_ref_index.modify (itr_pair.first, [] (nano::representative & value_a) {
 				value_a.last_request = std::chrono::steady_clock::now ();
 			});
+			tracker.requested (itr_pair.first->account, hash_a);
 		}
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nano/node/common.hpp>
+#include <nano/node/rep_tracker.hpp>
 #include <nano/node/transport/transport.hpp>
 
 #include <boost/multi_index/hashed_index.hpp>
@@ -117,6 +118,9 @@ public:
 	/** Total number of representatives */
 	size_t representative_count ();
 
+	/** Round trip times and reply rates of representatives, used to direct confirmation requests */
+	nano::rep_tracker tracker;
+
 private:
 	nano::node & node;
 
@@ -135,8 +139,8 @@ private:
 	/** Returns a list of endpoints to crawl. The total weight is passed in to avoid computing it twice. */
 	std::vector<std::shared_ptr<nano::transport::channel>> get_crawl_targets (nano::uint128_t total_weight_a);
 
-	/** When a rep request is made, this is called to update the last-request timestamp. */
-	void on_rep_request (std::shared_ptr<nano::transport::channel> const & channel_a);
+	/** When a rep request is made, this is called to update the last-request timestamp and to time the request of \p hash_a. */
+	void on_rep_request (std::shared_ptr<nano::transport::channel> const & channel_a, nano::block_hash const & hash_a);
 
 	/** Clean representatives with inactive channels */
 	void cleanup_reps ();
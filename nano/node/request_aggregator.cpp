@@ -21,17 +21,22 @@ nano::request_aggregator::request_aggregator (nano::network_constants const & ne
 	wallets (wallets_a),
 	active (active_a),
 	generator (generator_a),
-	final_generator (final_generator_a),
-	thread ([this] () { run (); })
+	final_generator (final_generator_a)
 {
+	stats.define_histogram (nano::stat::type::aggregator, nano::stat::detail::aggregator_latency, nano::stat::dir::in, { 0, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000 });
 	generator.set_reply_action ([this] (std::shared_ptr<nano::vote> const & vote_a, std::shared_ptr<nano::transport::channel> const & channel_a) {
 		this->reply_action (vote_a, channel_a);
 	});
 	final_generator.set_reply_action ([this] (std::shared_ptr<nano::vote> const & vote_a, std::shared_ptr<nano::transport::channel> const & channel_a) {
 		this->reply_action (vote_a, channel_a);
 	});
+	auto const thread_count (std::max (1u, config_a.request_aggregator_threads));
+	for (auto i (0u); i < thread_count; ++i)
+	{
+		threads.emplace_back ([this] () { run (); });
+	}
 	nano::unique_lock<nano::mutex> lock (mutex);
-	condition.wait (lock, [&started = started] { return started; });
+	condition.wait (lock, [this, thread_count] { return started == thread_count; });
 }
 
 void nano::request_aggregator::add (std::shared_ptr<nano::transport::channel> const & channel_a, std::vector<std::pair<nano::block_hash, nano::root>> const & hashes_roots_a)
@@ -73,8 +78,11 @@ void nano::request_aggregator::add (std::shared_ptr<nano::transport::channel> co
 void nano::request_aggregator::run ()
 {
 	nano::thread_role::set (nano::thread_role::name::request_aggregator);
+	// Each worker keeps its own read transaction, only renewed while processing a batch
+	auto transaction (ledger.store.tx_begin_read ());
+	transaction.reset ();
 	nano::unique_lock<nano::mutex> lock (mutex);
-	started = true;
+	++started;
 	lock.unlock ();
 	condition.notify_all ();
 	lock.lock ();
@@ -83,37 +91,39 @@ void nano::request_aggregator::run ()
 		if (!requests.empty ())
 		{
 			auto & requests_by_deadline (requests.get<tag_deadline> ());
-			auto front (requests_by_deadline.begin ());
-			if (front->deadline < std::chrono::steady_clock::now ())
+			auto const now (std::chrono::steady_clock::now ());
+			if (requests_by_deadline.begin ()->deadline < now)
 			{
-				// Store the channel and requests for processing after erasing this pool
-				decltype (front->channel) channel{};
-				decltype (front->hashes_roots) hashes_roots{};
-				requests_by_deadline.modify (front, [&channel, &hashes_roots] (channel_pool & pool) {
-					channel.swap (pool.channel);
-					hashes_roots.swap (pool.hashes_roots);
-				});
-				requests_by_deadline.erase (front);
+				// Store the channel and requests of expired pools for processing after erasing them
+				std::vector<pool_item> batch;
+				for (auto front (requests_by_deadline.begin ()); front != requests_by_deadline.end () && front->deadline < now && batch.size () < max_batch; front = requests_by_deadline.begin ())
+				{
+					pool_item item{ nullptr, {}, front->start };
+					requests_by_deadline.modify (front, [&item] (channel_pool & pool) {
+						item.channel.swap (pool.channel);
+						item.hashes_roots.swap (pool.hashes_roots);
+					});
+					requests_by_deadline.erase (front);
+					batch.push_back (std::move (item));
+				}
+				// Leave remaining expired pools to other workers
+				auto more (!requests.empty () && requests_by_deadline.begin ()->deadline < now);
 				lock.unlock ();
-				erase_duplicates (hashes_roots);
-				auto const remaining = aggregate (hashes_roots, channel);
-				if (!remaining.first.empty ())
+				if (more)
 				{
-					// Generate votes for the remaining hashes
-					auto const generated = generator.generate (remaining.first, channel);
-					stats.add (nano::stat::type::requests, nano::stat::detail::requests_cannot_vote, stat::dir::in, remaining.first.size () - generated);
+					condition.notify_one ();
 				}
-				if (!remaining.second.empty ())
+				transaction.renew ();
+				for (auto & item : batch)
 				{
-					// Generate final votes for the remaining hashes
-					auto const generated = final_generator.generate (remaining.second, channel);
-					stats.add (nano::stat::type::requests, nano::stat::detail::requests_cannot_vote, stat::dir::in, remaining.second.size () - generated);
+					process (transaction, item);
 				}
+				transaction.reset ();
 				lock.lock ();
 			}
 			else
 			{
-				auto deadline = front->deadline;
+				auto deadline = requests_by_deadline.begin ()->deadline;
 				condition.wait_until (lock, deadline, [this, &deadline] () { return this->stopped || deadline < std::chrono::steady_clock::now (); });
 			}
 		}
@@ -124,6 +134,27 @@ void nano::request_aggregator::run ()
 	}
 }
 
+void nano::request_aggregator::process (nano::transaction const & transaction_a, pool_item & item_a)
+{
+	erase_duplicates (item_a.hashes_roots);
+	auto const remaining = aggregate (transaction_a, item_a.hashes_roots, item_a.channel);
+	if (!remaining.first.empty ())
+	{
+		// Generate votes for the remaining hashes
+		auto const generated = generator.generate (remaining.first, item_a.channel);
+		stats.add (nano::stat::type::requests, nano::stat::detail::requests_cannot_vote, stat::dir::in, remaining.first.size () - generated);
+	}
+	if (!remaining.second.empty ())
+	{
+		// Generate final votes for the remaining hashes
+		auto const generated = final_generator.generate (remaining.second, item_a.channel);
+		stats.add (nano::stat::type::requests, nano::stat::detail::requests_cannot_vote, stat::dir::in, remaining.second.size () - generated);
+	}
+	// Time from the first request of the pool until it was served, in milliseconds
+	auto latency (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - item_a.start));
+	stats.update_histogram (nano::stat::type::aggregator, nano::stat::detail::aggregator_latency, nano::stat::dir::in, latency.count ());
+}
+
 void nano::request_aggregator::stop ()
 {
 	{
@@ -131,9 +162,12 @@ void nano::request_aggregator::stop ()
 		stopped = true;
 	}
 	condition.notify_all ();
-	if (thread.joinable ())
+	for (auto & thread : threads)
 	{
-		thread.join ();
+		if (thread.joinable ())
+		{
+			thread.join ();
+		}
 	}
 }
 
@@ -165,9 +199,8 @@ void nano::request_aggregator::erase_duplicates (std::vector<std::pair<nano::blo
 	requests_a.end ());
 }
 
-std::pair<std::vector<std::shared_ptr<nano::block>>, std::vector<std::shared_ptr<nano::block>>> nano::request_aggregator::aggregate (std::vector<std::pair<nano::block_hash, nano::root>> const & requests_a, std::shared_ptr<nano::transport::channel> & channel_a) const
+std::pair<std::vector<std::shared_ptr<nano::block>>, std::vector<std::shared_ptr<nano::block>>> nano::request_aggregator::aggregate (nano::transaction const & transaction, std::vector<std::pair<nano::block_hash, nano::root>> const & requests_a, std::shared_ptr<nano::transport::channel> & channel_a) const
 {
-	auto transaction (ledger.store.tx_begin_read ());
 	size_t cached_hashes = 0;
 	std::vector<std::shared_ptr<nano::block>> to_generate;
 	std::vector<std::shared_ptr<nano::block>> to_generate_final;
@@ -12,6 +12,7 @@
 #include <condition_variable>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace mi = boost::multi_index;
 
@@ -22,6 +23,7 @@ class ledger;
 class local_vote_history;
 class node_config;
 class stat;
+class transaction;
 class vote_generator;
 class wallets;
 /**
@@ -31,6 +33,7 @@ class wallets;
  * * A request arrives for hashes {1,4,5}. Another request arrives soon afterwards for hashes {2,3,6}
  * * The aggregator will reply with the two cached votes
  * Votes are generated for uncached hashes.
+ * Expired pools are processed by a configurable number of worker threads, each taking a batch of pools at a time and serving it from its own read transaction.
  */
 class request_aggregator final
 {
@@ -53,6 +56,15 @@ class request_aggregator final
 		std::chrono::steady_clock::time_point deadline;
 	};
 
+	/** Expired pool taken out of the container by a worker */
+	class pool_item final
+	{
+	public:
+		std::shared_ptr<nano::transport::channel> channel;
+		std::vector<std::pair<nano::block_hash, nano::root>> hashes_roots;
+		std::chrono::steady_clock::time_point start;
+	};
+
 	// clang-format off
 	class tag_endpoint {};
 	class tag_deadline {};
@@ -71,13 +83,16 @@ public:
 	const std::chrono::milliseconds max_delay;
 	const std::chrono::milliseconds small_delay;
 	const size_t max_channel_requests;
+	/** Maximum number of expired pools a worker takes at once */
+	static size_t constexpr max_batch = 16;
 
 private:
 	void run ();
+	void process (nano::transaction const &, pool_item &);
 	/** Remove duplicate requests **/
 	void erase_duplicates (std::vector<std::pair<nano::block_hash, nano::root>> &) const;
 	/** Aggregate \p requests_a and send cached votes to \p channel_a . Return the remaining hashes that need vote generation for each block for regular & final vote generators **/
-	std::pair<std::vector<std::shared_ptr<nano::block>>, std::vector<std::shared_ptr<nano::block>>> aggregate (std::vector<std::pair<nano::block_hash, nano::root>> const & requests_a, std::shared_ptr<nano::transport::channel> & channel_a) const;
+	std::pair<std::vector<std::shared_ptr<nano::block>>, std::vector<std::shared_ptr<nano::block>>> aggregate (nano::transaction const &, std::vector<std::pair<nano::block_hash, nano::root>> const & requests_a, std::shared_ptr<nano::transport::channel> & channel_a) const;
 	void reply_action (std::shared_ptr<nano::vote> const & vote_a, std::shared_ptr<nano::transport::channel> const & channel_a) const;
 
 	nano::stat & stats;
@@ -99,10 +114,10 @@ private:
 	// clang-format on
 
 	bool stopped{ false };
-	bool started{ false };
+	unsigned started{ 0 };
 	nano::condition_variable condition;
 	nano::mutex mutex{ mutex_identifier (mutexes::request_aggregator) };
-	std::thread thread;
+	std::vector<std::thread> threads;
 
 	friend std::unique_ptr<container_info_component> collect_container_info (request_aggregator &, const std::string &);
 };
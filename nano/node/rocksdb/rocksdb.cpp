@@ -103,6 +103,11 @@ nano::rocksdb_store::rocksdb_store (nano::logger_mt & logger_a, boost::filesyste
 	if (!error)
 	{
 		generate_tombstone_map ();
+		if (rocksdb_config.profile != nano::rocksdb_config::tuning_profile::standard)
+		{
+			// One cache sized like the per table caches of the standard profile, so hot tables can use what idle ones leave
+			shared_block_cache = rocksdb::NewLRUCache (1024ULL * 1024 * rocksdb_config.memory_multiplier * base_block_cache_size * shared_block_cache_multiplier, -1, false, 0.2);
+		}
 		small_table_factory.reset (rocksdb::NewBlockBasedTableFactory (get_small_table_options ()));
 		if (!open_read_only_a)
 		{
@@ -308,9 +313,71 @@ rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options (std::string co
 		debug_assert (false);
 	}
 
+	if (cf_options.table_factory != nullptr && cf_options.table_factory != small_table_factory)
+	{
+		apply_profile (cf_name_a, cf_options);
+	}
 	return cf_options;
 }
 
+void nano::rocksdb_store::apply_profile (std::string const & cf_name_a, rocksdb::ColumnFamilyOptions & cf_options_a) const
+{
+	using profile = nano::rocksdb_config::tuning_profile;
+	if (rocksdb_config.profile == profile::standard)
+	{
+		return;
+	}
+	auto table_options (get_active_table_options (0));
+	switch (rocksdb_config.profile)
+	{
+		case profile::bootstrap:
+			// Two more memtables and a higher level 0 trigger absorb insert bursts without stalling writes
+			cf_options_a.max_write_buffer_number = 4;
+			cf_options_a.level0_file_num_compaction_trigger = std::max (cf_options_a.level0_file_num_compaction_trigger, 8);
+			cf_options_a.level0_slowdown_writes_trigger = 32;
+			cf_options_a.level0_stop_writes_trigger = 48;
+			break;
+		case profile::rep:
+			// Blocks and receivables are checked for existence on every incoming block, more bits lower the false positive rate to ~0.3%
+			if (cf_name_a == "blocks" || cf_name_a == "pending")
+			{
+				table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (14, false));
+			}
+			// Lookups on these tables are for known accounts, the last level filter is skipped as it is the largest and rarely rules anything out
+			if (cf_name_a == "accounts" || cf_name_a == "confirmation_height" || cf_name_a == "frontiers")
+			{
+				cf_options_a.optimize_filters_for_hits = true;
+			}
+			break;
+		case profile::archive_rpc:
+			// Index and filter blocks are partitioned and charged to the block cache, only the top level stays pinned.
+			// This bounds their memory on ledgers much larger than RAM.
+			table_options.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+			table_options.partition_filters = true;
+			table_options.metadata_block_size = 4096;
+			table_options.cache_index_and_filter_blocks = true;
+			table_options.cache_index_and_filter_blocks_with_high_priority = true;
+			table_options.pin_top_level_index_and_filter = true;
+			table_options.block_size = 32 * 1024ULL;
+			// RPC mostly reads blocks and accounts which exist
+			if (cf_name_a == "blocks" || cf_name_a == "accounts" || cf_name_a == "confirmation_height")
+			{
+				cf_options_a.optimize_filters_for_hits = true;
+			}
+			break;
+		default:
+			debug_assert (false);
+			break;
+	}
+	if (cf_name_a == "pending")
+	{
+		// Receivables are read per account, a prefix bloom lets account scans skip files and memtables without the account
+		cf_options_a.prefix_extractor.reset (rocksdb::NewFixedPrefixTransform (sizeof (nano::account)));
+		cf_options_a.memtable_prefix_bloom_size_ratio = 0.1;
+	}
+	cf_options_a.table_factory.reset (rocksdb::NewBlockBasedTableFactory (table_options));
+}
+
 std::vector<rocksdb::ColumnFamilyDescriptor> nano::rocksdb_store::create_column_families ()
 {
 	std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
@@ -419,7 +486,12 @@ int nano::rocksdb_store::del (nano::write_transaction const & transaction_a, tab
 	// RocksDB does not report not_found status, it is a pre-condition that the key exists
 	debug_assert (exists (transaction_a, table_a, key_a));
 	flush_tombstones_check (table_a);
-	return tx (transaction_a)->Delete (table_to_column_family (table_a), key_a).code ();
+	auto txn = tx (transaction_a);
+	if (untracked_writes.load (std::memory_order_relaxed))
+	{
+		return txn->DeleteUntracked (table_to_column_family (table_a), key_a).code ();
+	}
+	return txn->Delete (table_to_column_family (table_a), key_a).code ();
 }
 
 void nano::rocksdb_store::flush_tombstones_check (tables table_a)
@@ -485,9 +557,18 @@ int nano::rocksdb_store::put (nano::write_transaction const & transaction_a, tab
 {
 	debug_assert (transaction_a.contains (table_a));
 	auto txn = tx (transaction_a);
+	if (untracked_writes.load (std::memory_order_relaxed))
+	{
+		return txn->PutUntracked (table_to_column_family (table_a), key_a, value_a).code ();
+	}
 	return txn->Put (table_to_column_family (table_a), key_a, value_a).code ();
 }
 
+void nano::rocksdb_store::set_untracked_writes (bool untracked_writes_a)
+{
+	untracked_writes = untracked_writes_a;
+}
+
 bool nano::rocksdb_store::not_found (int status) const
 {
 	return (status_code_not_found () == status);
@@ -724,7 +805,7 @@ rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_active_table_options (s
 	table_options.index_block_restart_interval = 16;
 
 	// Block cache for reads
-	table_options.block_cache = rocksdb::NewLRUCache (lru_size);
+	table_options.block_cache = shared_block_cache != nullptr ? shared_block_cache : rocksdb::NewLRUCache (lru_size);
 
 	// Bloom filter to help with point reads. 10bits gives 1% false positive rate.
 	table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (10, false));
@@ -94,6 +94,12 @@ public:
 
 	unsigned max_block_write_batch_num () const override;
 
+	/**
+	 * Writes skip optimistic transaction conflict tracking while enabled, they are buffered in the transaction and applied as one write batch on commit.
+	 * Only safe when every writer is serialized, either by holding the table locks or by the write database queue.
+	 */
+	void set_untracked_writes (bool);
+
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a, bool const direction_asc) const
 	{
@@ -118,9 +124,12 @@ private:
 	std::unique_ptr<rocksdb::DB> db;
 	std::vector<std::unique_ptr<rocksdb::ColumnFamilyHandle>> handles;
 	std::shared_ptr<rocksdb::TableFactory> small_table_factory;
+	/** Block cache shared by every active table, only used with a tuning profile other than standard */
+	std::shared_ptr<rocksdb::Cache> shared_block_cache;
 	std::unordered_map<nano::tables, nano::mutex> write_lock_mutexes;
 	nano::rocksdb_config rocksdb_config;
 	unsigned const max_block_write_batch_num_m;
+	std::atomic<bool> untracked_writes{ false };
 
 	class tombstone_info
 	{
@@ -154,6 +163,7 @@ private:
 	rocksdb::BlockBasedTableOptions get_active_table_options (size_t lru_size) const;
 	rocksdb::BlockBasedTableOptions get_small_table_options () const;
 	rocksdb::ColumnFamilyOptions get_cf_options (std::string const & cf_name_a) const;
+	void apply_profile (std::string const & cf_name_a, rocksdb::ColumnFamilyOptions & cf_options_a) const;
 
 	void on_flush (rocksdb::FlushJobInfo const &);
 	void flush_table (nano::tables table_a);
@@ -167,6 +177,7 @@ private:
 
 	constexpr static int base_memtable_size = 16;
 	constexpr static int base_block_cache_size = 8;
+	constexpr static int shared_block_cache_multiplier = 16;
 
 	friend class rocksdb_block_store_tombstone_count_Test;
 };
@@ -14,7 +14,8 @@ nano::socket::socket (nano::node & node_a, boost::optional<std::chrono::seconds>
 	node{ node_a },
 	next_deadline{ std::numeric_limits<uint64_t>::max () },
 	last_completion_time{ 0 },
-	io_timeout{ io_timeout_a }
+	io_timeout{ io_timeout_a },
+	flush_timer{ node_a.io_ctx }
 {
 	if (!io_timeout)
 	{
@@ -74,28 +75,9 @@ void nano::socket::async_write (nano::shared_const_buffer const & buffer_a, std:
 	{
 		++queue_size;
 		boost::asio::post (strand, boost::asio::bind_executor (strand, [buffer_a, callback_a, this_l = shared_from_this ()] () {
-			if (!this_l->closed)
-			{
-				this_l->start_timer ();
-				nano::async_write (this_l->tcp_socket, buffer_a,
-				boost::asio::bind_executor (this_l->strand,
-				[buffer_a, callback_a, this_l] (boost::system::error_code ec, std::size_t size_a) {
-					--this_l->queue_size;
-					this_l->node.stats.add (nano::stat::type::traffic_tcp, nano::stat::dir::out, size_a);
-					this_l->stop_timer ();
-					if (callback_a)
-					{
-						callback_a (ec, size_a);
-					}
-				}));
-			}
-			else
-			{
-				if (callback_a)
-				{
-					callback_a (boost::system::errc::make_error_code (boost::system::errc::not_supported), 0);
-				}
-			}
+			this_l->send_queue_bytes += buffer_a.size ();
+			this_l->send_queue.push_back ({ buffer_a, callback_a });
+			this_l->schedule_flush ();
 		}));
 	}
 	else if (callback_a)
@@ -106,6 +88,97 @@ void nano::socket::async_write (nano::shared_const_buffer const & buffer_a, std:
 	}
 }
 
+// This must be called from a strand
+void nano::socket::schedule_flush ()
+{
+	debug_assert (strand.running_in_this_thread ());
+	// An in-flight write flushes the queue on completion, writes queued meanwhile are gathered into the next one
+	if (!write_in_progress)
+	{
+		auto delay_l (node.config.tcp_write_coalesce_delay);
+		if (closed || delay_l.count () == 0 || send_queue_bytes >= node.config.tcp_write_coalesce_bytes)
+		{
+			flush_send_queue ();
+		}
+		else if (!flush_timer_armed)
+		{
+			flush_timer_armed = true;
+			flush_timer.expires_after (delay_l);
+			flush_timer.async_wait (boost::asio::bind_executor (strand, [this_l = shared_from_this ()] (boost::system::error_code const &) {
+				this_l->flush_timer_armed = false;
+				this_l->flush_send_queue ();
+			}));
+		}
+	}
+}
+
+// This must be called from a strand
+void nano::socket::flush_send_queue ()
+{
+	debug_assert (strand.running_in_this_thread ());
+	if (closed)
+	{
+		fail_send_queue ();
+	}
+	else if (!write_in_progress && !send_queue.empty ())
+	{
+		auto const bytes_max (node.config.tcp_write_coalesce_bytes);
+		auto batch (std::make_shared<std::vector<queue_item>> ());
+		std::vector<boost::asio::const_buffer> buffers;
+		size_t bytes (0);
+		while (!send_queue.empty () && batch->size () < write_buffers_max && (batch->empty () || bytes + send_queue.front ().buffer.size () <= bytes_max))
+		{
+			auto & item (send_queue.front ());
+			bytes += item.buffer.size ();
+			buffers.insert (buffers.end (), item.buffer.begin (), item.buffer.end ());
+			batch->push_back (std::move (item));
+			send_queue.pop_front ();
+		}
+		send_queue_bytes -= bytes;
+		write_in_progress = true;
+		node.stats.inc (nano::stat::type::tcp, nano::stat::detail::tcp_write, nano::stat::dir::out);
+		if (batch->size () > 1)
+		{
+			node.stats.add (nano::stat::type::tcp, nano::stat::detail::tcp_write_coalesced, nano::stat::dir::out, batch->size () - 1);
+		}
+		start_timer ();
+		// The batch owns the underlying buffers until the write completes
+		nano::unsafe_async_write (tcp_socket, buffers,
+		boost::asio::bind_executor (strand,
+		[batch, this_l = shared_from_this ()] (boost::system::error_code ec, std::size_t size_a) {
+			this_l->write_in_progress = false;
+			this_l->queue_size -= batch->size ();
+			this_l->node.stats.add (nano::stat::type::traffic_tcp, nano::stat::dir::out, size_a);
+			this_l->stop_timer ();
+			for (auto const & item : *batch)
+			{
+				if (item.callback)
+				{
+					item.callback (ec, ec ? 0 : item.buffer.size ());
+				}
+			}
+			this_l->flush_send_queue ();
+		}));
+	}
+}
+
+// This must be called from a strand
+void nano::socket::fail_send_queue ()
+{
+	debug_assert (strand.running_in_this_thread ());
+	while (!send_queue.empty ())
+	{
+		auto item (std::move (send_queue.front ()));
+		send_queue.pop_front ();
+		--queue_size;
+		if (item.callback)
+		{
+			item.callback (boost::system::errc::make_error_code (boost::system::errc::not_supported), 0);
+		}
+	}
+	send_queue_bytes = 0;
+}
+
 void nano::socket::start_timer ()
 {
 	start_timer (io_timeout.get ());
@@ -178,6 +251,11 @@ void nano::socket::close_internal ()
 	if (!closed.exchange (true))
 	{
 		io_timeout = boost::none;
+		if (flush_timer_armed)
+		{
+			// The pending flush fails any queued writes
+			flush_timer.cancel ();
+		}
 		boost::system::error_code ec;
 
 		// Ignore error code for shutdown as it is best-effort
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nano/boost/asio/ip/tcp.hpp>
+#include <nano/boost/asio/steady_timer.hpp>
 #include <nano/boost/asio/strand.hpp>
 #include <nano/lib/asio.hpp>
 
@@ -99,6 +100,20 @@ protected:
 	boost::optional<std::chrono::seconds> io_timeout;
 	std::atomic<size_t> queue_size{ 0 };
 
+	/**
+	 * Writes waiting for the in-flight write to complete. Only accessed from the strand.
+	 * Queued buffers are gathered into a single write, bounded by write_buffers_max and the tcp_write_coalesce_bytes config option.
+	 */
+	std::deque<queue_item> send_queue;
+	size_t send_queue_bytes{ 0 };
+	bool write_in_progress{ false };
+	/** Delays a flush by tcp_write_coalesce_delay so that more writes can be gathered */
+	boost::asio::steady_timer flush_timer;
+	bool flush_timer_armed{ false };
+	void schedule_flush ();
+	void flush_send_queue ();
+	void fail_send_queue ();
+
 	/** Set by close() - completion handlers must check this. This is more reliable than checking
 	 error codes as the OS may have already completed the async operation. */
 	std::atomic<bool> closed{ false };
@@ -112,6 +127,8 @@ private:
 
 public:
 	static size_t constexpr queue_size_max = 128;
+	/** Maximum number of buffers gathered into a single write */
+	static size_t constexpr write_buffers_max = 64;
 };
 
 /** Socket class for TCP servers */
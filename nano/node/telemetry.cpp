@@ -56,8 +56,13 @@ void nano::telemetry::set (nano::telemetry_ack const & message_a, nano::transpor
 			return;
 		}
 
+		if (it->aggregated)
+		{
+			aggregate.remove (it->data);
+		}
 		recent_or_initial_request_telemetry_data.modify (it, [&message_a] (nano::telemetry_info & telemetry_info_a) {
 			telemetry_info_a.data = message_a.data;
+			telemetry_info_a.aggregated = false;
 		});
 
 		// This can also remove the peer
@@ -146,86 +151,52 @@ void nano::telemetry::ongoing_req_all_peers (std::chrono::milliseconds next_requ
 			// Check if there are any peers which are in the peers list which haven't been request, or any which are below or equal to the cache cutoff time
 			if (!this_l->stopped)
 			{
-				class tag_channel
-				{
-				};
-
-				struct channel_wrapper
+				auto peers = this_l->network.list (std::numeric_limits<size_t>::max ());
 				{
-					std::shared_ptr<nano::transport::channel> channel;
-					channel_wrapper (std::shared_ptr<nano::transport::channel> const & channel_a) :
-						channel (channel_a)
-					{
-					}
-					nano::endpoint endpoint () const
-					{
-						return channel->get_endpoint ();
-					}
-				};
-
-				// clang-format off
-				namespace mi = boost::multi_index;
-				boost::multi_index_container<channel_wrapper,
-				mi::indexed_by<
-					mi::hashed_unique<mi::tag<tag_endpoint>,
-						mi::const_mem_fun<channel_wrapper, nano::endpoint, &channel_wrapper::endpoint>>,
-					mi::hashed_unique<mi::tag<tag_channel>,
-						mi::member<channel_wrapper, std::shared_ptr<nano::transport::channel>, &channel_wrapper::channel>>>> peers;
-				// clang-format on
+					// Remove from peers list if it exists and is within the cache cutoff
+					nano::lock_guard<nano::mutex> guard (this_l->mutex);
+					peers.erase (std::remove_if (peers.begin (), peers.end (), [&this_l] (auto const & channel_a) {
+						auto it = this_l->recent_or_initial_request_telemetry_data.find (channel_a->get_endpoint ());
+						return it != this_l->recent_or_initial_request_telemetry_data.cend () && this_l->within_cache_cutoff (*it);
+					}),
+					peers.end ());
+				}
 
+				// Request data from new peers, or ones which are out of date
+				for (auto const & peer : peers)
 				{
-					// Copy peers to the multi index container so can get better asymptotic complexity in future operations
-					auto temp_peers = this_l->network.list (std::numeric_limits<size_t>::max ());
-					peers.insert (temp_peers.begin (), temp_peers.end ());
+					this_l->get_metrics_single_peer_async (peer, [] (auto const &) {
+						// Intentionally empty, just using to refresh the cache
+					});
 				}
 
+				nano::lock_guard<nano::mutex> guard (this_l->mutex);
+				// Cleanup any stale saved telemetry data for non-existent peers, out of date peers which still exist are now undergoing a request
+				for (auto it = this_l->recent_or_initial_request_telemetry_data.begin (); it != this_l->recent_or_initial_request_telemetry_data.end ();)
 				{
-					// Cleanup any stale saved telemetry data for non-existent peers
-					nano::lock_guard<nano::mutex> guard (this_l->mutex);
-					for (auto it = this_l->recent_or_initial_request_telemetry_data.begin (); it != this_l->recent_or_initial_request_telemetry_data.end ();)
+					if (!it->undergoing_request && !this_l->within_cache_cutoff (*it))
 					{
-						if (!it->undergoing_request && !this_l->within_cache_cutoff (*it) && peers.count (it->endpoint) == 0)
+						if (it->aggregated)
 						{
-							it = this_l->recent_or_initial_request_telemetry_data.erase (it);
-						}
-						else
-						{
-							++it;
+							this_l->aggregate.remove (it->data);
 						}
+						it = this_l->recent_or_initial_request_telemetry_data.erase (it);
 					}
-
-					// Remove from peers list if it exists and is within the cache cutoff
-					for (auto peers_it = peers.begin (); peers_it != peers.end ();)
+					else
 					{
-						auto it = this_l->recent_or_initial_request_telemetry_data.find (peers_it->endpoint ());
-						if (it != this_l->recent_or_initial_request_telemetry_data.cend () && this_l->within_cache_cutoff (*it))
-						{
-							peers_it = peers.erase (peers_it);
-						}
-						else
-						{
-							++peers_it;
-						}
+						++it;
 					}
 				}
-
-				// Request data from new peers, or ones which are out of date
-				for (auto const & peer : boost::make_iterator_range (peers))
-				{
-					this_l->get_metrics_single_peer_async (peer.channel, [] (auto const &) {
-						// Intentionally empty, just using to refresh the cache
-					});
-				}
+				this_l->expire_aggregated ();
 
 				// Schedule the next request; Use the default request time unless a telemetry request cache expires sooner
-				nano::lock_guard<nano::mutex> guard (this_l->mutex);
 				long long next_round = std::chrono::duration_cast<std::chrono::milliseconds> (this_l->cache_cutoff + this_l->response_time_cutoff).count ();
 				if (!this_l->recent_or_initial_request_telemetry_data.empty ())
 				{
 					auto range = boost::make_iterator_range (this_l->recent_or_initial_request_telemetry_data.get<tag_last_updated> ());
-					for (auto telemetry_info : range)
+					for (auto const & telemetry_info : range)
 					{
-						if (!telemetry_info.undergoing_request && peers.count (telemetry_info.endpoint) == 0)
+						if (!telemetry_info.undergoing_request)
 						{
 							auto const last_response = telemetry_info.last_response;
 							auto now = std::chrono::steady_clock::now ();
@@ -245,6 +216,13 @@ void nano::telemetry::ongoing_req_all_peers (std::chrono::milliseconds next_requ
 	});
 }
 
+nano::telemetry_data nano::telemetry::get_consolidated_metrics ()
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	expire_aggregated ();
+	return aggregate.consolidated ();
+}
+
 std::unordered_map<nano::endpoint, nano::telemetry_data> nano::telemetry::get_metrics ()
 {
 	std::unordered_map<nano::endpoint, nano::telemetry_data> telemetry_data;
@@ -393,14 +371,19 @@ void nano::telemetry::channel_processed (nano::endpoint const & endpoint_a, bool
 	{
 		if (!error_a)
 		{
+			if (!it->aggregated)
+			{
+				aggregate.add (it->data);
+			}
 			recent_or_initial_request_telemetry_data.modify (it, [] (nano::telemetry_info & telemetry_info_a) {
 				telemetry_info_a.last_response = std::chrono::steady_clock::now ();
 				telemetry_info_a.undergoing_request = false;
+				telemetry_info_a.aggregated = true;
 			});
 		}
 		else
 		{
-			recent_or_initial_request_telemetry_data.erase (endpoint_a);
+			erase (endpoint_a);
 		}
 		flush_callbacks_async (endpoint_a, error_a);
 	}
@@ -447,6 +430,38 @@ void nano::telemetry::invoke_callbacks (nano::endpoint const & endpoint_a, bool
 	}
 }
 
+// Must be called with the mutex held
+void nano::telemetry::expire_aggregated ()
+{
+	// Data is aggregated for as long as get_metrics returns it, older data is at the front of the last updated index
+	auto cutoff = std::chrono::steady_clock::now () - cache_plus_buffer_cutoff_time ();
+	auto & by_last_updated (recent_or_initial_request_telemetry_data.get<tag_last_updated> ());
+	for (auto it = by_last_updated.begin (); it != by_last_updated.end () && it->last_response < cutoff; ++it)
+	{
+		if (it->aggregated)
+		{
+			aggregate.remove (it->data);
+			by_last_updated.modify (it, [] (nano::telemetry_info & telemetry_info_a) {
+				telemetry_info_a.aggregated = false;
+			});
+		}
+	}
+}
+
+// Must be called with the mutex held
+void nano::telemetry::erase (nano::endpoint const & endpoint_a)
+{
+	auto it = recent_or_initial_request_telemetry_data.find (endpoint_a);
+	if (it != recent_or_initial_request_telemetry_data.end ())
+	{
+		if (it->aggregated)
+		{
+			aggregate.remove (it->data);
+		}
+		recent_or_initial_request_telemetry_data.erase (it);
+	}
+}
+
 size_t nano::telemetry::telemetry_data_size ()
 {
 	nano::lock_guard<nano::mutex> guard (mutex);
@@ -466,6 +481,164 @@ bool nano::telemetry_info::awaiting_first_response () const
 	return data == nano::telemetry_data ();
 }
 
+template <typename T>
+void nano::telemetry_aggregate::samples<T>::add (T value_a)
+{
+	values.insert (value_a);
+	sum += value_a;
+}
+
+template <typename T>
+void nano::telemetry_aggregate::samples<T>::remove (T value_a)
+{
+	auto existing = values.find (value_a);
+	debug_assert (existing != values.end ());
+	if (existing != values.end ())
+	{
+		values.erase (existing);
+		sum -= value_a;
+	}
+}
+
+template <typename T>
+nano::uint128_t nano::telemetry_aggregate::samples<T>::trimmed_sum (size_t trim_a) const
+{
+	nano::uint128_t result (0);
+	if (values.size () > trim_a * 2)
+	{
+		result = sum;
+		auto lowest = values.begin ();
+		auto highest = values.rbegin ();
+		for (size_t i = 0; i < trim_a; ++i, ++lowest, ++highest)
+		{
+			result -= *lowest;
+			result -= *highest;
+		}
+	}
+	return result;
+}
+
+void nano::telemetry_aggregate::add (nano::telemetry_data const & data_a)
+{
+	update (data_a, true);
+}
+
+void nano::telemetry_aggregate::remove (nano::telemetry_data const & data_a)
+{
+	update (data_a, false);
+}
+
+size_t nano::telemetry_aggregate::size () const
+{
+	return count;
+}
+
+nano::telemetry_data nano::telemetry_aggregate::consolidated ()
+{
+	if (stale)
+	{
+		cached = consolidate ();
+		stale = false;
+	}
+	return cached;
+}
+
+void nano::telemetry_aggregate::update (nano::telemetry_data const & data_a, bool add_a)
+{
+	auto update_samples = [add_a] (auto & samples_a, auto value_a) {
+		if (add_a)
+		{
+			samples_a.add (value_a);
+		}
+		else
+		{
+			samples_a.remove (value_a);
+		}
+	};
+	auto update_occurrences = [add_a] (auto & occurrences_a, auto const & value_a) {
+		if (add_a)
+		{
+			++occurrences_a[value_a];
+		}
+		else
+		{
+			auto existing = occurrences_a.find (value_a);
+			debug_assert (existing != occurrences_a.end ());
+			if (existing != occurrences_a.end () && --existing->second == 0)
+			{
+				occurrences_a.erase (existing);
+			}
+		}
+	};
+
+	update_samples (account_counts, data_a.account_count);
+	update_samples (block_counts, data_a.block_count);
+	update_samples (cemented_counts, data_a.cemented_count);
+	update_samples (peer_counts, data_a.peer_count);
+	update_samples (unchecked_counts, data_a.unchecked_count);
+	update_samples (uptimes, data_a.uptime);
+	update_samples (timestamps, static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::milliseconds> (data_a.timestamp.time_since_epoch ()).count ()));
+	update_samples (active_difficulties, data_a.active_difficulty);
+	// 0 has a special meaning (unlimited), don't include it in the average as it will be heavily skewed
+	if (data_a.bandwidth_cap != 0)
+	{
+		update_samples (bandwidths, data_a.bandwidth_cap);
+	}
+	update_occurrences (protocol_versions, data_a.protocol_version);
+	update_occurrences (vendor_versions, uint64_t{ data_a.major_version } << 32 | uint64_t{ data_a.minor_version } << 24 | uint64_t{ data_a.patch_version } << 16 | uint64_t{ data_a.pre_release_version } << 8 | data_a.maker);
+	update_occurrences (bandwidth_caps, data_a.bandwidth_cap);
+	update_occurrences (genesis_blocks, data_a.genesis_block);
+	debug_assert (add_a || count > 0);
+	count = add_a ? count + 1 : count - 1;
+	stale = true;
+}
+
+nano::telemetry_data nano::telemetry_aggregate::consolidate () const
+{
+	nano::telemetry_data consolidated_data;
+	if (count > 0)
+	{
+		// Remove 10% of the results from the lower and upper bounds to catch any outliers. Need at least 10 responses before any are removed.
+		auto num_either_side_to_remove = count / 10;
+		auto size = count - num_either_side_to_remove * 2;
+		consolidated_data.account_count = boost::numeric_cast<decltype (consolidated_data.account_count)> (account_counts.trimmed_sum (num_either_side_to_remove) / size);
+		consolidated_data.block_count = boost::numeric_cast<decltype (consolidated_data.block_count)> (block_counts.trimmed_sum (num_either_side_to_remove) / size);
+		consolidated_data.cemented_count = boost::numeric_cast<decltype (consolidated_data.cemented_count)> (cemented_counts.trimmed_sum (num_either_side_to_remove) / size);
+		consolidated_data.peer_count = boost::numeric_cast<decltype (consolidated_data.peer_count)> (peer_counts.trimmed_sum (num_either_side_to_remove) / size);
+		consolidated_data.uptime = boost::numeric_cast<decltype (consolidated_data.uptime)> (uptimes.trimmed_sum (num_either_side_to_remove) / size);
+		consolidated_data.unchecked_count = boost::numeric_cast<decltype (consolidated_data.unchecked_count)> (unchecked_counts.trimmed_sum (num_either_side_to_remove) / size);
+		consolidated_data.active_difficulty = boost::numeric_cast<decltype (consolidated_data.active_difficulty)> (active_difficulties.trimmed_sum (num_either_side_to_remove) / size);
+		consolidated_data.timestamp = std::chrono::system_clock::time_point (std::chrono::milliseconds (boost::numeric_cast<uint64_t> (timestamps.trimmed_sum (num_either_side_to_remove) / size)));
+
+		// The first value with the most occurrences, which is any of them if all are unique
+		auto mode = [] (auto const & occurrences_a) {
+			return std::max_element (occurrences_a.begin (), occurrences_a.end (), [] (auto const & lhs, auto const & rhs) {
+				return lhs.second < rhs.second;
+			});
+		};
+
+		// Use the mode of protocol version and vendor version. Also use it for bandwidth cap if there is 2 or more of the same cap.
+		auto bandwidth_cap = mode (bandwidth_caps);
+		if (bandwidth_cap->second > 1)
+		{
+			consolidated_data.bandwidth_cap = bandwidth_cap->first;
+		}
+		else
+		{
+			consolidated_data.bandwidth_cap = (bandwidths.trimmed_sum (num_either_side_to_remove) / size).convert_to<uint64_t> ();
+		}
+		consolidated_data.protocol_version = mode (protocol_versions)->first;
+		consolidated_data.genesis_block = mode (genesis_blocks)->first;
+		auto vendor_version = mode (vendor_versions)->first;
+		consolidated_data.major_version = static_cast<uint8_t> (vendor_version >> 32);
+		consolidated_data.minor_version = static_cast<uint8_t> (vendor_version >> 24);
+		consolidated_data.patch_version = static_cast<uint8_t> (vendor_version >> 16);
+		consolidated_data.pre_release_version = static_cast<uint8_t> (vendor_version >> 8);
+		consolidated_data.maker = static_cast<uint8_t> (vendor_version);
+	}
+	return consolidated_data;
+}
+
 std::unique_ptr<nano::container_info_component> nano::collect_container_info (telemetry & telemetry, std::string const & name)
 {
 	auto composite = std::make_unique<container_info_composite> (name);
@@ -480,6 +653,12 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (te
 
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "recent_or_initial_request_telemetry_data", telemetry.telemetry_data_size (), sizeof (decltype (telemetry.recent_or_initial_request_telemetry_data)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "callbacks", callbacks_count, sizeof (decltype (telemetry.callbacks)::value_type::second_type) }));
+	size_t aggregated_count;
+	{
+		nano::lock_guard<nano::mutex> guard (telemetry.mutex);
+		aggregated_count = telemetry.aggregate.size ();
+	}
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "aggregate", aggregated_count, sizeof (nano::telemetry_data) }));
 
 	return composite;
 }
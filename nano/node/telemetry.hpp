@@ -11,6 +11,8 @@
 
 #include <functional>
 #include <memory>
+#include <set>
+#include <unordered_map>
 
 namespace mi = boost::multi_index;
 
@@ -48,6 +50,58 @@ public:
 	std::chrono::steady_clock::time_point last_response;
 	bool undergoing_request{ false };
 	uint64_t round{ 0 };
+	// Whether data is counted in the telemetry aggregate
+	bool aggregated{ false };
+};
+
+/*
+ * Consolidates the telemetry data of a set of peers the same way as consolidate_telemetry_data, but is updated as data is added and removed instead of being recomputed from every peer.
+ * Modes are kept as occurrence counts and trimmed averages as ordered samples with running sums, so consolidating only walks the trimmed ends of each metric.
+ * The consolidated data is cached until the set changes. Identification metrics and unknown data are not aggregated.
+ */
+class telemetry_aggregate final
+{
+public:
+	void add (nano::telemetry_data const &);
+	void remove (nano::telemetry_data const &);
+	nano::telemetry_data consolidated ();
+	size_t size () const;
+
+private:
+	template <typename T>
+	class samples final
+	{
+	public:
+		void add (T);
+		void remove (T);
+		// Sum of the samples excluding the trim_a lowest and the trim_a highest
+		nano::uint128_t trimmed_sum (size_t trim_a) const;
+		std::multiset<T> values;
+		nano::uint128_t sum{ 0 };
+	};
+	template <typename T>
+	using occurrences = std::unordered_map<T, size_t>;
+
+	void update (nano::telemetry_data const &, bool);
+	nano::telemetry_data consolidate () const;
+
+	samples<uint64_t> account_counts;
+	samples<uint64_t> block_counts;
+	samples<uint64_t> cemented_counts;
+	samples<uint32_t> peer_counts;
+	samples<uint64_t> unchecked_counts;
+	samples<uint64_t> uptimes;
+	samples<uint64_t> bandwidths;
+	samples<uint64_t> timestamps;
+	samples<uint64_t> active_difficulties;
+	occurrences<uint8_t> protocol_versions;
+	// Major, minor, patch and pre-release versions and maker packed in the low 40 bits
+	occurrences<uint64_t> vendor_versions;
+	occurrences<uint64_t> bandwidth_caps;
+	occurrences<nano::block_hash> genesis_blocks;
+	size_t count{ 0 };
+	nano::telemetry_data cached;
+	bool stale{ false };
 };
 
 /*
@@ -74,6 +128,11 @@ public:
 	 */
 	std::unordered_map<nano::endpoint, nano::telemetry_data> get_metrics ();
 
+	/*
+	 * Returns the consolidated metrics of what get_metrics returns, maintained as responses arrive
+	 */
+	nano::telemetry_data get_consolidated_metrics ();
+
 	/*
 	 * This makes a telemetry request to the specific channel.
 	 * Error is set for: no response received, no payload received, invalid signature or unsound metrics in message (e.g different genesis block) 
@@ -132,12 +191,19 @@ private:
 
 	std::unordered_map<nano::endpoint, std::vector<std::function<void (telemetry_data_response const &)>>> callbacks;
 
+	// Aggregate of the data get_metrics returns
+	nano::telemetry_aggregate aggregate;
+
 	void ongoing_req_all_peers (std::chrono::milliseconds);
 
 	void fire_request_message (std::shared_ptr<nano::transport::channel> const &);
 	void channel_processed (nano::endpoint const &, bool);
 	void flush_callbacks_async (nano::endpoint const &, bool);
 	void invoke_callbacks (nano::endpoint const &, bool);
+	// Removes data older than the cache plus buffer cutoff from the aggregate
+	void expire_aggregated ();
+	// Erases the entry for the endpoint, removing its data from the aggregate
+	void erase (nano::endpoint const &);
 
 	bool within_cache_cutoff (nano::telemetry_info const &) const;
 	bool within_cache_plus_buffer_cutoff (telemetry_info const &) const;
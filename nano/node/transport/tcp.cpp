@@ -45,12 +45,14 @@ bool nano::transport::channel_tcp::operator== (nano::transport::channel const &
 	return result;
 }
 
-void nano::transport::channel_tcp::send_buffer (nano::shared_const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy policy_a)
+bool nano::transport::channel_tcp::send_buffer (nano::shared_const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy policy_a)
 {
+	auto dropped (true);
 	if (auto socket_l = socket.lock ())
 	{
 		if (!socket_l->max () || (policy_a == nano::buffer_drop_policy::no_socket_drop && !socket_l->full ()))
 		{
+			dropped = false;
 			socket_l->async_write (
 			buffer_a, [endpoint_a = socket_l->remote_endpoint (), node = std::weak_ptr<nano::node> (node.shared ()), callback_a] (boost::system::error_code const & ec, size_t size_a) {
 				if (auto node_l = node.lock ())
@@ -92,6 +94,7 @@ void nano::transport::channel_tcp::send_buffer (nano::shared_const_buffer const
 			callback_a (boost::system::errc::make_error_code (boost::system::errc::not_supported), 0);
 		});
 	}
+	return dropped;
 }
 
 std::string nano::transport::channel_tcp::to_string () const
@@ -95,6 +95,8 @@ boost::asio::ip::address nano::transport::ipv4_address_or_ipv6_subnet (boost::as
 }
 
 nano::transport::channel::channel (nano::node & node_a) :
+	limiter (node_a.config.bandwidth_limit_burst_ratio, node_a.network.peer_limit),
+	limiter_generation (node_a.network.limits_generation.load ()),
 	node (node_a)
 {
 	set_network_version (node_a.network_params.protocol.protocol_version);
@@ -107,14 +109,28 @@ void nano::transport::channel::send (nano::message const & message_a, std::funct
 	auto buffer (message_a.to_shared_const_buffer ());
 	auto detail (visitor.result);
 	auto is_droppable_by_limiter = drop_policy_a == nano::buffer_drop_policy::limiter;
-	auto should_drop (node.network.limiter.should_drop (buffer.size ()));
+	// A channel exceeding its share is limited before consuming the node wide budget
+	auto should_drop (false);
+	auto generation (node.network.limits_generation.load ());
+	auto peer_limit (node.network.peer_limit.load ());
+	if (peer_limit != 0)
+	{
+		if (limiter_generation.exchange (generation) != generation)
+		{
+			limiter.reset (node.config.bandwidth_limit_burst_ratio, peer_limit);
+		}
+		should_drop = limiter.should_drop (buffer.size ());
+	}
+	should_drop = should_drop || node.network.limiter.should_drop (buffer.size ());
 	if (!is_droppable_by_limiter || !should_drop)
 	{
-		send_buffer (buffer, callback_a, drop_policy_a);
+		auto dropped (send_buffer (buffer, callback_a, drop_policy_a));
+		bandwidth.add (message_a.header.type, buffer.size (), dropped);
 		node.stats.inc (nano::stat::type::message, detail, nano::stat::dir::out);
 	}
 	else
 	{
+		bandwidth.add (message_a.header.type, buffer.size (), true);
 		if (callback_a)
 		{
 			node.background ([callback_a] () {
@@ -149,9 +165,10 @@ bool nano::transport::channel_loopback::operator== (nano::transport::channel con
 	return endpoint == other_a.get_endpoint ();
 }
 
-void nano::transport::channel_loopback::send_buffer (nano::shared_const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy drop_policy_a)
+bool nano::transport::channel_loopback::send_buffer (nano::shared_const_buffer const & buffer_a, std::function<void (boost::system::error_code const &, size_t)> const & callback_a, nano::buffer_drop_policy drop_policy_a)
 {
 	release_assert (false && "sending to a loopback channel is not supported");
+	return true;
 }
 
 std::string nano::transport::channel_loopback::to_string () const
@@ -282,3 +299,34 @@ void nano::bandwidth_limiter::reset (const double limit_burst_ratio_a, const siz
 {
 	bucket.reset (static_cast<size_t> (limit_a * limit_burst_ratio_a), limit_a);
 }
+
+void nano::bandwidth_counters::add (nano::message_type type_a, size_t size_a, bool dropped_a)
+{
+	auto index (static_cast<size_t> (type_a));
+	debug_assert (index < message_type_count);
+	auto & counters_l (types[std::min (index, message_type_count - 1)]);
+	if (!dropped_a)
+	{
+		counters_l.bytes.fetch_add (size_a, std::memory_order_relaxed);
+		counters_l.messages.fetch_add (1, std::memory_order_relaxed);
+	}
+	else
+	{
+		counters_l.dropped_bytes.fetch_add (size_a, std::memory_order_relaxed);
+		counters_l.dropped_messages.fetch_add (1, std::memory_order_relaxed);
+	}
+}
+
+nano::bandwidth_counters::counters const & nano::bandwidth_counters::get (nano::message_type type_a) const
+{
+	auto index (static_cast<size_t> (type_a));
+	debug_assert (index < message_type_count);
+	return types[std::min (index, message_type_count - 1)];
+}
+
+uint64_t nano::bandwidth_counters::bytes () const
+{
+	return std::accumulate (types.begin (), types.end (), uint64_t{ 0 }, [] (uint64_t total_a, counters const & counters_a) {
+		return total_a + counters_a.bytes.load (std::memory_order_relaxed);
+	});
+}
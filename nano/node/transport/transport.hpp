@@ -8,6 +8,9 @@
 
 #include <boost/asio/ip/network_v6.hpp>
 
+#include <array>
+#include <atomic>
+
 namespace nano
 {
 class bandwidth_limiter final
@@ -22,6 +25,31 @@ private:
 	nano::rate::token_bucket bucket;
 };
 
+/**
+ * Outbound bytes and messages of a channel per message type, split into those handed to the socket and those dropped by the bandwidth limiters.
+ * Channels are written to from many threads, so counters are lock free and each message type is kept on its own cache line.
+ */
+class bandwidth_counters final
+{
+public:
+	class alignas (64) counters final
+	{
+	public:
+		std::atomic<uint64_t> bytes{ 0 };
+		std::atomic<uint64_t> messages{ 0 };
+		std::atomic<uint64_t> dropped_bytes{ 0 };
+		std::atomic<uint64_t> dropped_messages{ 0 };
+	};
+	void add (nano::message_type, size_t, bool dropped_a);
+	counters const & get (nano::message_type) const;
+	/** Bytes handed to the socket across all message types */
+	uint64_t bytes () const;
+	static size_t constexpr message_type_count = static_cast<size_t> (nano::message_type::telemetry_ack) + 1;
+
+private:
+	std::array<counters, message_type_count> types;
+};
+
 namespace transport
 {
 	class message;
@@ -48,7 +76,8 @@ namespace transport
 		virtual size_t hash_code () const = 0;
 		virtual bool operator== (nano::transport::channel const &) const = 0;
 		void send (nano::message const & message_a, std::function<void (boost::system::error_code const &, size_t)> const & callback_a = nullptr, nano::buffer_drop_policy policy_a = nano::buffer_drop_policy::limiter);
-		virtual void send_buffer (nano::shared_const_buffer const &, std::function<void (boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter) = 0;
+		/** Returns true if the buffer was dropped instead of being queued for writing */
+		virtual bool send_buffer (nano::shared_const_buffer const &, std::function<void (boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter) = 0;
 		virtual std::string to_string () const = 0;
 		virtual nano::endpoint get_endpoint () const = 0;
 		virtual nano::tcp_endpoint get_tcp_endpoint () const = 0;
@@ -125,6 +154,11 @@ namespace transport
 			network_version = network_version_a;
 		}
 
+		nano::bandwidth_counters const & get_bandwidth () const
+		{
+			return bandwidth;
+		}
+
 		mutable nano::mutex channel_mutex;
 
 	private:
@@ -133,6 +167,11 @@ namespace transport
 		std::chrono::steady_clock::time_point last_packet_sent{ std::chrono::steady_clock::now () };
 		boost::optional<nano::account> node_id{ boost::none };
 		std::atomic<uint8_t> network_version{ 0 };
+		nano::bandwidth_counters bandwidth;
+		/** Limits this channel to its share of the node bandwidth limit, only used while network::peer_limit is set */
+		nano::bandwidth_limiter limiter;
+		/** The network::limits_generation the limiter was last reset for */
+		std::atomic<uint64_t> limiter_generation;
 
 	protected:
 		nano::node & node;
@@ -144,7 +183,7 @@ namespace transport
 		channel_loopback (nano::node &);
 		size_t hash_code () const override;
 		bool operator== (nano::transport::channel const &) const override;
-		void send_buffer (nano::shared_const_buffer const &, std::function<void (boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter) override;
+		bool send_buffer (nano::shared_const_buffer const &, std::function<void (boost::system::error_code const &, size_t)> const & = nullptr, nano::buffer_drop_policy = nano::buffer_drop_policy::limiter) override;
 		std::string to_string () const override;
 		bool operator== (nano::transport::channel_loopback const & other_a) const
 		{
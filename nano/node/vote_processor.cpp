@@ -35,6 +35,8 @@ nano::vote_processor::vote_processor (nano::signature_checker & checker_a, nano:
 		process_loop ();
 	})
 {
+	stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::vote_verify, nano::stat::dir::in);
+	stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::vote_apply, nano::stat::dir::in);
 	nano::unique_lock<nano::mutex> lock (mutex);
 	condition.wait (lock, [&started = started] { return started; });
 }
@@ -155,7 +157,10 @@ void nano::vote_processor::verify_votes (decltype (votes) const & votes_a)
 		signatures.push_back (vote.first->signature.bytes.data ());
 	}
 	nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data () };
+	auto verify_start (std::chrono::steady_clock::now ());
 	checker.verify (check);
+	auto apply_start (std::chrono::steady_clock::now ());
+	stats.update_histogram (nano::stat::type::latency, nano::stat::detail::vote_verify, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (apply_start - verify_start).count ());
 	auto i (0);
 	for (auto const & vote : votes_a)
 	{
@@ -166,6 +171,7 @@ void nano::vote_processor::verify_votes (decltype (votes) const & votes_a)
 		}
 		++i;
 	}
+	stats.update_histogram (nano::stat::type::latency, nano::stat::detail::vote_apply, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - apply_start).count ());
 }
 
 nano::vote_code nano::vote_processor::vote_blocking (std::shared_ptr<nano::vote> const & vote_a, std::shared_ptr<nano::transport::channel> const & channel_a, bool validated)
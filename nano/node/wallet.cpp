@@ -894,6 +894,96 @@ std::shared_ptr<nano::block> nano::wallet::receive_action (nano::block_hash cons
 	return block;
 }
 
+std::vector<std::shared_ptr<nano::block>> nano::wallet::receive_batch_action (nano::account const & account_a, nano::account const & representative_a, std::vector<nano::block_hash> const & hashes_a)
+{
+	std::vector<std::pair<std::shared_ptr<nano::block>, nano::block_details>> blocks;
+	{
+		auto block_transaction (wallets.node.ledger.store.tx_begin_read ());
+		auto transaction (wallets.tx_begin_read ());
+		nano::raw_key prv;
+		if (!store.fetch (transaction, account_a, prv))
+		{
+			nano::account_info info;
+			auto new_account (wallets.node.ledger.store.account.get (block_transaction, account_a, info));
+			auto representative (new_account ? representative_a : info.representative);
+			auto epoch (new_account ? nano::epoch::epoch_0 : info.epoch ());
+			nano::block_hash previous (new_account ? nano::block_hash (0) : info.head);
+			nano::uint128_t balance (new_account ? 0 : info.balance.number ());
+			uint64_t cached_work (0);
+			store.work_get (transaction, account_a, cached_work);
+			for (auto const & hash : hashes_a)
+			{
+				nano::pending_info pending_info;
+				if (!wallets.node.ledger.store.pending.get (block_transaction, nano::pending_key (account_a, hash), pending_info) && wallets.node.config.receive_minimum.number () <= pending_info.amount.number ())
+				{
+					nano::block_details details;
+					details.is_receive = true;
+					details.epoch = epoch = std::max (epoch, pending_info.epoch);
+					balance += pending_info.amount.number ();
+					// Only the first block can use the work cached for the current account head
+					auto block (std::make_shared<nano::state_block> (account_a, previous, representative, balance, hash, prv, account_a, blocks.empty () ? cached_work : 0));
+					previous = block->hash ();
+					blocks.emplace_back (block, details);
+				}
+			}
+		}
+		else
+		{
+			wallets.node.logger.try_log ("Unable to receive, wallet locked");
+		}
+	}
+
+	std::vector<std::future<boost::optional<uint64_t>>> work;
+	if (wallets.node.work_generation_enabled ())
+	{
+		for (auto const & [block, details] : blocks)
+		{
+			std::promise<boost::optional<uint64_t>> promise;
+			work.push_back (promise.get_future ());
+			auto required_difficulty (nano::work_threshold (block->work_version (), details));
+			if (block->difficulty () < required_difficulty)
+			{
+				wallets.node.work_generate (
+				block->work_version (), block->root (), required_difficulty, [promise = std::make_shared<decltype (promise)> (std::move (promise))] (boost::optional<uint64_t> work_a) {
+					promise->set_value (work_a);
+				},
+				account_a);
+			}
+			else
+			{
+				promise.set_value (block->block_work ());
+			}
+		}
+	}
+
+	std::vector<std::shared_ptr<nano::block>> result;
+	for (std::size_t index (0); index != blocks.size (); ++index)
+	{
+		auto const & [block, details] = blocks[index];
+		if (index < work.size ())
+		{
+			auto work_l (work[index].get ());
+			if (work_l.is_initialized ())
+			{
+				block->block_work_set (*work_l);
+			}
+		}
+		// Work for the next head is only cached after the last block of the chain
+		if (action_complete (block, account_a, index + 1 == blocks.size (), details))
+		{
+			// The remaining blocks build on top of this one
+			break;
+		}
+		result.push_back (block);
+	}
+	// Work requested for blocks which will not be processed anymore
+	for (auto index (result.size () + 1); index < blocks.size (); ++index)
+	{
+		wallets.node.distributed_work.cancel (blocks[index].first->root ());
+	}
+	return result;
+}
+
 std::shared_ptr<nano::block> nano::wallet::change_action (nano::account const & source_a, nano::account const & representative_a, uint64_t work_a, bool generate_work_a)
 {
 	std::shared_ptr<nano::block> block;
@@ -1042,10 +1132,13 @@ bool nano::wallet::action_complete (std::shared_ptr<nano::block> const & block_a
 	bool error{ false };
 	// Unschedule any work caching for this account
 	wallets.delayed_work->erase (account_a);
+	wallets.work_scheduler.activity (account_a);
 	if (block_a != nullptr)
 	{
+		auto const start (std::chrono::steady_clock::now ());
 		auto required_difficulty{ nano::work_threshold (block_a->work_version (), details_a) };
-		if (block_a->difficulty () < required_difficulty)
+		auto const cache_hit (block_a->difficulty () >= required_difficulty);
+		if (!cache_hit)
 		{
 			wallets.node.logger.try_log (boost::str (boost::format ("Cached or provided work for block %1% account %2% is invalid, regenerating") % block_a->hash ().to_string () % account_a.to_account ()));
 			debug_assert (required_difficulty <= wallets.node.max_work_generate_difficulty (block_a->work_version ()));
@@ -1056,6 +1149,9 @@ bool nano::wallet::action_complete (std::shared_ptr<nano::block> const & block_a
 			error = wallets.node.process_local (block_a).code != nano::process_result::progress;
 			debug_assert (error || block_a->sideband ().details == details_a);
 		}
+		auto const detail (cache_hit ? nano::stat::detail::work_cache_hit : nano::stat::detail::work_cache_miss);
+		wallets.node.stats.inc (nano::stat::type::wallet, detail);
+		wallets.node.stats.update_histogram (nano::stat::type::latency, detail, nano::stat::dir::in, std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count ());
 		if (!error && generate_work_a)
 		{
 			work_ensure (account_a, block_a->hash ());
@@ -1158,9 +1254,7 @@ void nano::wallet::work_ensure (nano::account const & account_a, nano::root cons
 		if (existing != delayed_work->end () && existing->second == root_a)
 		{
 			delayed_work->erase (existing);
-			this_l->wallets.queue_wallet_action (nano::wallets::generate_priority, this_l, [account_a, root_a] (nano::wallet & wallet_a) {
-				wallet_a.work_cache_blocking (account_a, root_a);
-			});
+			this_l->wallets.work_scheduler.add (this_l, account_a, root_a);
 		}
 	});
 }
@@ -1171,42 +1265,118 @@ bool nano::wallet::search_pending (nano::transaction const & wallet_transaction_
 	if (!result)
 	{
 		wallets.node.logger.try_log ("Beginning pending block search");
+		nano::timer<std::chrono::milliseconds> timer (nano::timer_state::started);
+		std::vector<nano::account> accounts;
 		for (auto i (store.begin (wallet_transaction_a)), n (store.end ()); i != n; ++i)
 		{
-			auto block_transaction (wallets.node.store.tx_begin_read ());
-			nano::account const & account (i->first);
 			// Don't search pending for watch-only accounts
 			if (!nano::wallet_value (i->second).key.is_zero ())
 			{
-				for (auto j (wallets.node.store.pending.begin (block_transaction, nano::pending_key (account, 0))), k (wallets.node.store.pending.end ()); j != k && nano::pending_key (j->first).account == account; ++j)
+				accounts.push_back (i->first);
+			}
+		}
+		// Wallet accounts are iterated in key order, the same order as the pending table
+		debug_assert (std::is_sorted (accounts.begin (), accounts.end ()));
+		auto representative (store.representative (wallet_transaction_a));
+
+		// Confirmed receivables per account, ordered so that receives are queued in account order
+		std::map<nano::account, std::vector<std::pair<nano::block_hash, nano::uint128_t>>> receivable;
+		nano::mutex receivable_mutex;
+		auto & pending_store (wallets.node.store.pending);
+		// Merges the sorted wallet accounts with the pending entries in [i, n), seeking over accounts which are not in the wallet
+		auto scan = [this, &accounts, &receivable, &receivable_mutex, &pending_store] (nano::read_transaction const & transaction_a, nano::store_iterator<nano::pending_key, nano::pending_info> i, nano::store_iterator<nano::pending_key, nano::pending_info> n) {
+			boost::optional<nano::pending_key> end_key;
+			if (n != pending_store.end ())
+			{
+				end_key = nano::pending_key (n->first);
+			}
+			auto before_end = [&end_key] (nano::pending_key const & key_a) {
+				return !end_key || key_a.account < end_key->account || (key_a.account == end_key->account && key_a.hash < end_key->hash);
+			};
+			decltype (receivable) found;
+			auto account (accounts.begin ());
+			while (i != n)
+			{
+				nano::pending_key key (i->first);
+				account = std::lower_bound (account, accounts.end (), key.account);
+				if (account == accounts.end ())
 				{
-					nano::pending_key key (j->first);
-					auto hash (key.hash);
-					nano::pending_info pending (j->second);
-					auto amount (pending.amount.number ());
-					if (wallets.node.config.receive_minimum.number () <= amount)
+					break;
+				}
+				if (*account != key.account)
+				{
+					nano::pending_key next (*account, 0);
+					if (!before_end (next))
 					{
-						wallets.node.logger.try_log (boost::str (boost::format ("Found a pending block %1% for account %2%") % hash.to_string () % pending.source.to_account ()));
-						if (wallets.node.ledger.block_confirmed (block_transaction, hash))
-						{
-							auto representative = store.representative (wallet_transaction_a);
-							// Receive confirmed block
-							receive_async (hash, representative, amount, account, [] (std::shared_ptr<nano::block> const &) {});
-						}
-						else if (!wallets.node.confirmation_height_processor.is_processing_block (hash))
+						break;
+					}
+					i = pending_store.begin (transaction_a, next);
+					continue;
+				}
+				nano::pending_info pending (i->second);
+				auto amount (pending.amount.number ());
+				if (wallets.node.config.receive_minimum.number () <= amount)
+				{
+					wallets.node.logger.try_log (boost::str (boost::format ("Found a pending block %1% for account %2%") % key.hash.to_string () % pending.source.to_account ()));
+					if (wallets.node.ledger.block_confirmed (transaction_a, key.hash))
+					{
+						found[key.account].emplace_back (key.hash, amount);
+					}
+					else if (!wallets.node.confirmation_height_processor.is_processing_block (key.hash))
+					{
+						auto block (wallets.node.store.block.get (transaction_a, key.hash));
+						if (block)
 						{
-							auto block (wallets.node.store.block.get (block_transaction, hash));
-							if (block)
-							{
-								// Request confirmation for block which is not being processed yet
-								wallets.node.block_confirm (block);
-							}
+							// Request confirmation for block which is not being processed yet
+							wallets.node.block_confirm (block);
 						}
 					}
 				}
+				++i;
+			}
+			nano::lock_guard<nano::mutex> guard (receivable_mutex);
+			for (auto & [account_l, blocks] : found)
+			{
+				auto & existing (receivable[account_l]);
+				existing.insert (existing.end (), blocks.begin (), blocks.end ());
+			}
+		};
+		if (accounts.size () >= search_pending_parallel_threshold)
+		{
+			pending_store.for_each_par (scan);
+		}
+		else if (!accounts.empty ())
+		{
+			auto transaction (wallets.node.store.tx_begin_read ());
+			scan (transaction, pending_store.begin (transaction, nano::pending_key (accounts.front (), 0)), pending_store.end ());
+		}
+
+		// Receive confirmed blocks, in batches per account
+		std::size_t found_count (0);
+		for (auto const & [account, blocks] : receivable)
+		{
+			found_count += blocks.size ();
+			for (auto begin (blocks.begin ()); begin != blocks.end ();)
+			{
+				auto end (begin + std::min<std::ptrdiff_t> (receive_batch_size, blocks.end () - begin));
+				std::vector<nano::block_hash> hashes;
+				nano::uint128_t amount (0);
+				for (auto i (begin); i != end; ++i)
+				{
+					hashes.push_back (i->first);
+					amount = std::max (amount, i->second);
+				}
+				wallets.node.stats.inc (nano::stat::type::wallet, nano::stat::detail::receive_batch);
+				wallets.queue_wallet_action (amount, shared_from_this (), [account = account, representative, hashes] (nano::wallet & wallet_a) {
+					wallet_a.receive_batch_action (account, representative, hashes);
+				});
+				begin = end;
 			}
 		}
-		wallets.node.logger.try_log ("Pending block search phase complete");
+		wallets.node.stats.add (nano::stat::type::wallet, nano::stat::detail::search_pending_accounts, nano::stat::dir::in, accounts.size ());
+		wallets.node.stats.add (nano::stat::type::wallet, nano::stat::detail::search_pending_found, nano::stat::dir::in, found_count);
+		auto elapsed (std::max<uint64_t> (1, timer.stop ().count ()));
+		wallets.node.logger.try_log (boost::str (boost::format ("Pending block search phase complete, %1% accounts scanned in %2% ms (%3% accounts/s), %4% receivable blocks found") % accounts.size () % elapsed % (accounts.size () * 1000 / elapsed) % found_count));
 	}
 	else
 	{
@@ -1336,6 +1506,7 @@ void nano::wallets::do_wallet_actions ()
 
 nano::wallets::wallets (bool error_a, nano::node & node_a) :
 	observer ([] (bool) {}),
+	work_scheduler (node_a),
 	node (node_a),
 	env (boost::polymorphic_downcast<nano::mdb_wallets_store *> (node_a.wallets_store_impl.get ())->environment),
 	stopped (false),
@@ -1344,6 +1515,8 @@ nano::wallets::wallets (bool error_a, nano::node & node_a) :
 		do_wallet_actions ();
 	})
 {
+	node.stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::work_cache_hit, nano::stat::dir::in);
+	node.stats.define_latency_histogram (nano::stat::type::latency, nano::stat::detail::work_cache_miss, nano::stat::dir::in);
 	nano::unique_lock<nano::mutex> lock (mutex);
 	if (!error_a)
 	{
@@ -1598,6 +1771,7 @@ void nano::wallets::stop ()
 		stopped = true;
 		actions.clear ();
 	}
+	work_scheduler.stop ();
 	condition.notify_all ();
 	if (thread.joinable ())
 	{
@@ -1844,5 +2018,6 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (wa
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "items", items_count, sizeof_item_element }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "actions", actions_count, sizeof_actions_element }));
+	composite->add_component (wallets.work_scheduler.collect_container_info ("work_scheduler"));
 	return composite;
 }
@@ -6,6 +6,7 @@
 #include <nano/node/lmdb/lmdb.hpp>
 #include <nano/node/lmdb/wallet_value.hpp>
 #include <nano/node/openclwork.hpp>
+#include <nano/node/wallet_work_scheduler.hpp>
 #include <nano/secure/common.hpp>
 #include <nano/secure/store.hpp>
 
@@ -121,6 +122,8 @@ class wallet final : public std::enable_shared_from_this<nano::wallet>
 public:
 	std::shared_ptr<nano::block> change_action (nano::account const &, nano::account const &, uint64_t = 0, bool = true);
 	std::shared_ptr<nano::block> receive_action (nano::block_hash const &, nano::account const &, nano::uint128_union const &, nano::account const &, uint64_t = 0, bool = true);
+	/** Receives several pending blocks into one account as a chain. Block hashes do not depend on work, so work for every block of the chain is requested before processing the first one */
+	std::vector<std::shared_ptr<nano::block>> receive_batch_action (nano::account const &, nano::account const &, std::vector<nano::block_hash> const &);
 	std::shared_ptr<nano::block> send_action (nano::account const &, nano::account const &, nano::uint128_t const &, uint64_t = 0, bool = true, boost::optional<std::string> = {});
 	bool action_complete (std::shared_ptr<nano::block> const &, nano::account const &, bool const, nano::block_details const &);
 	wallet (bool &, nano::transaction &, nano::wallets &, std::string const &);
@@ -159,6 +162,9 @@ public:
 	nano::wallets & wallets;
 	nano::mutex representatives_mutex;
 	std::unordered_set<nano::account> representatives;
+	/** Wallets with at least this many accounts scan the pending table in parallel by key range */
+	static std::size_t constexpr search_pending_parallel_threshold = 256;
+	static std::size_t constexpr receive_batch_size = 64;
 };
 
 class wallet_representatives
@@ -216,6 +222,7 @@ public:
 	std::unordered_map<nano::wallet_id, std::shared_ptr<nano::wallet>> items;
 	std::multimap<nano::uint128_t, std::pair<std::shared_ptr<nano::wallet>, std::function<void (nano::wallet &)>>, std::greater<nano::uint128_t>> actions;
 	nano::locked<std::unordered_map<nano::account, nano::root>> delayed_work;
+	nano::wallet_work_scheduler work_scheduler;
 	nano::mutex mutex;
 	nano::mutex action_mutex;
 	nano::condition_variable condition;
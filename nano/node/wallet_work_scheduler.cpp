@@ -0,0 +1,140 @@
+#include <nano/lib/threading.hpp>
+#include <nano/node/node.hpp>
+#include <nano/node/wallet.hpp>
+#include <nano/node/wallet_work_scheduler.hpp>
+
+#include <boost/format.hpp>
+
+#include <cmath>
+
+nano::wallet_work_scheduler::wallet_work_scheduler (nano::node & node_a) :
+	node (node_a)
+{
+}
+
+void nano::wallet_work_scheduler::add (std::shared_ptr<nano::wallet> const & wallet_a, nano::account const & account_a, nano::root const & root_a)
+{
+	// Accounts with receivables are likely to need work for a receive soon
+	auto receivable (node.store.pending.any (node.store.tx_begin_read (), account_a));
+	auto difficulty (node.default_difficulty (nano::work_version::work_1));
+	nano::unique_lock<nano::mutex> lock (mutex);
+	if (!stopped)
+	{
+		auto priority (activity_score (account_a, std::chrono::steady_clock::now ()) + (receivable ? receivable_bonus : 0.0));
+		auto & by_account (requests.get<tag_account> ());
+		by_account.erase (account_a);
+		by_account.insert ({ wallet_a, account_a, root_a, difficulty, priority });
+		node.stats.inc (nano::stat::type::wallet, nano::stat::detail::work_precompute_queued);
+		start (lock);
+	}
+}
+
+void nano::wallet_work_scheduler::activity (nano::account const & account_a)
+{
+	auto now (std::chrono::steady_clock::now ());
+	nano::lock_guard<nano::mutex> guard (mutex);
+	requests.get<tag_account> ().erase (account_a);
+	if (activity_m.size () >= max_activity && activity_m.find (account_a) == activity_m.end ())
+	{
+		// Forget accounts whose score decayed the most
+		for (auto i (activity_m.begin ()), n (activity_m.end ()); i != n;)
+		{
+			i = now - i->second.updated > activity_half_life ? activity_m.erase (i) : std::next (i);
+		}
+		if (activity_m.size () >= max_activity)
+		{
+			activity_m.erase (activity_m.begin ());
+		}
+	}
+	auto score (activity_score (account_a, now));
+	activity_m[account_a] = { score + 1.0, now };
+}
+
+void nano::wallet_work_scheduler::stop ()
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	stopped = true;
+	requests.clear ();
+}
+
+std::size_t nano::wallet_work_scheduler::size () const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	return requests.size ();
+}
+
+std::size_t nano::wallet_work_scheduler::in_flight () const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	return in_flight_m;
+}
+
+std::size_t nano::wallet_work_scheduler::budget () const
+{
+	return std::max<std::size_t> (1, (node.local_work_generation_enabled () ? 1 : 0) + node.config.work_peers.size ());
+}
+
+// Must be called with the mutex held
+double nano::wallet_work_scheduler::activity_score (nano::account const & account_a, std::chrono::steady_clock::time_point const & now_a) const
+{
+	double result (0.0);
+	auto existing (activity_m.find (account_a));
+	if (existing != activity_m.end ())
+	{
+		auto elapsed (std::chrono::duration<double> (now_a - existing->second.updated).count ());
+		result = existing->second.score * std::exp2 (-elapsed / activity_half_life.count ());
+	}
+	return result;
+}
+
+void nano::wallet_work_scheduler::start (nano::unique_lock<nano::mutex> & lock_a)
+{
+	debug_assert (lock_a.owns_lock ());
+	while (!stopped && !requests.empty () && in_flight_m < budget () && node.work_generation_enabled ())
+	{
+		auto & by_priority (requests.get<tag_priority> ());
+		auto request_l (*by_priority.begin ());
+		by_priority.erase (by_priority.begin ());
+		++in_flight_m;
+		lock_a.unlock ();
+		node.work_generate (
+		nano::work_version::work_1, request_l.root, request_l.difficulty, [this, request_l] (boost::optional<uint64_t> work_a) {
+			// Storing the result needs a wallet write transaction, keep it off work generation threads
+			node.workers.push_task ([this, request_l, work_a] () {
+				generated (request_l, work_a);
+			});
+		},
+		request_l.account);
+		lock_a.lock ();
+	}
+}
+
+void nano::wallet_work_scheduler::generated (request const & request_a, boost::optional<uint64_t> const & work_a)
+{
+	if (work_a.is_initialized ())
+	{
+		auto transaction (node.wallets.tx_begin_write ());
+		if (request_a.wallet->live () && request_a.wallet->store.exists (transaction, request_a.account))
+		{
+			request_a.wallet->work_update (transaction, request_a.account, request_a.root, *work_a);
+		}
+		node.stats.inc (nano::stat::type::wallet, nano::stat::detail::work_precompute_generated);
+	}
+	else if (!node.stopped)
+	{
+		node.logger.try_log (boost::str (boost::format ("Could not precache work for root %1% due to work generation failure") % request_a.root.to_string ()));
+	}
+	nano::unique_lock<nano::mutex> lock (mutex);
+	debug_assert (in_flight_m > 0);
+	--in_flight_m;
+	start (lock);
+}
+
+std::unique_ptr<nano::container_info_component> nano::wallet_work_scheduler::collect_container_info (std::string const & name)
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "requests", requests.size (), sizeof (decltype (requests)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "activity", activity_m.size (), sizeof (decltype (activity_m)::value_type) }));
+	return composite;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/lib/numbers.hpp>
+
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace mi = boost::multi_index;
+
+namespace nano
+{
+class container_info_component;
+class node;
+class wallet;
+
+/**
+ * Precomputes work for wallet accounts ahead of their next send or receive and stores it with wallet_store::work_put.
+ * Requests are served by predicted next use: accounts with recent activity first, with a bonus for accounts holding receivables.
+ * Only one request per work source (the local work pool and each configured work peer) is in flight at a time, so the rest queue here instead of on the wallet actions thread.
+ */
+class wallet_work_scheduler final
+{
+public:
+	explicit wallet_work_scheduler (nano::node &);
+	/** Queues work generation for \p root_a, replacing any request queued for the same account */
+	void add (std::shared_ptr<nano::wallet> const &, nano::account const &, nano::root const &);
+	/** Records that the wallet created a block for \p account_a, any request queued for the account is stale and dropped */
+	void activity (nano::account const &);
+	void stop ();
+	std::size_t size () const;
+	std::size_t in_flight () const;
+	/** Number of requests which may be in flight at once */
+	std::size_t budget () const;
+	std::unique_ptr<nano::container_info_component> collect_container_info (std::string const &);
+
+	/** Activity scores are halved every activity_half_life */
+	static std::chrono::seconds constexpr activity_half_life{ 600 };
+	static double constexpr receivable_bonus{ 4.0 };
+	static std::size_t constexpr max_activity{ 64 * 1024 };
+
+private:
+	class request final
+	{
+	public:
+		std::shared_ptr<nano::wallet> wallet;
+		nano::account account;
+		nano::root root;
+		uint64_t difficulty;
+		double priority;
+	};
+	class activity_entry final
+	{
+	public:
+		double score;
+		std::chrono::steady_clock::time_point updated;
+	};
+	class tag_account
+	{
+	};
+	class tag_priority
+	{
+	};
+
+	double activity_score (nano::account const &, std::chrono::steady_clock::time_point const &) const;
+	void start (nano::unique_lock<nano::mutex> &);
+	void generated (request const &, boost::optional<uint64_t> const &);
+
+	nano::node & node;
+	// clang-format off
+	boost::multi_index_container<request,
+	mi::indexed_by<
+		mi::hashed_unique<mi::tag<tag_account>,
+			mi::member<request, nano::account, &request::account>>,
+		mi::ordered_non_unique<mi::tag<tag_priority>,
+			mi::member<request, double, &request::priority>, std::greater<double>>>>
+	requests;
+	// clang-format on
+	std::unordered_map<nano::account, activity_entry> activity_m;
+	std::size_t in_flight_m{ 0 };
+	bool stopped{ false };
+	mutable nano::mutex mutex;
+};
+}
@@ -13,6 +13,8 @@
 #include <boost/asio/ssl/stream.hpp>
 #endif
 #include <boost/format.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
 
 nano::rpc_connection::rpc_connection (nano::rpc_config const & rpc_config, boost::asio::io_context & io_ctx, nano::logger_mt & logger, nano::rpc_handler_interface & rpc_handler_interface) :
 	socket (io_ctx),
@@ -98,6 +100,37 @@ void nano::rpc_connection::read (STREAM_TYPE & stream)
 	}));
 }
 
+template <typename STREAM_TYPE>
+void nano::rpc_connection::write_metrics (STREAM_TYPE & stream, unsigned version)
+{
+	auto this_l (shared_from_this ());
+	rpc_handler_interface.process_request ("stats", R"({"action": "stats", "type": "metrics"})", [this_l, version, &stream] (std::string const & response_a) {
+		// The node replies with the metrics text wrapped in a JSON response, or a JSON error which is passed on
+		std::string body;
+		auto status (boost::beast::http::status::ok);
+		try
+		{
+			std::stringstream istream (response_a);
+			boost::property_tree::ptree tree;
+			boost::property_tree::read_json (istream, tree);
+			body = tree.get<std::string> ("metrics");
+		}
+		catch (boost::property_tree::ptree_error const &)
+		{
+			body = response_a;
+			status = boost::beast::http::status::internal_server_error;
+		}
+		this_l->write_result (body, version, status);
+		if (status == boost::beast::http::status::ok)
+		{
+			this_l->res.set (boost::beast::http::field::content_type, "text/plain; version=0.0.4");
+		}
+		boost::beast::http::async_write (stream, this_l->res, boost::asio::bind_executor (this_l->strand, [this_l] (boost::system::error_code const & ec, size_t bytes_transferred) {
+			this_l->write_completion_handler (this_l);
+		}));
+	});
+}
+
 template <typename STREAM_TYPE>
 void nano::rpc_connection::parse_request (STREAM_TYPE & stream, std::shared_ptr<boost::beast::http::request_parser<boost::beast::http::empty_body>> const & header_parser)
 {
@@ -158,6 +191,18 @@ void nano::rpc_connection::parse_request (STREAM_TYPE & stream, std::shared_ptr<
 						}));
 						break;
 					}
+					case boost::beast::http::verb::get:
+					{
+						if (path_l == "/metrics")
+						{
+							this_l->write_metrics (stream, version);
+						}
+						else
+						{
+							nano::json_error_response (response_handler, "Can only POST requests");
+						}
+						break;
+					}
 					default:
 					{
 						nano::json_error_response (response_handler, "Can only POST requests");
@@ -174,8 +219,10 @@ void nano::rpc_connection::parse_request (STREAM_TYPE & stream, std::shared_ptr<
 }
 
 template void nano::rpc_connection::read (socket_type &);
+template void nano::rpc_connection::write_metrics (socket_type &, unsigned);
 template void nano::rpc_connection::parse_request (socket_type &, std::shared_ptr<boost::beast::http::request_parser<boost::beast::http::empty_body>> const &);
 #ifdef NANO_SECURE_RPC
 template void nano::rpc_connection::read (boost::asio::ssl::stream<socket_type &> &);
+template void nano::rpc_connection::write_metrics (boost::asio::ssl::stream<socket_type &> &, unsigned);
 template void nano::rpc_connection::parse_request (boost::asio::ssl::stream<socket_type &> &, std::shared_ptr<boost::beast::http::request_parser<boost::beast::http::empty_body>> const &);
 #endif
@@ -46,6 +46,10 @@ protected:
 	template <typename STREAM_TYPE>
 	void read (STREAM_TYPE & stream);
 
+	/** Replies to GET /metrics with the node metrics in the Prometheus text format */
+	template <typename STREAM_TYPE>
+	void write_metrics (STREAM_TYPE & stream, unsigned version);
+
 	template <typename STREAM_TYPE>
 	void parse_request (STREAM_TYPE & stream, std::shared_ptr<boost::beast::http::request_parser<boost::beast::http::empty_body>> const & header_parser);
 };
@@ -5,7 +5,11 @@
 
 #include <boost/endian/conversion.hpp>
 
+#include <cstring>
+
 nano::rpc_request_processor::rpc_request_processor (boost::asio::io_context & io_ctx, nano::rpc_config & rpc_config) :
+	io_ctx (io_ctx),
+	max_connections (std::max (1u, rpc_config.rpc_process.num_ipc_connections)),
 	ipc_address (rpc_config.rpc_process.ipc_address),
 	ipc_port (rpc_config.rpc_process.ipc_port),
 	thread ([this] () {
@@ -13,18 +17,10 @@ nano::rpc_request_processor::rpc_request_processor (boost::asio::io_context & io
 		this->run ();
 	})
 {
-	nano::lock_guard<nano::mutex> lk (this->request_mutex);
-	this->connections.reserve (rpc_config.rpc_process.num_ipc_connections);
-	for (auto i = 0u; i < rpc_config.rpc_process.num_ipc_connections; ++i)
-	{
-		connections.push_back (std::make_shared<nano::ipc_connection> (nano::ipc::ipc_client (io_ctx), false));
-		auto connection = this->connections.back ();
-		connection->client.async_connect (ipc_address, ipc_port, [connection, &connections_mutex = this->connections_mutex] (nano::error err) {
-			// Even if there is an error this needs to be set so that another attempt can be made to connect with the ipc connection
-			nano::lock_guard<nano::mutex> lk (connections_mutex);
-			connection->is_available = true;
-		});
-	}
+	nano::lock_guard<nano::mutex> lk (mutex);
+	connections.reserve (max_connections);
+	connections.push_back (std::make_shared<nano::ipc_connection> (nano::ipc::ipc_client (io_ctx)));
+	connect (connections.back ());
 }
 
 nano::rpc_request_processor::~rpc_request_processor ()
@@ -35,10 +31,10 @@ nano::rpc_request_processor::~rpc_request_processor ()
 void nano::rpc_request_processor::stop ()
 {
 	{
-		nano::lock_guard<nano::mutex> lock (request_mutex);
+		nano::lock_guard<nano::mutex> lock (mutex);
 		stopped = true;
 	}
-	condition.notify_one ();
+	condition.notify_all ();
 	if (thread.joinable ())
 	{
 		thread.join ();
@@ -47,135 +43,274 @@ void nano::rpc_request_processor::stop ()
 
 void nano::rpc_request_processor::add (std::shared_ptr<rpc_request> const & request)
 {
+	request->deadline = std::chrono::steady_clock::now () + request_timeout;
 	{
-		nano::lock_guard<nano::mutex> lk (request_mutex);
+		nano::lock_guard<nano::mutex> lk (mutex);
 		requests.push_back (request);
 	}
-	condition.notify_one ();
+	condition.notify_all ();
+}
+
+std::size_t nano::rpc_request_processor::max_in_flight ()
+{
+	nano::lock_guard<nano::mutex> lk (mutex);
+	return max_in_flight_m;
+}
+
+void nano::rpc_request_processor::respond (std::shared_ptr<nano::rpc_request> const & rpc_request, std::string const & body)
+{
+	rpc_request->response (body);
+	if (rpc_request->action == "stop")
+	{
+		stop_callback ();
+	}
 }
 
-void nano::rpc_request_processor::read_payload (std::shared_ptr<nano::ipc_connection> const & connection, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request)
+// Must be called with the mutex held. The connect callback is always invoked asynchronously.
+void nano::rpc_request_processor::connect (std::shared_ptr<nano::ipc_connection> const & connection)
 {
-	uint32_t payload_size_l = boost::endian::big_to_native (*reinterpret_cast<uint32_t *> (res->data ()));
-	res->resize (payload_size_l);
-	// Read JSON payload
-	connection->client.async_read (res, payload_size_l, [this, connection, res, rpc_request] (nano::error err_read_a, size_t size_read_a) {
-		// We need 2 sequential reads to get both the header and payload, so only allow other writes
-		// when they have both been read.
-		make_available (*connection);
-		if (!err_read_a && size_read_a != 0)
+	debug_assert (!connection->connecting && !connection->connected);
+	connection->connecting = true;
+	connection->client.async_connect (ipc_address, ipc_port, [this, connection] (nano::error err) {
+		std::deque<std::shared_ptr<nano::rpc_request>> failed;
 		{
-			rpc_request->response (std::string (res->begin (), res->end ()));
-			if (rpc_request->action == "stop")
+			nano::lock_guard<nano::mutex> lk (mutex);
+			connection->connecting = false;
+			connection->connected = !err;
+			auto any_usable (std::any_of (connections.begin (), connections.end (), [] (auto const & connection_a) {
+				return connection_a->connected || connection_a->connecting;
+			}));
+			if (!any_usable)
 			{
-				this->stop_callback ();
+				// Nothing can serve the queued requests, they are failed so a later request tries connecting again
+				failed.swap (requests);
 			}
 		}
-		else
+		if (!err)
+		{
+			read_responses (connection);
+		}
+		condition.notify_all ();
+		for (auto const & rpc_request : failed)
 		{
-			json_error_response (rpc_request->response, "Failed to read payload");
+			json_error_response (rpc_request->response, "There is a problem connecting to the node. Make sure ipc->tcp is enabled in the node config, ipc ports match and ipc_address is the ip where the node is located");
 		}
 	});
 }
 
-void nano::rpc_request_processor::make_available (nano::ipc_connection & connection)
+void nano::rpc_request_processor::write (std::shared_ptr<nano::ipc_connection> const & connection, nano::shared_const_buffer const & req)
 {
-	nano::lock_guard<nano::mutex> lk (connections_mutex);
-	connection.is_available = true; // Allow people to use it now
+	connection->client.async_write (req, [this, connection] (nano::error err_a, size_t size_a) {
+		if (err_a || size_a == 0)
+		{
+			fail_connection (connection, "Cannot write to the node");
+		}
+	});
 }
 
-// Connection does not exist or has been closed, try to connect to it again and then resend IPC request
-void nano::rpc_request_processor::try_reconnect_and_execute_request (std::shared_ptr<nano::ipc_connection> const & connection, nano::shared_const_buffer const & req, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request)
+/** Reads responses for as long as the connection is up. Each response is matched to its request by id, except for a request holding the connection exclusively */
+void nano::rpc_request_processor::read_responses (std::shared_ptr<nano::ipc_connection> const & connection)
 {
-	connection->client.async_connect (ipc_address, ipc_port, [this, connection, req, res, rpc_request] (nano::error err) {
-		if (!err)
+	auto res (std::make_shared<std::vector<uint8_t>> ());
+	connection->client.async_read_message (res, std::chrono::seconds::max (), [this, connection, res] (nano::error err_a, size_t size_a) {
+		if (!err_a && size_a != 0)
 		{
-			connection->client.async_write (req, [this, connection, res, rpc_request] (nano::error err_a, size_t size_a) {
-				if (size_a != 0 && !err_a)
+			std::shared_ptr<nano::rpc_request> rpc_request;
+			std::string body;
+			{
+				nano::lock_guard<nano::mutex> lk (mutex);
+				if (connection->exclusive != nullptr)
 				{
-					// Read length
-					connection->client.async_read (res, sizeof (uint32_t), [this, connection, res, rpc_request] (nano::error err_read_a, size_t size_read_a) {
-						if (size_read_a != 0 && !err_read_a)
-						{
-							this->read_payload (connection, res, rpc_request);
-						}
-						else
-						{
-							json_error_response (rpc_request->response, "Connection to node has failed");
-							make_available (*connection);
-						}
-					});
+					if (!connection->exclusive_expired)
+					{
+						rpc_request = connection->exclusive;
+						body.assign (res->begin (), res->end ());
+					}
+					connection->exclusive = nullptr;
+					connection->exclusive_expired = false;
 				}
-				else
+				else if (res->size () >= sizeof (uint32_t))
 				{
-					json_error_response (rpc_request->response, "Cannot write to the node");
-					make_available (*connection);
+					uint32_t id;
+					std::memcpy (&id, res->data (), sizeof (id));
+					boost::endian::big_to_native_inplace (id);
+					auto existing (connection->in_flight.find (id));
+					if (existing != connection->in_flight.end ())
+					{
+						rpc_request = existing->second;
+						connection->in_flight.erase (existing);
+						body.assign (res->begin () + sizeof (id), res->end ());
+					}
 				}
-			});
+			}
+			condition.notify_all ();
+			if (rpc_request != nullptr)
+			{
+				respond (rpc_request, body);
+			}
+			read_responses (connection);
 		}
 		else
 		{
-			json_error_response (rpc_request->response, "There is a problem connecting to the node. Make sure ipc->tcp is enabled in the node config, ipc ports match and ipc_address is the ip where the node is located");
-			make_available (*connection);
+			fail_connection (connection, "Connection to node has failed");
 		}
 	});
 }
 
+void nano::rpc_request_processor::fail_connection (std::shared_ptr<nano::ipc_connection> const & connection, std::string const & message)
+{
+	std::vector<std::shared_ptr<nano::rpc_request>> failed;
+	{
+		nano::lock_guard<nano::mutex> lk (mutex);
+		// Both the reader and a writer may report the same failure
+		if (connection->connected)
+		{
+			connection->connected = false;
+			for (auto const & [id, rpc_request] : connection->in_flight)
+			{
+				failed.push_back (rpc_request);
+			}
+			connection->in_flight.clear ();
+			if (connection->exclusive != nullptr && !connection->exclusive_expired)
+			{
+				failed.push_back (connection->exclusive);
+			}
+			connection->exclusive = nullptr;
+			connection->exclusive_expired = false;
+		}
+	}
+	condition.notify_all ();
+	for (auto const & rpc_request : failed)
+	{
+		json_error_response (rpc_request->response, message);
+	}
+}
+
+// Must be called with the mutex held
+std::shared_ptr<nano::ipc_connection> nano::rpc_request_processor::select_connection (nano::rpc_request const & request)
+{
+	// RPC 1.0 requests are multiplexed, others need a connection without requests in flight
+	auto multiplexed (request.rpc_api_version == 1);
+	std::shared_ptr<nano::ipc_connection> result;
+	auto connecting (false);
+	for (auto const & connection : connections)
+	{
+		connecting = connecting || connection->connecting;
+		if (connection->connected && connection->exclusive == nullptr && (multiplexed ? connection->in_flight.size () < pipeline_depth : connection->in_flight.empty ()))
+		{
+			if (result == nullptr || connection->in_flight.size () < result->in_flight.size ())
+			{
+				result = connection;
+			}
+		}
+	}
+	if (!connecting)
+	{
+		if (result == nullptr)
+		{
+			// Reconnect a failed connection first, otherwise grow the pool
+			auto disconnected (std::find_if (connections.begin (), connections.end (), [] (auto const & connection_a) {
+				return !connection_a->connected;
+			}));
+			if (disconnected != connections.end ())
+			{
+				connect (*disconnected);
+			}
+			else if (connections.size () < max_connections)
+			{
+				connections.push_back (std::make_shared<nano::ipc_connection> (nano::ipc::ipc_client (io_ctx)));
+				connect (connections.back ());
+			}
+		}
+	}
+	return result;
+}
+
+// Must be called with the mutex held
+std::vector<std::shared_ptr<nano::rpc_request>> nano::rpc_request_processor::expire (std::chrono::steady_clock::time_point const & now)
+{
+	std::vector<std::shared_ptr<nano::rpc_request>> result;
+	// Requests are queued in the order they were added, so the oldest are at the front
+	while (!requests.empty () && requests.front ()->deadline <= now)
+	{
+		result.push_back (requests.front ());
+		requests.pop_front ();
+	}
+	for (auto const & connection : connections)
+	{
+		for (auto i (connection->in_flight.begin ()), n (connection->in_flight.end ()); i != n;)
+		{
+			if (i->second->deadline <= now)
+			{
+				// A late response no longer finds its id and is discarded
+				result.push_back (i->second);
+				i = connection->in_flight.erase (i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+		if (connection->exclusive != nullptr && !connection->exclusive_expired && connection->exclusive->deadline <= now)
+		{
+			// The connection stays held until the node answers, the response cannot be told apart from the next one otherwise
+			result.push_back (connection->exclusive);
+			connection->exclusive_expired = true;
+		}
+	}
+	return result;
+}
+
 void nano::rpc_request_processor::run ()
 {
-	// This should be a conditioned wait
-	nano::unique_lock<nano::mutex> lk (request_mutex);
+	auto next_expiry_check (std::chrono::steady_clock::now () + std::chrono::seconds (1));
+	nano::unique_lock<nano::mutex> lk (mutex);
 	while (!stopped)
 	{
-		if (!requests.empty ())
+		auto now (std::chrono::steady_clock::now ());
+		if (now >= next_expiry_check)
 		{
-			lk.unlock ();
-			nano::unique_lock<nano::mutex> conditions_lk (connections_mutex);
-			// Find the first free ipc_client
-			auto it = std::find_if (connections.begin (), connections.end (), [] (auto connection) -> bool {
-				return connection->is_available;
-			});
-
-			if (it != connections.cend ())
+			next_expiry_check = now + std::chrono::seconds (1);
+			auto expired (expire (now));
+			if (!expired.empty ())
 			{
-				// Successfully found one
+				lk.unlock ();
+				for (auto const & rpc_request : expired)
+				{
+					json_error_response (rpc_request->response, "Request to the node timed out");
+				}
 				lk.lock ();
-				auto rpc_request = requests.front ();
-				requests.pop_front ();
+				continue;
+			}
+		}
+		std::shared_ptr<nano::ipc_connection> connection;
+		if (!requests.empty ())
+		{
+			connection = select_connection (*requests.front ());
+		}
+		if (connection != nullptr)
+		{
+			auto rpc_request = requests.front ();
+			requests.pop_front ();
+			if (rpc_request->rpc_api_version == 1)
+			{
+				auto id (connection->next_id++);
+				connection->in_flight.emplace (id, rpc_request);
+				max_in_flight_m = std::max (max_in_flight_m, connection->in_flight.size ());
 				lk.unlock ();
-				auto connection = *it;
-				connection->is_available = false; // Make sure no one else can take it
-				conditions_lk.unlock ();
-				auto encoding (rpc_request->rpc_api_version == 1 ? nano::ipc::payload_encoding::json_v1 : nano::ipc::payload_encoding::flatbuffers_json);
-				auto req (nano::ipc::prepare_request (encoding, rpc_request->body));
-				auto res (std::make_shared<std::vector<uint8_t>> ());
-
-				// Have we tried to connect yet?
-				connection->client.async_write (req, [this, connection, req, res, rpc_request] (nano::error err_a, size_t size_a) {
-					if (!err_a)
-					{
-						connection->client.async_read (res, sizeof (uint32_t), [this, connection, req, res, rpc_request] (nano::error err_read_a, size_t size_read_a) {
-							if (size_read_a != 0 && !err_read_a)
-							{
-								this->read_payload (connection, res, rpc_request);
-							}
-							else
-							{
-								this->try_reconnect_and_execute_request (connection, req, res, rpc_request);
-							}
-						});
-					}
-					else
-					{
-						try_reconnect_and_execute_request (connection, req, res, rpc_request);
-					}
-				});
+				write (connection, nano::ipc::prepare_multiplexed_request (id, rpc_request->body));
+			}
+			else
+			{
+				connection->exclusive = rpc_request;
+				lk.unlock ();
+				write (connection, nano::ipc::prepare_request (nano::ipc::payload_encoding::flatbuffers_json, rpc_request->body));
 			}
 			lk.lock ();
 		}
 		else
 		{
-			condition.wait (lk);
+			condition.wait_until (lk, next_expiry_check);
 		}
 	}
 }
@@ -5,21 +5,12 @@
 #include <nano/lib/rpcconfig.hpp>
 #include <nano/rpc/rpc.hpp>
 
+#include <chrono>
 #include <deque>
+#include <unordered_map>
 
 namespace nano
 {
-struct ipc_connection
-{
-	ipc_connection (nano::ipc::ipc_client && client_a, bool is_available_a) :
-		client (std::move (client_a)), is_available (is_available_a)
-	{
-	}
-
-	nano::ipc::ipc_client client;
-	bool is_available{ false };
-};
-
 struct rpc_request
 {
 	rpc_request (const std::string & action_a, const std::string & body_a, std::function<void (std::string const &)> response_a) :
@@ -41,8 +32,36 @@ struct rpc_request
 	std::string action;
 	std::string body;
 	std::function<void (std::string const &)> response;
+	/** Set when the request is added to the processor, unanswered requests are failed after this */
+	std::chrono::steady_clock::time_point deadline;
 };
 
+/** A connection to the node IPC server. RPC 1.0 requests are multiplexed over the connection by request id */
+struct ipc_connection
+{
+	explicit ipc_connection (nano::ipc::ipc_client && client_a) :
+		client (std::move (client_a))
+	{
+	}
+
+	nano::ipc::ipc_client client;
+	bool connecting{ false };
+	bool connected{ false };
+	/** Multiplexed requests awaiting a response, by request id */
+	std::unordered_map<uint32_t, std::shared_ptr<nano::rpc_request>> in_flight;
+	/** Request using a non-multiplexed encoding, which has the connection to itself until it is answered */
+	std::shared_ptr<nano::rpc_request> exclusive;
+	/** The exclusive request timed out, its response is discarded when it arrives */
+	bool exclusive_expired{ false };
+	uint32_t next_id{ 0 };
+};
+
+/**
+ * Forwards RPC requests to the node over a pool of IPC connections.
+ * RPC 1.0 requests are pipelined, so each connection can have up to pipeline_depth requests in flight. The pool starts with a single
+ * connection and grows up to num_ipc_connections while every connection is full, after that requests wait until a connection has room.
+ * Requests not answered within request_timeout, including the time spent waiting, are failed.
+ */
 class rpc_request_processor
 {
 public:
@@ -50,19 +69,31 @@ public:
 	~rpc_request_processor ();
 	void stop ();
 	void add (std::shared_ptr<rpc_request> const & request);
+	/** Most requests which were in flight on a single connection at the same time */
+	std::size_t max_in_flight ();
 	std::function<void ()> stop_callback;
 
+	/** Most requests in flight on a connection, another connection is opened once every connection has this many */
+	static size_t constexpr pipeline_depth = 32;
+	static std::chrono::seconds constexpr request_timeout{ 300 };
+
 private:
 	void run ();
-	void read_payload (std::shared_ptr<nano::ipc_connection> const & connection, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request);
-	void try_reconnect_and_execute_request (std::shared_ptr<nano::ipc_connection> const & connection, nano::shared_const_buffer const & req, std::shared_ptr<std::vector<uint8_t>> const & res, std::shared_ptr<nano::rpc_request> const & rpc_request);
-	void make_available (nano::ipc_connection & connection);
-
+	std::shared_ptr<nano::ipc_connection> select_connection (nano::rpc_request const & request);
+	void connect (std::shared_ptr<nano::ipc_connection> const & connection);
+	void write (std::shared_ptr<nano::ipc_connection> const & connection, nano::shared_const_buffer const & req);
+	void read_responses (std::shared_ptr<nano::ipc_connection> const & connection);
+	void fail_connection (std::shared_ptr<nano::ipc_connection> const & connection, std::string const & message);
+	void respond (std::shared_ptr<nano::rpc_request> const & rpc_request, std::string const & body);
+	std::vector<std::shared_ptr<nano::rpc_request>> expire (std::chrono::steady_clock::time_point const & now);
+
+	boost::asio::io_context & io_ctx;
 	std::vector<std::shared_ptr<nano::ipc_connection>> connections;
-	nano::mutex request_mutex;
-	nano::mutex connections_mutex;
+	std::size_t const max_connections;
+	nano::mutex mutex;
 	bool stopped{ false };
 	std::deque<std::shared_ptr<nano::rpc_request>> requests;
+	std::size_t max_in_flight_m{ 0 };
 	nano::condition_variable condition;
 	const std::string ipc_address;
 	const uint16_t ipc_port;
@@ -103,6 +134,11 @@ public:
 		};
 	}
 
+	std::size_t max_in_flight ()
+	{
+		return rpc_request_processor.max_in_flight ();
+	}
+
 private:
 	nano::rpc_request_processor rpc_request_processor;
 };
@@ -1706,6 +1706,38 @@ TEST (rpc, peers)
 	ASSERT_EQ (std::to_string (node->network_params.protocol.protocol_version), peers_node.get<std::string> (endpoint_text.str ()));
 }
 
+TEST (rpc, peers_bandwidth)
+{
+	nano::system system;
+	auto node = add_ipc_enabled_node (system);
+	nano::endpoint endpoint1 (boost::asio::ip::make_address_v6 ("fc00::1"), 4000);
+	nano::endpoint endpoint2 (boost::asio::ip::make_address_v6 ("fc00::2"), 4000);
+	auto channel1 (node->network.udp_channels.insert (endpoint1, node->network_params.protocol.protocol_version));
+	auto channel2 (node->network.udp_channels.insert (endpoint2, node->network_params.protocol.protocol_version));
+	ASSERT_NE (nullptr, channel1);
+	ASSERT_NE (nullptr, channel2);
+	nano::keepalive keepalive;
+	channel1->send (keepalive);
+	channel2->send (keepalive);
+	channel2->send (nano::publish (nano::dev::genesis));
+	auto [rpc, rpc_ctx] = add_rpc (system, node);
+	boost::property_tree::ptree request;
+	request.put ("action", "peers_bandwidth");
+	request.put ("count", 1);
+	auto response (wait_response (system, rpc, request));
+	auto & peers_node (response.get_child ("peers"));
+	// Only the heaviest peer
+	ASSERT_EQ (1, peers_node.size ());
+	std::stringstream endpoint_text;
+	endpoint_text << endpoint2;
+	auto peer (peers_node.get_child (endpoint_text.str ()));
+	// Keepalives may also be sent by the node in the background
+	ASSERT_LE (2, peer.get<uint64_t> ("messages"));
+	ASSERT_LE (1, peer.get<uint64_t> ("types.keepalive.messages"));
+	ASSERT_EQ (1, peer.get<uint64_t> ("types.publish.messages"));
+	ASSERT_EQ (0, peer.get<uint64_t> ("dropped_messages"));
+}
+
 TEST (rpc, peers_node_id)
 {
 	nano::system system;
@@ -4987,6 +5019,40 @@ TEST (rpc, stats_clear)
 	ASSERT_LE (node->stats.last_reset ().count (), 5);
 }
 
+TEST (rpc, stats_metrics)
+{
+	nano::system system;
+	auto node = add_ipc_enabled_node (system);
+	auto [rpc, rpc_ctx] = add_rpc (system, node);
+	node->stats.inc (nano::stat::type::ledger, nano::stat::detail::send, nano::stat::dir::in);
+	boost::asio::ip::tcp::socket socket (system.io_ctx);
+	boost::beast::http::request<boost::beast::http::empty_body> request;
+	boost::beast::http::response<boost::beast::http::string_body> response;
+	boost::beast::flat_buffer buffer;
+	std::atomic<bool> done{ false };
+	socket.async_connect (nano::tcp_endpoint (boost::asio::ip::address_v6::loopback (), rpc->config.port), [&socket, &request, &response, &buffer, &done] (boost::system::error_code const & ec) {
+		ASSERT_FALSE (ec);
+		request.method (boost::beast::http::verb::get);
+		request.target ("/metrics");
+		request.version (11);
+		boost::beast::http::async_write (socket, request, [&socket, &response, &buffer, &done] (boost::system::error_code const & ec, size_t) {
+			ASSERT_FALSE (ec);
+			boost::beast::http::async_read (socket, buffer, response, [&done] (boost::system::error_code const & ec, size_t) {
+				ASSERT_FALSE (ec);
+				done = true;
+			});
+		});
+	});
+	ASSERT_TIMELY (5s, done);
+	ASSERT_EQ (boost::beast::http::status::ok, response.result ());
+	ASSERT_EQ ("text/plain; version=0.0.4", response[boost::beast::http::field::content_type]);
+	auto const & body (response.body ());
+	ASSERT_NE (std::string::npos, body.find ("nano_stat_total{type=\"ledger\",detail=\"send\",dir=\"in\"} 1\n"));
+	ASSERT_NE (std::string::npos, body.find ("# TYPE nano_latency_rpc_action histogram\n"));
+	ASSERT_NE (std::string::npos, body.find ("nano_latency_block_processor_batch_bucket{dir=\"in\",le=\"+Inf\"} "));
+	ASSERT_NE (std::string::npos, body.find ("nano_container_count{container=\"node/"));
+}
+
 TEST (rpc, unchecked)
 {
 	nano::system system;
@@ -5558,6 +5624,65 @@ TEST (rpc, simultaneous_calls)
 	runner.join ();
 }
 
+// Requests sent to the same node in parallel are pipelined over a single IPC connection
+TEST (rpc, simultaneous_calls_pipelined)
+{
+	nano::system system;
+	auto node = add_ipc_enabled_node (system);
+	scoped_io_thread_name_change scoped_thread_name_io;
+	nano::thread_runner runner (system.io_ctx, node->config.io_threads);
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc_server (*node, node_rpc_config);
+	nano::rpc_config rpc_config (nano::get_available_port (), true);
+	rpc_config.rpc_process.ipc_port = node->config.ipc_config.transport_tcp.port;
+	rpc_config.rpc_process.num_ipc_connections = 1;
+	nano::ipc_rpc_processor ipc_rpc_processor (system.io_ctx, rpc_config);
+	nano::rpc rpc (system.io_ctx, rpc_config, ipc_rpc_processor);
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "account_block_count");
+	request.put ("account", nano::dev::genesis_key.pub.to_account ());
+
+	constexpr int num = 2 * nano::rpc_request_processor::pipeline_depth;
+	std::array<std::unique_ptr<test_response>, num> test_responses;
+	for (int i = 0; i < num; ++i)
+	{
+		test_responses[i] = std::make_unique<test_response> (request, system.io_ctx);
+	}
+
+	std::promise<void> promise;
+	std::atomic<int> count{ num };
+	for (int i = 0; i < num; ++i)
+	{
+		std::thread ([&test_responses, &promise, &count, i, port = rpc.config.port] () {
+			test_responses[i]->run (port);
+			if (--count == 0)
+			{
+				promise.set_value ();
+			}
+		})
+		.detach ();
+	}
+
+	promise.get_future ().wait ();
+
+	ASSERT_TIMELY (60s, std::all_of (test_responses.begin (), test_responses.end (), [] (const auto & test_response) { return test_response->status != 0; }));
+
+	for (int i = 0; i < num; ++i)
+	{
+		ASSERT_EQ (200, test_responses[i]->status);
+		ASSERT_EQ ("1", test_responses[i]->json.get<std::string> ("block_count"));
+	}
+	// Requests overlapped on the single connection, without going over its pipeline depth
+	ASSERT_GT (ipc_rpc_processor.max_in_flight (), 1);
+	ASSERT_LE (ipc_rpc_processor.max_in_flight (), nano::rpc_request_processor::pipeline_depth);
+	rpc.stop ();
+	system.stop ();
+	ipc_server.stop ();
+	system.io_ctx.stop ();
+	runner.join ();
+}
+
 // This tests that the inprocess RPC (i.e without using IPC) works correctly
 TEST (rpc, in_process)
 {
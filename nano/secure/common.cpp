@@ -894,4 +894,5 @@ void nano::generate_cache::enable_all ()
 	cemented_count = true;
 	unchecked_count = true;
 	account_count = true;
+	uncemented = true;
 }
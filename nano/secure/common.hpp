@@ -508,6 +508,7 @@ public:
 	bool unchecked_count = true;
 	bool account_count = true;
 	bool block_count = true;
+	bool uncemented = true;
 
 	void enable_all ();
 };
@@ -0,0 +1,110 @@
+#include <nano/lib/stats.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/secure/exists_filter.hpp>
+
+namespace
+{
+std::size_t constexpr words_per_block = nano::exists_filter::block_bytes / sizeof (uint64_t);
+
+// Keeps the same key from mapping to the same bits in different tables
+uint64_t table_salt (nano::exists_filter::table table_a)
+{
+	return (static_cast<uint64_t> (table_a) + 1) * 0x9e3779b97f4a7c15ULL;
+}
+}
+
+void nano::exists_filter::enable (std::size_t size_bytes_a, nano::stat & stats_a)
+{
+	debug_assert (!enabled_m);
+	block_count = std::max<std::size_t> (1, size_bytes_a / block_bytes);
+	words = std::make_unique<std::atomic<uint64_t>[]> (block_count * words_per_block);
+	for (std::size_t i = 0; i < block_count * words_per_block; ++i)
+	{
+		words[i].store (0, std::memory_order_relaxed);
+	}
+	stats = &stats_a;
+	enabled_m.store (true, std::memory_order_release);
+}
+
+void nano::exists_filter::set_ready ()
+{
+	debug_assert (enabled_m);
+	ready_m.store (true, std::memory_order_release);
+}
+
+bool nano::exists_filter::ready () const
+{
+	return ready_m.load (std::memory_order_acquire);
+}
+
+std::size_t nano::exists_filter::size_bytes () const
+{
+	return enabled_m.load (std::memory_order_acquire) ? block_count * block_bytes : 0;
+}
+
+void nano::exists_filter::insert (table table_a, nano::uint256_union const & key_a)
+{
+	insert (table_a, key_a.qwords[0], key_a.qwords[1]);
+}
+
+void nano::exists_filter::insert (table table_a, nano::uint256_union const & first_a, nano::uint256_union const & second_a)
+{
+	insert (table_a, first_a.qwords[0] ^ second_a.qwords[2], first_a.qwords[1] ^ second_a.qwords[3]);
+}
+
+bool nano::exists_filter::absent (table table_a, nano::uint256_union const & key_a) const
+{
+	return absent (table_a, key_a.qwords[0], key_a.qwords[1]);
+}
+
+bool nano::exists_filter::absent (table table_a, nano::uint256_union const & first_a, nano::uint256_union const & second_a) const
+{
+	return absent (table_a, first_a.qwords[0] ^ second_a.qwords[2], first_a.qwords[1] ^ second_a.qwords[3]);
+}
+
+void nano::exists_filter::lookup (bool found_a) const
+{
+	if (ready ())
+	{
+		stats->inc (nano::stat::type::filter, found_a ? nano::stat::detail::exists_filter_positive : nano::stat::detail::exists_filter_false_positive);
+	}
+}
+
+void nano::exists_filter::insert (table table_a, uint64_t block_digest_a, uint64_t bits_digest_a)
+{
+	if (enabled_m.load (std::memory_order_acquire))
+	{
+		auto salt (table_salt (table_a));
+		auto block (static_cast<std::size_t> ((block_digest_a ^ salt) % block_count) * words_per_block);
+		// Double hashing within the block, an odd step visits distinct bits
+		auto digest (bits_digest_a ^ salt);
+		auto position (static_cast<unsigned> (digest & 511));
+		auto step (static_cast<unsigned> ((digest >> 9) & 511) | 1);
+		for (unsigned i = 0; i < bits_per_key; ++i, position = (position + step) & 511)
+		{
+			words[block + position / 64].fetch_or (uint64_t{ 1 } << (position % 64), std::memory_order_release);
+		}
+	}
+}
+
+bool nano::exists_filter::absent (table table_a, uint64_t block_digest_a, uint64_t bits_digest_a) const
+{
+	auto result (false);
+	if (ready ())
+	{
+		auto salt (table_salt (table_a));
+		auto block (static_cast<std::size_t> ((block_digest_a ^ salt) % block_count) * words_per_block);
+		auto digest (bits_digest_a ^ salt);
+		auto position (static_cast<unsigned> (digest & 511));
+		auto step (static_cast<unsigned> ((digest >> 9) & 511) | 1);
+		for (unsigned i = 0; i < bits_per_key && !result; ++i, position = (position + step) & 511)
+		{
+			result = (words[block + position / 64].load (std::memory_order_acquire) & (uint64_t{ 1 } << (position % 64))) == 0;
+		}
+		if (result)
+		{
+			stats->inc (nano::stat::type::filter, nano::stat::detail::exists_filter_negative);
+		}
+	}
+	return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace nano
+{
+class stat;
+
+/**
+ * A blocked bloom filter over the keys of the blocks, accounts, pending and pruned tables, consulted before a store lookup.
+ * Each key sets bits within a single 64 byte block, so a check touches one cache line.
+ * Deletions are not tracked, they only raise the false positive rate, so the filter never reports an existing key as absent.
+ * Keys are cryptographic hashes or public keys and are used as their own digest.
+ * @note This class is thread-safe. It is disabled until enabled, and lookups only consult it after set_ready.
+ */
+class exists_filter final
+{
+public:
+	enum class table : uint8_t
+	{
+		blocks,
+		accounts,
+		pending,
+		pruned
+	};
+
+	/** Allocates \p size_bytes of filter, rounded down to whole blocks. Inserts are recorded from here on, which allows the filter to be populated while the store is in use */
+	void enable (std::size_t size_bytes_a, nano::stat & stats_a);
+	/** Lookups consult the filter after this call, it must only be made once every existing key was inserted */
+	void set_ready ();
+	bool ready () const;
+	std::size_t size_bytes () const;
+
+	void insert (table, nano::uint256_union const &);
+	void insert (table, nano::uint256_union const &, nano::uint256_union const &);
+	/** Returns true if the key was never inserted, in which case the store lookup can be skipped */
+	bool absent (table, nano::uint256_union const &) const;
+	bool absent (table, nano::uint256_union const &, nano::uint256_union const &) const;
+	/** Records the outcome of a store lookup which the filter did not rule out */
+	void lookup (bool found_a) const;
+
+	static std::size_t constexpr block_bytes = 64;
+	static unsigned constexpr bits_per_key = 8;
+
+private:
+	void insert (table, uint64_t, uint64_t);
+	bool absent (table, uint64_t, uint64_t) const;
+
+	std::unique_ptr<std::atomic<uint64_t>[]> words;
+	std::size_t block_count{ 0 };
+	nano::stat * stats{ nullptr };
+	std::atomic<bool> enabled_m{ false };
+	std::atomic<bool> ready_m{ false };
+};
+}
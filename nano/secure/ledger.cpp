@@ -782,6 +782,11 @@ void nano::ledger::initialize (nano::generate_cache const & generate_cache_a)
 		});
 	}
 
+	if (generate_cache_a.uncemented)
+	{
+		rebuild_uncemented ();
+	}
+
 	auto transaction (store.tx_begin_read ());
 	cache.pruned_count = store.pruned.count (transaction);
 
@@ -1247,6 +1252,15 @@ nano::link const & nano::ledger::epoch_link (nano::epoch epoch_a) const
 
 void nano::ledger::update_account (nano::write_transaction const & transaction_a, nano::account const & account_a, nano::account_info const & old_a, nano::account_info const & new_a)
 {
+	nano::confirmation_height_info confirmation_height_info;
+	if (uncemented.confirmation_height (account_a, confirmation_height_info))
+	{
+		store.confirmation_height.get (transaction_a, account_a, confirmation_height_info);
+	}
+	if (uncemented.update (account_a, new_a.head, new_a.block_count, confirmation_height_info))
+	{
+		stats.inc (nano::stat::type::ledger, nano::stat::detail::uncemented_dropped);
+	}
 	if (!new_a.head.is_zero ())
 	{
 		if (old_a.head.is_zero () && new_a.open_block == new_a.head)
@@ -1373,6 +1387,17 @@ uint64_t nano::ledger::pruning_action (nano::write_transaction & transaction_a,
 
 std::multimap<uint64_t, nano::uncemented_info, std::greater<>> nano::ledger::unconfirmed_frontiers () const
 {
+	if (uncemented.complete ())
+	{
+		std::multimap<uint64_t, nano::uncemented_info, std::greater<>> result;
+		for (auto const & [account, entry] : uncemented.next (0, std::numeric_limits<std::size_t>::max ()))
+		{
+			result.emplace (std::piecewise_construct, std::forward_as_tuple (entry.block_count - entry.cemented_height), std::forward_as_tuple (entry.cemented_frontier, entry.head, account));
+		}
+		return result;
+	}
+
+	// The index left accounts out, every account has to be checked
 	nano::locked<std::multimap<uint64_t, nano::uncemented_info, std::greater<>>> result;
 	using result_t = decltype (result)::value_type;
 
@@ -1402,6 +1427,21 @@ std::multimap<uint64_t, nano::uncemented_info, std::greater<>> nano::ledger::unc
 	return result;
 }
 
+void nano::ledger::rebuild_uncemented ()
+{
+	uncemented.clear ();
+	store.account.for_each_par (
+	[this] (nano::read_transaction const & transaction_a, nano::store_iterator<nano::account, nano::account_info> i, nano::store_iterator<nano::account, nano::account_info> n) {
+		for (; i != n; ++i)
+		{
+			nano::confirmation_height_info confirmation_height_info;
+			this->store.confirmation_height.get (transaction_a, i->first, confirmation_height_info);
+			this->uncemented.update (i->first, i->second.head, i->second.block_count, confirmation_height_info);
+		}
+	});
+	uncemented.built ();
+}
+
 // A precondition is that the store is an LMDB store
 bool nano::ledger::migrate_lmdb_to_rocksdb (boost::filesystem::path const & data_path_a) const
 {
@@ -1544,6 +1584,41 @@ bool nano::ledger::migrate_lmdb_to_rocksdb (boost::filesystem::path const & data
 	return error;
 }
 
+void nano::ledger::enable_exists_filter (std::size_t size_bytes_a)
+{
+	store.exists_filter.enable (size_bytes_a, stats);
+	// Writes made while populating are recorded by the store, so the filter is complete once every table was scanned
+	store.block.for_each_par (
+	[this] (nano::read_transaction const & /*unused*/, auto i, auto n) {
+		for (; i != n; ++i)
+		{
+			store.exists_filter.insert (nano::exists_filter::table::blocks, i->first);
+		}
+	});
+	store.account.for_each_par (
+	[this] (nano::read_transaction const & /*unused*/, auto i, auto n) {
+		for (; i != n; ++i)
+		{
+			store.exists_filter.insert (nano::exists_filter::table::accounts, i->first);
+		}
+	});
+	store.pending.for_each_par (
+	[this] (nano::read_transaction const & /*unused*/, auto i, auto n) {
+		for (; i != n; ++i)
+		{
+			store.exists_filter.insert (nano::exists_filter::table::pending, i->first.account, i->first.hash);
+		}
+	});
+	store.pruned.for_each_par (
+	[this] (nano::read_transaction const & /*unused*/, auto i, auto n) {
+		for (; i != n; ++i)
+		{
+			store.exists_filter.insert (nano::exists_filter::table::pruned, i->first);
+		}
+	});
+	store.exists_filter.set_ready ();
+}
+
 nano::uncemented_info::uncemented_info (nano::block_hash const & cemented_frontier, nano::block_hash const & frontier, nano::account const & account) :
 	cemented_frontier (cemented_frontier), frontier (frontier), account (account)
 {
@@ -1556,5 +1631,7 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (le
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "bootstrap_weights", count, sizeof_element }));
 	composite->add_component (collect_container_info (ledger.cache.rep_weights, "rep_weights"));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "exists_filter", ledger.store.exists_filter.size_bytes (), 1 }));
+	composite->add_component (ledger.uncemented.collect_container_info ("uncemented"));
 	return composite;
 }
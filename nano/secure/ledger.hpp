@@ -3,6 +3,7 @@
 #include <nano/lib/rep_weights.hpp>
 #include <nano/lib/timer.hpp>
 #include <nano/secure/common.hpp>
+#include <nano/secure/uncemented_index.hpp>
 
 #include <map>
 
@@ -67,10 +68,15 @@ public:
 	nano::link const & epoch_link (nano::epoch) const;
 	std::multimap<uint64_t, uncemented_info, std::greater<>> unconfirmed_frontiers () const;
 	bool migrate_lmdb_to_rocksdb (boost::filesystem::path const &) const;
+	/** Allocates the store's exists filter and populates it from the blocks, accounts, pending and pruned tables */
+	void enable_exists_filter (std::size_t);
+	/** Rebuilds the uncemented index from the accounts and confirmation_height tables */
+	void rebuild_uncemented ();
 	static nano::uint128_t const unit;
 	nano::network_params network_params;
 	nano::store & store;
 	nano::ledger_cache cache;
+	nano::uncemented_index uncemented;
 	nano::stat & stats;
 	std::unordered_map<nano::account, nano::uint128_t> bootstrap_weights;
 	std::atomic<size_t> bootstrap_weights_size{ 0 };
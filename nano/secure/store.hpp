@@ -8,6 +8,7 @@
 #include <nano/lib/rocksdbconfig.hpp>
 #include <nano/secure/buffer.hpp>
 #include <nano/secure/common.hpp>
+#include <nano/secure/exists_filter.hpp>
 #include <nano/secure/versioning.hpp>
 
 #include <boost/endian/conversion.hpp>
@@ -849,6 +850,9 @@ public:
 	final_vote_store & final_vote;
 	version_store & version;
 
+	/** Optional negative cache consulted by the block, account, pending and pruned stores, see ledger::enable_exists_filter */
+	nano::exists_filter exists_filter;
+
 	virtual unsigned max_block_write_batch_num () const = 0;
 
 	virtual bool copy_db (boost::filesystem::path const & destination) = 0;
@@ -34,14 +34,20 @@ public:
 		nano::db_val<Val> info (info_a);
 		auto status = store.put (transaction_a, tables::accounts, account_a, info);
 		release_assert_success (store, status);
+		store.exists_filter.insert (nano::exists_filter::table::accounts, account_a);
 	}
 
 	bool get (nano::transaction const & transaction_a, nano::account const & account_a, nano::account_info & info_a) override
 	{
+		if (store.exists_filter.absent (nano::exists_filter::table::accounts, account_a))
+		{
+			return true;
+		}
 		nano::db_val<Val> value;
 		nano::db_val<Val> account (account_a);
 		auto status1 (store.get (transaction_a, tables::accounts, account, value));
 		release_assert (store.success (status1) || store.not_found (status1));
+		store.exists_filter.lookup (store.success (status1));
 		bool result (true);
 		if (store.success (status1))
 		{
@@ -59,6 +65,10 @@ public:
 
 	bool exists (nano::transaction const & transaction_a, nano::account const & account_a) override
 	{
+		if (store.exists_filter.absent (nano::exists_filter::table::accounts, account_a))
+		{
+			return false;
+		}
 		auto iterator (begin (transaction_a, account_a));
 		return iterator != end () && nano::account (iterator->first) == account_a;
 	}
@@ -51,6 +51,7 @@ public:
 		nano::db_val<Val> value{ data.size (), (void *)data.data () };
 		auto status = store.put (transaction_a, tables::blocks, hash_a, value);
 		release_assert_success (store, status);
+		store.exists_filter.insert (nano::exists_filter::table::blocks, hash_a);
 	}
 
 	nano::block_hash successor (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
@@ -244,8 +245,12 @@ protected:
 	nano::db_val<Val> block_raw_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 	{
 		nano::db_val<Val> result;
-		auto status = store.get (transaction_a, tables::blocks, hash_a, result);
-		release_assert (store.success (status) || store.not_found (status));
+		if (!store.exists_filter.absent (nano::exists_filter::table::blocks, hash_a))
+		{
+			auto status = store.get (transaction_a, tables::blocks, hash_a, result);
+			release_assert (store.success (status) || store.not_found (status));
+			store.exists_filter.lookup (store.success (status));
+		}
 		return result;
 	}
 
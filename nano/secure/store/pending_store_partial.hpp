@@ -33,6 +33,7 @@ public:
 		nano::db_val<Val> pending (pending_info_a);
 		auto status = store.put (transaction_a, tables::pending, key_a, pending);
 		release_assert_success (store, status);
+		store.exists_filter.insert (nano::exists_filter::table::pending, key_a.account, key_a.hash);
 	}
 
 	void del (nano::write_transaction const & transaction_a, nano::pending_key const & key_a) override
@@ -43,10 +44,15 @@ public:
 
 	bool get (nano::transaction const & transaction_a, nano::pending_key const & key_a, nano::pending_info & pending_a) override
 	{
+		if (store.exists_filter.absent (nano::exists_filter::table::pending, key_a.account, key_a.hash))
+		{
+			return true;
+		}
 		nano::db_val<Val> value;
 		nano::db_val<Val> key (key_a);
 		auto status1 = store.get (transaction_a, tables::pending, key, value);
 		release_assert (store.success (status1) || store.not_found (status1));
+		store.exists_filter.lookup (store.success (status1));
 		bool result (true);
 		if (store.success (status1))
 		{
@@ -58,6 +64,10 @@ public:
 
 	bool exists (nano::transaction const & transaction_a, nano::pending_key const & key_a) override
 	{
+		if (store.exists_filter.absent (nano::exists_filter::table::pending, key_a.account, key_a.hash))
+		{
+			return false;
+		}
 		auto iterator (begin (transaction_a, key_a));
 		return iterator != end () && nano::pending_key (iterator->first) == key_a;
 	}
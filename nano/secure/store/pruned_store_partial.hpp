@@ -32,6 +32,7 @@ public:
 	{
 		auto status = store.put_key (transaction_a, tables::pruned, hash_a);
 		release_assert_success (store, status);
+		store.exists_filter.insert (nano::exists_filter::table::pruned, hash_a);
 	}
 
 	void del (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a) override
@@ -42,7 +43,13 @@ public:
 
 	bool exists (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
 	{
-		return store.exists (transaction_a, tables::pruned, nano::db_val<Val> (hash_a));
+		if (store.exists_filter.absent (nano::exists_filter::table::pruned, hash_a))
+		{
+			return false;
+		}
+		auto result (store.exists (transaction_a, tables::pruned, nano::db_val<Val> (hash_a)));
+		store.exists_filter.lookup (result);
+		return result;
 	}
 
 	nano::block_hash random (nano::transaction const & transaction_a) override
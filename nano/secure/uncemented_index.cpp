@@ -0,0 +1,127 @@
+#include <nano/lib/utility.hpp>
+#include <nano/secure/common.hpp>
+#include <nano/secure/uncemented_index.hpp>
+
+nano::uncemented_index::uncemented_index (std::size_t max_entries_a) :
+	max_entries (max_entries_a)
+{
+}
+
+bool nano::uncemented_index::update (nano::account const & account_a, nano::block_hash const & head_a, uint64_t block_count_a, nano::confirmation_height_info const & info_a)
+{
+	auto result (false);
+	nano::lock_guard<nano::mutex> guard (mutex);
+	if (head_a.is_zero () || block_count_a <= info_a.height)
+	{
+		entries.erase (account_a);
+	}
+	else
+	{
+		auto existing (entries.find (account_a));
+		if (existing != entries.end ())
+		{
+			existing->second = entry{ head_a, block_count_a, info_a.frontier, info_a.height };
+		}
+		else if (entries.size () < max_entries)
+		{
+			entries.emplace (account_a, entry{ head_a, block_count_a, info_a.frontier, info_a.height });
+		}
+		else
+		{
+			result = true;
+			complete_m = false;
+			missing = true;
+		}
+	}
+	return result;
+}
+
+void nano::uncemented_index::cemented (nano::account const & account_a, nano::confirmation_height_info const & info_a)
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing (entries.find (account_a));
+	if (existing != entries.end ())
+	{
+		if (existing->second.block_count <= info_a.height)
+		{
+			entries.erase (existing);
+		}
+		else
+		{
+			existing->second.cemented_frontier = info_a.frontier;
+			existing->second.cemented_height = info_a.height;
+		}
+	}
+}
+
+bool nano::uncemented_index::confirmation_height (nano::account const & account_a, nano::confirmation_height_info & info_a) const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	auto existing (entries.find (account_a));
+	auto result (existing == entries.end ());
+	if (!result)
+	{
+		info_a.frontier = existing->second.cemented_frontier;
+		info_a.height = existing->second.cemented_height;
+	}
+	return result;
+}
+
+std::vector<std::pair<nano::account, nano::uncemented_index::entry>> nano::uncemented_index::next (nano::account const & start_a, std::size_t count_a) const
+{
+	std::vector<std::pair<nano::account, entry>> result;
+	nano::lock_guard<nano::mutex> guard (mutex);
+	for (auto i (entries.lower_bound (start_a)), n (entries.end ()); i != n && result.size () < count_a; ++i)
+	{
+		result.emplace_back (*i);
+	}
+	return result;
+}
+
+void nano::uncemented_index::clear ()
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	entries.clear ();
+	complete_m = false;
+	missing = false;
+}
+
+void nano::uncemented_index::built ()
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	complete_m = !missing;
+}
+
+void nano::uncemented_index::invalidate ()
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	complete_m = false;
+	missing = true;
+}
+
+void nano::uncemented_index::all_cemented ()
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	if (entries.empty ())
+	{
+		complete_m = true;
+		missing = false;
+	}
+}
+
+bool nano::uncemented_index::complete () const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	return complete_m;
+}
+
+std::size_t nano::uncemented_index::size () const
+{
+	nano::lock_guard<nano::mutex> guard (mutex);
+	return entries.size ();
+}
+
+std::unique_ptr<nano::container_info_component> nano::uncemented_index::collect_container_info (std::string const & name) const
+{
+	return std::make_unique<container_info_leaf> (container_info{ name, size (), sizeof (decltype (entries)::value_type) });
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <nano/lib/locks.hpp>
+#include <nano/lib/numbers.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nano
+{
+class confirmation_height_info;
+class container_info_component;
+
+/**
+ * In-memory index of the accounts whose head is above their confirmation height, ordered by account.
+ * It is rebuilt from the accounts and confirmation_height tables when the ledger is initialized and kept up to date by ledger processing, rollback and cementing,
+ * so finding uncemented frontiers costs time in the number of uncemented accounts rather than in the number of accounts.
+ * The index holds at most max_entries accounts, as it can grow to millions of accounts while bootstrapping. Accounts which do not fit are left out and the
+ * index is incomplete until it is rebuilt or the ledger is fully cemented, users then have to read the accounts and confirmation_height tables instead.
+ * The index is also incomplete until it has been built, and after confirmation heights were written to the store without going through the ledger.
+ * @note This class is thread-safe
+ */
+class uncemented_index final
+{
+public:
+	class entry final
+	{
+	public:
+		nano::block_hash head;
+		uint64_t block_count;
+		nano::block_hash cemented_frontier;
+		uint64_t cemented_height;
+	};
+
+	explicit uncemented_index (std::size_t max_entries_a = default_max_entries);
+	/**
+	 * Records the new head of \p account_a, dropping the account once every block up to its head is cemented or when the account no longer exists (zero head)
+	 * @return true if the account was left out because the index is full
+	 */
+	bool update (nano::account const & account_a, nano::block_hash const & head_a, uint64_t block_count_a, nano::confirmation_height_info const &);
+	/** Records a new confirmation height for \p account_a */
+	void cemented (nano::account const & account_a, nano::confirmation_height_info const &);
+	/** Copies the cemented frontier and height of \p account_a into \p info_a. Returns true if the account is not in the index */
+	bool confirmation_height (nano::account const & account_a, nano::confirmation_height_info & info_a) const;
+	/** Returns up to \p count_a entries, in account order, starting with the first account not less than \p start_a */
+	std::vector<std::pair<nano::account, entry>> next (nano::account const & start_a, std::size_t count_a) const;
+	/** Empties the index, which is incomplete until it is built again */
+	void clear ();
+	/** Called once every account in the store has been added since the index was cleared, the index is complete unless accounts were left out */
+	void built ();
+	/** Marks the index incomplete. Called after confirmation heights are written to the store directly, the index does not see those writes */
+	void invalidate ();
+	/** Called when every block in the ledger is cemented, an incomplete index which has emptied out is complete again as no account can be missing from it */
+	void all_cemented ();
+	/** False until the index is built, and afterwards if an account with uncemented blocks may be missing from it */
+	bool complete () const;
+	std::size_t size () const;
+	std::unique_ptr<nano::container_info_component> collect_container_info (std::string const &) const;
+
+	/** About 40MB of entries */
+	static std::size_t constexpr default_max_entries = 256 * 1024;
+
+private:
+	std::size_t const max_entries;
+	std::map<nano::account, entry> entries;
+	bool complete_m{ false };
+	/** An account may be missing since the index was last cleared */
+	bool missing{ false };
+	mutable nano::mutex mutex;
+};
+}
@@ -1,6 +1,14 @@
+#include <nano/boost/asio/local/stream_protocol.hpp>
+#include <nano/boost/asio/read.hpp>
+#include <nano/boost/asio/write.hpp>
 #include <nano/crypto_lib/random_pool.hpp>
+#include <nano/lib/ipc_client.hpp>
+#include <nano/lib/ipc_shm.hpp>
 #include <nano/lib/threading.hpp>
+#include <nano/lib/timer.hpp>
 #include <nano/node/election.hpp>
+#include <nano/node/ipc/ipc_server.hpp>
+#include <nano/node/lmdb/lmdb.hpp>
 #include <nano/node/transport/udp.hpp>
 #include <nano/test_common/network.hpp>
 #include <nano/test_common/system.hpp>
@@ -8,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/format.hpp>
 #include <boost/unordered_set.hpp>
 
@@ -1087,6 +1097,7 @@ TEST (confirmation_height, prioritize_frontiers_overwrite)
 		auto transaction = node->store.tx_begin_write ();
 		node->store.confirmation_height.clear (transaction);
 	}
+	node->ledger.uncemented.invalidate ();
 
 	{
 		auto transaction = node->store.tx_begin_write ();
@@ -1863,3 +1874,221 @@ TEST (node, wallet_create_block_confirm_conflicts)
 		t.join ();
 	}
 }
+
+// Measures the request loop tick and election confirmation latency. Before elections were scheduled by their next transition every active election was visited on every tick
+TEST (active_transactions, request_loop_tick_cost)
+{
+	nano::system system;
+	nano::node_config node_config (nano::get_available_port (), system.logging);
+	node_config.frontiers_confirmation = nano::frontiers_confirmation_mode::disabled;
+	node_config.active_elections_size = 10000;
+	auto & node = *system.add_node (node_config);
+	auto const num_elections = 5000;
+	auto const num_confirmed = 1000;
+	nano::keypair key;
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	std::vector<std::shared_ptr<nano::block>> key_blocks;
+	{
+		auto transaction (node.store.tx_begin_write ());
+		auto latest (nano::dev::genesis->hash ());
+		// The first send funds a second account and has no election, cementing the second account's blocks does not confirm genesis elections
+		for (auto i (0); i <= num_elections; ++i)
+		{
+			auto send = nano::send_block_builder ()
+						.previous (latest)
+						.destination (i == 0 ? key.pub : nano::keypair ().pub)
+						.balance (nano::dev::genesis_amount - (i == 0 ? nano::Gxrb_ratio : nano::Gxrb_ratio + i))
+						.sign (nano::dev::genesis_key.prv, nano::dev::genesis_key.pub)
+						.work (*system.work.generate (latest))
+						.build_shared ();
+			ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *send).code);
+			latest = send->hash ();
+			if (i != 0)
+			{
+				blocks.push_back (send);
+			}
+		}
+		auto open = nano::open_block_builder ()
+					.source (blocks.front ()->previous ())
+					.representative (nano::dev::genesis_key.pub)
+					.account (key.pub)
+					.sign (key.prv, key.pub)
+					.work (*system.work.generate (key.pub))
+					.build_shared ();
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *open).code);
+		key_blocks.push_back (open);
+		for (auto i (1); i < num_confirmed; ++i)
+		{
+			auto send = nano::send_block_builder ()
+						.previous (key_blocks.back ()->hash ())
+						.destination (nano::keypair ().pub)
+						.balance (nano::Gxrb_ratio - i)
+						.sign (key.prv, key.pub)
+						.work (*system.work.generate (key_blocks.back ()->hash ()))
+						.build_shared ();
+			ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, *send).code);
+			key_blocks.push_back (send);
+		}
+	}
+	// Upper end of the latency histogram bin holding the \p fraction_a quantile, in microseconds
+	auto quantile = [&node] (nano::stat::detail detail_a, double fraction_a) {
+		auto bins (node.stats.get_histogram (nano::stat::type::latency, detail_a, nano::stat::dir::in)->get_bins ());
+		auto total (std::accumulate (bins.begin (), bins.end (), uint64_t (0), [] (uint64_t sum_a, auto const & bin_a) { return sum_a + bin_a.value; }));
+		uint64_t seen (0);
+		for (auto const & bin : bins)
+		{
+			seen += bin.value;
+			if (seen > 0 && seen >= fraction_a * total)
+			{
+				return bin.end_exclusive;
+			}
+		}
+		return uint64_t (0);
+	};
+
+	// Ticks with every election active and unanswered
+	for (auto const & block : blocks)
+	{
+		node.block_confirm (block);
+	}
+	node.scheduler.flush ();
+	ASSERT_TIMELY (10s, node.active.size () == num_elections);
+	auto const duration = 2s;
+	node.stats.get_histogram (nano::stat::type::latency, nano::stat::detail::request_loop_tick, nano::stat::dir::in)->clear ();
+	auto const transitions_before (node.stats.count (nano::stat::type::election, nano::stat::detail::election_transitions, nano::stat::dir::in));
+	std::this_thread::sleep_for (duration);
+	auto const transitions (node.stats.count (nano::stat::type::election, nano::stat::detail::election_transitions, nano::stat::dir::in) - transitions_before);
+	// Visiting every election on every tick
+	auto const ticks (duration / std::chrono::milliseconds (node.network_params.network.request_interval_ms));
+	auto const full_scan (num_elections * ticks);
+	std::cout << boost::str (boost::format ("Elections visited in %1% ms: %2% (%3% with a full scan every tick)\n") % std::chrono::duration_cast<std::chrono::milliseconds> (duration).count () % transitions % full_scan);
+	std::cout << boost::str (boost::format ("Request loop tick with %1% active elections: p50 < %2% us, p99 < %3% us\n") % num_elections % quantile (nano::stat::detail::request_loop_tick, 0.5) % quantile (nano::stat::detail::request_loop_tick, 0.99));
+	ASSERT_LT (transitions, full_scan / 2);
+
+	// Elections started while voting confirm next to the unanswered ones
+	system.wallet (0)->insert_adhoc (nano::dev::genesis_key.prv);
+	node.stats.get_histogram (nano::stat::type::latency, nano::stat::detail::election_confirm, nano::stat::dir::in)->clear ();
+	for (auto const & block : key_blocks)
+	{
+		node.block_confirm (block);
+	}
+	ASSERT_TIMELY (60s, std::all_of (key_blocks.begin (), key_blocks.end (), [&node] (auto const & block_a) { return node.block_confirmed (block_a->hash ()); }));
+	std::cout << boost::str (boost::format ("Election confirmation with %1% active elections: p50 < %2% us, p99 < %3% us\n") % num_elections % quantile (nano::stat::detail::election_confirm, 0.5) % quantile (nano::stat::detail::election_confirm, 0.99));
+}
+
+#if defined(NANO_IPC_SHM)
+TEST (ipc, shm_throughput)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	auto path ((boost::filesystem::temp_directory_path () / "nano_slow_test_ipc").string ());
+	node.config.ipc_config.transport_domain.enabled = true;
+	node.config.ipc_config.transport_domain.path = path;
+	nano::node_rpc_config node_rpc_config;
+	nano::ipc::ipc_server ipc (node, node_rpc_config);
+	nanoapi::IsAliveT alive;
+	auto fbb (nano::ipc::flatbuffer_producer::make_buffer (alive));
+	auto const count (100000);
+	auto rate = [count] (nano::timer<std::chrono::milliseconds> & timer_a) {
+		return count * 1000 / std::max<uint64_t> (timer_a.stop ().count (), 1);
+	};
+
+	// Domain socket, each request carries a preamble and a length prefix
+	boost::asio::io_context io_ctx;
+	boost::asio::local::stream_protocol::socket socket (io_ctx);
+	socket.connect (boost::asio::local::stream_protocol::endpoint (path));
+	auto request (nano::ipc::get_preamble (nano::ipc::payload_encoding::flatbuffers));
+	auto big_size (boost::endian::native_to_big (static_cast<uint32_t> (fbb->GetSize ())));
+	request.insert (request.end (), reinterpret_cast<uint8_t *> (&big_size), reinterpret_cast<uint8_t *> (&big_size) + sizeof (big_size));
+	request.insert (request.end (), fbb->GetBufferPointer (), fbb->GetBufferPointer () + fbb->GetSize ());
+	std::vector<uint8_t> response;
+	nano::timer<std::chrono::milliseconds> timer (nano::timer_state::started);
+	for (auto i (0); i < count; ++i)
+	{
+		boost::asio::write (socket, boost::asio::buffer (request));
+		uint32_t size;
+		boost::asio::read (socket, boost::asio::buffer (&size, sizeof (size)));
+		response.resize (boost::endian::big_to_native (size));
+		boost::asio::read (socket, boost::asio::buffer (response));
+	}
+	auto socket_rate (rate (timer));
+
+	// Shared memory, the same requests issued one at a time and then pipelined
+	nano::ipc::shm_client client;
+	ASSERT_FALSE (client.connect (path));
+	nanoapi::Message type{ nanoapi::Message::Message_NONE };
+	auto read = [&client, &type] () {
+		return client.read ([&type] (uint8_t const * data_a, size_t size_a) {
+			type = nanoapi::GetEnvelope (data_a)->message_type ();
+		},
+		std::chrono::seconds (5));
+	};
+	timer.restart ();
+	for (auto i (0); i < count; ++i)
+	{
+		ASSERT_FALSE (client.write (fbb->GetBufferPointer (), fbb->GetSize (), std::chrono::seconds (5)));
+		ASSERT_FALSE (read ());
+		ASSERT_EQ (nanoapi::Message::Message_IsAlive, type);
+	}
+	auto shm_rate (rate (timer));
+	auto const window (256);
+	timer.restart ();
+	for (auto i (0); i < count + window; ++i)
+	{
+		if (i < count)
+		{
+			ASSERT_FALSE (client.write (fbb->GetBufferPointer (), fbb->GetSize (), std::chrono::seconds (5)));
+		}
+		if (i >= window)
+		{
+			ASSERT_FALSE (read ());
+		}
+	}
+	auto pipelined_rate (rate (timer));
+	std::cout << boost::str (boost::format ("Messages/sec: domain socket %1%, shared memory %2%, shared memory pipelined %3%\n") % socket_rate % shm_rate % pipelined_rate);
+	ipc.stop ();
+}
+#endif
+
+// Compares copying a synthetic ledger with mdb_env_copy2 against the parallel compactor
+TEST (mdb_compactor, synthetic_ledger)
+{
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, nano::unique_path ());
+	ASSERT_FALSE (store.init_error ());
+	auto fill = [&store] (MDB_dbi handle_a, size_t count_a, size_t key_size_a, size_t value_size_a) {
+		std::vector<uint8_t> key (key_size_a);
+		std::vector<uint8_t> value (value_size_a);
+		auto transaction (store.tx_begin_write ());
+		for (size_t i (0); i < count_a; ++i)
+		{
+			nano::random_pool::generate_block (key.data (), key.size ());
+			nano::random_pool::generate_block (value.data (), value.size ());
+			MDB_val key_val{ key.size (), key.data () };
+			MDB_val value_val{ value.size (), value.data () };
+			ASSERT_EQ (0, mdb_put (store.env.tx (transaction), handle_a, &key_val, &value_val, 0));
+		}
+	};
+	// Random keys leave pages partly filled, like a ledger built by live traffic
+	fill (store.blocks_handle, 1000000, 32, 256);
+	fill (store.accounts_handle, 250000, 32, 128);
+	fill (store.pending_handle, 250000, 64, 48);
+	fill (store.confirmation_height_handle, 250000, 32, 40);
+	fill (store.unchecked_handle, 100000, 64, 320);
+
+	auto copy_path (nano::unique_path ());
+	nano::timer<std::chrono::milliseconds> timer (nano::timer_state::started);
+	ASSERT_EQ (0, mdb_env_copy2 (store.env, copy_path.string ().c_str (), MDB_CP_COMPACT));
+	auto copy_time (timer.stop ());
+
+	nano::mdb_compactor compactor (store.env, nano::unique_path ());
+	timer.restart ();
+	ASSERT_FALSE (compactor.run ([] (nano::mdb_compactor::table_progress const & progress_a) {
+		if (progress_a.done)
+		{
+			std::cout << progress_a.to_string () << std::endl;
+		}
+	}));
+	auto compactor_time (timer.stop ());
+	std::cout << boost::str (boost::format ("mdb_env_copy2 %1% ms, compactor %2% ms with %3% threads\n") % copy_time.count () % compactor_time.count () % nano::mdb_compactor::default_threads ());
+}